@@ -377,6 +377,7 @@ public:
 
 	/// Get the user data pointer that was provided in the body definition.
 	b2BodyUserData& GetUserData();
+	const b2BodyUserData& GetUserData() const;
 
 	/// Get the parent world of this body.
 	b2World* GetWorld();
@@ -733,6 +734,11 @@ inline b2BodyUserData& b2Body::GetUserData()
 	return m_userData;
 }
 
+inline const b2BodyUserData& b2Body::GetUserData() const
+{
+	return m_userData;
+}
+
 inline void b2Body::ApplyForce(const b2Vec2& force, const b2Vec2& point, bool wake)
 {
 	if (m_type != b2_dynamicBody)
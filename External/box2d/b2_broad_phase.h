@@ -27,6 +27,8 @@
 #include "box2d/b2_settings.h"
 #include "box2d/b2_collision.h"
 #include "box2d/b2_dynamic_tree.h"
+#include "box2d/b2_sweep_and_prune.h"
+#include "box2d/b2_spatial_grid.h"
 
 struct B2_API b2Pair
 {
@@ -34,9 +36,28 @@ struct B2_API b2Pair
 	int32 proxyIdB;
 };
 
+/// The structures a broad-phase can keep its proxies in. They find the same pairs.
+enum b2BroadPhaseType
+{
+	/// A dynamic AABB tree. Good for any mix of proxy sizes.
+	b2_treeBroadPhase,
+
+	/// Proxies sorted along both axes. Good for many proxies of a similar size,
+	/// and cheap to move.
+	b2_sweepBroadPhase,
+
+	/// A hashed uniform grid. Good for many proxies a little smaller than a cell.
+	b2_gridBroadPhase
+};
+
+class b2TaskExecutor;
+struct b2MoveSpan;
+struct b2ThreadPairs;
+
 /// The broad-phase is used for computing pairs and performing volume queries and ray casts.
 /// This broad-phase does not persist pairs. Instead, this reports potentially new pairs.
 /// It is up to the client to consume the new pairs and to track subsequent overlap.
+/// The proxies are kept in a dynamic tree unless SetType picks another structure.
 class B2_API b2BroadPhase
 {
 public:
@@ -94,30 +115,66 @@ public:
 	template <typename T>
 	void RayCast(T* callback, const b2RayCastInput& input) const;
 
-	/// Get the height of the embedded tree.
+	/// Ray-cast a packet of rays. The tree traverses the lanes together, see
+	/// b2DynamicTree::RayCastPacket. The other broad-phases cast them one at a time.
+	template <typename T>
+	void RayCastPacket(T* callback, b2RayPacket* packet) const;
+
+	/// Get the height of the embedded tree. Zero unless the type is b2_treeBroadPhase.
 	int32 GetTreeHeight() const;
 
-	/// Get the balance of the embedded tree.
+	/// Get the balance of the embedded tree. Zero unless the type is b2_treeBroadPhase.
 	int32 GetTreeBalance() const;
 
-	/// Get the quality metric of the embedded tree.
+	/// Get the quality metric of the embedded tree. Zero unless the type is b2_treeBroadPhase.
 	float GetTreeQuality() const;
 
+	/// Build the tree again, top down with a binned surface area heuristic, on the
+	/// task executor's threads. See b2DynamicTree::RebuildTopDown. Does nothing
+	/// unless the type is b2_treeBroadPhase.
+	void RebuildTree();
+
+	/// Change the structure the proxies are kept in. There must be no proxies.
+	/// @param cellSize the grid's cell size, and the extent past which sweep-and-prune
+	/// scans a proxy on its own. Ignored by the tree.
+	void SetType(b2BroadPhaseType type, float cellSize);
+
+	/// Get the structure the proxies are kept in.
+	b2BroadPhaseType GetType() const;
+
 	/// Shift the world origin. Useful for large worlds.
 	/// The shift formula is: position -= newOrigin
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// Query the moved proxies across the executor's threads in UpdatePairs. Pairs
+	/// are reported in the same order as without one. Pass nullptr to query on the
+	/// calling thread.
+	void SetTaskExecutor(b2TaskExecutor* executor);
+
 private:
 
 	friend class b2DynamicTree;
+	friend class b2SweepAndPrune;
+	friend class b2SpatialGrid;
+	friend class b2FindPairsTask;
+	friend class b2PairQuery;
 
 	void BufferMove(int32 proxyId);
 	void UnBufferMove(int32 proxyId);
 
 	bool QueryCallback(int32 proxyId);
 
+	bool WasMoved(int32 proxyId) const;
+	void ClearMoved(int32 proxyId);
+
+	bool FindPairsParallel();
+	void FindPairs(int32 begin, int32 end, int32 threadIndex);
+
+	b2BroadPhaseType m_type;
 	b2DynamicTree m_tree;
+	b2SweepAndPrune m_sweep;
+	b2SpatialGrid m_grid;
 
 	int32 m_proxyCount;
 
@@ -130,23 +187,76 @@ private:
 	int32 m_pairCount;
 
 	int32 m_queryProxyId;
+
+	b2TaskExecutor* m_taskExecutor;
+
+	// Pairs found by each thread, and where each moved proxy's pairs landed.
+	b2ThreadPairs* m_threadPairs;
+	int32 m_threadCount;
+	b2MoveSpan* m_moveSpans;
+	int32 m_moveSpanCapacity;
 };
 
 inline void* b2BroadPhase::GetUserData(int32 proxyId) const
 {
-	return m_tree.GetUserData(proxyId);
+	switch (m_type)
+	{
+	case b2_sweepBroadPhase:
+		return m_sweep.GetUserData(proxyId);
+	case b2_gridBroadPhase:
+		return m_grid.GetUserData(proxyId);
+	default:
+		return m_tree.GetUserData(proxyId);
+	}
 }
 
 inline bool b2BroadPhase::TestOverlap(int32 proxyIdA, int32 proxyIdB) const
 {
-	const b2AABB& aabbA = m_tree.GetFatAABB(proxyIdA);
-	const b2AABB& aabbB = m_tree.GetFatAABB(proxyIdB);
+	const b2AABB& aabbA = GetFatAABB(proxyIdA);
+	const b2AABB& aabbB = GetFatAABB(proxyIdB);
 	return b2TestOverlap(aabbA, aabbB);
 }
 
 inline const b2AABB& b2BroadPhase::GetFatAABB(int32 proxyId) const
 {
-	return m_tree.GetFatAABB(proxyId);
+	switch (m_type)
+	{
+	case b2_sweepBroadPhase:
+		return m_sweep.GetFatAABB(proxyId);
+	case b2_gridBroadPhase:
+		return m_grid.GetFatAABB(proxyId);
+	default:
+		return m_tree.GetFatAABB(proxyId);
+	}
+}
+
+inline bool b2BroadPhase::WasMoved(int32 proxyId) const
+{
+	switch (m_type)
+	{
+	case b2_sweepBroadPhase:
+		return m_sweep.WasMoved(proxyId);
+	case b2_gridBroadPhase:
+		return m_grid.WasMoved(proxyId);
+	default:
+		return m_tree.WasMoved(proxyId);
+	}
+}
+
+inline void b2BroadPhase::ClearMoved(int32 proxyId)
+{
+	switch (m_type)
+	{
+	case b2_sweepBroadPhase:
+		m_sweep.ClearMoved(proxyId);
+		break;
+	case b2_gridBroadPhase:
+		m_grid.ClearMoved(proxyId);
+		break;
+	default:
+		m_tree.ClearMoved(proxyId);
+		break;
+	}
 }
 
 inline int32 b2BroadPhase::GetProxyCount() const
@@ -156,17 +266,22 @@ inline int32 b2BroadPhase::GetProxyCount() const
 
 inline int32 b2BroadPhase::GetTreeHeight() const
 {
-	return m_tree.GetHeight();
+	return m_type == b2_treeBroadPhase ? m_tree.GetHeight() : 0;
 }
 
 inline int32 b2BroadPhase::GetTreeBalance() const
 {
-	return m_tree.GetMaxBalance();
+	return m_type == b2_treeBroadPhase ? m_tree.GetMaxBalance() : 0;
 }
 
 inline float b2BroadPhase::GetTreeQuality() const
 {
-	return m_tree.GetAreaRatio();
+	return m_type == b2_treeBroadPhase ? m_tree.GetAreaRatio() : 0.0f;
+}
+
+inline b2BroadPhaseType b2BroadPhase::GetType() const
+{
+	return m_type;
 }
 
 template <typename T>
@@ -175,29 +290,39 @@ void b2BroadPhase::UpdatePairs(T* callback)
 	// Reset pair buffer
 	m_pairCount = 0;
 
-	// Perform tree queries for all moving proxies.
-	for (int32 i = 0; i < m_moveCount; ++i)
+	// Sort the proxies that moved since the last step, so the queries
+	// below don't scan them one by one.
+	if (m_type == b2_sweepBroadPhase)
+	{
+		m_sweep.Commit();
+	}
+
+	// Perform queries for all moving proxies.
+	if (FindPairsParallel() == false)
 	{
-		m_queryProxyId = m_moveBuffer[i];
-		if (m_queryProxyId == e_nullProxy)
+		for (int32 i = 0; i < m_moveCount; ++i)
 		{
-			continue;
+			m_queryProxyId = m_moveBuffer[i];
+			if (m_queryProxyId == e_nullProxy)
+			{
+				continue;
+			}
+
+			// We have to query with the fat AABB so that
+			// we don't fail to create a pair that may touch later.
+			const b2AABB& fatAABB = GetFatAABB(m_queryProxyId);
+
+			// Query, create pairs and add them pair buffer.
+			Query(this, fatAABB);
 		}
-
-		// We have to query the tree with the fat AABB so that
-		// we don't fail to create a pair that may touch later.
-		const b2AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
-
-		// Query tree, create pairs and add them pair buffer.
-		m_tree.Query(this, fatAABB);
 	}
 
 	// Send pairs to caller
 	for (int32 i = 0; i < m_pairCount; ++i)
 	{
 		b2Pair* primaryPair = m_pairBuffer + i;
-		void* userDataA = m_tree.GetUserData(primaryPair->proxyIdA);
-		void* userDataB = m_tree.GetUserData(primaryPair->proxyIdB);
+		void* userDataA = GetUserData(primaryPair->proxyIdA);
+		void* userDataB = GetUserData(primaryPair->proxyIdB);
 
 		callback->AddPair(userDataA, userDataB);
 	}
@@ -211,7 +336,7 @@ void b2BroadPhase::UpdatePairs(T* callback)
 			continue;
 		}
 
-		m_tree.ClearMoved(proxyId);
+		ClearMoved(proxyId);
 	}
 
 	// Reset move buffer
@@ -221,18 +346,88 @@ void b2BroadPhase::UpdatePairs(T* callback)
 template <typename T>
 inline void b2BroadPhase::Query(T* callback, const b2AABB& aabb) const
 {
-	m_tree.Query(callback, aabb);
+	switch (m_type)
+	{
+	case b2_sweepBroadPhase:
+		m_sweep.Query(callback, aabb);
+		break;
+	case b2_gridBroadPhase:
+		m_grid.Query(callback, aabb);
+		break;
+	default:
+		m_tree.Query(callback, aabb);
+		break;
+	}
 }
 
 template <typename T>
 inline void b2BroadPhase::RayCast(T* callback, const b2RayCastInput& input) const
 {
-	m_tree.RayCast(callback, input);
+	switch (m_type)
+	{
+	case b2_sweepBroadPhase:
+		m_sweep.RayCast(callback, input);
+		break;
+	case b2_gridBroadPhase:
+		m_grid.RayCast(callback, input);
+		break;
+	default:
+		m_tree.RayCast(callback, input);
+		break;
+	}
+}
+
+// Casts one lane of a packet through a broad-phase that has no packet traversal.
+template <typename T>
+struct b2RayPacketLane
+{
+	float RayCastCallback(const b2RayCastInput& input, int32 proxyId)
+	{
+		float value = callback->RayCastCallback(input, proxyId, lane);
+		if (value > 0.0f)
+		{
+			packet->SetMaxFraction(lane, value);
+		}
+		return value;
+	}
+
+	T* callback;
+	b2RayPacket* packet;
+	int32 lane;
+};
+
+template <typename T>
+inline void b2BroadPhase::RayCastPacket(T* callback, b2RayPacket* packet) const
+{
+	if (m_type == b2_treeBroadPhase)
+	{
+		m_tree.RayCastPacket(callback, packet);
+		return;
+	}
+
+	b2RayPacketLane<T> lane;
+	lane.callback = callback;
+	lane.packet = packet;
+	for (lane.lane = 0; lane.lane < packet->count; ++lane.lane)
+	{
+		RayCast(&lane, packet->GetInput(lane.lane));
+	}
 }
 
 inline void b2BroadPhase::ShiftOrigin(const b2Vec2& newOrigin)
 {
-	m_tree.ShiftOrigin(newOrigin);
+	switch (m_type)
+	{
+	case b2_sweepBroadPhase:
+		m_sweep.ShiftOrigin(newOrigin);
+		break;
+	case b2_gridBroadPhase:
+		m_grid.ShiftOrigin(newOrigin);
+		break;
+	default:
+		m_tree.ShiftOrigin(newOrigin);
+		break;
+	}
 }
 
 #endif
@@ -255,6 +255,11 @@ B2_API bool b2TestOverlap(	const b2Shape* shapeA, int32 indexA,
 					const b2Shape* shapeB, int32 indexB,
 					const b2Transform& xfA, const b2Transform& xfB);
 
+/// Fatten a broad-phase proxy's AABB the way b2DynamicTree does. The AABB is extended
+/// by b2_aabbExtension and predicted along the displacement. Returns false, leaving
+/// fatAABB alone, if fatAABB still contains aabb and is not too large.
+B2_API bool b2FattenAABB(b2AABB* fatAABB, const b2AABB& aabb, const b2Vec2& displacement);
+
 // ---------------- Inline Functions ------------------------------------------
 
 inline bool b2AABB::IsValid() const
@@ -280,4 +285,16 @@ inline bool b2TestOverlap(const b2AABB& a, const b2AABB& b)
 	return true;
 }
 
+/// Test the segment's separating axis against an AABB, for broad-phase ray casts.
+/// v is perpendicular to the segment and abs_v is its absolute value.
+inline bool b2TestSegmentOverlap(const b2AABB& aabb, const b2Vec2& p1, const b2Vec2& v, const b2Vec2& abs_v)
+{
+	// Separating axis for segment (Gino, p80).
+	// |dot(v, p1 - c)| > dot(|v|, h)
+	b2Vec2 c = aabb.GetCenter();
+	b2Vec2 h = aabb.GetExtents();
+	float separation = b2Abs(b2Dot(v, p1 - c)) - b2Dot(abs_v, h);
+	return separation <= 0.0f;
+}
+
 #endif
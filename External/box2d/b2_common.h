@@ -82,6 +82,17 @@
 /// Maximum number of contacts to be handled to solve a TOI impact.
 #define b2_maxTOIContacts			32
 
+/// Constraints solved a color at a time are sorted into this many colors, where no two
+/// constraints in a color move the same body. Constraints that fit in none are solved
+/// one at a time after the colors.
+#define b2_graphColorCount			16
+
+/// Islands with at least this many contacts, or this many joints, solve them a color at
+/// a time, when the world has color solving or wide solving on. Each color is spread
+/// across the task executor's threads, if there is one. Otherwise constraints are
+/// solved in their original order.
+#define b2_minColoredConstraints	128
+
 /// The maximum linear position correction used when solving constraints. This helps to
 /// prevent overshoot. Meters.
 #define b2_maxLinearCorrection		(0.2f * b2_lengthUnitsPerMeter)
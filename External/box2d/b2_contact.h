@@ -210,6 +210,12 @@ protected:
 
 	void Update(b2ContactListener* listener);
 
+	// Update in two parts, so the narrow phase can run in parallel. UpdateManifold
+	// only writes this contact's manifold. FinishUpdate sets the flags, wakes the
+	// bodies and calls the listener, so it must be called serially.
+	bool UpdateManifold(b2Manifold* oldManifold);
+	void FinishUpdate(b2ContactListener* listener, const b2Manifold& oldManifold, bool touching);
+
 	static b2ContactRegister s_registers[b2Shape::e_typeCount][b2Shape::e_typeCount];
 	static bool s_initialized;
 
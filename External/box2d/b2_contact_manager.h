@@ -25,17 +25,68 @@
 
 #include "box2d/b2_api.h"
 #include "box2d/b2_broad_phase.h"
+#include "box2d/b2_collision.h"
 
 class b2Contact;
+class b2Fixture;
 class b2ContactFilter;
 class b2ContactListener;
 class b2BlockAllocator;
+class b2TaskExecutor;
+
+// A contact as Collide found it, before its manifold is updated.
+struct b2CollideEntry
+{
+	enum State
+	{
+		e_inactive,	// neither body is awake and movable, it's checked again when finishing
+		e_destroy,	// filtered out, or the proxies stopped overlapping
+		e_update
+	};
+
+	b2Contact* contact;
+	State state;
+	bool touching;
+	b2Manifold oldManifold;
+};
+
+// Open addressing hash set of contacts, keyed by their fixtures and child indices.
+// Lets AddPair tell whether a pair already has a contact without walking a body's
+// contact list, which is long for a ground body touching everything.
+class B2_API b2ContactSet
+{
+public:
+	b2ContactSet();
+	~b2ContactSet();
+
+	void Add(b2Contact* contact);
+	void Remove(b2Contact* contact);
+
+	// The contact between these fixture children, in either order, or nullptr.
+	b2Contact* Find(const b2Fixture* fixtureA, int32 indexA, const b2Fixture* fixtureB, int32 indexB) const;
+
+	int32 GetCount() const { return m_count; }
+
+private:
+	struct Slot
+	{
+		b2Contact* contact;
+		uint32 hash;
+	};
+
+	void Grow();
+
+	Slot* m_slots;
+	int32 m_capacity;	// a power of two, or 0
+	int32 m_count;
+};
 
 // Delegate of b2World.
 class B2_API b2ContactManager
 {
 public:
 	b2ContactManager();
+	~b2ContactManager();
 
 	// Broad-phase callback.
 	void AddPair(void* proxyUserDataA, void* proxyUserDataB);
@@ -46,12 +97,22 @@ public:
 
 	void Collide();
 
+	// Collide with the manifolds updated across the task executor's threads.
+	void CollideParallel();
+	void UpdateManifolds(int32 begin, int32 end);
+
 	b2BroadPhase m_broadPhase;
+	b2ContactSet m_contactSet;
 	b2Contact* m_contactList;
 	int32 m_contactCount;
 	b2ContactFilter* m_contactFilter;
 	b2ContactListener* m_contactListener;
 	b2BlockAllocator* m_allocator;
+
+	// Runs the narrow phase in parallel when set, see b2World::SetTaskExecutor.
+	b2TaskExecutor* m_taskExecutor;
+	b2CollideEntry* m_collideEntries;
+	int32 m_collideCapacity;
 };
 
 #endif
@@ -29,8 +29,10 @@
 
 class b2Contact;
 class b2Body;
+class b2Island;
 class b2StackAllocator;
-struct b2ContactPositionConstraint;
+struct b2WideVelocityConstraint;
+struct b2WidePositionConstraint;
 
 struct b2VelocityConstraintPoint
 {
@@ -61,6 +63,21 @@ struct b2ContactVelocityConstraint
 	int32 contactIndex;
 };
 
+struct b2ContactPositionConstraint
+{
+	b2Vec2 localPoints[b2_maxManifoldPoints];
+	b2Vec2 localNormal;
+	b2Vec2 localPoint;
+	int32 indexA;
+	int32 indexB;
+	float invMassA, invMassB;
+	b2Vec2 localCenterA, localCenterB;
+	float invIA, invIB;
+	b2Manifold::Type type;
+	float radiusA, radiusB;
+	int32 pointCount;
+};
+
 struct b2ContactSolverDef
 {
 	b2TimeStep step;
@@ -69,6 +86,7 @@ struct b2ContactSolverDef
 	b2Position* positions;
 	b2Velocity* velocities;
 	b2StackAllocator* allocator;
+	const b2Island* island;
 };
 
 class b2ContactSolver
@@ -86,14 +104,45 @@ public:
 	bool SolvePositionConstraints();
 	bool SolveTOIPositionConstraints(int32 toiIndexA, int32 toiIndexB);
 
+	// One constraint at a time.
+	void WarmStartContact(b2ContactVelocityConstraint* vc);
+	void SolveContactVelocity(b2ContactVelocityConstraint* vc);
+	float SolveContactPosition(b2ContactPositionConstraint* pc);
+
+	// Colors for big islands and the wide solver. The colors are solved one after the
+	// other, each spread across the island's task executor, then the overflow.
+	void ColorConstraints();
+	float SolveColors(bool position);
+
+	// The wide solver, see b2_contact_solver_wide.cpp. Used when the step asks for it.
+	void InitializeWideConstraints();
+	void WarmStartWide();
+	void SolveVelocityGroup(int32 group);
+	void StoreImpulsesWide();
+	float SolvePositionGroup(int32 group);
+
 	b2TimeStep m_step;
 	b2Position* m_positions;
 	b2Velocity* m_velocities;
 	b2StackAllocator* m_allocator;
+	const b2Island* m_island;
 	b2ContactPositionConstraint* m_positionConstraints;
 	b2ContactVelocityConstraint* m_velocityConstraints;
 	b2Contact** m_contacts;
 	int m_count;
+
+	// Constraint indices sorted by color, so no two in a color share a dynamic body.
+	// The overflow, constraints that fit in no color, follows the last color.
+	bool m_colored;
+	int32* m_colorConstraints;
+	int32 m_colorStarts[b2_graphColorCount + 1];
+
+	// The colored constraints packed into groups of SIMD lanes, color after color.
+	bool m_wide;
+	b2WideVelocityConstraint* m_wideVelocityConstraints;
+	b2WidePositionConstraint* m_widePositionConstraints;
+	int32 m_wideCount;
+	int32 m_wideColorStarts[b2_graphColorCount + 1];
 };
 
 #endif
@@ -26,9 +26,12 @@
 #include "box2d/b2_api.h"
 #include "box2d/b2_collision.h"
 #include "box2d/b2_growable_stack.h"
+#include "box2d/b2_ray_packet.h"
 
 #define b2_nullNode (-1)
 
+class b2TaskExecutor;
+
 /// A node in the dynamic tree. The client does not interact with this directly.
 struct B2_API b2TreeNode
 {
@@ -111,6 +114,14 @@ public:
 	template <typename T>
 	void RayCast(T* callback, const b2RayCastInput& input) const;
 
+	/// Ray-cast a packet of rays in one traversal. A node is visited while any lane
+	/// may cross it, and each lane reaches the same leaves, in the same order, as its
+	/// ray alone would through RayCast. The callback's RayCastCallback takes the lane
+	/// as a third argument and returns that lane's new max fraction, as in RayCast.
+	/// The packet's max fractions are shortened as the lanes hit.
+	template <typename T>
+	void RayCastPacket(T* callback, b2RayPacket* packet) const;
+
 	/// Validate this tree. For testing.
 	void Validate() const;
 
@@ -128,6 +139,13 @@ public:
 	/// Build an optimal tree. Very expensive. For testing.
 	void RebuildBottomUp();
 
+	/// Build the tree again, top down, splitting the proxies with a binned surface
+	/// area heuristic. Much better than the tree incremental insertion leaves after
+	/// many proxies are created at once, such as a level's static geometry, and fast
+	/// enough to run at load. Pass an executor to build subtrees across its threads.
+	/// The tree is the same either way. Proxy ids and moved flags are kept.
+	void RebuildTopDown(b2TaskExecutor* executor);
+
 	/// Shift the world origin. Useful for large worlds.
 	/// The shift formula is: position -= newOrigin
 	/// @param newOrigin the new origin with respect to the old origin
@@ -305,4 +323,58 @@ inline void b2DynamicTree::RayCast(T* callback, const b2RayCastInput& input) con
 	}
 }
 
+template <typename T>
+inline void b2DynamicTree::RayCastPacket(T* callback, b2RayPacket* packet) const
+{
+	uint32 active = (1u << packet->count) - 1;
+
+	b2GrowableStack<int32, 256> stack;
+	stack.Push(m_root);
+
+	while (stack.GetCount() > 0 && active != 0)
+	{
+		int32 nodeId = stack.Pop();
+		if (nodeId == b2_nullNode)
+		{
+			continue;
+		}
+
+		const b2TreeNode* node = m_nodes + nodeId;
+
+		uint32 lanes = packet->TestOverlap(node->aabb, active);
+		if (lanes == 0)
+		{
+			continue;
+		}
+
+		if (node->IsLeaf())
+		{
+			for (int32 lane = 0; lane < packet->count; ++lane)
+			{
+				if ((lanes & (1u << lane)) == 0)
+				{
+					continue;
+				}
+
+				float value = callback->RayCastCallback(packet->GetInput(lane), nodeId, lane);
+
+				if (value == 0.0f)
+				{
+					// The client has terminated this lane.
+					active &= ~(1u << lane);
+				}
+				else if (value > 0.0f)
+				{
+					packet->SetMaxFraction(lane, value);
+				}
+			}
+		}
+		else
+		{
+			stack.Push(node->child1);
+			stack.Push(node->child2);
+		}
+	}
+}
+
 #endif
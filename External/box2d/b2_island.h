@@ -27,12 +27,29 @@
 #include "box2d/b2_math.h"
 #include "box2d/b2_time_step.h"
 
+#include <algorithm>
+
 class b2Contact;
 class b2Joint;
 class b2StackAllocator;
 class b2ContactListener;
+class b2TaskExecutor;
 struct b2ContactVelocityConstraint;
+struct b2ContactImpulse;
 struct b2Profile;
+struct b2SolverData;
+
+/// A static body in an island, and its index there. This is an internal structure.
+struct b2IslandStatic
+{
+	const b2Body* body;
+	int32 index;
+
+	bool operator<(const b2IslandStatic& other) const
+	{
+		return body < other.body;
+	}
+};
 
 /// This is an internal class.
 class b2Island
@@ -73,8 +90,47 @@ public:
 		m_joints[m_jointCount++] = joint;
 	}
 
+	/// Islands solved at the same time can share static bodies, so a shared static
+	/// body's index is kept in the island instead of the body. Reserve room for them
+	/// before adding bodies, then sort once they're all added.
+	void ReserveStatics(int32 staticCapacity);
+	void AddStatic(b2Body* body)
+	{
+		b2Assert(m_staticCount < m_staticCapacity);
+		m_statics[m_staticCount].body = body;
+		m_statics[m_staticCount].index = m_bodyCount;
+		++m_staticCount;
+		m_bodies[m_bodyCount++] = body;
+	}
+	void SortStatics()
+	{
+		std::sort(m_statics, m_statics + m_staticCount);
+	}
+
+	/// The index of a body in this island's position and velocity arrays.
+	int32 GetIndex(const b2Body* body) const
+	{
+		if (m_staticCount > 0 && body->m_type == b2_staticBody)
+		{
+			b2IslandStatic key;
+			key.body = body;
+			const b2IslandStatic* it = std::lower_bound(m_statics, m_statics + m_staticCount, key);
+			if (it != m_statics + m_staticCount && it->body == body)
+			{
+				return it->index;
+			}
+		}
+
+		return body->m_islandIndex;
+	}
+
 	void Report(const b2ContactVelocityConstraint* constraints);
 
+	/// Big islands solve their joints a color at a time, see b2_minColoredConstraints.
+	void ColorJoints();
+	bool SolveJointColors(const b2SolverData& data, bool position);
+	bool SolveJointRange(const b2SolverData& data, bool position, int32 begin, int32 end);
+
 	b2StackAllocator* m_allocator;
 	b2ContactListener* m_listener;
 
@@ -85,6 +141,22 @@ public:
 	b2Position* m_positions;
 	b2Velocity* m_velocities;
 
+	b2IslandStatic* m_statics;
+	int32 m_staticCount;
+	int32 m_staticCapacity;
+
+	/// When set, Report stores the contact impulses here instead of calling the
+	/// listener, so the world can report them in order after a parallel solve.
+	b2ContactImpulse* m_impulses;
+
+	/// When set, the colors of big islands are spread across its threads.
+	b2TaskExecutor* m_taskExecutor;
+
+	/// Joint indices sorted by color, so no two in a color share a body. The overflow,
+	/// joints that fit in no color, follows the last color. Null unless colored.
+	int32* m_jointColors;
+	int32 m_jointColorStarts[b2_graphColorCount + 1];
+
 	int32 m_bodyCount;
 	int32 m_jointCount;
 	int32 m_contactCount;
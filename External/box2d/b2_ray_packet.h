@@ -0,0 +1,72 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef B2_RAY_PACKET_H
+#define B2_RAY_PACKET_H
+
+#include "box2d/b2_api.h"
+#include "box2d/b2_collision.h"
+
+/// The most rays in a b2RayPacket.
+#define b2_rayPacketSize 8
+
+/// Rays that are traversed together. Each ray is a lane, stored as arrays so that
+/// one node's AABB is tested against every lane at once. Lanes past the count
+/// never overlap anything.
+struct B2_API b2RayPacket
+{
+	/// Empty the packet.
+	void Clear();
+
+	/// Put a ray in the next lane. The packet must not be full.
+	/// @return the lane.
+	int32 Add(const b2RayCastInput& input);
+
+	/// Shorten a lane's ray, after it hit something at this fraction.
+	void SetMaxFraction(int32 lane, float maxFraction);
+
+	/// Get a lane's ray, shortened to its current max fraction.
+	b2RayCastInput GetInput(int32 lane) const;
+
+	/// Test the lanes against an AABB, with the same separating axis test as
+	/// b2DynamicTree::RayCast.
+	/// @param lanes bit i set to test lane i.
+	/// @return the tested lanes that may cross the AABB.
+	uint32 TestOverlap(const b2AABB& aabb, uint32 lanes) const;
+
+	float p1x[b2_rayPacketSize], p1y[b2_rayPacketSize];
+	float p2x[b2_rayPacketSize], p2y[b2_rayPacketSize];
+
+	// v is perpendicular to the ray.
+	float vx[b2_rayPacketSize], vy[b2_rayPacketSize];
+	float absVx[b2_rayPacketSize], absVy[b2_rayPacketSize];
+
+	// Bounding box of each ray up to its max fraction.
+	float lowerX[b2_rayPacketSize], lowerY[b2_rayPacketSize];
+	float upperX[b2_rayPacketSize], upperY[b2_rayPacketSize];
+
+	float maxFraction[b2_rayPacketSize];
+	int32 count;
+};
+
+#endif
@@ -61,6 +61,7 @@ struct B2_API b2RopeTuning
 		isometric = false;
 		fixedEffectiveMass = false;
 		warmStart = false;
+		tethers = false;
 	}
 
 	b2StretchingModel stretchingModel;
@@ -75,6 +76,10 @@ struct B2_API b2RopeTuning
 	bool isometric;
 	bool fixedEffectiveMass;
 	bool warmStart;
+
+	/// Keep each vertex within its length along the rope of the nearest vertex without
+	/// mass on either side. Long ropes stay their length in a few iterations.
+	bool tethers;
 };
 
 ///
@@ -119,6 +124,19 @@ public:
 	///
 	void Draw(b2Draw* draw) const;
 
+	/// Get the number of vertices.
+	int32 GetVertexCount() const;
+
+	/// Get the vertex positions, in world coordinates.
+	const b2Vec2* GetVertices() const;
+
+	/// Move where a vertex is bound, relative to the rope position. A vertex without
+	/// mass is moved there by the next step, so it can follow a body.
+	void SetBindPosition(int32 index, const b2Vec2& bindPosition);
+
+	/// Set the gravity applied to vertices with mass, so it can follow the world's.
+	void SetGravity(const b2Vec2& gravity);
+
 private:
 
 	void SolveStretch_PBD();
@@ -129,6 +147,7 @@ private:
 	void SolveBend_PBD_Height();
 	void SolveBend_PBD_Triangle();
 	void ApplyBendForces(float dt);
+	void SolveTethers();
 
 	b2Vec2 m_position;
 
@@ -145,9 +164,23 @@ private:
 	b2Vec2* m_vs;
 
 	float* m_invMasses;
+
+	// Rest length along the rope from the first vertex.
+	float* m_arcLengths;
+
 	b2Vec2 m_gravity;
 
 	b2RopeTuning m_tuning;
 };
 
+inline int32 b2Rope::GetVertexCount() const
+{
+	return m_count;
+}
+
+inline const b2Vec2* b2Rope::GetVertices() const
+{
+	return m_ps;
+}
+
 #endif
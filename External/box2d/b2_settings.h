@@ -60,10 +60,18 @@ struct B2_API b2BodyUserData
 	b2BodyUserData()
 	{
 		pointer = 0;
+		slot = -1;
+		visit = 0;
 	}
 
 	/// For legacy compatibility
 	uintptr_t pointer;
+
+	/// The body's slot in per body arrays the game keeps, -1 until it's given one
+	int32 slot;
+
+	/// The last walk over the world's islands that reached the body, see PhysicsLOD
+	uint32 visit;
 };
 
 /// You can define this to inject whatever data you want in b2Fixture
@@ -0,0 +1,174 @@
+// MIT License
+
+// Copyright (c) 2020 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef B2_SIMD_H
+#define B2_SIMD_H
+
+#include "box2d/b2_math.h"
+
+#include <string.h>
+
+/// Internal. Floats in SIMD lanes: AVX when the build has it, otherwise SSE2, and a
+/// loop over the lanes where there's neither. Shared by the solvers and queries
+/// that work several constraints, particles or rays at a time.
+
+#if defined(__AVX__)
+
+#include <immintrin.h>
+
+#define b2_simdLanes 8
+
+typedef __m256 b2FloatW;
+
+static inline b2FloatW b2LoadW(const float* p) { return _mm256_loadu_ps(p); }
+static inline void b2StoreW(float* p, b2FloatW a) { _mm256_storeu_ps(p, a); }
+static inline b2FloatW b2SplatW(float a) { return _mm256_set1_ps(a); }
+static inline b2FloatW b2AddW(b2FloatW a, b2FloatW b) { return _mm256_add_ps(a, b); }
+static inline b2FloatW b2SubW(b2FloatW a, b2FloatW b) { return _mm256_sub_ps(a, b); }
+static inline b2FloatW b2MulW(b2FloatW a, b2FloatW b) { return _mm256_mul_ps(a, b); }
+static inline b2FloatW b2DivW(b2FloatW a, b2FloatW b) { return _mm256_div_ps(a, b); }
+static inline b2FloatW b2NegW(b2FloatW a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+static inline b2FloatW b2AbsW(b2FloatW a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+static inline b2FloatW b2SqrtW(b2FloatW a) { return _mm256_sqrt_ps(a); }
+
+// b2Min and b2Max, including which argument is returned for equal values.
+static inline b2FloatW b2MinW(b2FloatW a, b2FloatW b) { return _mm256_min_ps(a, b); }
+static inline b2FloatW b2MaxW(b2FloatW a, b2FloatW b) { return _mm256_max_ps(a, b); }
+
+// Comparisons return a mask, all bits set in the lanes where they're true.
+static inline b2FloatW b2GreaterEqualW(b2FloatW a, b2FloatW b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+static inline b2FloatW b2GreaterW(b2FloatW a, b2FloatW b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline b2FloatW b2LessW(b2FloatW a, b2FloatW b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline b2FloatW b2AndW(b2FloatW a, b2FloatW b) { return _mm256_and_ps(a, b); }
+static inline b2FloatW b2OrW(b2FloatW a, b2FloatW b) { return _mm256_or_ps(a, b); }
+
+// b where the mask is set, a elsewhere.
+static inline b2FloatW b2BlendW(b2FloatW a, b2FloatW b, b2FloatW mask) { return _mm256_blendv_ps(a, b, mask); }
+
+// Bit i set where lane i of the mask is set.
+static inline uint32 b2MaskBitsW(b2FloatW mask) { return uint32(_mm256_movemask_ps(mask)); }
+
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+#include <emmintrin.h>
+
+#define b2_simdLanes 4
+
+typedef __m128 b2FloatW;
+
+static inline b2FloatW b2LoadW(const float* p) { return _mm_loadu_ps(p); }
+static inline void b2StoreW(float* p, b2FloatW a) { _mm_storeu_ps(p, a); }
+static inline b2FloatW b2SplatW(float a) { return _mm_set1_ps(a); }
+static inline b2FloatW b2AddW(b2FloatW a, b2FloatW b) { return _mm_add_ps(a, b); }
+static inline b2FloatW b2SubW(b2FloatW a, b2FloatW b) { return _mm_sub_ps(a, b); }
+static inline b2FloatW b2MulW(b2FloatW a, b2FloatW b) { return _mm_mul_ps(a, b); }
+static inline b2FloatW b2DivW(b2FloatW a, b2FloatW b) { return _mm_div_ps(a, b); }
+static inline b2FloatW b2NegW(b2FloatW a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+static inline b2FloatW b2AbsW(b2FloatW a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline b2FloatW b2SqrtW(b2FloatW a) { return _mm_sqrt_ps(a); }
+
+// b2Min and b2Max, including which argument is returned for equal values.
+static inline b2FloatW b2MinW(b2FloatW a, b2FloatW b) { return _mm_min_ps(a, b); }
+static inline b2FloatW b2MaxW(b2FloatW a, b2FloatW b) { return _mm_max_ps(a, b); }
+
+// Comparisons return a mask, all bits set in the lanes where they're true.
+static inline b2FloatW b2GreaterEqualW(b2FloatW a, b2FloatW b) { return _mm_cmpge_ps(a, b); }
+static inline b2FloatW b2GreaterW(b2FloatW a, b2FloatW b) { return _mm_cmpgt_ps(a, b); }
+static inline b2FloatW b2LessW(b2FloatW a, b2FloatW b) { return _mm_cmplt_ps(a, b); }
+static inline b2FloatW b2AndW(b2FloatW a, b2FloatW b) { return _mm_and_ps(a, b); }
+static inline b2FloatW b2OrW(b2FloatW a, b2FloatW b) { return _mm_or_ps(a, b); }
+
+// b where the mask is set, a elsewhere.
+static inline b2FloatW b2BlendW(b2FloatW a, b2FloatW b, b2FloatW mask)
+{
+	return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b));
+}
+
+// Bit i set where lane i of the mask is set.
+static inline uint32 b2MaskBitsW(b2FloatW mask) { return uint32(_mm_movemask_ps(mask)); }
+
+#else
+
+// No SIMD, the lanes are worked through in a loop. Masks are 1 where true and 0 elsewhere.
+#define b2_simdLanes 4
+
+struct b2FloatW
+{
+	float v[b2_simdLanes];
+};
+
+#define B2_WIDE_OP(expression) \
+	b2FloatW r; \
+	for (int32 i = 0; i < b2_simdLanes; ++i) { r.v[i] = (expression); } \
+	return r
+
+static inline b2FloatW b2LoadW(const float* p) { B2_WIDE_OP(p[i]); }
+static inline void b2StoreW(float* p, b2FloatW a) { memcpy(p, a.v, sizeof(a.v)); }
+static inline b2FloatW b2SplatW(float a) { B2_WIDE_OP(a); }
+static inline b2FloatW b2AddW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(a.v[i] + b.v[i]); }
+static inline b2FloatW b2SubW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(a.v[i] - b.v[i]); }
+static inline b2FloatW b2MulW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(a.v[i] * b.v[i]); }
+static inline b2FloatW b2DivW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(a.v[i] / b.v[i]); }
+static inline b2FloatW b2NegW(b2FloatW a) { B2_WIDE_OP(-a.v[i]); }
+static inline b2FloatW b2AbsW(b2FloatW a) { B2_WIDE_OP(b2Abs(a.v[i])); }
+static inline b2FloatW b2SqrtW(b2FloatW a) { B2_WIDE_OP(sqrtf(a.v[i])); }
+static inline b2FloatW b2MinW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(b2Min(a.v[i], b.v[i])); }
+static inline b2FloatW b2MaxW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(b2Max(a.v[i], b.v[i])); }
+static inline b2FloatW b2GreaterEqualW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(a.v[i] >= b.v[i] ? 1.0f : 0.0f); }
+static inline b2FloatW b2GreaterW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(a.v[i] > b.v[i] ? 1.0f : 0.0f); }
+static inline b2FloatW b2LessW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(a.v[i] < b.v[i] ? 1.0f : 0.0f); }
+static inline b2FloatW b2AndW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(a.v[i] * b.v[i]); }
+static inline b2FloatW b2OrW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(a.v[i] != 0.0f || b.v[i] != 0.0f ? 1.0f : 0.0f); }
+static inline b2FloatW b2BlendW(b2FloatW a, b2FloatW b, b2FloatW mask) { B2_WIDE_OP(mask.v[i] != 0.0f ? b.v[i] : a.v[i]); }
+
+#undef B2_WIDE_OP
+
+static inline uint32 b2MaskBitsW(b2FloatW mask)
+{
+	uint32 bits = 0;
+	for (int32 i = 0; i < b2_simdLanes; ++i)
+	{
+		bits |= mask.v[i] != 0.0f ? 1u << i : 0u;
+	}
+	return bits;
+}
+
+#endif
+
+static inline b2FloatW b2ZeroW()
+{
+	return b2SplatW(0.0f);
+}
+
+// b2Cross(a, b) for vectors.
+static inline b2FloatW b2CrossW(b2FloatW ax, b2FloatW ay, b2FloatW bx, b2FloatW by)
+{
+	return b2SubW(b2MulW(ax, by), b2MulW(ay, bx));
+}
+
+// b2Dot(a, b).
+static inline b2FloatW b2DotW(b2FloatW ax, b2FloatW ay, b2FloatW bx, b2FloatW by)
+{
+	return b2AddW(b2MulW(ax, bx), b2MulW(ay, by));
+}
+
+#endif
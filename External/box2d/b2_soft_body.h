@@ -0,0 +1,354 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef B2_SOFT_BODY_H
+#define B2_SOFT_BODY_H
+
+#include "box2d/b2_api.h"
+#include "box2d/b2_collision.h"
+#include "box2d/b2_fixture.h"
+#include "box2d/b2_math.h"
+
+class b2BlockAllocator;
+class b2Body;
+class b2BroadPhase;
+class b2Shape;
+class b2SoftBodySystem;
+struct b2TimeStep;
+
+/// A soft body definition. A soft body is a set of particles joined by links. The
+/// particles are circles that collide with the world's fixtures and with the particles
+/// of other soft bodies. Links keep the distance between two particles, as stiff as
+/// their compliance allows. The arrays are copied, no reference to the definition is
+/// retained.
+struct B2_API b2SoftBodyDef
+{
+	b2SoftBodyDef()
+	{
+		position.SetZero();
+		positions = nullptr;
+		count = 0;
+		masses = nullptr;
+		mass = 1.0f;
+		radii = nullptr;
+		radius = 0.5f;
+		links = nullptr;
+		linkCount = 0;
+		compliances = nullptr;
+		compliance = 0.0f;
+		outline = nullptr;
+		outlineCount = 0;
+		linearVelocity.SetZero();
+		linearDamping = 0.0f;
+		friction = 0.4f;
+	}
+
+	/// The world position the particle positions are relative to. One set of positions
+	/// can make many soft bodies, each at its own position.
+	b2Vec2 position;
+
+	/// The positions of the particles, relative to position.
+	const b2Vec2* positions;
+
+	/// The number of particles.
+	int32 count;
+
+	/// The mass of each particle, or nullptr for every particle to have mass.
+	/// A particle with zero mass is pinned in place.
+	const float* masses;
+	float mass;
+
+	/// The radius of each particle, or nullptr for every particle to have radius.
+	const float* radii;
+	float radius;
+
+	/// Pairs of particle indices, two per link. A link's rest length is the distance
+	/// between its particles in the definition.
+	const int32* links;
+
+	/// The number of links.
+	int32 linkCount;
+
+	/// The compliance of each link, or nullptr for every link to have compliance.
+	/// Compliance is the inverse of stiffness, in meters per newton. Zero is rigid.
+	const float* compliances;
+	float compliance;
+
+	/// Particle indices around the outside of the soft body, counter-clockwise.
+	const int32* outline;
+
+	/// The number of outline particles.
+	int32 outlineCount;
+
+	/// The initial velocity of every particle.
+	b2Vec2 linearVelocity;
+
+	/// Slows every particle, like b2BodyDef::linearDamping. Settles piles of soft
+	/// bodies that would otherwise keep rocking on each other.
+	float linearDamping;
+
+	/// The friction against fixtures, mixed with the fixture's friction.
+	float friction;
+
+	/// Contact filtering data, against fixtures and other soft bodies.
+	b2Filter filter;
+
+	/// Use this to store application specific soft body data.
+	b2BodyUserData userData;
+};
+
+/// A soft body, made with b2World::CreateSoftBody. Its particles and links are kept
+/// with those of every other soft body, in arrays owned by the world.
+class B2_API b2SoftBody
+{
+public:
+	/// Get the number of particles.
+	int32 GetParticleCount() const;
+
+	/// Get the world position of a particle.
+	b2Vec2 GetParticlePosition(int32 index) const;
+
+	/// Get the velocity of a particle.
+	b2Vec2 GetParticleVelocity(int32 index) const;
+
+	/// Get the total mass of the particles.
+	float GetMass() const;
+
+	/// Get the center of mass, in world coordinates.
+	b2Vec2 GetPosition() const;
+
+	/// Get the velocity of the center of mass.
+	b2Vec2 GetLinearVelocity() const;
+
+	/// Change the velocity of every particle by the same amount, so the center of mass
+	/// moves at this velocity. The particles keep moving relative to each other.
+	void SetLinearVelocity(const b2Vec2& v);
+
+	/// Apply an impulse spread over the particles by mass, so each one's velocity
+	/// changes by the same amount.
+	void ApplyLinearImpulse(const b2Vec2& impulse);
+
+	/// Get the bounds of the particles, radii included, after the last step.
+	const b2AABB& GetAABB() const;
+
+	/// Get the number of particles resting on something, in the last step. A particle
+	/// rests on a fixture or particle when the contact normal is within about 45 degrees
+	/// of straight up, against gravity.
+	int32 GetGroundContactCount() const;
+
+	/// Get the normal of the last ground contact, pointing toward the soft body.
+	b2Vec2 GetGroundNormal() const;
+
+	/// Get the outline, pushed out from the outline particles by their radii so it wraps
+	/// them.
+	/// @param vertices receives the outline, counter-clockwise.
+	/// @param maxCount the size of vertices. Longer outlines are cut short.
+	/// @param alpha blends the particles from where they were before the last step (0)
+	/// to where they are now (1).
+	/// @return the number of vertices written.
+	int32 GetOutline(b2Vec2* vertices, int32 maxCount, float alpha) const;
+
+	/// Get the user data set in the definition.
+	b2BodyUserData& GetUserData();
+
+	/// Get the next soft body in the world's list.
+	b2SoftBody* GetNext();
+	const b2SoftBody* GetNext() const;
+
+private:
+
+	friend class b2SoftBodySystem;
+	friend struct b2SoftQueryWrapper;
+
+	b2SoftBodySystem* m_system;
+
+	b2SoftBody* m_prev;
+	b2SoftBody* m_next;
+
+	// Ranges in the system's arrays.
+	int32 m_particleStart, m_particleCount;
+	int32 m_linkStart, m_linkCount;
+	int32 m_outlineStart, m_outlineCount;
+	int32 m_candidateStart, m_candidateCount;
+
+	float m_mass;
+	float m_friction;
+	b2Filter m_filter;
+
+	b2AABB m_aabb;
+	int32 m_groundCount;
+	b2Vec2 m_groundNormal;
+
+	b2BodyUserData m_userData;
+};
+
+/// A link between two particles. This is an internal structure.
+struct B2_API b2SoftLink
+{
+	int32 indexA, indexB;
+	float length;
+	float compliance;
+};
+
+/// A fixture child that may touch a soft body during a step. This is an internal structure.
+struct B2_API b2SoftCandidate
+{
+	b2Fixture* fixture;
+	int32 childIndex;
+	b2AABB aabb;
+};
+
+/// Two particles of different soft bodies that may touch during a step. This is an
+/// internal structure.
+struct B2_API b2SoftPair
+{
+	int32 indexA, indexB;
+};
+
+/// A particle sorted into the grid cell it is in. This is an internal structure.
+struct B2_API b2SoftCell
+{
+	uint64 key;
+	int32 index;
+};
+
+/// Stores and solves every soft body of a world. Particles are kept as arrays of floats,
+/// so they are integrated several at a time in SIMD lanes. Each step is split into
+/// substeps, and each substep solves the links, the particle contacts, and the fixture
+/// contacts once, with extended position based dynamics (XPBD). Fixtures are found with
+/// one broad-phase query per soft body per step. This is an internal class.
+class B2_API b2SoftBodySystem
+{
+public:
+	b2SoftBodySystem();
+	~b2SoftBodySystem();
+
+	b2SoftBody* Create(const b2SoftBodyDef* def, b2BlockAllocator* allocator);
+	void Destroy(b2SoftBody* body, b2BlockAllocator* allocator);
+
+	void Step(const b2TimeStep& step, const b2Vec2& gravity, const b2BroadPhase* broadPhase);
+
+	void ShiftOrigin(const b2Vec2& newOrigin);
+
+	void Reserve(int32 moreParticles, int32 moreLinks, int32 moreOutlines);
+
+	b2SoftBody* m_bodyList;
+	int32 m_bodyCount;
+
+	int32 m_subStepCount;
+
+private:
+
+	friend class b2SoftBody;
+	friend struct b2SoftQueryWrapper;
+
+	void FindCandidates(b2SoftBody* body, float dt, const b2Vec2& gravity, const b2BroadPhase* broadPhase);
+	void FindPairs(float dt);
+	void TestPair(int32 indexA, int32 indexB, float margin);
+	void Integrate(float h, const b2Vec2& gravity);
+	void SolveLinks(float h);
+	void SolvePairs(const b2Vec2& up, bool last);
+	void SolveCandidates(b2SoftBody* body, float h, const b2Vec2& up, bool last);
+	void UpdateVelocities(float h);
+	void UpdateBounds(b2SoftBody* body);
+	void PushCandidate(b2Fixture* fixture, int32 childIndex, const b2AABB& aabb);
+
+	// Particles. x0 and y0 are where they were at the start of the step, px and py at
+	// the start of the substep.
+	float* m_x;
+	float* m_y;
+	float* m_x0;
+	float* m_y0;
+	float* m_px;
+	float* m_py;
+	float* m_vx;
+	float* m_vy;
+	float* m_invMass;
+	float* m_gravityScale;
+	float* m_damping;
+	float* m_radius;
+	b2SoftBody** m_owners;
+	int32 m_particleCount;
+	int32 m_particleCapacity;
+
+	b2SoftLink* m_links;
+	int32 m_linkCount;
+	int32 m_linkCapacity;
+
+	int32* m_outlines;
+	int32 m_outlineCount;
+	int32 m_outlineCapacity;
+
+	// Found each step.
+	b2SoftCandidate* m_candidates;
+	int32 m_candidateCount;
+	int32 m_candidateCapacity;
+
+	b2SoftPair* m_pairs;
+	int32 m_pairCount;
+	int32 m_pairCapacity;
+
+	b2SoftCell* m_cells;
+	int32 m_cellCapacity;
+};
+
+inline int32 b2SoftBody::GetParticleCount() const
+{
+	return m_particleCount;
+}
+
+inline float b2SoftBody::GetMass() const
+{
+	return m_mass;
+}
+
+inline const b2AABB& b2SoftBody::GetAABB() const
+{
+	return m_aabb;
+}
+
+inline int32 b2SoftBody::GetGroundContactCount() const
+{
+	return m_groundCount;
+}
+
+inline b2Vec2 b2SoftBody::GetGroundNormal() const
+{
+	return m_groundNormal;
+}
+
+inline b2BodyUserData& b2SoftBody::GetUserData()
+{
+	return m_userData;
+}
+
+inline b2SoftBody* b2SoftBody::GetNext()
+{
+	return m_next;
+}
+
+inline const b2SoftBody* b2SoftBody::GetNext() const
+{
+	return m_next;
+}
+
+#endif
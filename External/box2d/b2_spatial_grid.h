@@ -0,0 +1,465 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef B2_SPATIAL_GRID_H
+#define B2_SPATIAL_GRID_H
+
+#include "box2d/b2_api.h"
+#include "box2d/b2_collision.h"
+
+/// A proxy in a b2SpatialGrid. The client does not interact with this directly.
+struct B2_API b2GridProxy
+{
+	/// Enlarged AABB
+	b2AABB aabb;
+
+	void* userData;
+
+	// Next free proxy, or the proxy's index in the large list.
+	int32 next;
+
+	// The cells the proxy is in, inclusive.
+	int32 lowerX, lowerY;
+	int32 upperX, upperY;
+
+	// e_free, e_celled or e_large
+	int32 state;
+
+	bool moved;
+};
+
+/// A cell of a b2SpatialGrid, holding the proxies that overlap it.
+struct B2_API b2GridCell
+{
+	int32 x, y;
+	int32* proxies;
+	int32 count;
+	int32 capacity;
+};
+
+/// A uniform grid broad-phase. Each proxy is listed in every cell its fat AABB
+/// overlaps, and only the cells that have held a proxy are kept, in a hash table.
+/// A query visits the cells it overlaps, and reports a proxy from only the first
+/// of them the proxy is in. Proxies that would cover more than a few cells are kept
+/// in a list that is always scanned. This suits scenes of many proxies a little
+/// smaller than a cell. It has the same interface and fat AABBs as b2DynamicTree.
+class B2_API b2SpatialGrid
+{
+public:
+
+	b2SpatialGrid();
+	~b2SpatialGrid();
+
+	/// Set the cell size. The grid must be empty.
+	void SetCellSize(float size);
+
+	/// Create a proxy. Provide a tight fitting AABB and a userData pointer.
+	int32 CreateProxy(const b2AABB& aabb, void* userData);
+
+	/// Destroy a proxy. This asserts if the id is invalid.
+	void DestroyProxy(int32 proxyId);
+
+	/// Move a proxy with a swepted AABB. If the proxy has moved outside of its fattened AABB,
+	/// then the proxy is moved between cells and the function returns true.
+	/// @return true if the proxy was re-inserted.
+	bool MoveProxy(int32 proxyId, const b2AABB& aabb1, const b2Vec2& displacement);
+
+	/// Get proxy user data.
+	/// @return the proxy user data or 0 if the id is invalid.
+	void* GetUserData(int32 proxyId) const;
+
+	bool WasMoved(int32 proxyId) const;
+	void ClearMoved(int32 proxyId);
+
+	/// Get the fat AABB for a proxy.
+	const b2AABB& GetFatAABB(int32 proxyId) const;
+
+	/// Query an AABB for overlapping proxies. The callback class
+	/// is called for each proxy that overlaps the supplied AABB.
+	template <typename T>
+	void Query(T* callback, const b2AABB& aabb) const;
+
+	/// Ray-cast against the proxies. This relies on the callback to perform
+	/// an exact ray-cast in the case were the proxy contains a shape.
+	/// The cells are walked in order along the ray.
+	/// @param input the ray-cast input data. The ray extends from p1 to p1 + maxFraction * (p2 - p1).
+	/// @param callback a callback class that is called for each proxy that is hit by the ray.
+	template <typename T>
+	void RayCast(T* callback, const b2RayCastInput& input) const;
+
+	/// Shift the world origin. Useful for large worlds.
+	/// The shift formula is: position -= newOrigin
+	/// @param newOrigin the new origin with respect to the old origin
+	void ShiftOrigin(const b2Vec2& newOrigin);
+
+private:
+
+	enum
+	{
+		e_nullProxy = -1
+	};
+
+	enum
+	{
+		e_free,
+		e_celled,
+		e_large
+	};
+
+	int32 AllocateProxy();
+	void FreeProxy(int32 proxyId);
+
+	void Insert(int32 proxyId);
+	void Remove(int32 proxyId);
+
+	int32 ToCell(float x) const;
+	int32 FindCell(int32 x, int32 y) const;
+	int32 GetCell(int32 x, int32 y);
+	void GrowTable();
+	void ClearCells();
+
+	template <typename T>
+	bool QueryCell(T* callback, const b2GridCell& cell, const b2AABB& aabb,
+		int32 lowerX, int32 lowerY) const;
+
+	b2GridProxy* m_proxies;
+	int32 m_proxyCount;
+	int32 m_proxyCapacity;
+	int32 m_freeList;
+
+	float m_cellSize;
+	float m_inverseCellSize;
+
+	b2GridCell* m_cells;
+	int32 m_cellCount;
+	int32 m_cellCapacity;
+
+	// Open addressed cell indices, e_nullProxy where empty. The capacity is a
+	// power of two at least twice the cell count.
+	int32* m_table;
+	int32 m_tableCapacity;
+
+	int32* m_large;
+	int32 m_largeCount;
+	int32 m_largeCapacity;
+};
+
+inline void* b2SpatialGrid::GetUserData(int32 proxyId) const
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	return m_proxies[proxyId].userData;
+}
+
+inline bool b2SpatialGrid::WasMoved(int32 proxyId) const
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	return m_proxies[proxyId].moved;
+}
+
+inline void b2SpatialGrid::ClearMoved(int32 proxyId)
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	m_proxies[proxyId].moved = false;
+}
+
+inline const b2AABB& b2SpatialGrid::GetFatAABB(int32 proxyId) const
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	return m_proxies[proxyId].aabb;
+}
+
+inline int32 b2SpatialGrid::ToCell(float x) const
+{
+	// Clamped so far away proxies can't overflow the conversion.
+	return int32(b2Clamp(floorf(x * m_inverseCellSize), -1.0e9f, 1.0e9f));
+}
+
+inline int32 b2SpatialGrid::FindCell(int32 x, int32 y) const
+{
+	if (m_cellCount == 0)
+	{
+		return e_nullProxy;
+	}
+
+	uint32 mask = uint32(m_tableCapacity - 1);
+	uint32 hash = (uint32(x) * 73856093u) ^ (uint32(y) * 19349663u);
+	for (uint32 i = hash & mask; ; i = (i + 1) & mask)
+	{
+		int32 index = m_table[i];
+		if (index == e_nullProxy || (m_cells[index].x == x && m_cells[index].y == y))
+		{
+			return index;
+		}
+	}
+}
+
+// Reports the proxies in a cell that overlap aabb, skipping those that are also
+// in an earlier cell of the query, whose lower cell is lowerX, lowerY. Returns
+// false if the callback ended the query.
+template <typename T>
+inline bool b2SpatialGrid::QueryCell(T* callback, const b2GridCell& cell, const b2AABB& aabb,
+	int32 lowerX, int32 lowerY) const
+{
+	for (int32 i = 0; i < cell.count; ++i)
+	{
+		const int32 proxyId = cell.proxies[i];
+		const b2GridProxy* proxy = m_proxies + proxyId;
+		if (b2Max(proxy->lowerX, lowerX) != cell.x || b2Max(proxy->lowerY, lowerY) != cell.y)
+		{
+			continue;
+		}
+
+		if (b2TestOverlap(proxy->aabb, aabb) && callback->QueryCallback(proxyId) == false)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template <typename T>
+inline void b2SpatialGrid::Query(T* callback, const b2AABB& aabb) const
+{
+	for (int32 i = 0; i < m_largeCount; ++i)
+	{
+		const int32 proxyId = m_large[i];
+		if (b2TestOverlap(m_proxies[proxyId].aabb, aabb) && callback->QueryCallback(proxyId) == false)
+		{
+			return;
+		}
+	}
+
+	if (m_cellCount == 0)
+	{
+		return;
+	}
+
+	const int32 lowerX = ToCell(aabb.lowerBound.x);
+	const int32 lowerY = ToCell(aabb.lowerBound.y);
+	const int32 upperX = ToCell(aabb.upperBound.x);
+	const int32 upperY = ToCell(aabb.upperBound.y);
+
+	// A query bigger than the grid walks the cells that exist instead.
+	const double area = double(upperX - lowerX + 1) * double(upperY - lowerY + 1);
+	if (area > m_cellCount)
+	{
+		for (int32 i = 0; i < m_cellCount; ++i)
+		{
+			const b2GridCell& cell = m_cells[i];
+			if (cell.x < lowerX || upperX < cell.x || cell.y < lowerY || upperY < cell.y)
+			{
+				continue;
+			}
+
+			if (QueryCell(callback, cell, aabb, lowerX, lowerY) == false)
+			{
+				return;
+			}
+		}
+		return;
+	}
+
+	for (int32 y = lowerY; y <= upperY; ++y)
+	{
+		for (int32 x = lowerX; x <= upperX; ++x)
+		{
+			const int32 index = FindCell(x, y);
+			if (index != e_nullProxy && QueryCell(callback, m_cells[index], aabb, lowerX, lowerY) == false)
+			{
+				return;
+			}
+		}
+	}
+}
+
+template <typename T>
+inline void b2SpatialGrid::RayCast(T* callback, const b2RayCastInput& input) const
+{
+	b2Vec2 p1 = input.p1;
+	b2Vec2 p2 = input.p2;
+	b2Vec2 r = p2 - p1;
+	b2Assert(r.LengthSquared() > 0.0f);
+	r.Normalize();
+
+	// v is perpendicular to the segment.
+	b2Vec2 v = b2Cross(1.0f, r);
+	b2Vec2 abs_v = b2Abs(v);
+
+	float maxFraction = input.maxFraction;
+
+	// Build a bounding box for the segment.
+	b2AABB segmentAABB;
+	{
+		b2Vec2 t = p1 + maxFraction * (p2 - p1);
+		segmentAABB.lowerBound = b2Min(p1, t);
+		segmentAABB.upperBound = b2Max(p1, t);
+	}
+
+	// Large proxies first, their hits shorten the walk through the cells.
+	for (int32 i = 0; i < m_largeCount; ++i)
+	{
+		const int32 proxyId = m_large[i];
+		const b2AABB& aabb = m_proxies[proxyId].aabb;
+		if (b2TestOverlap(aabb, segmentAABB) == false || b2TestSegmentOverlap(aabb, p1, v, abs_v) == false)
+		{
+			continue;
+		}
+
+		b2RayCastInput subInput;
+		subInput.p1 = input.p1;
+		subInput.p2 = input.p2;
+		subInput.maxFraction = maxFraction;
+
+		float value = callback->RayCastCallback(subInput, proxyId);
+
+		if (value == 0.0f)
+		{
+			// The client has terminated the ray cast.
+			return;
+		}
+
+		if (value > 0.0f)
+		{
+			// Update segment bounding box.
+			maxFraction = value;
+			b2Vec2 t = p1 + maxFraction * (p2 - p1);
+			segmentAABB.lowerBound = b2Min(p1, t);
+			segmentAABB.upperBound = b2Max(p1, t);
+		}
+	}
+
+	if (m_cellCount == 0)
+	{
+		return;
+	}
+
+	// Walk the cells the segment passes through (Amanatides and Woo). tMax is the
+	// fraction where the segment leaves the cell on each axis, tDelta the fraction
+	// it takes to cross a cell.
+	b2Vec2 d = p2 - p1;
+	int32 x = ToCell(p1.x);
+	int32 y = ToCell(p1.y);
+	int32 stepX = 0, stepY = 0;
+	float tMaxX = b2_maxFloat, tMaxY = b2_maxFloat;
+	float tDeltaX = b2_maxFloat, tDeltaY = b2_maxFloat;
+
+	if (d.x > 0.0f)
+	{
+		stepX = 1;
+		tMaxX = ((x + 1) * m_cellSize - p1.x) / d.x;
+		tDeltaX = m_cellSize / d.x;
+	}
+	else if (d.x < 0.0f)
+	{
+		stepX = -1;
+		tMaxX = (x * m_cellSize - p1.x) / d.x;
+		tDeltaX = -m_cellSize / d.x;
+	}
+
+	if (d.y > 0.0f)
+	{
+		stepY = 1;
+		tMaxY = ((y + 1) * m_cellSize - p1.y) / d.y;
+		tDeltaY = m_cellSize / d.y;
+	}
+	else if (d.y < 0.0f)
+	{
+		stepY = -1;
+		tMaxY = (y * m_cellSize - p1.y) / d.y;
+		tDeltaY = -m_cellSize / d.y;
+	}
+
+	// The cell walked before this one. A proxy that was in it has been tested.
+	bool first = true;
+	int32 lastX = x;
+	int32 lastY = y;
+
+	for (;;)
+	{
+		const int32 index = FindCell(x, y);
+		if (index != e_nullProxy)
+		{
+			const b2GridCell& cell = m_cells[index];
+			for (int32 i = 0; i < cell.count; ++i)
+			{
+				const int32 proxyId = cell.proxies[i];
+				const b2GridProxy* proxy = m_proxies + proxyId;
+				if (first == false && proxy->lowerX <= lastX && lastX <= proxy->upperX && proxy->lowerY <= lastY && lastY <= proxy->upperY)
+				{
+					continue;
+				}
+
+				if (b2TestOverlap(proxy->aabb, segmentAABB) == false || b2TestSegmentOverlap(proxy->aabb, p1, v, abs_v) == false)
+				{
+					continue;
+				}
+
+				b2RayCastInput subInput;
+				subInput.p1 = input.p1;
+				subInput.p2 = input.p2;
+				subInput.maxFraction = maxFraction;
+
+				float value = callback->RayCastCallback(subInput, proxyId);
+
+				if (value == 0.0f)
+				{
+					// The client has terminated the ray cast.
+					return;
+				}
+
+				if (value > 0.0f)
+				{
+					// Update segment bounding box.
+					maxFraction = value;
+					b2Vec2 t = p1 + maxFraction * (p2 - p1);
+					segmentAABB.lowerBound = b2Min(p1, t);
+					segmentAABB.upperBound = b2Max(p1, t);
+				}
+			}
+		}
+
+		first = false;
+		lastX = x;
+		lastY = y;
+		if (tMaxX < tMaxY)
+		{
+			if (tMaxX > maxFraction)
+			{
+				break;
+			}
+			x += stepX;
+			tMaxX += tDeltaX;
+		}
+		else
+		{
+			if (tMaxY > maxFraction)
+			{
+				break;
+			}
+			y += stepY;
+			tMaxY += tDeltaY;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,309 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef B2_SWEEP_AND_PRUNE_H
+#define B2_SWEEP_AND_PRUNE_H
+
+#include "box2d/b2_api.h"
+#include "box2d/b2_collision.h"
+
+/// A proxy in a b2SweepAndPrune. The client does not interact with this directly.
+struct B2_API b2SweepProxy
+{
+	/// Enlarged AABB
+	b2AABB aabb;
+
+	void* userData;
+
+	// Next free proxy, or the proxy's index in the pending or large list.
+	int32 next;
+
+	// The proxy's entry on each sorted axis.
+	int32 entries[2];
+
+	// e_free, e_sorted, e_pending or e_large
+	int32 state;
+
+	bool moved;
+};
+
+/// A proxy on a sorted axis. The AABB is copied in so scans stay in the axis.
+struct B2_API b2SweepEntry
+{
+	b2AABB aabb;
+	int32 proxyId;
+};
+
+/// A multi-axis sweep-and-prune broad-phase. Proxies are kept sorted by their lower
+/// bound on both axes. A query scans the axis where the fewest proxies could overlap,
+/// from its lower bound less the largest extent on that axis to its upper bound.
+/// Proxies that move are set aside and scanned one by one until Commit sorts them
+/// back in. Proxies larger than the large size are always scanned one by one, so
+/// they don't widen every query. This suits scenes of many proxies of a similar size.
+/// It has the same interface and fat AABBs as b2DynamicTree.
+class B2_API b2SweepAndPrune
+{
+public:
+
+	b2SweepAndPrune();
+	~b2SweepAndPrune();
+
+	/// Set the extent past which a proxy is kept out of the sorted axes.
+	/// Only takes effect for proxies created or moved afterwards.
+	void SetLargeSize(float size);
+
+	/// Create a proxy. Provide a tight fitting AABB and a userData pointer.
+	int32 CreateProxy(const b2AABB& aabb, void* userData);
+
+	/// Destroy a proxy. This asserts if the id is invalid.
+	void DestroyProxy(int32 proxyId);
+
+	/// Move a proxy with a swepted AABB. If the proxy has moved outside of its fattened AABB,
+	/// then the proxy is set aside for sorting and the function returns true.
+	/// @return true if the proxy was re-inserted.
+	bool MoveProxy(int32 proxyId, const b2AABB& aabb1, const b2Vec2& displacement);
+
+	/// Get proxy user data.
+	/// @return the proxy user data or 0 if the id is invalid.
+	void* GetUserData(int32 proxyId) const;
+
+	bool WasMoved(int32 proxyId) const;
+	void ClearMoved(int32 proxyId);
+
+	/// Get the fat AABB for a proxy.
+	const b2AABB& GetFatAABB(int32 proxyId) const;
+
+	/// Sort the proxies moved since the last call into the axes. Queries are right
+	/// either way, but are faster after a commit.
+	void Commit();
+
+	/// Query an AABB for overlapping proxies. The callback class
+	/// is called for each proxy that overlaps the supplied AABB.
+	template <typename T>
+	void Query(T* callback, const b2AABB& aabb) const;
+
+	/// Ray-cast against the proxies. This relies on the callback to perform
+	/// an exact ray-cast in the case were the proxy contains a shape.
+	/// @param input the ray-cast input data. The ray extends from p1 to p1 + maxFraction * (p2 - p1).
+	/// @param callback a callback class that is called for each proxy that is hit by the ray.
+	template <typename T>
+	void RayCast(T* callback, const b2RayCastInput& input) const;
+
+	/// Shift the world origin. Useful for large worlds.
+	/// The shift formula is: position -= newOrigin
+	/// @param newOrigin the new origin with respect to the old origin
+	void ShiftOrigin(const b2Vec2& newOrigin);
+
+private:
+
+	enum
+	{
+		e_nullProxy = -1
+	};
+
+	enum
+	{
+		e_free,
+		e_sorted,
+		e_pending,
+		e_large
+	};
+
+	int32 AllocateProxy();
+	void FreeProxy(int32 proxyId);
+
+	void Insert(int32 proxyId);
+	void Remove(int32 proxyId);
+
+	void PushList(int32** list, int32* count, int32* capacity, int32 proxyId);
+
+	void FindRange(int32 axis, float lower, float upper, int32* begin, int32* end) const;
+	int32 ChooseAxis(const b2AABB& aabb, int32* begin, int32* end) const;
+
+	b2SweepProxy* m_proxies;
+	int32 m_proxyCount;
+	int32 m_proxyCapacity;
+	int32 m_freeList;
+
+	// Sorted entries of both axes. Removed entries are left in place with a null
+	// proxy and an AABB that overlaps nothing, until the next commit.
+	b2SweepEntry* m_axes[2];
+	b2SweepEntry* m_scratch;
+	int32 m_entryCount;
+	int32 m_entryCapacity;
+	int32 m_staleCount;
+
+	// Largest extent of a sorted proxy on each axis.
+	float m_maxExtent[2];
+
+	int32* m_pending;
+	int32 m_pendingCount;
+	int32 m_pendingCapacity;
+
+	int32* m_large;
+	int32 m_largeCount;
+	int32 m_largeCapacity;
+
+	float m_largeSize;
+};
+
+inline void* b2SweepAndPrune::GetUserData(int32 proxyId) const
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	return m_proxies[proxyId].userData;
+}
+
+inline bool b2SweepAndPrune::WasMoved(int32 proxyId) const
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	return m_proxies[proxyId].moved;
+}
+
+inline void b2SweepAndPrune::ClearMoved(int32 proxyId)
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	m_proxies[proxyId].moved = false;
+}
+
+inline const b2AABB& b2SweepAndPrune::GetFatAABB(int32 proxyId) const
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	return m_proxies[proxyId].aabb;
+}
+
+template <typename T>
+inline void b2SweepAndPrune::Query(T* callback, const b2AABB& aabb) const
+{
+	int32 begin, end;
+	const int32 axis = ChooseAxis(aabb, &begin, &end);
+	if (axis >= 0)
+	{
+		const b2SweepEntry* entries = m_axes[axis];
+		for (int32 i = begin; i < end; ++i)
+		{
+			const b2SweepEntry& entry = entries[i];
+			if (b2TestOverlap(entry.aabb, aabb) && callback->QueryCallback(entry.proxyId) == false)
+			{
+				return;
+			}
+		}
+	}
+
+	for (int32 i = 0; i < m_pendingCount; ++i)
+	{
+		const int32 proxyId = m_pending[i];
+		if (b2TestOverlap(m_proxies[proxyId].aabb, aabb) && callback->QueryCallback(proxyId) == false)
+		{
+			return;
+		}
+	}
+
+	for (int32 i = 0; i < m_largeCount; ++i)
+	{
+		const int32 proxyId = m_large[i];
+		if (b2TestOverlap(m_proxies[proxyId].aabb, aabb) && callback->QueryCallback(proxyId) == false)
+		{
+			return;
+		}
+	}
+}
+
+template <typename T>
+inline void b2SweepAndPrune::RayCast(T* callback, const b2RayCastInput& input) const
+{
+	b2Vec2 p1 = input.p1;
+	b2Vec2 p2 = input.p2;
+	b2Vec2 r = p2 - p1;
+	b2Assert(r.LengthSquared() > 0.0f);
+	r.Normalize();
+
+	// v is perpendicular to the segment.
+	b2Vec2 v = b2Cross(1.0f, r);
+	b2Vec2 abs_v = b2Abs(v);
+
+	float maxFraction = input.maxFraction;
+
+	// Build a bounding box for the segment.
+	b2AABB segmentAABB;
+	{
+		b2Vec2 t = p1 + maxFraction * (p2 - p1);
+		segmentAABB.lowerBound = b2Min(p1, t);
+		segmentAABB.upperBound = b2Max(p1, t);
+	}
+
+	// The range is taken from the whole segment. Hits only shorten it.
+	int32 begin = 0, end = 0;
+	const int32 axis = ChooseAxis(segmentAABB, &begin, &end);
+	const int32 sortedCount = axis >= 0 ? end - begin : 0;
+	const int32 count = sortedCount + m_pendingCount + m_largeCount;
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		int32 proxyId;
+		if (i < sortedCount)
+		{
+			proxyId = m_axes[axis][begin + i].proxyId;
+			if (proxyId == e_nullProxy)
+			{
+				continue;
+			}
+		}
+		else if (i < sortedCount + m_pendingCount)
+		{
+			proxyId = m_pending[i - sortedCount];
+		}
+		else
+		{
+			proxyId = m_large[i - sortedCount - m_pendingCount];
+		}
+
+		const b2AABB& aabb = m_proxies[proxyId].aabb;
+		if (b2TestOverlap(aabb, segmentAABB) == false || b2TestSegmentOverlap(aabb, p1, v, abs_v) == false)
+		{
+			continue;
+		}
+
+		b2RayCastInput subInput;
+		subInput.p1 = input.p1;
+		subInput.p2 = input.p2;
+		subInput.maxFraction = maxFraction;
+
+		float value = callback->RayCastCallback(subInput, proxyId);
+
+		if (value == 0.0f)
+		{
+			// The client has terminated the ray cast.
+			return;
+		}
+
+		if (value > 0.0f)
+		{
+			// Update segment bounding box.
+			maxFraction = value;
+			b2Vec2 t = p1 + maxFraction * (p2 - p1);
+			segmentAABB.lowerBound = b2Min(p1, t);
+			segmentAABB.upperBound = b2Max(p1, t);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,56 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef B2_TASK_H
+#define B2_TASK_H
+
+#include "box2d/b2_api.h"
+#include "box2d/b2_settings.h"
+
+/// A range of work box2d wants run in parallel. Execute is called on disjoint
+/// sub-ranges, possibly at the same time on different threads.
+class B2_API b2Task
+{
+public:
+	virtual ~b2Task() {}
+
+	/// Run items [begin, end). threadIndex is in [0, b2TaskExecutor::GetThreadCount())
+	/// and no two ranges running at the same time share one.
+	virtual void Execute(int32 begin, int32 end, int32 threadIndex) = 0;
+};
+
+/// Implement this class to let the world spread its work across your threads.
+/// Without one, or with only one thread, everything runs on the stepping thread.
+class B2_API b2TaskExecutor
+{
+public:
+	virtual ~b2TaskExecutor() {}
+
+	/// The number of threads that may run tasks, including the calling thread.
+	virtual int32 GetThreadCount() const = 0;
+
+	/// Split [0, count) into ranges of at least minRange items and execute them.
+	/// Must not return until every range is done.
+	virtual void ParallelFor(int32 count, int32 minRange, b2Task* task) = 0;
+};
+
+#endif
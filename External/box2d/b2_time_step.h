@@ -25,6 +25,8 @@
 #include "box2d/b2_api.h"
 #include "box2d/b2_math.h"
 
+class b2Island;
+
 /// Profiling data. Times are in milliseconds.
 struct B2_API b2Profile
 {
@@ -36,6 +38,7 @@ struct B2_API b2Profile
 	float solvePosition;
 	float broadphase;
 	float solveTOI;
+	float solveSoftBodies;
 };
 
 /// This is an internal structure.
@@ -47,6 +50,8 @@ struct B2_API b2TimeStep
 	int32 velocityIterations;
 	int32 positionIterations;
 	bool warmStarting;
+	bool wideSolving;	// solve contacts in SIMD lanes, see b2World::SetWideSolving
+	bool colorSolving;	// solve big islands a color at a time, see b2_minColoredConstraints
 };
 
 /// This is an internal structure.
@@ -69,6 +74,7 @@ struct B2_API b2SolverData
 	b2TimeStep step;
 	b2Position* positions;
 	b2Velocity* velocities;
+	const b2Island* island;	// looks up the bodies' indices into positions and velocities
 };
 
 #endif
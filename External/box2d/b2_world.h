@@ -27,7 +27,9 @@
 #include "box2d/b2_block_allocator.h"
 #include "box2d/b2_contact_manager.h"
 #include "box2d/b2_math.h"
+#include "box2d/b2_soft_body.h"
 #include "box2d/b2_stack_allocator.h"
+#include "box2d/b2_task.h"
 #include "box2d/b2_time_step.h"
 #include "box2d/b2_world_callbacks.h"
 
@@ -38,7 +40,19 @@ struct b2JointDef;
 class b2Body;
 class b2Draw;
 class b2Fixture;
+class b2Island;
 class b2Joint;
+struct b2ContactImpulse;
+
+/// The closest fixture a ray hit, from b2World::RayCastClosest.
+struct B2_API b2RayCastHit
+{
+	/// The fixture hit, nullptr if the ray hit nothing.
+	b2Fixture* fixture;
+	b2Vec2 point;
+	b2Vec2 normal;
+	float fraction;
+};
 
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
@@ -71,6 +85,31 @@ public:
 	/// by you and must remain in scope.
 	void SetDebugDraw(b2Draw* debugDraw);
 
+	/// Register a task executor to collide and solve on several threads. New pairs
+	/// are found, contact manifolds updated, and islands solved in parallel, each
+	/// thread with its own stack allocator. Listener callbacks, contact creation and
+	/// destruction, and sleeping come out in the same order, and with the same
+	/// results, as stepping on one thread. With color solving on, islands too big for
+	/// one thread are spread across the threads a color at a time, see SetColorSolving.
+	/// The executor is owned by you and must remain in scope. Pass nullptr to go back
+	/// to solving on the stepping thread.
+	void SetTaskExecutor(b2TaskExecutor* executor);
+	b2TaskExecutor* GetTaskExecutor() const { return m_taskExecutor; }
+
+	/// Change the structure the broad-phase keeps its proxies in, see b2BroadPhaseType.
+	/// Every proxy is rebuilt. Contacts are kept, and found again on the next step.
+	/// @param cellSize the grid's cell size, and the extent past which sweep-and-prune
+	/// scans a proxy on its own. A little over the size of a typical fixture works well.
+	void SetBroadPhase(b2BroadPhaseType type, float cellSize);
+	b2BroadPhaseType GetBroadPhase() const;
+
+	/// Build the broad-phase tree again from scratch. The tree fixtures are inserted
+	/// into one at a time is much worse than one built over them all at once, so call
+	/// this after creating many fixtures, such as a level's static geometry. Ray casts
+	/// and queries are faster for the rest of the session. Runs on the task executor's
+	/// threads if there is one.
+	void RebuildBroadPhase();
+
 	/// Create a rigid body given a definition. No reference to the definition
 	/// is retained.
 	/// @warning This function is locked during callbacks.
@@ -91,6 +130,20 @@ public:
 	/// @warning This function is locked during callbacks.
 	void DestroyJoint(b2Joint* joint);
 
+	/// Create a soft body given a definition. No reference to the definition
+	/// is retained. Soft bodies are stepped after the rigid bodies, see b2SoftBodyDef.
+	/// @warning This function is locked during callbacks.
+	b2SoftBody* CreateSoftBody(const b2SoftBodyDef* def);
+
+	/// Destroy a soft body. The particles of the soft bodies created after it are moved
+	/// down to close the gap.
+	/// @warning This function is locked during callbacks.
+	void DestroySoftBody(b2SoftBody* body);
+
+	/// Make room for this many more soft body particles, links and outline particles,
+	/// so creating that many soft bodies doesn't grow the world's soft body arrays.
+	void ReserveSoftBodies(int32 particleCount, int32 linkCount, int32 outlineCount);
+
 	/// Take a time step. This performs collision detection, integration,
 	/// and constraint solution.
 	/// @param timeStep the amount of time to simulate, this should not vary.
@@ -126,6 +179,17 @@ public:
 	/// @param point2 the ray ending point
 	void RayCast(b2RayCastCallback* callback, const b2Vec2& point1, const b2Vec2& point2) const;
 
+	/// Ray-cast the world for the closest fixture in the path of each ray. Rays are
+	/// sorted so that ones starting near each other and pointing the same way share
+	/// a packet, and each packet of b2_rayPacketSize rays is cast in one traversal of
+	/// the broad-phase. Hits are the same as RayCast with a callback that keeps the
+	/// closest fixture, and the ray-cast ignores shapes that contain the starting point.
+	/// @param inputs the rays. Each extends from p1 to p1 + maxFraction * (p2 - p1).
+	/// @param hits receives the closest hit of each ray, in the order of the rays.
+	/// @param count the number of rays.
+	/// @param parallel spread the packets across the task executor's threads, if it has any.
+	void RayCastClosest(const b2RayCastInput* inputs, b2RayCastHit* hits, int32 count, bool parallel) const;
+
 	/// Get the world body list. With the returned body, use b2Body::GetNext to get
 	/// the next body in the world list. A nullptr body indicates the end of the list.
 	/// @return the head of the world body list.
@@ -146,6 +210,16 @@ public:
 	b2Contact* GetContactList();
 	const b2Contact* GetContactList() const;
 
+	/// Get the world soft body list. With the returned soft body, use b2SoftBody::GetNext
+	/// to get the next soft body in the world list.
+	b2SoftBody* GetSoftBodyList();
+	const b2SoftBody* GetSoftBodyList() const;
+
+	/// Set the number of substeps soft bodies are solved in each step. More substeps
+	/// make the links stiffer and the contacts firmer, for more time.
+	void SetSoftBodySubSteps(int32 count);
+	int32 GetSoftBodySubSteps() const { return m_softBodySystem.m_subStepCount; }
+
 	/// Enable/disable sleep.
 	void SetAllowSleeping(bool flag);
 	bool GetAllowSleeping() const { return m_allowSleep; }
@@ -154,6 +228,22 @@ public:
 	void SetWarmStarting(bool flag) { m_warmStarting = flag; }
 	bool GetWarmStarting() const { return m_warmStarting; }
 
+	/// Enable/disable the wide contact solver. Contacts are colored so that none in a
+	/// color share a dynamic body, then solved several at a time in SIMD lanes (SSE2
+	/// or AVX, depending on the build). Warm starting, restitution and the block
+	/// solver work as before, but contacts are solved in a different order, so
+	/// results are not bit for bit the same as the scalar solver's.
+	void SetWideSolving(bool flag) { m_wideSolving = flag; }
+	bool GetWideSolving() const { return m_wideSolving; }
+
+	/// Enable/disable color solving. Islands with at least b2_minColoredConstraints
+	/// contacts or joints solve them a color at a time, each color spread across the
+	/// task executor's threads. Results are the same for any thread count, but not bit
+	/// for bit the same as solving in the original order. Off by default. The wide
+	/// contact solver always colors.
+	void SetColorSolving(bool flag) { m_colorSolving = flag; }
+	bool GetColorSolving() const { return m_colorSolving; }
+
 	/// Enable/disable continuous physics. For testing.
 	void SetContinuousPhysics(bool flag) { m_continuousPhysics = flag; }
 	bool GetContinuousPhysics() const { return m_continuousPhysics; }
@@ -174,6 +264,9 @@ public:
 	/// Get the number of contacts (each may have 0 or more contact points).
 	int32 GetContactCount() const;
 
+	/// Get the number of soft bodies.
+	int32 GetSoftBodyCount() const;
+
 	/// Get the height of the dynamic tree.
 	int32 GetTreeHeight() const;
 
@@ -222,6 +315,8 @@ private:
 	friend class b2Controller;
 
 	void Solve(const b2TimeStep& step);
+	void SolveIslands(const b2TimeStep& step, int32 islandCount);
+	void SolveStoredIsland(const b2TimeStep& step, int32 index, b2StackAllocator* allocator, b2TaskExecutor* executor);
 	void SolveTOI(const b2TimeStep& step);
 
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
@@ -231,6 +326,8 @@ private:
 
 	b2ContactManager m_contactManager;
 
+	b2SoftBodySystem m_softBodySystem;
+
 	b2Body* m_bodyList;
 	b2Joint* m_jointList;
 
@@ -253,12 +350,37 @@ private:
 
 	// These are for debugging the solver.
 	bool m_warmStarting;
+	bool m_wideSolving;
+	bool m_colorSolving;
 	bool m_continuousPhysics;
 	bool m_subStepping;
 
 	bool m_stepComplete;
 
 	b2Profile m_profile;
+
+	// Parallel island solving. The islands of a step are stored back to back in the
+	// island arrays, and ranges into them are kept per island.
+	struct b2IslandRange
+	{
+		int32 bodyStart, bodyCount, staticCount;
+		int32 contactStart, contactCount;
+		int32 jointStart, jointCount;
+		bool colored;	// solved on the stepping thread, a color at a time
+	};
+
+	b2TaskExecutor* m_taskExecutor;
+	b2StackAllocator* m_threadAllocators;
+	int32 m_threadAllocatorCount;
+
+	b2IslandRange* m_islandRanges;
+	b2Body** m_islandBodies;
+	b2Contact** m_islandContacts;
+	b2Joint** m_islandJoints;
+	b2ContactImpulse* m_islandImpulses;
+	b2Profile* m_islandProfiles;
+
+	friend class b2SolveIslandsTask;
 };
 
 inline b2Body* b2World::GetBodyList()
@@ -291,6 +413,16 @@ inline const b2Contact* b2World::GetContactList() const
 	return m_contactManager.m_contactList;
 }
 
+inline b2SoftBody* b2World::GetSoftBodyList()
+{
+	return m_softBodySystem.m_bodyList;
+}
+
+inline const b2SoftBody* b2World::GetSoftBodyList() const
+{
+	return m_softBodySystem.m_bodyList;
+}
+
 inline int32 b2World::GetBodyCount() const
 {
 	return m_bodyCount;
@@ -306,6 +438,11 @@ inline int32 b2World::GetContactCount() const
 	return m_contactManager.m_contactCount;
 }
 
+inline int32 b2World::GetSoftBodyCount() const
+{
+	return m_softBodySystem.m_bodyCount;
+}
+
 inline void b2World::SetGravity(const b2Vec2& gravity)
 {
 	m_gravity = gravity;
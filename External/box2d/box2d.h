@@ -40,9 +40,11 @@
 #include "box2d/b2_body.h"
 #include "box2d/b2_contact.h"
 #include "box2d/b2_fixture.h"
+#include "box2d/b2_soft_body.h"
 #include "box2d/b2_time_step.h"
 #include "box2d/b2_world.h"
 #include "box2d/b2_world_callbacks.h"
+#include "box2d/b2_task.h"
 
 #include "box2d/b2_distance_joint.h"
 #include "box2d/b2_friction_joint.h"
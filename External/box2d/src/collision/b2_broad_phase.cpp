@@ -21,10 +21,31 @@
 // SOFTWARE.
 
 #include "box2d/b2_broad_phase.h"
+#include "box2d/b2_task.h"
 #include <string.h>
 
+// Where one moved proxy's pairs are in its thread's buffer.
+struct b2MoveSpan
+{
+	int32 threadIndex;
+	int32 begin;
+	int32 count;
+};
+
+// The pairs one thread has found.
+struct b2ThreadPairs
+{
+	b2Pair* pairs;
+	int32 count;
+	int32 capacity;
+};
+
+// Fewest moved proxies worth spreading across threads.
+static const int32 b2_minParallelMoves = 64;
+
 b2BroadPhase::b2BroadPhase()
 {
+	m_type = b2_treeBroadPhase;
 	m_proxyCount = 0;
 
 	m_pairCapacity = 16;
@@ -34,17 +55,82 @@ b2BroadPhase::b2BroadPhase()
 	m_moveCapacity = 16;
 	m_moveCount = 0;
 	m_moveBuffer = (int32*)b2Alloc(m_moveCapacity * sizeof(int32));
+
+	m_taskExecutor = nullptr;
+	m_threadPairs = nullptr;
+	m_threadCount = 0;
+	m_moveSpans = nullptr;
+	m_moveSpanCapacity = 0;
 }
 
 b2BroadPhase::~b2BroadPhase()
 {
+	SetTaskExecutor(nullptr);
+	b2Free(m_moveSpans);
 	b2Free(m_moveBuffer);
 	b2Free(m_pairBuffer);
 }
 
+void b2BroadPhase::SetTaskExecutor(b2TaskExecutor* executor)
+{
+	for (int32 i = 0; i < m_threadCount; ++i)
+	{
+		b2Free(m_threadPairs[i].pairs);
+	}
+	b2Free(m_threadPairs);
+	m_threadPairs = nullptr;
+	m_threadCount = 0;
+
+	m_taskExecutor = executor;
+	if (m_taskExecutor == nullptr)
+	{
+		return;
+	}
+
+	// Each thread appends to its own buffer, so queries take no locks.
+	m_threadCount = b2Max(m_taskExecutor->GetThreadCount(), 1);
+	m_threadPairs = (b2ThreadPairs*)b2Alloc(m_threadCount * sizeof(b2ThreadPairs));
+	for (int32 i = 0; i < m_threadCount; ++i)
+	{
+		m_threadPairs[i].capacity = 16;
+		m_threadPairs[i].count = 0;
+		m_threadPairs[i].pairs = (b2Pair*)b2Alloc(m_threadPairs[i].capacity * sizeof(b2Pair));
+	}
+}
+
+void b2BroadPhase::SetType(b2BroadPhaseType type, float cellSize)
+{
+	b2Assert(m_proxyCount == 0);
+	b2Assert(cellSize > 0.0f);
+	m_type = type;
+	m_sweep.SetLargeSize(cellSize);
+	m_grid.SetCellSize(cellSize);
+}
+
+void b2BroadPhase::RebuildTree()
+{
+	if (m_type == b2_treeBroadPhase)
+	{
+		m_tree.RebuildTopDown(m_taskExecutor);
+	}
+}
+
 int32 b2BroadPhase::CreateProxy(const b2AABB& aabb, void* userData)
 {
-	int32 proxyId = m_tree.CreateProxy(aabb, userData);
+	int32 proxyId;
+	switch (m_type)
+	{
+	case b2_sweepBroadPhase:
+		proxyId = m_sweep.CreateProxy(aabb, userData);
+		break;
+	case b2_gridBroadPhase:
+		proxyId = m_grid.CreateProxy(aabb, userData);
+		break;
+	default:
+		proxyId = m_tree.CreateProxy(aabb, userData);
+		break;
+	}
+
 	++m_proxyCount;
 	BufferMove(proxyId);
 	return proxyId;
@@ -54,12 +140,36 @@ void b2BroadPhase::DestroyProxy(int32 proxyId)
 {
 	UnBufferMove(proxyId);
 	--m_proxyCount;
-	m_tree.DestroyProxy(proxyId);
+	switch (m_type)
+	{
+	case b2_sweepBroadPhase:
+		m_sweep.DestroyProxy(proxyId);
+		break;
+	case b2_gridBroadPhase:
+		m_grid.DestroyProxy(proxyId);
+		break;
+	default:
+		m_tree.DestroyProxy(proxyId);
+		break;
+	}
 }
 
 void b2BroadPhase::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement)
 {
-	bool buffer = m_tree.MoveProxy(proxyId, aabb, displacement);
+	bool buffer;
+	switch (m_type)
+	{
+	case b2_sweepBroadPhase:
+		buffer = m_sweep.MoveProxy(proxyId, aabb, displacement);
+		break;
+	case b2_gridBroadPhase:
+		buffer = m_grid.MoveProxy(proxyId, aabb, displacement);
+		break;
+	default:
+		buffer = m_tree.MoveProxy(proxyId, aabb, displacement);
+		break;
+	}
+
 	if (buffer)
 	{
 		BufferMove(proxyId);
@@ -97,7 +207,7 @@ void b2BroadPhase::UnBufferMove(int32 proxyId)
 	}
 }
 
-// This is called from b2DynamicTree::Query when we are gathering pairs.
+// This is called from the proxy structure's Query when we are gathering pairs.
 bool b2BroadPhase::QueryCallback(int32 proxyId)
 {
 	// A proxy cannot form a pair with itself.
@@ -106,7 +216,7 @@ bool b2BroadPhase::QueryCallback(int32 proxyId)
 		return true;
 	}
 
-	const bool moved = m_tree.WasMoved(proxyId);
+	const bool moved = WasMoved(proxyId);
 	if (moved && proxyId > m_queryProxyId)
 	{
 		// Both proxies are moving. Avoid duplicate pairs.
@@ -129,3 +239,145 @@ bool b2BroadPhase::QueryCallback(int32 proxyId)
 
 	return true;
 }
+
+
+// Collects the pairs of one moved proxy into a thread's buffer. The same as
+// b2BroadPhase::QueryCallback, without touching the broad-phase.
+class b2PairQuery
+{
+public:
+	b2PairQuery(const b2BroadPhase* broadPhase, b2ThreadPairs* buffer, int32 queryProxyId)
+		: m_broadPhase(broadPhase), m_buffer(buffer), m_queryProxyId(queryProxyId)
+	{
+	}
+
+	bool QueryCallback(int32 proxyId)
+	{
+		// A proxy cannot form a pair with itself.
+		if (proxyId == m_queryProxyId)
+		{
+			return true;
+		}
+
+		const bool moved = m_broadPhase->WasMoved(proxyId);
+		if (moved && proxyId > m_queryProxyId)
+		{
+			// Both proxies are moving. Avoid duplicate pairs.
+			return true;
+		}
+
+		// Grow the pair buffer as needed.
+		if (m_buffer->count == m_buffer->capacity)
+		{
+			b2Pair* oldBuffer = m_buffer->pairs;
+			m_buffer->capacity = m_buffer->capacity + (m_buffer->capacity >> 1);
+			m_buffer->pairs = (b2Pair*)b2Alloc(m_buffer->capacity * sizeof(b2Pair));
+			memcpy(m_buffer->pairs, oldBuffer, m_buffer->count * sizeof(b2Pair));
+			b2Free(oldBuffer);
+		}
+
+		m_buffer->pairs[m_buffer->count].proxyIdA = b2Min(proxyId, m_queryProxyId);
+		m_buffer->pairs[m_buffer->count].proxyIdB = b2Max(proxyId, m_queryProxyId);
+		++m_buffer->count;
+
+		return true;
+	}
+
+private:
+	const b2BroadPhase* m_broadPhase;
+	b2ThreadPairs* m_buffer;
+	int32 m_queryProxyId;
+};
+
+// Queries a range of the move buffer.
+class b2FindPairsTask : public b2Task
+{
+public:
+	b2FindPairsTask(b2BroadPhase* broadPhase)
+		: m_broadPhase(broadPhase)
+	{
+	}
+
+	void Execute(int32 begin, int32 end, int32 threadIndex) override
+	{
+		m_broadPhase->FindPairs(begin, end, threadIndex);
+	}
+
+private:
+	b2BroadPhase* m_broadPhase;
+};
+
+// Finds the moved proxies' pairs across threads, then copies them into the pair
+// buffer in move buffer order. That is the order the serial queries find them in,
+// so contacts are created in the same order whatever the thread count. Returns
+// false, having done nothing, when there is no executor or too little to do.
+bool b2BroadPhase::FindPairsParallel()
+{
+	if (m_taskExecutor == nullptr || m_threadCount < 2 || m_moveCount < b2_minParallelMoves)
+	{
+		return false;
+	}
+
+	if (m_moveSpanCapacity < m_moveCount)
+	{
+		b2Free(m_moveSpans);
+		m_moveSpanCapacity = b2Max(m_moveCount, 2 * m_moveSpanCapacity);
+		m_moveSpans = (b2MoveSpan*)b2Alloc(m_moveSpanCapacity * sizeof(b2MoveSpan));
+	}
+
+	for (int32 i = 0; i < m_threadCount; ++i)
+	{
+		m_threadPairs[i].count = 0;
+	}
+
+	const int32 minRange = 16;
+	b2FindPairsTask task(this);
+	m_taskExecutor->ParallelFor(m_moveCount, minRange, &task);
+
+	int32 pairCount = 0;
+	for (int32 i = 0; i < m_moveCount; ++i)
+	{
+		pairCount += m_moveSpans[i].count;
+	}
+
+	if (m_pairCapacity < pairCount)
+	{
+		b2Free(m_pairBuffer);
+		m_pairCapacity = b2Max(pairCount, m_pairCapacity + (m_pairCapacity >> 1));
+		m_pairBuffer = (b2Pair*)b2Alloc(m_pairCapacity * sizeof(b2Pair));
+	}
+
+	for (int32 i = 0; i < m_moveCount; ++i)
+	{
+		const b2MoveSpan& span = m_moveSpans[i];
+		memcpy(m_pairBuffer + m_pairCount, m_threadPairs[span.threadIndex].pairs + span.begin, span.count * sizeof(b2Pair));
+		m_pairCount += span.count;
+	}
+
+	return true;
+}
+
+void b2BroadPhase::FindPairs(int32 begin, int32 end, int32 threadIndex)
+{
+	b2ThreadPairs* buffer = m_threadPairs + threadIndex;
+	for (int32 i = begin; i < end; ++i)
+	{
+		b2MoveSpan& span = m_moveSpans[i];
+		span.threadIndex = threadIndex;
+		span.begin = buffer->count;
+		span.count = 0;
+
+		int32 queryProxyId = m_moveBuffer[i];
+		if (queryProxyId == e_nullProxy)
+		{
+			continue;
+		}
+
+		// We have to query with the fat AABB so that
+		// we don't fail to create a pair that may touch later.
+		b2PairQuery query(this, buffer, queryProxyId);
+		Query(&query, GetFatAABB(queryProxyId));
+
+		span.count = buffer->count - span.begin;
+	}
+}
@@ -256,3 +256,49 @@ bool b2TestOverlap(	const b2Shape* shapeA, int32 indexA,
 
 	return output.distance < 10.0f * b2_epsilon;
 }
+
+bool b2FattenAABB(b2AABB* fatAABB, const b2AABB& aabb, const b2Vec2& displacement)
+{
+	// Extend AABB
+	b2AABB newAABB;
+	b2Vec2 r(b2_aabbExtension, b2_aabbExtension);
+	newAABB.lowerBound = aabb.lowerBound - r;
+	newAABB.upperBound = aabb.upperBound + r;
+
+	// Predict AABB movement
+	b2Vec2 d = b2_aabbMultiplier * displacement;
+
+	if (d.x < 0.0f)
+	{
+		newAABB.lowerBound.x += d.x;
+	}
+	else
+	{
+		newAABB.upperBound.x += d.x;
+	}
+
+	if (d.y < 0.0f)
+	{
+		newAABB.lowerBound.y += d.y;
+	}
+	else
+	{
+		newAABB.upperBound.y += d.y;
+	}
+
+	if (fatAABB->Contains(aabb))
+	{
+		// The fat AABB still contains the object, but it might be too large.
+		b2AABB hugeAABB;
+		hugeAABB.lowerBound = newAABB.lowerBound - 4.0f * r;
+		hugeAABB.upperBound = newAABB.upperBound + 4.0f * r;
+
+		if (hugeAABB.Contains(*fatAABB))
+		{
+			return false;
+		}
+	}
+
+	*fatAABB = newAABB;
+	return true;
+}
@@ -20,6 +20,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 #include "box2d/b2_dynamic_tree.h"
+#include "box2d/b2_task.h"
+
+#include <algorithm>
 #include <string.h>
 
 b2DynamicTree::b2DynamicTree()
@@ -790,6 +793,355 @@ void b2DynamicTree::RebuildBottomUp()
 	Validate();
 }
 
+// A leaf being sorted into place by a top-down build.
+struct b2BuildLeaf
+{
+	b2Vec2 center;
+	int32 proxyId;
+};
+
+// A range of leaves built into a subtree by one task.
+struct b2BuildRange
+{
+	int32 begin;
+	int32 end;
+	int32 depth;
+	int32 root;
+};
+
+// The state of a top-down build. A range of leaves [begin, end) split at mid
+// becomes internal node internals[mid - 1], and its two halves take the internal
+// nodes on either side of it. So every range owns its nodes up front, and
+// subtrees can be built on any thread in any order.
+struct b2TreeBuild
+{
+	b2TreeNode* nodes;
+	b2BuildLeaf* leaves;
+	const int32* internals;
+
+	// The splits above the task ranges, in depth first order.
+	int32* mids;
+	int32 midCount;
+	b2BuildRange* ranges;
+	int32 rangeCount;
+	int32 topDepth;
+};
+
+// Buckets the leaf centers fall into along an axis, to price the splits between them.
+static const int32 b2_sahBinCount = 16;
+
+// Splits this deep fall back to the median, which bounds the recursion however
+// the proxies are laid out.
+static const int32 b2_maxSAHDepth = 64;
+
+// Fewest leaves worth handing to a task.
+static const int32 b2_minBuildRange = 256;
+
+static int32 b2BinIndex(float center, float lower, float scale)
+{
+	return b2Min(int32((center - lower) * scale), b2_sahBinCount - 1);
+}
+
+// Orders the leaves of [begin, end) so the range splits in two at the returned
+// index, at the cheapest binned split by the surface area heuristic.
+static int32 b2SplitLeaves(const b2TreeNode* nodes, b2BuildLeaf* leaves, int32 begin, int32 end, int32 depth)
+{
+	const int32 count = end - begin;
+	if (count == 2)
+	{
+		return begin + 1;
+	}
+
+	b2Vec2 lower = leaves[begin].center;
+	b2Vec2 upper = lower;
+	for (int32 i = begin + 1; i < end; ++i)
+	{
+		lower = b2Min(lower, leaves[i].center);
+		upper = b2Max(upper, leaves[i].center);
+	}
+	b2Vec2 extent = upper - lower;
+
+	if (depth < b2_maxSAHDepth)
+	{
+		float bestCost = b2_maxFloat;
+		int32 bestAxis = -1;
+		int32 bestBin = 0;
+
+		for (int32 axis = 0; axis < 2; ++axis)
+		{
+			if (extent(axis) <= 0.0f)
+			{
+				continue;
+			}
+
+			const float scale = b2_sahBinCount / extent(axis);
+			int32 binCounts[b2_sahBinCount] = {};
+			b2AABB binBounds[b2_sahBinCount];
+			for (int32 i = begin; i < end; ++i)
+			{
+				const int32 bin = b2BinIndex(leaves[i].center(axis), lower(axis), scale);
+				const b2AABB& aabb = nodes[leaves[i].proxyId].aabb;
+				if (binCounts[bin] == 0)
+				{
+					binBounds[bin] = aabb;
+				}
+				else
+				{
+					binBounds[bin].Combine(aabb);
+				}
+				++binCounts[bin];
+			}
+
+			// Price the right side of every split, then sweep in from the left.
+			float rightCosts[b2_sahBinCount];
+			int32 rightCounts[b2_sahBinCount];
+			b2AABB bounds;
+			int32 n = 0;
+			for (int32 bin = b2_sahBinCount - 1; bin > 0; --bin)
+			{
+				if (binCounts[bin] > 0)
+				{
+					if (n == 0)
+					{
+						bounds = binBounds[bin];
+					}
+					else
+					{
+						bounds.Combine(binBounds[bin]);
+					}
+					n += binCounts[bin];
+				}
+				rightCounts[bin] = n;
+				rightCosts[bin] = n > 0 ? n * bounds.GetPerimeter() : 0.0f;
+			}
+
+			n = 0;
+			for (int32 bin = 0; bin < b2_sahBinCount - 1; ++bin)
+			{
+				if (binCounts[bin] > 0)
+				{
+					if (n == 0)
+					{
+						bounds = binBounds[bin];
+					}
+					else
+					{
+						bounds.Combine(binBounds[bin]);
+					}
+					n += binCounts[bin];
+				}
+
+				if (n == 0 || rightCounts[bin + 1] == 0)
+				{
+					continue;
+				}
+
+				float cost = n * bounds.GetPerimeter() + rightCosts[bin + 1];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = bin + 1;
+				}
+			}
+		}
+
+		if (bestAxis != -1)
+		{
+			const float scale = b2_sahBinCount / extent(bestAxis);
+			const float axisLower = lower(bestAxis);
+			b2BuildLeaf* mid = std::partition(leaves + begin, leaves + end,
+				[bestAxis, axisLower, scale, bestBin](const b2BuildLeaf& leaf)
+				{
+					return b2BinIndex(leaf.center(bestAxis), axisLower, scale) < bestBin;
+				});
+			return int32(mid - leaves);
+		}
+	}
+
+	// Every center is in one bin, or the range is too deep. Split at the median
+	// of the longer axis.
+	const int32 axis = extent.x >= extent.y ? 0 : 1;
+	const int32 mid = begin + count / 2;
+	std::nth_element(leaves + begin, leaves + mid, leaves + end,
+		[axis](const b2BuildLeaf& a, const b2BuildLeaf& b)
+		{
+			return a.center(axis) < b.center(axis);
+		});
+	return mid;
+}
+
+// Makes an internal node the parent of two subtrees.
+static int32 b2LinkNodes(b2TreeNode* nodes, int32 parentId, int32 child1, int32 child2)
+{
+	b2TreeNode* parent = nodes + parentId;
+	parent->child1 = child1;
+	parent->child2 = child2;
+	parent->aabb.Combine(nodes[child1].aabb, nodes[child2].aabb);
+	parent->height = 1 + b2Max(nodes[child1].height, nodes[child2].height);
+	parent->moved = false;
+	nodes[child1].parent = parentId;
+	nodes[child2].parent = parentId;
+	return parentId;
+}
+
+// Builds the leaves of [begin, end) into a subtree and returns its root.
+static int32 b2BuildSubtree(b2TreeBuild* build, int32 begin, int32 end, int32 depth)
+{
+	if (end - begin == 1)
+	{
+		return build->leaves[begin].proxyId;
+	}
+
+	int32 mid = b2SplitLeaves(build->nodes, build->leaves, begin, end, depth);
+	int32 child1 = b2BuildSubtree(build, begin, mid, depth + 1);
+	int32 child2 = b2BuildSubtree(build, mid, end, depth + 1);
+	return b2LinkNodes(build->nodes, build->internals[mid - 1], child1, child2);
+}
+
+static bool b2IsBuildRange(const b2TreeBuild* build, int32 begin, int32 end, int32 depth)
+{
+	return depth == build->topDepth || end - begin <= b2_minBuildRange;
+}
+
+// Splits the top of the tree, leaving the ranges below it for tasks.
+static void b2SplitTop(b2TreeBuild* build, int32 begin, int32 end, int32 depth)
+{
+	if (b2IsBuildRange(build, begin, end, depth))
+	{
+		b2BuildRange* range = build->ranges + build->rangeCount++;
+		range->begin = begin;
+		range->end = end;
+		range->depth = depth;
+		range->root = b2_nullNode;
+		return;
+	}
+
+	int32 mid = b2SplitLeaves(build->nodes, build->leaves, begin, end, depth);
+	build->mids[build->midCount++] = mid;
+	b2SplitTop(build, begin, mid, depth + 1);
+	b2SplitTop(build, mid, end, depth + 1);
+}
+
+// Links the top of the tree over the subtrees the tasks built, walking the splits
+// in the order b2SplitTop made them.
+static int32 b2LinkTop(b2TreeBuild* build, int32 begin, int32 end, int32 depth, int32* midIndex, int32* rangeIndex)
+{
+	if (b2IsBuildRange(build, begin, end, depth))
+	{
+		return build->ranges[(*rangeIndex)++].root;
+	}
+
+	int32 mid = build->mids[(*midIndex)++];
+	int32 child1 = b2LinkTop(build, begin, mid, depth + 1, midIndex, rangeIndex);
+	int32 child2 = b2LinkTop(build, mid, end, depth + 1, midIndex, rangeIndex);
+	return b2LinkNodes(build->nodes, build->internals[mid - 1], child1, child2);
+}
+
+// Builds the subtrees of a range of b2BuildRanges.
+class b2BuildTreeTask : public b2Task
+{
+public:
+	b2BuildTreeTask(b2TreeBuild* build)
+		: m_build(build)
+	{
+	}
+
+	void Execute(int32 begin, int32 end, int32 threadIndex) override
+	{
+		B2_NOT_USED(threadIndex);
+		for (int32 i = begin; i < end; ++i)
+		{
+			b2BuildRange* range = m_build->ranges + i;
+			range->root = b2BuildSubtree(m_build, range->begin, range->end, range->depth);
+		}
+	}
+
+private:
+	b2TreeBuild* m_build;
+};
+
+void b2DynamicTree::RebuildTopDown(b2TaskExecutor* executor)
+{
+	if (m_root == b2_nullNode)
+	{
+		return;
+	}
+
+	// Gather the leaves, and the internal nodes to reuse for the new tree.
+	b2BuildLeaf* leaves = (b2BuildLeaf*)b2Alloc(m_nodeCount * sizeof(b2BuildLeaf));
+	int32* internals = (int32*)b2Alloc(m_nodeCount * sizeof(int32));
+	int32 leafCount = 0;
+	int32 internalCount = 0;
+	for (int32 i = 0; i < m_nodeCapacity; ++i)
+	{
+		if (m_nodes[i].height < 0)
+		{
+			// free node in pool
+			continue;
+		}
+
+		if (m_nodes[i].IsLeaf())
+		{
+			leaves[leafCount].center = m_nodes[i].aabb.GetCenter();
+			leaves[leafCount].proxyId = i;
+			++leafCount;
+		}
+		else
+		{
+			internals[internalCount] = i;
+			++internalCount;
+		}
+	}
+	b2Assert(internalCount == leafCount - 1);
+
+	b2TreeBuild build;
+	build.nodes = m_nodes;
+	build.leaves = leaves;
+	build.internals = internals;
+	build.mids = nullptr;
+	build.midCount = 0;
+	build.ranges = nullptr;
+	build.rangeCount = 0;
+	build.topDepth = 0;
+
+	int32 threadCount = executor != nullptr ? executor->GetThreadCount() : 1;
+	if (threadCount < 2 || leafCount < 2 * b2_minBuildRange)
+	{
+		m_root = b2BuildSubtree(&build, 0, leafCount, 0);
+	}
+	else
+	{
+		// A few ranges per thread, so uneven ones even out.
+		while ((1 << build.topDepth) < 4 * threadCount)
+		{
+			++build.topDepth;
+		}
+
+		const int32 maxRanges = 1 << build.topDepth;
+		build.mids = (int32*)b2Alloc(maxRanges * sizeof(int32));
+		build.ranges = (b2BuildRange*)b2Alloc(maxRanges * sizeof(b2BuildRange));
+		b2SplitTop(&build, 0, leafCount, 0);
+
+		b2BuildTreeTask task(&build);
+		executor->ParallelFor(build.rangeCount, 1, &task);
+
+		int32 midIndex = 0;
+		int32 rangeIndex = 0;
+		m_root = b2LinkTop(&build, 0, leafCount, 0, &midIndex, &rangeIndex);
+
+		b2Free(build.ranges);
+		b2Free(build.mids);
+	}
+
+	m_nodes[m_root].parent = b2_nullNode;
+
+	b2Free(internals);
+	b2Free(leaves);
+
+	Validate();
+}
+
 void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
 {
 	// Build array of leaves. Free the rest.
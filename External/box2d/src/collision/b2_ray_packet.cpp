@@ -0,0 +1,128 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "box2d/b2_ray_packet.h"
+#include "box2d/b2_simd.h"
+
+#include <float.h>
+
+void b2RayPacket::Clear()
+{
+	// Inside out boxes overlap nothing.
+	for (int32 i = 0; i < b2_rayPacketSize; ++i)
+	{
+		p1x[i] = p1y[i] = p2x[i] = p2y[i] = 0.0f;
+		vx[i] = vy[i] = absVx[i] = absVy[i] = 0.0f;
+		lowerX[i] = lowerY[i] = FLT_MAX;
+		upperX[i] = upperY[i] = -FLT_MAX;
+		maxFraction[i] = 0.0f;
+	}
+	count = 0;
+}
+
+int32 b2RayPacket::Add(const b2RayCastInput& input)
+{
+	b2Assert(count < b2_rayPacketSize);
+	int32 lane = count;
+	++count;
+
+	b2Vec2 r = input.p2 - input.p1;
+	b2Assert(r.LengthSquared() > 0.0f);
+	r.Normalize();
+
+	b2Vec2 v = b2Cross(1.0f, r);
+	b2Vec2 abs_v = b2Abs(v);
+
+	p1x[lane] = input.p1.x;
+	p1y[lane] = input.p1.y;
+	p2x[lane] = input.p2.x;
+	p2y[lane] = input.p2.y;
+	vx[lane] = v.x;
+	vy[lane] = v.y;
+	absVx[lane] = abs_v.x;
+	absVy[lane] = abs_v.y;
+	SetMaxFraction(lane, input.maxFraction);
+
+	return lane;
+}
+
+void b2RayPacket::SetMaxFraction(int32 lane, float fraction)
+{
+	b2Assert(0 <= lane && lane < count);
+	b2Vec2 p1(p1x[lane], p1y[lane]);
+	b2Vec2 p2(p2x[lane], p2y[lane]);
+	b2Vec2 t = p1 + fraction * (p2 - p1);
+	b2Vec2 lower = b2Min(p1, t);
+	b2Vec2 upper = b2Max(p1, t);
+	lowerX[lane] = lower.x;
+	lowerY[lane] = lower.y;
+	upperX[lane] = upper.x;
+	upperY[lane] = upper.y;
+	maxFraction[lane] = fraction;
+}
+
+b2RayCastInput b2RayPacket::GetInput(int32 lane) const
+{
+	b2Assert(0 <= lane && lane < count);
+	b2RayCastInput input;
+	input.p1.Set(p1x[lane], p1y[lane]);
+	input.p2.Set(p2x[lane], p2y[lane]);
+	input.maxFraction = maxFraction[lane];
+	return input;
+}
+
+uint32 b2RayPacket::TestOverlap(const b2AABB& aabb, uint32 lanes) const
+{
+	// The same operations as b2TestOverlap and the separating axis test in
+	// b2DynamicTree::RayCast, so a lane is kept exactly when a lone ray would be.
+	b2Vec2 c = aabb.GetCenter();
+	b2Vec2 h = aabb.GetExtents();
+	const b2FloatW nodeLowerX = b2SplatW(aabb.lowerBound.x);
+	const b2FloatW nodeLowerY = b2SplatW(aabb.lowerBound.y);
+	const b2FloatW nodeUpperX = b2SplatW(aabb.upperBound.x);
+	const b2FloatW nodeUpperY = b2SplatW(aabb.upperBound.y);
+	const b2FloatW cx = b2SplatW(c.x);
+	const b2FloatW cy = b2SplatW(c.y);
+	const b2FloatW hx = b2SplatW(h.x);
+	const b2FloatW hy = b2SplatW(h.y);
+
+	uint32 separated = 0;
+	for (int32 i = 0; i < b2_rayPacketSize; i += b2_simdLanes)
+	{
+		b2FloatW mask = b2GreaterW(b2LoadW(lowerX + i), nodeUpperX);
+		mask = b2OrW(mask, b2GreaterW(b2LoadW(lowerY + i), nodeUpperY));
+		mask = b2OrW(mask, b2GreaterW(nodeLowerX, b2LoadW(upperX + i)));
+		mask = b2OrW(mask, b2GreaterW(nodeLowerY, b2LoadW(upperY + i)));
+
+		// |dot(v, p1 - c)| > dot(|v|, h)
+		b2FloatW dx = b2SubW(b2LoadW(p1x + i), cx);
+		b2FloatW dy = b2SubW(b2LoadW(p1y + i), cy);
+		b2FloatW distance = b2AbsW(b2AddW(b2MulW(b2LoadW(vx + i), dx), b2MulW(b2LoadW(vy + i), dy)));
+		b2FloatW radius = b2AddW(b2MulW(b2LoadW(absVx + i), hx), b2MulW(b2LoadW(absVy + i), hy));
+		mask = b2OrW(mask, b2GreaterW(distance, radius));
+
+		separated |= b2MaskBitsW(mask) << i;
+	}
+
+	return lanes & ~separated;
+}
@@ -0,0 +1,354 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "box2d/b2_spatial_grid.h"
+
+#include <string.h>
+
+// Most cells a proxy is listed in. Bigger proxies go in the large list.
+static const int32 b2_maxProxyCells = 16;
+
+b2SpatialGrid::b2SpatialGrid()
+{
+	m_proxies = nullptr;
+	m_proxyCount = 0;
+	m_proxyCapacity = 0;
+	m_freeList = e_nullProxy;
+
+	m_cellSize = 2.0f;
+	m_inverseCellSize = 0.5f;
+
+	m_cells = nullptr;
+	m_cellCount = 0;
+	m_cellCapacity = 0;
+
+	m_table = nullptr;
+	m_tableCapacity = 0;
+
+	m_large = nullptr;
+	m_largeCount = 0;
+	m_largeCapacity = 0;
+}
+
+b2SpatialGrid::~b2SpatialGrid()
+{
+	ClearCells();
+	b2Free(m_cells);
+	b2Free(m_table);
+	b2Free(m_large);
+	b2Free(m_proxies);
+}
+
+void b2SpatialGrid::SetCellSize(float size)
+{
+	b2Assert(size > 0.0f);
+	b2Assert(m_proxyCount == 0);
+	ClearCells();
+	m_cellSize = size;
+	m_inverseCellSize = 1.0f / size;
+}
+
+// Frees every cell and empties the table.
+void b2SpatialGrid::ClearCells()
+{
+	for (int32 i = 0; i < m_cellCount; ++i)
+	{
+		b2Free(m_cells[i].proxies);
+	}
+	m_cellCount = 0;
+
+	for (int32 i = 0; i < m_tableCapacity; ++i)
+	{
+		m_table[i] = e_nullProxy;
+	}
+}
+
+int32 b2SpatialGrid::AllocateProxy()
+{
+	if (m_freeList == e_nullProxy)
+	{
+		b2Assert(m_proxyCount == m_proxyCapacity);
+
+		// The free list is empty. Rebuild a bigger pool.
+		b2GridProxy* oldProxies = m_proxies;
+		int32 oldCapacity = m_proxyCapacity;
+		m_proxyCapacity = b2Max(16, 2 * m_proxyCapacity);
+		m_proxies = (b2GridProxy*)b2Alloc(m_proxyCapacity * sizeof(b2GridProxy));
+		if (oldProxies != nullptr)
+		{
+			memcpy(m_proxies, oldProxies, oldCapacity * sizeof(b2GridProxy));
+			b2Free(oldProxies);
+		}
+
+		// Build a linked list for the free list.
+		for (int32 i = oldCapacity; i < m_proxyCapacity; ++i)
+		{
+			m_proxies[i].next = i + 1;
+			m_proxies[i].state = e_free;
+		}
+		m_proxies[m_proxyCapacity - 1].next = e_nullProxy;
+		m_freeList = oldCapacity;
+	}
+
+	int32 proxyId = m_freeList;
+	m_freeList = m_proxies[proxyId].next;
+	m_proxies[proxyId].userData = nullptr;
+	m_proxies[proxyId].moved = false;
+	++m_proxyCount;
+	return proxyId;
+}
+
+void b2SpatialGrid::FreeProxy(int32 proxyId)
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	b2Assert(0 < m_proxyCount);
+	m_proxies[proxyId].next = m_freeList;
+	m_proxies[proxyId].state = e_free;
+	m_freeList = proxyId;
+	--m_proxyCount;
+}
+
+// Doubles the table and rehashes the cells into it.
+void b2SpatialGrid::GrowTable()
+{
+	b2Free(m_table);
+	m_tableCapacity = b2Max(64, 2 * m_tableCapacity);
+	m_table = (int32*)b2Alloc(m_tableCapacity * sizeof(int32));
+	for (int32 i = 0; i < m_tableCapacity; ++i)
+	{
+		m_table[i] = e_nullProxy;
+	}
+
+	uint32 mask = uint32(m_tableCapacity - 1);
+	for (int32 index = 0; index < m_cellCount; ++index)
+	{
+		uint32 hash = (uint32(m_cells[index].x) * 73856093u) ^ (uint32(m_cells[index].y) * 19349663u);
+		uint32 i = hash & mask;
+		while (m_table[i] != e_nullProxy)
+		{
+			i = (i + 1) & mask;
+		}
+		m_table[i] = index;
+	}
+}
+
+// Finds a cell, making it if it doesn't exist yet.
+int32 b2SpatialGrid::GetCell(int32 x, int32 y)
+{
+	int32 index = FindCell(x, y);
+	if (index != e_nullProxy)
+	{
+		return index;
+	}
+
+	if (2 * (m_cellCount + 1) > m_tableCapacity)
+	{
+		GrowTable();
+	}
+
+	if (m_cellCount == m_cellCapacity)
+	{
+		b2GridCell* oldCells = m_cells;
+		m_cellCapacity = b2Max(16, 2 * m_cellCapacity);
+		m_cells = (b2GridCell*)b2Alloc(m_cellCapacity * sizeof(b2GridCell));
+		if (oldCells != nullptr)
+		{
+			memcpy(m_cells, oldCells, m_cellCount * sizeof(b2GridCell));
+			b2Free(oldCells);
+		}
+	}
+
+	index = m_cellCount;
+	++m_cellCount;
+
+	b2GridCell* cell = m_cells + index;
+	cell->x = x;
+	cell->y = y;
+	cell->count = 0;
+	cell->capacity = 4;
+	cell->proxies = (int32*)b2Alloc(cell->capacity * sizeof(int32));
+
+	uint32 mask = uint32(m_tableCapacity - 1);
+	uint32 hash = (uint32(x) * 73856093u) ^ (uint32(y) * 19349663u);
+	uint32 i = hash & mask;
+	while (m_table[i] != e_nullProxy)
+	{
+		i = (i + 1) & mask;
+	}
+	m_table[i] = index;
+
+	return index;
+}
+
+// Lists a proxy in the cells its AABB overlaps, or in the large list.
+void b2SpatialGrid::Insert(int32 proxyId)
+{
+	b2GridProxy* proxy = m_proxies + proxyId;
+	proxy->lowerX = ToCell(proxy->aabb.lowerBound.x);
+	proxy->lowerY = ToCell(proxy->aabb.lowerBound.y);
+	proxy->upperX = ToCell(proxy->aabb.upperBound.x);
+	proxy->upperY = ToCell(proxy->aabb.upperBound.y);
+
+	const float cellCount = float(proxy->upperX - proxy->lowerX + 1) * float(proxy->upperY - proxy->lowerY + 1);
+	if (cellCount > b2_maxProxyCells)
+	{
+		if (m_largeCount == m_largeCapacity)
+		{
+			int32* oldLarge = m_large;
+			m_largeCapacity = b2Max(16, 2 * m_largeCapacity);
+			m_large = (int32*)b2Alloc(m_largeCapacity * sizeof(int32));
+			if (oldLarge != nullptr)
+			{
+				memcpy(m_large, oldLarge, m_largeCount * sizeof(int32));
+				b2Free(oldLarge);
+			}
+		}
+
+		proxy->state = e_large;
+		proxy->next = m_largeCount;
+		m_large[m_largeCount] = proxyId;
+		++m_largeCount;
+		return;
+	}
+
+	proxy->state = e_celled;
+	for (int32 y = proxy->lowerY; y <= proxy->upperY; ++y)
+	{
+		for (int32 x = proxy->lowerX; x <= proxy->upperX; ++x)
+		{
+			// GetCell can grow the cell array.
+			int32 index = GetCell(x, y);
+			b2GridCell* cell = m_cells + index;
+			if (cell->count == cell->capacity)
+			{
+				int32* oldProxies = cell->proxies;
+				cell->capacity *= 2;
+				cell->proxies = (int32*)b2Alloc(cell->capacity * sizeof(int32));
+				memcpy(cell->proxies, oldProxies, cell->count * sizeof(int32));
+				b2Free(oldProxies);
+			}
+
+			cell->proxies[cell->count] = proxyId;
+			++cell->count;
+		}
+	}
+}
+
+// Takes a proxy out of its cells, or out of the large list.
+void b2SpatialGrid::Remove(int32 proxyId)
+{
+	b2GridProxy* proxy = m_proxies + proxyId;
+	if (proxy->state == e_large)
+	{
+		// Swap the last large proxy into this one's place.
+		int32 index = proxy->next;
+		b2Assert(m_large[index] == proxyId);
+		--m_largeCount;
+		m_large[index] = m_large[m_largeCount];
+		m_proxies[m_large[index]].next = index;
+		return;
+	}
+
+	b2Assert(proxy->state == e_celled);
+	for (int32 y = proxy->lowerY; y <= proxy->upperY; ++y)
+	{
+		for (int32 x = proxy->lowerX; x <= proxy->upperX; ++x)
+		{
+			int32 index = FindCell(x, y);
+			b2Assert(index != e_nullProxy);
+			b2GridCell* cell = m_cells + index;
+			for (int32 i = 0; i < cell->count; ++i)
+			{
+				if (cell->proxies[i] == proxyId)
+				{
+					--cell->count;
+					cell->proxies[i] = cell->proxies[cell->count];
+					break;
+				}
+			}
+		}
+	}
+}
+
+int32 b2SpatialGrid::CreateProxy(const b2AABB& aabb, void* userData)
+{
+	int32 proxyId = AllocateProxy();
+
+	// Fatten the aabb.
+	b2Vec2 r(b2_aabbExtension, b2_aabbExtension);
+	m_proxies[proxyId].aabb.lowerBound = aabb.lowerBound - r;
+	m_proxies[proxyId].aabb.upperBound = aabb.upperBound + r;
+	m_proxies[proxyId].userData = userData;
+	m_proxies[proxyId].moved = true;
+
+	Insert(proxyId);
+
+	return proxyId;
+}
+
+void b2SpatialGrid::DestroyProxy(int32 proxyId)
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	b2Assert(m_proxies[proxyId].state != e_free);
+
+	Remove(proxyId);
+	FreeProxy(proxyId);
+}
+
+bool b2SpatialGrid::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement)
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	b2Assert(m_proxies[proxyId].state != e_free);
+
+	b2AABB fatAABB = m_proxies[proxyId].aabb;
+	if (b2FattenAABB(&fatAABB, aabb, displacement) == false)
+	{
+		return false;
+	}
+
+	Remove(proxyId);
+	m_proxies[proxyId].aabb = fatAABB;
+	Insert(proxyId);
+
+	m_proxies[proxyId].moved = true;
+
+	return true;
+}
+
+void b2SpatialGrid::ShiftOrigin(const b2Vec2& newOrigin)
+{
+	// The cells don't shift with the origin, so the grid is built again.
+	ClearCells();
+	m_largeCount = 0;
+
+	for (int32 i = 0; i < m_proxyCapacity; ++i)
+	{
+		if (m_proxies[i].state == e_free)
+		{
+			continue;
+		}
+
+		m_proxies[i].aabb.lowerBound -= newOrigin;
+		m_proxies[i].aabb.upperBound -= newOrigin;
+		Insert(i);
+	}
+}
@@ -0,0 +1,415 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "box2d/b2_sweep_and_prune.h"
+
+#include <algorithm>
+#include <string.h>
+
+static bool b2LowerXLessThan(const b2SweepEntry& a, const b2SweepEntry& b)
+{
+	return a.aabb.lowerBound.x < b.aabb.lowerBound.x;
+}
+
+static bool b2LowerYLessThan(const b2SweepEntry& a, const b2SweepEntry& b)
+{
+	return a.aabb.lowerBound.y < b.aabb.lowerBound.y;
+}
+
+b2SweepAndPrune::b2SweepAndPrune()
+{
+	m_proxies = nullptr;
+	m_proxyCount = 0;
+	m_proxyCapacity = 0;
+	m_freeList = e_nullProxy;
+
+	m_axes[0] = nullptr;
+	m_axes[1] = nullptr;
+	m_scratch = nullptr;
+	m_entryCount = 0;
+	m_entryCapacity = 0;
+	m_staleCount = 0;
+
+	m_maxExtent[0] = 0.0f;
+	m_maxExtent[1] = 0.0f;
+
+	m_pending = nullptr;
+	m_pendingCount = 0;
+	m_pendingCapacity = 0;
+
+	m_large = nullptr;
+	m_largeCount = 0;
+	m_largeCapacity = 0;
+
+	m_largeSize = 8.0f;
+}
+
+b2SweepAndPrune::~b2SweepAndPrune()
+{
+	b2Free(m_large);
+	b2Free(m_pending);
+	b2Free(m_scratch);
+	b2Free(m_axes[1]);
+	b2Free(m_axes[0]);
+	b2Free(m_proxies);
+}
+
+void b2SweepAndPrune::SetLargeSize(float size)
+{
+	b2Assert(size > 0.0f);
+	m_largeSize = size;
+}
+
+int32 b2SweepAndPrune::AllocateProxy()
+{
+	if (m_freeList == e_nullProxy)
+	{
+		b2Assert(m_proxyCount == m_proxyCapacity);
+
+		// The free list is empty. Rebuild a bigger pool.
+		b2SweepProxy* oldProxies = m_proxies;
+		int32 oldCapacity = m_proxyCapacity;
+		m_proxyCapacity = b2Max(16, 2 * m_proxyCapacity);
+		m_proxies = (b2SweepProxy*)b2Alloc(m_proxyCapacity * sizeof(b2SweepProxy));
+		if (oldProxies != nullptr)
+		{
+			memcpy(m_proxies, oldProxies, oldCapacity * sizeof(b2SweepProxy));
+			b2Free(oldProxies);
+		}
+
+		// Build a linked list for the free list.
+		for (int32 i = oldCapacity; i < m_proxyCapacity; ++i)
+		{
+			m_proxies[i].next = i + 1;
+			m_proxies[i].state = e_free;
+		}
+		m_proxies[m_proxyCapacity - 1].next = e_nullProxy;
+		m_freeList = oldCapacity;
+	}
+
+	int32 proxyId = m_freeList;
+	m_freeList = m_proxies[proxyId].next;
+	m_proxies[proxyId].userData = nullptr;
+	m_proxies[proxyId].moved = false;
+	++m_proxyCount;
+	return proxyId;
+}
+
+void b2SweepAndPrune::FreeProxy(int32 proxyId)
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	b2Assert(0 < m_proxyCount);
+	m_proxies[proxyId].next = m_freeList;
+	m_proxies[proxyId].state = e_free;
+	m_freeList = proxyId;
+	--m_proxyCount;
+}
+
+void b2SweepAndPrune::PushList(int32** list, int32* count, int32* capacity, int32 proxyId)
+{
+	if (*count == *capacity)
+	{
+		int32* oldList = *list;
+		*capacity = b2Max(16, 2 * *capacity);
+		*list = (int32*)b2Alloc(*capacity * sizeof(int32));
+		if (oldList != nullptr)
+		{
+			memcpy(*list, oldList, *count * sizeof(int32));
+			b2Free(oldList);
+		}
+	}
+
+	m_proxies[proxyId].next = *count;
+	(*list)[*count] = proxyId;
+	++*count;
+}
+
+// Sets a proxy aside, in the large list or the pending list.
+void b2SweepAndPrune::Insert(int32 proxyId)
+{
+	b2SweepProxy* proxy = m_proxies + proxyId;
+	b2Vec2 extents = proxy->aabb.upperBound - proxy->aabb.lowerBound;
+	if (b2Max(extents.x, extents.y) > m_largeSize)
+	{
+		proxy->state = e_large;
+		PushList(&m_large, &m_largeCount, &m_largeCapacity, proxyId);
+	}
+	else
+	{
+		proxy->state = e_pending;
+		PushList(&m_pending, &m_pendingCount, &m_pendingCapacity, proxyId);
+	}
+}
+
+// Takes a proxy out of wherever it is. Sorted entries are left for the next
+// commit to drop.
+void b2SweepAndPrune::Remove(int32 proxyId)
+{
+	b2SweepProxy* proxy = m_proxies + proxyId;
+	int32* list = nullptr;
+	int32* count = nullptr;
+
+	switch (proxy->state)
+	{
+	case e_sorted:
+		for (int32 axis = 0; axis < 2; ++axis)
+		{
+			b2SweepEntry* entry = m_axes[axis] + proxy->entries[axis];
+			b2Assert(entry->proxyId == proxyId);
+			entry->proxyId = e_nullProxy;
+
+			// Inside out, so it overlaps nothing. The lower bound on the axis is
+			// the sort key, so it stays.
+			float lower = entry->aabb.lowerBound(axis);
+			entry->aabb.lowerBound.Set(b2_maxFloat, b2_maxFloat);
+			entry->aabb.upperBound.Set(-b2_maxFloat, -b2_maxFloat);
+			entry->aabb.lowerBound(axis) = lower;
+		}
+		++m_staleCount;
+		return;
+
+	case e_pending:
+		list = m_pending;
+		count = &m_pendingCount;
+		break;
+
+	case e_large:
+		list = m_large;
+		count = &m_largeCount;
+		break;
+
+	default:
+		b2Assert(false);
+		return;
+	}
+
+	// Swap the last proxy of the list into this one's place.
+	int32 index = proxy->next;
+	b2Assert(list[index] == proxyId);
+	--*count;
+	list[index] = list[*count];
+	m_proxies[list[index]].next = index;
+}
+
+int32 b2SweepAndPrune::CreateProxy(const b2AABB& aabb, void* userData)
+{
+	int32 proxyId = AllocateProxy();
+
+	// Fatten the aabb.
+	b2Vec2 r(b2_aabbExtension, b2_aabbExtension);
+	m_proxies[proxyId].aabb.lowerBound = aabb.lowerBound - r;
+	m_proxies[proxyId].aabb.upperBound = aabb.upperBound + r;
+	m_proxies[proxyId].userData = userData;
+	m_proxies[proxyId].moved = true;
+
+	Insert(proxyId);
+
+	return proxyId;
+}
+
+void b2SweepAndPrune::DestroyProxy(int32 proxyId)
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	b2Assert(m_proxies[proxyId].state != e_free);
+
+	Remove(proxyId);
+	FreeProxy(proxyId);
+}
+
+bool b2SweepAndPrune::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement)
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	b2Assert(m_proxies[proxyId].state != e_free);
+
+	if (b2FattenAABB(&m_proxies[proxyId].aabb, aabb, displacement) == false)
+	{
+		return false;
+	}
+
+	// Pending proxies are already set aside, sorted and large ones are set aside again.
+	if (m_proxies[proxyId].state != e_pending)
+	{
+		Remove(proxyId);
+		Insert(proxyId);
+	}
+
+	m_proxies[proxyId].moved = true;
+
+	return true;
+}
+
+void b2SweepAndPrune::Commit()
+{
+	if (m_pendingCount == 0 && m_staleCount == 0)
+	{
+		return;
+	}
+
+	int32 liveCount = m_entryCount - m_staleCount;
+	int32 capacity = liveCount + m_pendingCount;
+	if (m_entryCapacity < capacity)
+	{
+		m_entryCapacity = b2Max(capacity, 2 * m_entryCapacity);
+		for (int32 axis = 0; axis < 2; ++axis)
+		{
+			b2SweepEntry* oldEntries = m_axes[axis];
+			m_axes[axis] = (b2SweepEntry*)b2Alloc(m_entryCapacity * sizeof(b2SweepEntry));
+			if (oldEntries != nullptr)
+			{
+				memcpy(m_axes[axis], oldEntries, m_entryCount * sizeof(b2SweepEntry));
+				b2Free(oldEntries);
+			}
+		}
+
+		b2Free(m_scratch);
+		m_scratch = (b2SweepEntry*)b2Alloc(m_entryCapacity * sizeof(b2SweepEntry));
+	}
+
+	for (int32 axis = 0; axis < 2; ++axis)
+	{
+		bool (*lessThan)(const b2SweepEntry&, const b2SweepEntry&) = axis == 0 ? b2LowerXLessThan : b2LowerYLessThan;
+
+		// Drop the removed entries, measuring the largest extent left.
+		b2SweepEntry* entries = m_axes[axis];
+		float maxExtent = 0.0f;
+		int32 count = 0;
+		for (int32 i = 0; i < m_entryCount; ++i)
+		{
+			if (entries[i].proxyId == e_nullProxy)
+			{
+				continue;
+			}
+
+			const b2AABB& aabb = entries[i].aabb;
+			maxExtent = b2Max(maxExtent, aabb.upperBound(axis) - aabb.lowerBound(axis));
+			entries[count++] = entries[i];
+		}
+		b2Assert(count == liveCount);
+
+		// Sort the pending proxies on their own.
+		b2SweepEntry* added = m_scratch;
+		for (int32 i = 0; i < m_pendingCount; ++i)
+		{
+			const b2AABB& aabb = m_proxies[m_pending[i]].aabb;
+			added[i].aabb = aabb;
+			added[i].proxyId = m_pending[i];
+			maxExtent = b2Max(maxExtent, aabb.upperBound(axis) - aabb.lowerBound(axis));
+		}
+		std::sort(added, added + m_pendingCount, lessThan);
+
+		// Merge them in from the back, so the axis needs no second buffer.
+		int32 i = count - 1;
+		int32 j = m_pendingCount - 1;
+		int32 k = count + m_pendingCount - 1;
+		while (j >= 0)
+		{
+			if (i >= 0 && lessThan(added[j], entries[i]))
+			{
+				entries[k--] = entries[i--];
+			}
+			else
+			{
+				entries[k--] = added[j--];
+			}
+		}
+
+		for (k = 0; k < count + m_pendingCount; ++k)
+		{
+			m_proxies[entries[k].proxyId].entries[axis] = k;
+		}
+
+		m_maxExtent[axis] = maxExtent;
+	}
+
+	for (int32 i = 0; i < m_pendingCount; ++i)
+	{
+		m_proxies[m_pending[i]].state = e_sorted;
+	}
+
+	m_entryCount = liveCount + m_pendingCount;
+	m_pendingCount = 0;
+	m_staleCount = 0;
+}
+
+// The sorted entries on an axis that might overlap [lower, upper]. The largest
+// extent is padded by the slop, so rounding never drops an entry.
+void b2SweepAndPrune::FindRange(int32 axis, float lower, float upper, int32* begin, int32* end) const
+{
+	const b2SweepEntry* entries = m_axes[axis];
+
+	lower = lower - m_maxExtent[axis] - b2_linearSlop;
+	*begin = int32(std::lower_bound(entries, entries + m_entryCount, lower,
+		[axis](const b2SweepEntry& entry, float value) { return entry.aabb.lowerBound(axis) < value; }) - entries);
+
+	*end = int32(std::upper_bound(entries + *begin, entries + m_entryCount, upper,
+		[axis](float value, const b2SweepEntry& entry) { return value < entry.aabb.lowerBound(axis); }) - entries);
+}
+
+// Picks the axis with the fewest sorted entries to scan. Returns -1 when there
+// are none.
+int32 b2SweepAndPrune::ChooseAxis(const b2AABB& aabb, int32* begin, int32* end) const
+{
+	if (m_entryCount == 0)
+	{
+		return -1;
+	}
+
+	int32 beginX, endX, beginY, endY;
+	FindRange(0, aabb.lowerBound.x, aabb.upperBound.x, &beginX, &endX);
+	FindRange(1, aabb.lowerBound.y, aabb.upperBound.y, &beginY, &endY);
+
+	if (endX - beginX <= endY - beginY)
+	{
+		*begin = beginX;
+		*end = endX;
+		return 0;
+	}
+
+	*begin = beginY;
+	*end = endY;
+	return 1;
+}
+
+void b2SweepAndPrune::ShiftOrigin(const b2Vec2& newOrigin)
+{
+	// Shifting keeps the order on both axes.
+	for (int32 i = 0; i < m_proxyCapacity; ++i)
+	{
+		if (m_proxies[i].state == e_free)
+		{
+			continue;
+		}
+
+		m_proxies[i].aabb.lowerBound -= newOrigin;
+		m_proxies[i].aabb.upperBound -= newOrigin;
+	}
+
+	// Removed entries are inside out, shifting keeps them that way.
+	for (int32 axis = 0; axis < 2; ++axis)
+	{
+		for (int32 i = 0; i < m_entryCount; ++i)
+		{
+			m_axes[axis][i].aabb.lowerBound -= newOrigin;
+			m_axes[axis][i].aabb.upperBound -= newOrigin;
+		}
+	}
+}
@@ -165,13 +165,17 @@ b2Contact::b2Contact(b2Fixture* fA, int32 indexA, b2Fixture* fB, int32 indexB)
 // Note: do not assume the fixture AABBs are overlapping or are valid.
 void b2Contact::Update(b2ContactListener* listener)
 {
-	b2Manifold oldManifold = m_manifold;
+	b2Manifold oldManifold;
+	bool touching = UpdateManifold(&oldManifold);
+	FinishUpdate(listener, oldManifold, touching);
+}
 
-	// Re-enable this contact.
-	m_flags |= e_enabledFlag;
+// Returns whether the fixtures touch.
+bool b2Contact::UpdateManifold(b2Manifold* oldManifold)
+{
+	*oldManifold = m_manifold;
 
 	bool touching = false;
-	bool wasTouching = (m_flags & e_touchingFlag) == e_touchingFlag;
 
 	bool sensorA = m_fixtureA->IsSensor();
 	bool sensorB = m_fixtureB->IsSensor();
@@ -206,9 +210,9 @@ void b2Contact::Update(b2ContactListener* listener)
 			mp2->tangentImpulse = 0.0f;
 			b2ContactID id2 = mp2->id;
 
-			for (int32 j = 0; j < oldManifold.pointCount; ++j)
+			for (int32 j = 0; j < oldManifold->pointCount; ++j)
 			{
-				b2ManifoldPoint* mp1 = oldManifold.points + j;
+				b2ManifoldPoint* mp1 = oldManifold->points + j;
 
 				if (mp1->id.key == id2.key)
 				{
@@ -218,12 +222,24 @@ void b2Contact::Update(b2ContactListener* listener)
 				}
 			}
 		}
+	}
 
-		if (touching != wasTouching)
-		{
-			bodyA->SetAwake(true);
-			bodyB->SetAwake(true);
-		}
+	return touching;
+}
+
+void b2Contact::FinishUpdate(b2ContactListener* listener, const b2Manifold& oldManifold, bool touching)
+{
+	// Re-enable this contact.
+	m_flags |= e_enabledFlag;
+
+	bool wasTouching = (m_flags & e_touchingFlag) == e_touchingFlag;
+
+	bool sensor = m_fixtureA->IsSensor() || m_fixtureB->IsSensor();
+
+	if (sensor == false && touching != wasTouching)
+	{
+		m_fixtureA->GetBody()->SetAwake(true);
+		m_fixtureB->GetBody()->SetAwake(true);
 	}
 
 	if (touching)
@@ -24,8 +24,12 @@
 #include "box2d/b2_contact.h"
 #include "box2d/b2_contact_manager.h"
 #include "box2d/b2_fixture.h"
+#include "box2d/b2_task.h"
 #include "box2d/b2_world_callbacks.h"
 
+#include <stdint.h>
+#include <string.h>
+
 b2ContactFilter b2_defaultFilter;
 b2ContactListener b2_defaultListener;
 
@@ -36,6 +40,173 @@ b2ContactManager::b2ContactManager()
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
 	m_allocator = nullptr;
+
+	m_taskExecutor = nullptr;
+	m_collideEntries = nullptr;
+	m_collideCapacity = 0;
+}
+
+b2ContactManager::~b2ContactManager()
+{
+	b2Free(m_collideEntries);
+}
+
+// Hashes a pair of fixture children, the same in either order.
+static uint32 b2HashContactKey(const b2Fixture* fixtureA, int32 indexA, const b2Fixture* fixtureB, int32 indexB)
+{
+	uint64_t a = ((uint64_t)(uintptr_t)fixtureA << 8) ^ (uint64_t)indexA;
+	uint64_t b = ((uint64_t)(uintptr_t)fixtureB << 8) ^ (uint64_t)indexB;
+	if (a > b)
+	{
+		uint64_t t = a;
+		a = b;
+		b = t;
+	}
+
+	uint64_t h = a * 0x9E3779B97F4A7C15ull ^ b;
+	h ^= h >> 32;
+	h *= 0xD6E8FEB86659FD93ull;
+	h ^= h >> 32;
+	return (uint32)h;
+}
+
+static uint32 b2HashContact(const b2Contact* c)
+{
+	return b2HashContactKey(c->GetFixtureA(), c->GetChildIndexA(), c->GetFixtureB(), c->GetChildIndexB());
+}
+
+b2ContactSet::b2ContactSet()
+{
+	m_slots = nullptr;
+	m_capacity = 0;
+	m_count = 0;
+}
+
+b2ContactSet::~b2ContactSet()
+{
+	b2Free(m_slots);
+}
+
+void b2ContactSet::Add(b2Contact* contact)
+{
+	// Keep the load at one half or less, so probes stay short.
+	if (2 * (m_count + 1) > m_capacity)
+	{
+		Grow();
+	}
+
+	uint32 hash = b2HashContact(contact);
+	int32 mask = m_capacity - 1;
+	int32 i = (int32)(hash & (uint32)mask);
+	while (m_slots[i].contact != nullptr)
+	{
+		i = (i + 1) & mask;
+	}
+
+	m_slots[i].contact = contact;
+	m_slots[i].hash = hash;
+	++m_count;
+}
+
+void b2ContactSet::Remove(b2Contact* contact)
+{
+	b2Assert(m_count > 0);
+
+	int32 mask = m_capacity - 1;
+	int32 i = (int32)(b2HashContact(contact) & (uint32)mask);
+	while (m_slots[i].contact != contact)
+	{
+		b2Assert(m_slots[i].contact != nullptr);
+		i = (i + 1) & mask;
+	}
+
+	// Shift later entries of the probe run back into the gap, so no tombstones
+	// are needed. An entry can fill the gap if its home slot isn't between the gap
+	// and where it is now.
+	int32 j = i;
+	for (;;)
+	{
+		j = (j + 1) & mask;
+		if (m_slots[j].contact == nullptr)
+		{
+			break;
+		}
+
+		int32 home = (int32)(m_slots[j].hash & (uint32)mask);
+		bool between = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+		if (between == false)
+		{
+			m_slots[i] = m_slots[j];
+			i = j;
+		}
+	}
+
+	m_slots[i].contact = nullptr;
+	--m_count;
+}
+
+b2Contact* b2ContactSet::Find(const b2Fixture* fixtureA, int32 indexA, const b2Fixture* fixtureB, int32 indexB) const
+{
+	if (m_count == 0)
+	{
+		return nullptr;
+	}
+
+	uint32 hash = b2HashContactKey(fixtureA, indexA, fixtureB, indexB);
+	int32 mask = m_capacity - 1;
+	for (int32 i = (int32)(hash & (uint32)mask); m_slots[i].contact != nullptr; i = (i + 1) & mask)
+	{
+		if (m_slots[i].hash != hash)
+		{
+			continue;
+		}
+
+		b2Contact* c = m_slots[i].contact;
+		const b2Fixture* fA = c->GetFixtureA();
+		const b2Fixture* fB = c->GetFixtureB();
+		int32 iA = c->GetChildIndexA();
+		int32 iB = c->GetChildIndexB();
+
+		if (fA == fixtureA && fB == fixtureB && iA == indexA && iB == indexB)
+		{
+			return c;
+		}
+
+		if (fA == fixtureB && fB == fixtureA && iA == indexB && iB == indexA)
+		{
+			return c;
+		}
+	}
+
+	return nullptr;
+}
+
+void b2ContactSet::Grow()
+{
+	Slot* oldSlots = m_slots;
+	int32 oldCapacity = m_capacity;
+
+	m_capacity = b2Max(2 * m_capacity, 256);
+	m_slots = (Slot*)b2Alloc(m_capacity * sizeof(Slot));
+	memset(m_slots, 0, m_capacity * sizeof(Slot));
+
+	int32 mask = m_capacity - 1;
+	for (int32 k = 0; k < oldCapacity; ++k)
+	{
+		if (oldSlots[k].contact == nullptr)
+		{
+			continue;
+		}
+
+		int32 i = (int32)(oldSlots[k].hash & (uint32)mask);
+		while (m_slots[i].contact != nullptr)
+		{
+			i = (i + 1) & mask;
+		}
+		m_slots[i] = oldSlots[k];
+	}
+
+	b2Free(oldSlots);
 }
 
 void b2ContactManager::Destroy(b2Contact* c)
@@ -51,6 +222,8 @@ void b2ContactManager::Destroy(b2Contact* c)
 	}
 
 	// Remove from the world.
+	m_contactSet.Remove(c);
+
 	if (c->m_prev)
 	{
 		c->m_prev->m_next = c->m_next;
@@ -108,6 +281,14 @@ void b2ContactManager::Destroy(b2Contact* c)
 // contact list.
 void b2ContactManager::Collide()
 {
+	// Below this many contacts the narrow phase isn't worth splitting up.
+	const int32 minParallelContacts = 128;
+	if (m_taskExecutor && m_taskExecutor->GetThreadCount() > 1 && m_contactCount >= minParallelContacts)
+	{
+		CollideParallel();
+		return;
+	}
+
 	// Update awake contacts.
 	b2Contact* c = m_contactList;
 	while (c)
@@ -173,6 +354,145 @@ void b2ContactManager::Collide()
 	}
 }
 
+// Updates the manifolds of a range of collide entries.
+class b2UpdateManifoldsTask : public b2Task
+{
+public:
+	b2UpdateManifoldsTask(b2ContactManager* contactManager)
+		: m_contactManager(contactManager)
+	{
+	}
+
+	void Execute(int32 begin, int32 end, int32 threadIndex) override
+	{
+		B2_NOT_USED(threadIndex);
+		m_contactManager->UpdateManifolds(begin, end);
+	}
+
+private:
+	b2ContactManager* m_contactManager;
+};
+
+// The same as Collide, in three passes. The first sorts the contacts in list order
+// into ones to destroy, skip or update, calling the contact filter as it goes. The
+// second updates the manifolds in parallel. The third walks the entries in list
+// order again, destroying contacts and finishing updates, so bodies wake and the
+// listener hears about contacts in the same order as Collide. A skipped contact
+// whose body was woken by an earlier one is collided right there, as Collide would.
+void b2ContactManager::CollideParallel()
+{
+	if (m_collideCapacity < m_contactCount)
+	{
+		b2Free(m_collideEntries);
+		m_collideCapacity = b2Max(m_contactCount, 2 * m_collideCapacity);
+		m_collideEntries = (b2CollideEntry*)b2Alloc(m_collideCapacity * sizeof(b2CollideEntry));
+	}
+
+	int32 entryCount = 0;
+	for (b2Contact* c = m_contactList; c; c = c->GetNext())
+	{
+		b2CollideEntry* entry = m_collideEntries + entryCount++;
+		entry->contact = c;
+		entry->state = b2CollideEntry::e_update;
+
+		b2Fixture* fixtureA = c->GetFixtureA();
+		b2Fixture* fixtureB = c->GetFixtureB();
+		b2Body* bodyA = fixtureA->GetBody();
+		b2Body* bodyB = fixtureB->GetBody();
+
+		// Is this contact flagged for filtering?
+		if (c->m_flags & b2Contact::e_filterFlag)
+		{
+			// Should these bodies collide? Check user filtering.
+			if (bodyB->ShouldCollide(bodyA) == false ||
+				(m_contactFilter && m_contactFilter->ShouldCollide(fixtureA, fixtureB) == false))
+			{
+				entry->state = b2CollideEntry::e_destroy;
+				continue;
+			}
+
+			// Clear the filtering flag.
+			c->m_flags &= ~b2Contact::e_filterFlag;
+		}
+
+		bool activeA = bodyA->IsAwake() && bodyA->m_type != b2_staticBody;
+		bool activeB = bodyB->IsAwake() && bodyB->m_type != b2_staticBody;
+
+		// At least one body must be awake and it must be dynamic or kinematic.
+		if (activeA == false && activeB == false)
+		{
+			entry->state = b2CollideEntry::e_inactive;
+			continue;
+		}
+
+		int32 proxyIdA = fixtureA->m_proxies[c->GetChildIndexA()].proxyId;
+		int32 proxyIdB = fixtureB->m_proxies[c->GetChildIndexB()].proxyId;
+		if (m_broadPhase.TestOverlap(proxyIdA, proxyIdB) == false)
+		{
+			entry->state = b2CollideEntry::e_destroy;
+		}
+	}
+
+	const int32 minRange = 32;
+	b2UpdateManifoldsTask task(this);
+	m_taskExecutor->ParallelFor(entryCount, minRange, &task);
+
+	for (int32 i = 0; i < entryCount; ++i)
+	{
+		b2CollideEntry* entry = m_collideEntries + i;
+		b2Contact* c = entry->contact;
+
+		switch (entry->state)
+		{
+		case b2CollideEntry::e_destroy:
+			Destroy(c);
+			break;
+
+		case b2CollideEntry::e_update:
+			c->FinishUpdate(m_contactListener, entry->oldManifold, entry->touching);
+			break;
+
+		case b2CollideEntry::e_inactive:
+		{
+			b2Fixture* fixtureA = c->GetFixtureA();
+			b2Fixture* fixtureB = c->GetFixtureB();
+			b2Body* bodyA = fixtureA->GetBody();
+			b2Body* bodyB = fixtureB->GetBody();
+			bool activeA = bodyA->IsAwake() && bodyA->m_type != b2_staticBody;
+			bool activeB = bodyB->IsAwake() && bodyB->m_type != b2_staticBody;
+			if (activeA == false && activeB == false)
+			{
+				break;
+			}
+
+			int32 proxyIdA = fixtureA->m_proxies[c->GetChildIndexA()].proxyId;
+			int32 proxyIdB = fixtureB->m_proxies[c->GetChildIndexB()].proxyId;
+			if (m_broadPhase.TestOverlap(proxyIdA, proxyIdB) == false)
+			{
+				Destroy(c);
+			}
+			else
+			{
+				c->Update(m_contactListener);
+			}
+			break;
+		}
+		}
+	}
+}
+
+void b2ContactManager::UpdateManifolds(int32 begin, int32 end)
+{
+	for (int32 i = begin; i < end; ++i)
+	{
+		b2CollideEntry* entry = m_collideEntries + i;
+		if (entry->state == b2CollideEntry::e_update)
+		{
+			entry->touching = entry->contact->UpdateManifold(&entry->oldManifold);
+		}
+	}
+}
+
 void b2ContactManager::FindNewContacts()
 {
 	m_broadPhase.UpdatePairs(this);
@@ -198,33 +518,10 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 		return;
 	}
 
-	// TODO_ERIN use a hash table to remove a potential bottleneck when both
-	// bodies have a lot of contacts.
 	// Does a contact already exist?
-	b2ContactEdge* edge = bodyB->GetContactList();
-	while (edge)
+	if (m_contactSet.Find(fixtureA, indexA, fixtureB, indexB) != nullptr)
 	{
-		if (edge->other == bodyA)
-		{
-			b2Fixture* fA = edge->contact->GetFixtureA();
-			b2Fixture* fB = edge->contact->GetFixtureB();
-			int32 iA = edge->contact->GetChildIndexA();
-			int32 iB = edge->contact->GetChildIndexB();
-
-			if (fA == fixtureA && fB == fixtureB && iA == indexA && iB == indexB)
-			{
-				// A contact already exists.
-				return;
-			}
-
-			if (fA == fixtureB && fB == fixtureA && iA == indexB && iB == indexA)
-			{
-				// A contact already exists.
-				return;
-			}
-		}
-
-		edge = edge->next;
+		return;
 	}
 
 	// Does a joint override collision? Is at least one body dynamic?
@@ -255,6 +552,8 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 	bodyB = fixtureB->GetBody();
 
 	// Insert into the world.
+	m_contactSet.Add(c);
+
 	c->m_prev = nullptr;
 	c->m_next = m_contactList;
 	if (m_contactList != nullptr)
@@ -25,29 +25,18 @@
 #include "box2d/b2_body.h"
 #include "box2d/b2_contact.h"
 #include "box2d/b2_fixture.h"
+#include "box2d/b2_island.h"
 #include "box2d/b2_stack_allocator.h"
+#include "box2d/b2_task.h"
 #include "box2d/b2_world.h"
 
+#include <string.h>
+
 // Solver debugging is normally disabled because the block solver sometimes has to deal with a poorly conditioned effective mass matrix.
 #define B2_DEBUG_SOLVER 0
 
 B2_API bool g_blockSolve = true;
 
-struct b2ContactPositionConstraint
-{
-	b2Vec2 localPoints[b2_maxManifoldPoints];
-	b2Vec2 localNormal;
-	b2Vec2 localPoint;
-	int32 indexA;
-	int32 indexB;
-	float invMassA, invMassB;
-	b2Vec2 localCenterA, localCenterB;
-	float invIA, invIB;
-	b2Manifold::Type type;
-	float radiusA, radiusB;
-	int32 pointCount;
-};
-
 b2ContactSolver::b2ContactSolver(b2ContactSolverDef* def)
 {
 	m_step = def->step;
@@ -58,6 +47,14 @@ b2ContactSolver::b2ContactSolver(b2ContactSolverDef* def)
 	m_positions = def->positions;
 	m_velocities = def->velocities;
 	m_contacts = def->contacts;
+	m_island = def->island;
+
+	m_colored = false;
+	m_colorConstraints = nullptr;
+	m_wide = false;
+	m_wideVelocityConstraints = nullptr;
+	m_widePositionConstraints = nullptr;
+	m_wideCount = 0;
 
 	// Initialize position independent portions of the constraints.
 	for (int32 i = 0; i < m_count; ++i)
@@ -82,8 +79,8 @@ b2ContactSolver::b2ContactSolver(b2ContactSolverDef* def)
 		vc->restitution = contact->m_restitution;
 		vc->threshold = contact->m_restitutionThreshold;
 		vc->tangentSpeed = contact->m_tangentSpeed;
-		vc->indexA = bodyA->m_islandIndex;
-		vc->indexB = bodyB->m_islandIndex;
+		vc->indexA = def->island->GetIndex(bodyA);
+		vc->indexB = def->island->GetIndex(bodyB);
 		vc->invMassA = bodyA->m_invMass;
 		vc->invMassB = bodyB->m_invMass;
 		vc->invIA = bodyA->m_invI;
@@ -94,8 +91,8 @@ b2ContactSolver::b2ContactSolver(b2ContactSolverDef* def)
 		vc->normalMass.SetZero();
 
 		b2ContactPositionConstraint* pc = m_positionConstraints + i;
-		pc->indexA = bodyA->m_islandIndex;
-		pc->indexB = bodyB->m_islandIndex;
+		pc->indexA = vc->indexA;
+		pc->indexB = vc->indexB;
 		pc->invMassA = bodyA->m_invMass;
 		pc->invMassB = bodyB->m_invMass;
 		pc->localCenterA = bodyA->m_sweep.localCenter;
@@ -138,6 +135,17 @@ b2ContactSolver::b2ContactSolver(b2ContactSolverDef* def)
 
 b2ContactSolver::~b2ContactSolver()
 {
+	if (m_wide)
+	{
+		m_allocator->Free(m_widePositionConstraints);
+		m_allocator->Free(m_wideVelocityConstraints);
+	}
+
+	if (m_colored)
+	{
+		m_allocator->Free(m_colorConstraints);
+	}
+
 	m_allocator->Free(m_velocityConstraints);
 	m_allocator->Free(m_positionConstraints);
 }
@@ -252,75 +260,330 @@ void b2ContactSolver::InitializeVelocityConstraints()
 			}
 		}
 	}
+
+	if (m_colored == false)
+	{
+		if (m_step.wideSolving)
+		{
+			InitializeWideConstraints();
+		}
+		else if (m_step.colorSolving && m_count >= b2_minColoredConstraints)
+		{
+			ColorConstraints();
+		}
+	}
 }
 
-void b2ContactSolver::WarmStart()
+// Sorts the constraints into colors, first fit. Only dynamic bodies are counted, the
+// others are read but never written. Within a color, constraints using the block
+// solver come first, so at most one wide group per color mixes the two. Order is
+// otherwise kept, so the solve order only depends on the island.
+void b2ContactSolver::ColorConstraints()
 {
-	// Warm start.
+	m_colorConstraints = (int32*)m_allocator->Allocate(m_count * sizeof(int32));
+	m_colored = true;
+
+	// Colors each dynamic body is in, one bit per color.
+	int32 bodyCount = m_island->m_bodyCount;
+	uint32* bodyColors = (uint32*)m_allocator->Allocate(bodyCount * sizeof(uint32));
+	memset(bodyColors, 0, bodyCount * sizeof(uint32));
+	int32* colors = (int32*)m_allocator->Allocate(m_count * sizeof(int32));
+
+	// The overflow is counted as the last color.
+	int32 counts[b2_graphColorCount + 1][2] = {};
 	for (int32 i = 0; i < m_count; ++i)
 	{
-		b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+		const b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+		bool dynamicA = m_island->m_bodies[vc->indexA]->m_type == b2_dynamicBody;
+		bool dynamicB = m_island->m_bodies[vc->indexB]->m_type == b2_dynamicBody;
 
-		int32 indexA = vc->indexA;
-		int32 indexB = vc->indexB;
-		float mA = vc->invMassA;
-		float iA = vc->invIA;
-		float mB = vc->invMassB;
-		float iB = vc->invIB;
-		int32 pointCount = vc->pointCount;
+		uint32 used = 0;
+		used |= dynamicA ? bodyColors[vc->indexA] : 0;
+		used |= dynamicB ? bodyColors[vc->indexB] : 0;
 
-		b2Vec2 vA = m_velocities[indexA].v;
-		float wA = m_velocities[indexA].w;
-		b2Vec2 vB = m_velocities[indexB].v;
-		float wB = m_velocities[indexB].w;
+		int32 color = 0;
+		while (color < b2_graphColorCount && (used & (1u << color)) != 0)
+		{
+			++color;
+		}
 
-		b2Vec2 normal = vc->normal;
-		b2Vec2 tangent = b2Cross(normal, 1.0f);
+		if (color < b2_graphColorCount)
+		{
+			if (dynamicA)
+			{
+				bodyColors[vc->indexA] |= 1u << color;
+			}
+			if (dynamicB)
+			{
+				bodyColors[vc->indexB] |= 1u << color;
+			}
+		}
 
-		for (int32 j = 0; j < pointCount; ++j)
+		bool block = vc->pointCount == 2 && g_blockSolve;
+		colors[i] = color;
+		++counts[color][block ? 0 : 1];
+	}
+
+	// Where each color's block and non-block constraints start.
+	int32 starts[b2_graphColorCount + 1][2];
+	int32 start = 0;
+	for (int32 color = 0; color <= b2_graphColorCount; ++color)
+	{
+		m_colorStarts[color] = start;
+		starts[color][0] = start;
+		starts[color][1] = start + counts[color][0];
+		start += counts[color][0] + counts[color][1];
+	}
+
+	for (int32 i = 0; i < m_count; ++i)
+	{
+		bool block = m_velocityConstraints[i].pointCount == 2 && g_blockSolve;
+		m_colorConstraints[starts[colors[i]][block ? 0 : 1]++] = i;
+	}
+
+	m_allocator->Free(colors);
+	m_allocator->Free(bodyColors);
+}
+
+// Fewest constraints, or wide groups, a thread takes from a color. Smaller ranges cost
+// more to hand out than to solve.
+static const int32 b2_minColorRange = 32;
+static const int32 b2_minWideColorRange = 8;
+
+// Solves a range of one color's constraints, or of its wide groups. Nothing in a
+// color shares a dynamic body, so the ranges can be solved at the same time.
+class b2SolveColorTask : public b2Task
+{
+public:
+	b2SolveColorTask(b2ContactSolver* solver, bool position, float* minSeparations)
+		: m_solver(solver), m_position(position), m_minSeparations(minSeparations), m_start(0)
+	{
+	}
+
+	void Execute(int32 begin, int32 end, int32 threadIndex) override
+	{
+		float minSeparation = 0.0f;
+		for (int32 i = m_start + begin; i < m_start + end; ++i)
 		{
-			b2VelocityConstraintPoint* vcp = vc->points + j;
-			b2Vec2 P = vcp->normalImpulse * normal + vcp->tangentImpulse * tangent;
-			wA -= iA * b2Cross(vcp->rA, P);
-			vA -= mA * P;
-			wB += iB * b2Cross(vcp->rB, P);
-			vB += mB * P;
+			if (m_solver->m_wide)
+			{
+				if (m_position)
+				{
+					minSeparation = b2Min(minSeparation, m_solver->SolvePositionGroup(i));
+				}
+				else
+				{
+					m_solver->SolveVelocityGroup(i);
+				}
+			}
+			else
+			{
+				int32 index = m_solver->m_colorConstraints[i];
+				if (m_position)
+				{
+					minSeparation = b2Min(minSeparation, m_solver->SolveContactPosition(m_solver->m_positionConstraints + index));
+				}
+				else
+				{
+					m_solver->SolveContactVelocity(m_solver->m_velocityConstraints + index);
+				}
+			}
 		}
 
-		m_velocities[indexA].v = vA;
-		m_velocities[indexA].w = wA;
-		m_velocities[indexB].v = vB;
-		m_velocities[indexB].w = wB;
+		if (m_position)
+		{
+			m_minSeparations[threadIndex] = b2Min(m_minSeparations[threadIndex], minSeparation);
+		}
 	}
+
+	b2ContactSolver* m_solver;
+	bool m_position;
+	float* m_minSeparations;
+	int32 m_start;
+};
+
+// Solves the colors one after the other, then the overflow. Returns the smallest
+// separation when solving positions, or zero if none is smaller.
+float b2ContactSolver::SolveColors(bool position)
+{
+	b2TaskExecutor* executor = m_island->m_taskExecutor;
+	int32 threadCount = executor ? executor->GetThreadCount() : 1;
+
+	// Each thread tracks its own smallest separation.
+	float* minSeparations = nullptr;
+	if (position)
+	{
+		minSeparations = (float*)m_allocator->Allocate(threadCount * sizeof(float));
+		for (int32 i = 0; i < threadCount; ++i)
+		{
+			minSeparations[i] = 0.0f;
+		}
+	}
+
+	b2SolveColorTask task(this, position, minSeparations);
+	const int32* starts = m_wide ? m_wideColorStarts : m_colorStarts;
+	for (int32 color = 0; color < b2_graphColorCount; ++color)
+	{
+		int32 count = starts[color + 1] - starts[color];
+		if (count == 0)
+		{
+			continue;
+		}
+
+		task.m_start = starts[color];
+		if (executor)
+		{
+			executor->ParallelFor(count, m_wide ? b2_minWideColorRange : b2_minColorRange, &task);
+		}
+		else
+		{
+			task.Execute(0, count, 0);
+		}
+	}
+
+	float minSeparation = 0.0f;
+	if (position)
+	{
+		for (int32 i = 0; i < threadCount; ++i)
+		{
+			minSeparation = b2Min(minSeparation, minSeparations[i]);
+		}
+
+		m_allocator->Free(minSeparations);
+	}
+
+	for (int32 i = m_colorStarts[b2_graphColorCount]; i < m_count; ++i)
+	{
+		int32 index = m_colorConstraints[i];
+		if (position)
+		{
+			minSeparation = b2Min(minSeparation, SolveContactPosition(m_positionConstraints + index));
+		}
+		else
+		{
+			SolveContactVelocity(m_velocityConstraints + index);
+		}
+	}
+
+	return minSeparation;
+}
+
+void b2ContactSolver::WarmStart()
+{
+	if (m_wide)
+	{
+		WarmStartWide();
+		return;
+	}
+
+	// Warm start.
+	for (int32 i = 0; i < m_count; ++i)
+	{
+		WarmStartContact(m_velocityConstraints + i);
+	}
+}
+
+void b2ContactSolver::WarmStartContact(b2ContactVelocityConstraint* vc)
+{
+	int32 indexA = vc->indexA;
+	int32 indexB = vc->indexB;
+	float mA = vc->invMassA;
+	float iA = vc->invIA;
+	float mB = vc->invMassB;
+	float iB = vc->invIB;
+	int32 pointCount = vc->pointCount;
+
+	b2Vec2 vA = m_velocities[indexA].v;
+	float wA = m_velocities[indexA].w;
+	b2Vec2 vB = m_velocities[indexB].v;
+	float wB = m_velocities[indexB].w;
+
+	b2Vec2 normal = vc->normal;
+	b2Vec2 tangent = b2Cross(normal, 1.0f);
+
+	for (int32 j = 0; j < pointCount; ++j)
+	{
+		b2VelocityConstraintPoint* vcp = vc->points + j;
+		b2Vec2 P = vcp->normalImpulse * normal + vcp->tangentImpulse * tangent;
+		wA -= iA * b2Cross(vcp->rA, P);
+		vA -= mA * P;
+		wB += iB * b2Cross(vcp->rB, P);
+		vB += mB * P;
+	}
+
+	m_velocities[indexA].v = vA;
+	m_velocities[indexA].w = wA;
+	m_velocities[indexB].v = vB;
+	m_velocities[indexB].w = wB;
 }
 
 void b2ContactSolver::SolveVelocityConstraints()
 {
+	if (m_colored)
+	{
+		SolveColors(false);
+		return;
+	}
+
 	for (int32 i = 0; i < m_count; ++i)
 	{
-		b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+		SolveContactVelocity(m_velocityConstraints + i);
+	}
+}
 
-		int32 indexA = vc->indexA;
-		int32 indexB = vc->indexB;
-		float mA = vc->invMassA;
-		float iA = vc->invIA;
-		float mB = vc->invMassB;
-		float iB = vc->invIB;
-		int32 pointCount = vc->pointCount;
+void b2ContactSolver::SolveContactVelocity(b2ContactVelocityConstraint* vc)
+{
+	int32 indexA = vc->indexA;
+	int32 indexB = vc->indexB;
+	float mA = vc->invMassA;
+	float iA = vc->invIA;
+	float mB = vc->invMassB;
+	float iB = vc->invIB;
+	int32 pointCount = vc->pointCount;
+
+	b2Vec2 vA = m_velocities[indexA].v;
+	float wA = m_velocities[indexA].w;
+	b2Vec2 vB = m_velocities[indexB].v;
+	float wB = m_velocities[indexB].w;
+
+	b2Vec2 normal = vc->normal;
+	b2Vec2 tangent = b2Cross(normal, 1.0f);
+	float friction = vc->friction;
+
+	b2Assert(pointCount == 1 || pointCount == 2);
+
+	// Solve tangent constraints first because non-penetration is more important
+	// than friction.
+	for (int32 j = 0; j < pointCount; ++j)
+	{
+		b2VelocityConstraintPoint* vcp = vc->points + j;
 
-		b2Vec2 vA = m_velocities[indexA].v;
-		float wA = m_velocities[indexA].w;
-		b2Vec2 vB = m_velocities[indexB].v;
-		float wB = m_velocities[indexB].w;
+		// Relative velocity at contact
+		b2Vec2 dv = vB + b2Cross(wB, vcp->rB) - vA - b2Cross(wA, vcp->rA);
 
-		b2Vec2 normal = vc->normal;
-		b2Vec2 tangent = b2Cross(normal, 1.0f);
-		float friction = vc->friction;
+		// Compute tangent force
+		float vt = b2Dot(dv, tangent) - vc->tangentSpeed;
+		float lambda = vcp->tangentMass * (-vt);
 
-		b2Assert(pointCount == 1 || pointCount == 2);
+		// b2Clamp the accumulated force
+		float maxFriction = friction * vcp->normalImpulse;
+		float newImpulse = b2Clamp(vcp->tangentImpulse + lambda, -maxFriction, maxFriction);
+		lambda = newImpulse - vcp->tangentImpulse;
+		vcp->tangentImpulse = newImpulse;
 
-		// Solve tangent constraints first because non-penetration is more important
-		// than friction.
+		// Apply contact impulse
+		b2Vec2 P = lambda * tangent;
+
+		vA -= mA * P;
+		wA -= iA * b2Cross(vcp->rA, P);
+
+		vB += mB * P;
+		wB += iB * b2Cross(vcp->rB, P);
+	}
+
+	// Solve normal constraints
+	if (pointCount == 1 || g_blockSolve == false)
+	{
 		for (int32 j = 0; j < pointCount; ++j)
 		{
 			b2VelocityConstraintPoint* vcp = vc->points + j;
@@ -328,278 +591,255 @@ void b2ContactSolver::SolveVelocityConstraints()
 			// Relative velocity at contact
 			b2Vec2 dv = vB + b2Cross(wB, vcp->rB) - vA - b2Cross(wA, vcp->rA);
 
-			// Compute tangent force
-			float vt = b2Dot(dv, tangent) - vc->tangentSpeed;
-			float lambda = vcp->tangentMass * (-vt);
+			// Compute normal impulse
+			float vn = b2Dot(dv, normal);
+			float lambda = -vcp->normalMass * (vn - vcp->velocityBias);
 
-			// b2Clamp the accumulated force
-			float maxFriction = friction * vcp->normalImpulse;
-			float newImpulse = b2Clamp(vcp->tangentImpulse + lambda, -maxFriction, maxFriction);
-			lambda = newImpulse - vcp->tangentImpulse;
-			vcp->tangentImpulse = newImpulse;
+			// b2Clamp the accumulated impulse
+			float newImpulse = b2Max(vcp->normalImpulse + lambda, 0.0f);
+			lambda = newImpulse - vcp->normalImpulse;
+			vcp->normalImpulse = newImpulse;
 
 			// Apply contact impulse
-			b2Vec2 P = lambda * tangent;
-
+			b2Vec2 P = lambda * normal;
 			vA -= mA * P;
 			wA -= iA * b2Cross(vcp->rA, P);
 
 			vB += mB * P;
 			wB += iB * b2Cross(vcp->rB, P);
 		}
-
-		// Solve normal constraints
-		if (pointCount == 1 || g_blockSolve == false)
-		{
-			for (int32 j = 0; j < pointCount; ++j)
-			{
-				b2VelocityConstraintPoint* vcp = vc->points + j;
-
-				// Relative velocity at contact
-				b2Vec2 dv = vB + b2Cross(wB, vcp->rB) - vA - b2Cross(wA, vcp->rA);
-
-				// Compute normal impulse
-				float vn = b2Dot(dv, normal);
-				float lambda = -vcp->normalMass * (vn - vcp->velocityBias);
-
-				// b2Clamp the accumulated impulse
-				float newImpulse = b2Max(vcp->normalImpulse + lambda, 0.0f);
-				lambda = newImpulse - vcp->normalImpulse;
-				vcp->normalImpulse = newImpulse;
-
-				// Apply contact impulse
-				b2Vec2 P = lambda * normal;
-				vA -= mA * P;
-				wA -= iA * b2Cross(vcp->rA, P);
-
-				vB += mB * P;
-				wB += iB * b2Cross(vcp->rB, P);
-			}
-		}
-		else
+	}
+	else
+	{
+		// Block solver developed in collaboration with Dirk Gregorius (back in 01/07 on Box2D_Lite).
+		// Build the mini LCP for this contact patch
+		//
+		// vn = A * x + b, vn >= 0, x >= 0 and vn_i * x_i = 0 with i = 1..2
+		//
+		// A = J * W * JT and J = ( -n, -r1 x n, n, r2 x n )
+		// b = vn0 - velocityBias
+		//
+		// The system is solved using the "Total enumeration method" (s. Murty). The complementary constraint vn_i * x_i
+		// implies that we must have in any solution either vn_i = 0 or x_i = 0. So for the 2D contact problem the cases
+		// vn1 = 0 and vn2 = 0, x1 = 0 and x2 = 0, x1 = 0 and vn2 = 0, x2 = 0 and vn1 = 0 need to be tested. The first valid
+		// solution that satisfies the problem is chosen.
+		//
+		// In order to account of the accumulated impulse 'a' (because of the iterative nature of the solver which only requires
+		// that the accumulated impulse is clamped and not the incremental impulse) we change the impulse variable (x_i).
+		//
+		// Substitute:
+		//
+		// x = a + d
+		//
+		// a := old total impulse
+		// x := new total impulse
+		// d := incremental impulse
+		//
+		// For the current iteration we extend the formula for the incremental impulse
+		// to compute the new total impulse:
+		//
+		// vn = A * d + b
+		//    = A * (x - a) + b
+		//    = A * x + b - A * a
+		//    = A * x + b'
+		// b' = b - A * a;
+
+		b2VelocityConstraintPoint* cp1 = vc->points + 0;
+		b2VelocityConstraintPoint* cp2 = vc->points + 1;
+
+		b2Vec2 a(cp1->normalImpulse, cp2->normalImpulse);
+		b2Assert(a.x >= 0.0f && a.y >= 0.0f);
+
+		// Relative velocity at contact
+		b2Vec2 dv1 = vB + b2Cross(wB, cp1->rB) - vA - b2Cross(wA, cp1->rA);
+		b2Vec2 dv2 = vB + b2Cross(wB, cp2->rB) - vA - b2Cross(wA, cp2->rA);
+
+		// Compute normal velocity
+		float vn1 = b2Dot(dv1, normal);
+		float vn2 = b2Dot(dv2, normal);
+
+		b2Vec2 b;
+		b.x = vn1 - cp1->velocityBias;
+		b.y = vn2 - cp2->velocityBias;
+
+		// Compute b'
+		b -= b2Mul(vc->K, a);
+
+		const float k_errorTol = 1e-3f;
+		B2_NOT_USED(k_errorTol);
+
+		for (;;)
 		{
-			// Block solver developed in collaboration with Dirk Gregorius (back in 01/07 on Box2D_Lite).
-			// Build the mini LCP for this contact patch
-			//
-			// vn = A * x + b, vn >= 0, x >= 0 and vn_i * x_i = 0 with i = 1..2
-			//
-			// A = J * W * JT and J = ( -n, -r1 x n, n, r2 x n )
-			// b = vn0 - velocityBias
 			//
-			// The system is solved using the "Total enumeration method" (s. Murty). The complementary constraint vn_i * x_i
-			// implies that we must have in any solution either vn_i = 0 or x_i = 0. So for the 2D contact problem the cases
-			// vn1 = 0 and vn2 = 0, x1 = 0 and x2 = 0, x1 = 0 and vn2 = 0, x2 = 0 and vn1 = 0 need to be tested. The first valid
-			// solution that satisfies the problem is chosen.
+			// Case 1: vn = 0
 			//
-			// In order to account of the accumulated impulse 'a' (because of the iterative nature of the solver which only requires
-			// that the accumulated impulse is clamped and not the incremental impulse) we change the impulse variable (x_i).
+			// 0 = A * x + b'
 			//
-			// Substitute:
+			// Solve for x:
 			//
-			// x = a + d
+			// x = - inv(A) * b'
 			//
-			// a := old total impulse
-			// x := new total impulse
-			// d := incremental impulse
-			//
-			// For the current iteration we extend the formula for the incremental impulse
-			// to compute the new total impulse:
-			//
-			// vn = A * d + b
-			//    = A * (x - a) + b
-			//    = A * x + b - A * a
-			//    = A * x + b'
-			// b' = b - A * a;
-
-			b2VelocityConstraintPoint* cp1 = vc->points + 0;
-			b2VelocityConstraintPoint* cp2 = vc->points + 1;
-
-			b2Vec2 a(cp1->normalImpulse, cp2->normalImpulse);
-			b2Assert(a.x >= 0.0f && a.y >= 0.0f);
+			b2Vec2 x = -b2Mul(vc->normalMass, b);
 
-			// Relative velocity at contact
-			b2Vec2 dv1 = vB + b2Cross(wB, cp1->rB) - vA - b2Cross(wA, cp1->rA);
-			b2Vec2 dv2 = vB + b2Cross(wB, cp2->rB) - vA - b2Cross(wA, cp2->rA);
-
-			// Compute normal velocity
-			float vn1 = b2Dot(dv1, normal);
-			float vn2 = b2Dot(dv2, normal);
-
-			b2Vec2 b;
-			b.x = vn1 - cp1->velocityBias;
-			b.y = vn2 - cp2->velocityBias;
-
-			// Compute b'
-			b -= b2Mul(vc->K, a);
-
-			const float k_errorTol = 1e-3f;
-			B2_NOT_USED(k_errorTol);
-
-			for (;;)
+			if (x.x >= 0.0f && x.y >= 0.0f)
 			{
-				//
-				// Case 1: vn = 0
-				//
-				// 0 = A * x + b'
-				//
-				// Solve for x:
-				//
-				// x = - inv(A) * b'
-				//
-				b2Vec2 x = -b2Mul(vc->normalMass, b);
-
-				if (x.x >= 0.0f && x.y >= 0.0f)
-				{
-					// Get the incremental impulse
-					b2Vec2 d = x - a;
+				// Get the incremental impulse
+				b2Vec2 d = x - a;
 
-					// Apply incremental impulse
-					b2Vec2 P1 = d.x * normal;
-					b2Vec2 P2 = d.y * normal;
-					vA -= mA * (P1 + P2);
-					wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
+				// Apply incremental impulse
+				b2Vec2 P1 = d.x * normal;
+				b2Vec2 P2 = d.y * normal;
+				vA -= mA * (P1 + P2);
+				wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
 
-					vB += mB * (P1 + P2);
-					wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
+				vB += mB * (P1 + P2);
+				wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
 
-					// Accumulate
-					cp1->normalImpulse = x.x;
-					cp2->normalImpulse = x.y;
+				// Accumulate
+				cp1->normalImpulse = x.x;
+				cp2->normalImpulse = x.y;
 
 #if B2_DEBUG_SOLVER == 1
-					// Postconditions
-					dv1 = vB + b2Cross(wB, cp1->rB) - vA - b2Cross(wA, cp1->rA);
-					dv2 = vB + b2Cross(wB, cp2->rB) - vA - b2Cross(wA, cp2->rA);
+				// Postconditions
+				dv1 = vB + b2Cross(wB, cp1->rB) - vA - b2Cross(wA, cp1->rA);
+				dv2 = vB + b2Cross(wB, cp2->rB) - vA - b2Cross(wA, cp2->rA);
 
-					// Compute normal velocity
-					vn1 = b2Dot(dv1, normal);
-					vn2 = b2Dot(dv2, normal);
+				// Compute normal velocity
+				vn1 = b2Dot(dv1, normal);
+				vn2 = b2Dot(dv2, normal);
 
-					b2Assert(b2Abs(vn1 - cp1->velocityBias) < k_errorTol);
-					b2Assert(b2Abs(vn2 - cp2->velocityBias) < k_errorTol);
+				b2Assert(b2Abs(vn1 - cp1->velocityBias) < k_errorTol);
+				b2Assert(b2Abs(vn2 - cp2->velocityBias) < k_errorTol);
 #endif
-					break;
-				}
+				break;
+			}
 
-				//
-				// Case 2: vn1 = 0 and x2 = 0
-				//
-				//   0 = a11 * x1 + a12 * 0 + b1'
-				// vn2 = a21 * x1 + a22 * 0 + b2'
-				//
-				x.x = -cp1->normalMass * b.x;
-				x.y = 0.0f;
-				vn1 = 0.0f;
-				vn2 = vc->K.ex.y * x.x + b.y;
-				if (x.x >= 0.0f && vn2 >= 0.0f)
-				{
-					// Get the incremental impulse
-					b2Vec2 d = x - a;
+			//
+			// Case 2: vn1 = 0 and x2 = 0
+			//
+			//   0 = a11 * x1 + a12 * 0 + b1'
+			// vn2 = a21 * x1 + a22 * 0 + b2'
+			//
+			x.x = -cp1->normalMass * b.x;
+			x.y = 0.0f;
+			vn1 = 0.0f;
+			vn2 = vc->K.ex.y * x.x + b.y;
+			if (x.x >= 0.0f && vn2 >= 0.0f)
+			{
+				// Get the incremental impulse
+				b2Vec2 d = x - a;
 
-					// Apply incremental impulse
-					b2Vec2 P1 = d.x * normal;
-					b2Vec2 P2 = d.y * normal;
-					vA -= mA * (P1 + P2);
-					wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
+				// Apply incremental impulse
+				b2Vec2 P1 = d.x * normal;
+				b2Vec2 P2 = d.y * normal;
+				vA -= mA * (P1 + P2);
+				wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
 
-					vB += mB * (P1 + P2);
-					wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
+				vB += mB * (P1 + P2);
+				wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
 
-					// Accumulate
-					cp1->normalImpulse = x.x;
-					cp2->normalImpulse = x.y;
+				// Accumulate
+				cp1->normalImpulse = x.x;
+				cp2->normalImpulse = x.y;
 
 #if B2_DEBUG_SOLVER == 1
-					// Postconditions
-					dv1 = vB + b2Cross(wB, cp1->rB) - vA - b2Cross(wA, cp1->rA);
+				// Postconditions
+				dv1 = vB + b2Cross(wB, cp1->rB) - vA - b2Cross(wA, cp1->rA);
 
-					// Compute normal velocity
-					vn1 = b2Dot(dv1, normal);
+				// Compute normal velocity
+				vn1 = b2Dot(dv1, normal);
 
-					b2Assert(b2Abs(vn1 - cp1->velocityBias) < k_errorTol);
+				b2Assert(b2Abs(vn1 - cp1->velocityBias) < k_errorTol);
 #endif
-					break;
-				}
+				break;
+			}
 
-				//
-				// Case 3: vn2 = 0 and x1 = 0
-				//
-				// vn1 = a11 * 0 + a12 * x2 + b1'
-				//   0 = a21 * 0 + a22 * x2 + b2'
-				//
-				x.x = 0.0f;
-				x.y = -cp2->normalMass * b.y;
-				vn1 = vc->K.ey.x * x.y + b.x;
-				vn2 = 0.0f;
-
-				if (x.y >= 0.0f && vn1 >= 0.0f)
-				{
-					// Resubstitute for the incremental impulse
-					b2Vec2 d = x - a;
+			//
+			// Case 3: vn2 = 0 and x1 = 0
+			//
+			// vn1 = a11 * 0 + a12 * x2 + b1'
+			//   0 = a21 * 0 + a22 * x2 + b2'
+			//
+			x.x = 0.0f;
+			x.y = -cp2->normalMass * b.y;
+			vn1 = vc->K.ey.x * x.y + b.x;
+			vn2 = 0.0f;
 
-					// Apply incremental impulse
-					b2Vec2 P1 = d.x * normal;
-					b2Vec2 P2 = d.y * normal;
-					vA -= mA * (P1 + P2);
-					wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
+			if (x.y >= 0.0f && vn1 >= 0.0f)
+			{
+				// Resubstitute for the incremental impulse
+				b2Vec2 d = x - a;
 
-					vB += mB * (P1 + P2);
-					wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
+				// Apply incremental impulse
+				b2Vec2 P1 = d.x * normal;
+				b2Vec2 P2 = d.y * normal;
+				vA -= mA * (P1 + P2);
+				wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
 
-					// Accumulate
-					cp1->normalImpulse = x.x;
-					cp2->normalImpulse = x.y;
+				vB += mB * (P1 + P2);
+				wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
+
+				// Accumulate
+				cp1->normalImpulse = x.x;
+				cp2->normalImpulse = x.y;
 
 #if B2_DEBUG_SOLVER == 1
-					// Postconditions
-					dv2 = vB + b2Cross(wB, cp2->rB) - vA - b2Cross(wA, cp2->rA);
+				// Postconditions
+				dv2 = vB + b2Cross(wB, cp2->rB) - vA - b2Cross(wA, cp2->rA);
 
-					// Compute normal velocity
-					vn2 = b2Dot(dv2, normal);
+				// Compute normal velocity
+				vn2 = b2Dot(dv2, normal);
 
-					b2Assert(b2Abs(vn2 - cp2->velocityBias) < k_errorTol);
+				b2Assert(b2Abs(vn2 - cp2->velocityBias) < k_errorTol);
 #endif
-					break;
-				}
-
-				//
-				// Case 4: x1 = 0 and x2 = 0
-				//
-				// vn1 = b1
-				// vn2 = b2;
-				x.x = 0.0f;
-				x.y = 0.0f;
-				vn1 = b.x;
-				vn2 = b.y;
-
-				if (vn1 >= 0.0f && vn2 >= 0.0f)
-				{
-					// Resubstitute for the incremental impulse
-					b2Vec2 d = x - a;
+				break;
+			}
 
-					// Apply incremental impulse
-					b2Vec2 P1 = d.x * normal;
-					b2Vec2 P2 = d.y * normal;
-					vA -= mA * (P1 + P2);
-					wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
+			//
+			// Case 4: x1 = 0 and x2 = 0
+			//
+			// vn1 = b1
+			// vn2 = b2;
+			x.x = 0.0f;
+			x.y = 0.0f;
+			vn1 = b.x;
+			vn2 = b.y;
+
+			if (vn1 >= 0.0f && vn2 >= 0.0f)
+			{
+				// Resubstitute for the incremental impulse
+				b2Vec2 d = x - a;
 
-					vB += mB * (P1 + P2);
-					wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
+				// Apply incremental impulse
+				b2Vec2 P1 = d.x * normal;
+				b2Vec2 P2 = d.y * normal;
+				vA -= mA * (P1 + P2);
+				wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
 
-					// Accumulate
-					cp1->normalImpulse = x.x;
-					cp2->normalImpulse = x.y;
+				vB += mB * (P1 + P2);
+				wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
 
-					break;
-				}
+				// Accumulate
+				cp1->normalImpulse = x.x;
+				cp2->normalImpulse = x.y;
 
-				// No solution, give up. This is hit sometimes, but it doesn't seem to matter.
 				break;
 			}
+
+			// No solution, give up. This is hit sometimes, but it doesn't seem to matter.
+			break;
 		}
+	}
 
+	// Bodies that can't move are only read, the threads solving a color may share them.
+	if (mA != 0.0f || iA != 0.0f)
+	{
 		m_velocities[indexA].v = vA;
 		m_velocities[indexA].w = wA;
+	}
+
+	if (mB != 0.0f || iB != 0.0f)
+	{
 		m_velocities[indexB].v = vB;
 		m_velocities[indexB].w = wB;
 	}
@@ -607,6 +847,11 @@ void b2ContactSolver::SolveVelocityConstraints()
 
 void b2ContactSolver::StoreImpulses()
 {
+	if (m_wide)
+	{
+		StoreImpulsesWide();
+	}
+
 	for (int32 i = 0; i < m_count; ++i)
 	{
 		b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
@@ -676,78 +921,100 @@ bool b2ContactSolver::SolvePositionConstraints()
 {
 	float minSeparation = 0.0f;
 
-	for (int32 i = 0; i < m_count; ++i)
+	if (m_colored)
 	{
-		b2ContactPositionConstraint* pc = m_positionConstraints + i;
+		minSeparation = SolveColors(true);
+	}
+	else
+	{
+		for (int32 i = 0; i < m_count; ++i)
+		{
+			minSeparation = b2Min(minSeparation, SolveContactPosition(m_positionConstraints + i));
+		}
+	}
 
-		int32 indexA = pc->indexA;
-		int32 indexB = pc->indexB;
-		b2Vec2 localCenterA = pc->localCenterA;
-		float mA = pc->invMassA;
-		float iA = pc->invIA;
-		b2Vec2 localCenterB = pc->localCenterB;
-		float mB = pc->invMassB;
-		float iB = pc->invIB;
-		int32 pointCount = pc->pointCount;
+	// We can't expect minSpeparation >= -b2_linearSlop because we don't
+	// push the separation above -b2_linearSlop.
+	return minSeparation >= -3.0f * b2_linearSlop;
+}
 
-		b2Vec2 cA = m_positions[indexA].c;
-		float aA = m_positions[indexA].a;
+// Returns the smallest separation of the contact's points, or zero if none is smaller.
+float b2ContactSolver::SolveContactPosition(b2ContactPositionConstraint* pc)
+{
+	float minSeparation = 0.0f;
 
-		b2Vec2 cB = m_positions[indexB].c;
-		float aB = m_positions[indexB].a;
+	int32 indexA = pc->indexA;
+	int32 indexB = pc->indexB;
+	b2Vec2 localCenterA = pc->localCenterA;
+	float mA = pc->invMassA;
+	float iA = pc->invIA;
+	b2Vec2 localCenterB = pc->localCenterB;
+	float mB = pc->invMassB;
+	float iB = pc->invIB;
+	int32 pointCount = pc->pointCount;
 
-		// Solve normal constraints
-		for (int32 j = 0; j < pointCount; ++j)
-		{
-			b2Transform xfA, xfB;
-			xfA.q.Set(aA);
-			xfB.q.Set(aB);
-			xfA.p = cA - b2Mul(xfA.q, localCenterA);
-			xfB.p = cB - b2Mul(xfB.q, localCenterB);
+	b2Vec2 cA = m_positions[indexA].c;
+	float aA = m_positions[indexA].a;
 
-			b2PositionSolverManifold psm;
-			psm.Initialize(pc, xfA, xfB, j);
-			b2Vec2 normal = psm.normal;
+	b2Vec2 cB = m_positions[indexB].c;
+	float aB = m_positions[indexB].a;
 
-			b2Vec2 point = psm.point;
-			float separation = psm.separation;
+	// Solve normal constraints
+	for (int32 j = 0; j < pointCount; ++j)
+	{
+		b2Transform xfA, xfB;
+		xfA.q.Set(aA);
+		xfB.q.Set(aB);
+		xfA.p = cA - b2Mul(xfA.q, localCenterA);
+		xfB.p = cB - b2Mul(xfB.q, localCenterB);
 
-			b2Vec2 rA = point - cA;
-			b2Vec2 rB = point - cB;
+		b2PositionSolverManifold psm;
+		psm.Initialize(pc, xfA, xfB, j);
+		b2Vec2 normal = psm.normal;
 
-			// Track max constraint error.
-			minSeparation = b2Min(minSeparation, separation);
+		b2Vec2 point = psm.point;
+		float separation = psm.separation;
 
-			// Prevent large corrections and allow slop.
-			float C = b2Clamp(b2_baumgarte * (separation + b2_linearSlop), -b2_maxLinearCorrection, 0.0f);
+		b2Vec2 rA = point - cA;
+		b2Vec2 rB = point - cB;
 
-			// Compute the effective mass.
-			float rnA = b2Cross(rA, normal);
-			float rnB = b2Cross(rB, normal);
-			float K = mA + mB + iA * rnA * rnA + iB * rnB * rnB;
+		// Track max constraint error.
+		minSeparation = b2Min(minSeparation, separation);
 
-			// Compute normal impulse
-			float impulse = K > 0.0f ? -C / K : 0.0f;
+		// Prevent large corrections and allow slop.
+		float C = b2Clamp(b2_baumgarte * (separation + b2_linearSlop), -b2_maxLinearCorrection, 0.0f);
 
-			b2Vec2 P = impulse * normal;
+		// Compute the effective mass.
+		float rnA = b2Cross(rA, normal);
+		float rnB = b2Cross(rB, normal);
+		float K = mA + mB + iA * rnA * rnA + iB * rnB * rnB;
 
-			cA -= mA * P;
-			aA -= iA * b2Cross(rA, P);
+		// Compute normal impulse
+		float impulse = K > 0.0f ? -C / K : 0.0f;
 
-			cB += mB * P;
-			aB += iB * b2Cross(rB, P);
-		}
+		b2Vec2 P = impulse * normal;
 
+		cA -= mA * P;
+		aA -= iA * b2Cross(rA, P);
+
+		cB += mB * P;
+		aB += iB * b2Cross(rB, P);
+	}
+
+	// Bodies that can't move are only read, the threads solving a color may share them.
+	if (mA != 0.0f || iA != 0.0f)
+	{
 		m_positions[indexA].c = cA;
 		m_positions[indexA].a = aA;
+	}
 
+	if (mB != 0.0f || iB != 0.0f)
+	{
 		m_positions[indexB].c = cB;
 		m_positions[indexB].a = aB;
 	}
 
-	// We can't expect minSpeparation >= -b2_linearSlop because we don't
-	// push the separation above -b2_linearSlop.
-	return minSeparation >= -3.0f * b2_linearSlop;
+	return minSeparation;
 }
 
 // Sequential position solver for position constraints.
@@ -0,0 +1,786 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// The wide contact solver. It solves the same constraints as the scalar solver in
+// b2_contact_solver.cpp, with the same math, several at a time. Constraints are
+// colored so that no two in a color share a dynamic body, then each color is packed
+// into groups of b2_simdLanes constraints stored as structures of arrays. A group
+// loads its bodies' velocities into SIMD lanes, solves every lane at once and
+// stores them back. Static and kinematic bodies are only read, so any number of
+// lanes may share one. Constraints that don't fit in any color are solved one at a
+// time after the colors. The coloring is b2ContactSolver::ColorConstraints, and the
+// groups of a color are solved together by b2ContactSolver::SolveColors.
+
+#include "box2d/b2_contact_solver.h"
+
+#include "box2d/b2_body.h"
+#include "box2d/b2_island.h"
+#include "box2d/b2_simd.h"
+#include "box2d/b2_stack_allocator.h"
+
+#include <math.h>
+#include <string.h>
+
+extern B2_API bool g_blockSolve;
+
+// How a group's lanes solve their normal constraints.
+enum b2WideBlockMode
+{
+	e_blockNone,	// one point at a time in every lane
+	e_blockAll,		// the block solver in every lane
+	e_blockMixed	// both, each lane keeping the one it uses
+};
+
+struct b2WideVelocityPoint
+{
+	float rAx[b2_simdLanes], rAy[b2_simdLanes];
+	float rBx[b2_simdLanes], rBy[b2_simdLanes];
+	float normalImpulse[b2_simdLanes];
+	float tangentImpulse[b2_simdLanes];
+	float normalMass[b2_simdLanes];
+	float tangentMass[b2_simdLanes];
+	float velocityBias[b2_simdLanes];
+};
+
+// A group of velocity constraints, one per lane. A lane whose constraint has one
+// point has a second point with no mass and no impulse, which never moves a body.
+// Empty lanes have no mass at all.
+struct b2WideVelocityConstraint
+{
+	int32 constraintIndex[b2_simdLanes];	// -1 for an empty lane
+	int32 indexA[b2_simdLanes];
+	int32 indexB[b2_simdLanes];
+	bool writeA[b2_simdLanes];				// only dynamic bodies are stored back
+	bool writeB[b2_simdLanes];
+	b2WideBlockMode blockMode;
+	float block[b2_simdLanes];				// 1 in the lanes using the block solver
+	float invMassA[b2_simdLanes], invMassB[b2_simdLanes];
+	float invIA[b2_simdLanes], invIB[b2_simdLanes];
+	float normalX[b2_simdLanes], normalY[b2_simdLanes];
+	float friction[b2_simdLanes];
+	float tangentSpeed[b2_simdLanes];
+	float k11[b2_simdLanes], k12[b2_simdLanes], k22[b2_simdLanes];
+	float normalMass11[b2_simdLanes], normalMass12[b2_simdLanes];
+	float normalMass21[b2_simdLanes], normalMass22[b2_simdLanes];
+	b2WideVelocityPoint points[b2_maxManifoldPoints];
+};
+
+// The position constraints of the same group. Bodies are those of the velocity
+// constraint group with the same index.
+struct b2WidePositionConstraint
+{
+	float localPointsX[b2_maxManifoldPoints][b2_simdLanes];
+	float localPointsY[b2_maxManifoldPoints][b2_simdLanes];
+	float localNormalX[b2_simdLanes], localNormalY[b2_simdLanes];
+	float localPointX[b2_simdLanes], localPointY[b2_simdLanes];
+	float localCenterAx[b2_simdLanes], localCenterAy[b2_simdLanes];
+	float localCenterBx[b2_simdLanes], localCenterBy[b2_simdLanes];
+	float invMassA[b2_simdLanes], invMassB[b2_simdLanes];
+	float invIA[b2_simdLanes], invIB[b2_simdLanes];
+	float radiusA[b2_simdLanes], radiusB[b2_simdLanes];
+	float circles[b2_simdLanes];	// 1 for b2Manifold::e_circles
+	float faceB[b2_simdLanes];		// 1 for b2Manifold::e_faceB
+	float pointCount[b2_simdLanes];	// 0 for an empty lane
+};
+
+// A body's velocity or position in each lane.
+struct b2WideBody
+{
+	b2FloatW x, y, a;
+};
+
+static inline b2WideBody b2GatherVelocities(const b2Velocity* velocities, const int32* indices)
+{
+	float x[b2_simdLanes], y[b2_simdLanes], w[b2_simdLanes];
+	for (int32 i = 0; i < b2_simdLanes; ++i)
+	{
+		const b2Velocity& v = velocities[indices[i]];
+		x[i] = v.v.x;
+		y[i] = v.v.y;
+		w[i] = v.w;
+	}
+
+	b2WideBody body;
+	body.x = b2LoadW(x);
+	body.y = b2LoadW(y);
+	body.a = b2LoadW(w);
+	return body;
+}
+
+static inline void b2ScatterVelocities(b2Velocity* velocities, const int32* indices, const bool* write, const b2WideBody& body)
+{
+	float x[b2_simdLanes], y[b2_simdLanes], w[b2_simdLanes];
+	b2StoreW(x, body.x);
+	b2StoreW(y, body.y);
+	b2StoreW(w, body.a);
+	for (int32 i = 0; i < b2_simdLanes; ++i)
+	{
+		if (write[i])
+		{
+			b2Velocity& v = velocities[indices[i]];
+			v.v.Set(x[i], y[i]);
+			v.w = w[i];
+		}
+	}
+}
+
+static inline b2WideBody b2GatherPositions(const b2Position* positions, const int32* indices)
+{
+	float x[b2_simdLanes], y[b2_simdLanes], a[b2_simdLanes];
+	for (int32 i = 0; i < b2_simdLanes; ++i)
+	{
+		const b2Position& p = positions[indices[i]];
+		x[i] = p.c.x;
+		y[i] = p.c.y;
+		a[i] = p.a;
+	}
+
+	b2WideBody body;
+	body.x = b2LoadW(x);
+	body.y = b2LoadW(y);
+	body.a = b2LoadW(a);
+	return body;
+}
+
+static inline void b2ScatterPositions(b2Position* positions, const int32* indices, const bool* write, const b2WideBody& body)
+{
+	float x[b2_simdLanes], y[b2_simdLanes], a[b2_simdLanes];
+	b2StoreW(x, body.x);
+	b2StoreW(y, body.y);
+	b2StoreW(a, body.a);
+	for (int32 i = 0; i < b2_simdLanes; ++i)
+	{
+		if (write[i])
+		{
+			b2Position& p = positions[indices[i]];
+			p.c.Set(x[i], y[i]);
+			p.a = a[i];
+		}
+	}
+}
+
+// A rotation in each lane, the same as b2Rot::Set.
+struct b2WideRot
+{
+	b2FloatW s, c;
+};
+
+static inline b2WideRot b2MakeRotW(b2FloatW angle)
+{
+	float a[b2_simdLanes], s[b2_simdLanes], c[b2_simdLanes];
+	b2StoreW(a, angle);
+	for (int32 i = 0; i < b2_simdLanes; ++i)
+	{
+		s[i] = sinf(a[i]);
+		c[i] = cosf(a[i]);
+	}
+
+	b2WideRot q;
+	q.s = b2LoadW(s);
+	q.c = b2LoadW(c);
+	return q;
+}
+
+// Colors the constraints and packs each color into groups, in color order.
+void b2ContactSolver::InitializeWideConstraints()
+{
+	if (m_count < b2_simdLanes)
+	{
+		return;
+	}
+
+	ColorConstraints();
+
+	m_wideCount = 0;
+	for (int32 color = 0; color < b2_graphColorCount; ++color)
+	{
+		int32 colorCount = m_colorStarts[color + 1] - m_colorStarts[color];
+		m_wideColorStarts[color] = m_wideCount;
+		m_wideCount += (colorCount + b2_simdLanes - 1) / b2_simdLanes;
+	}
+	m_wideColorStarts[b2_graphColorCount] = m_wideCount;
+
+	m_wideVelocityConstraints = (b2WideVelocityConstraint*)m_allocator->Allocate(m_wideCount * sizeof(b2WideVelocityConstraint));
+	m_widePositionConstraints = (b2WidePositionConstraint*)m_allocator->Allocate(m_wideCount * sizeof(b2WidePositionConstraint));
+	m_wide = true;
+
+	// Pack the groups, color after color.
+	memset(m_wideVelocityConstraints, 0, m_wideCount * sizeof(b2WideVelocityConstraint));
+	memset(m_widePositionConstraints, 0, m_wideCount * sizeof(b2WidePositionConstraint));
+	for (int32 color = 0; color < b2_graphColorCount; ++color)
+	{
+		int32 orderIndex = m_colorStarts[color];
+		int32 colorEnd = m_colorStarts[color + 1];
+		for (int32 g = m_wideColorStarts[color]; g < m_wideColorStarts[color + 1]; ++g)
+		{
+			b2WideVelocityConstraint* wvc = m_wideVelocityConstraints + g;
+			b2WidePositionConstraint* wpc = m_widePositionConstraints + g;
+
+			int32 blockCount = 0;
+			int32 laneCount = 0;
+			for (int32 lane = 0; lane < b2_simdLanes; ++lane)
+			{
+				if (orderIndex == colorEnd)
+				{
+					// Empty lane. It reads the bodies of the first lane, which no other
+					// group in the color writes, and never writes them.
+					wvc->constraintIndex[lane] = -1;
+					wvc->indexA[lane] = wvc->indexA[0];
+					wvc->indexB[lane] = wvc->indexB[0];
+					continue;
+				}
+
+				int32 i = m_colorConstraints[orderIndex++];
+				const b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+				const b2ContactPositionConstraint* pc = m_positionConstraints + i;
+				++laneCount;
+
+				wvc->constraintIndex[lane] = i;
+				wvc->indexA[lane] = vc->indexA;
+				wvc->indexB[lane] = vc->indexB;
+				wvc->writeA[lane] = m_island->m_bodies[vc->indexA]->m_type == b2_dynamicBody;
+				wvc->writeB[lane] = m_island->m_bodies[vc->indexB]->m_type == b2_dynamicBody;
+				wvc->invMassA[lane] = vc->invMassA;
+				wvc->invMassB[lane] = vc->invMassB;
+				wvc->invIA[lane] = vc->invIA;
+				wvc->invIB[lane] = vc->invIB;
+				wvc->normalX[lane] = vc->normal.x;
+				wvc->normalY[lane] = vc->normal.y;
+				wvc->friction[lane] = vc->friction;
+				wvc->tangentSpeed[lane] = vc->tangentSpeed;
+
+				if (vc->pointCount == 2 && g_blockSolve)
+				{
+					wvc->block[lane] = 1.0f;
+					wvc->k11[lane] = vc->K.ex.x;
+					wvc->k12[lane] = vc->K.ex.y;
+					wvc->k22[lane] = vc->K.ey.y;
+					wvc->normalMass11[lane] = vc->normalMass.ex.x;
+					wvc->normalMass12[lane] = vc->normalMass.ey.x;
+					wvc->normalMass21[lane] = vc->normalMass.ex.y;
+					wvc->normalMass22[lane] = vc->normalMass.ey.y;
+					++blockCount;
+				}
+
+				for (int32 j = 0; j < vc->pointCount; ++j)
+				{
+					const b2VelocityConstraintPoint* vcp = vc->points + j;
+					b2WideVelocityPoint* wp = wvc->points + j;
+					wp->rAx[lane] = vcp->rA.x;
+					wp->rAy[lane] = vcp->rA.y;
+					wp->rBx[lane] = vcp->rB.x;
+					wp->rBy[lane] = vcp->rB.y;
+					wp->normalImpulse[lane] = vcp->normalImpulse;
+					wp->tangentImpulse[lane] = vcp->tangentImpulse;
+					wp->normalMass[lane] = vcp->normalMass;
+					wp->tangentMass[lane] = vcp->tangentMass;
+					wp->velocityBias[lane] = vcp->velocityBias;
+				}
+
+				for (int32 j = 0; j < pc->pointCount; ++j)
+				{
+					wpc->localPointsX[j][lane] = pc->localPoints[j].x;
+					wpc->localPointsY[j][lane] = pc->localPoints[j].y;
+				}
+				wpc->localNormalX[lane] = pc->localNormal.x;
+				wpc->localNormalY[lane] = pc->localNormal.y;
+				wpc->localPointX[lane] = pc->localPoint.x;
+				wpc->localPointY[lane] = pc->localPoint.y;
+				wpc->localCenterAx[lane] = pc->localCenterA.x;
+				wpc->localCenterAy[lane] = pc->localCenterA.y;
+				wpc->localCenterBx[lane] = pc->localCenterB.x;
+				wpc->localCenterBy[lane] = pc->localCenterB.y;
+				wpc->invMassA[lane] = pc->invMassA;
+				wpc->invMassB[lane] = pc->invMassB;
+				wpc->invIA[lane] = pc->invIA;
+				wpc->invIB[lane] = pc->invIB;
+				wpc->radiusA[lane] = pc->radiusA;
+				wpc->radiusB[lane] = pc->radiusB;
+				wpc->circles[lane] = pc->type == b2Manifold::e_circles ? 1.0f : 0.0f;
+				wpc->faceB[lane] = pc->type == b2Manifold::e_faceB ? 1.0f : 0.0f;
+				wpc->pointCount[lane] = (float)pc->pointCount;
+			}
+
+			if (blockCount == 0)
+			{
+				wvc->blockMode = e_blockNone;
+			}
+			else if (blockCount == laneCount)
+			{
+				wvc->blockMode = e_blockAll;
+			}
+			else
+			{
+				wvc->blockMode = e_blockMixed;
+			}
+		}
+	}
+}
+
+void b2ContactSolver::WarmStartWide()
+{
+	for (int32 g = 0; g < m_wideCount; ++g)
+	{
+		const b2WideVelocityConstraint* wvc = m_wideVelocityConstraints + g;
+
+		b2WideBody bA = b2GatherVelocities(m_velocities, wvc->indexA);
+		b2WideBody bB = b2GatherVelocities(m_velocities, wvc->indexB);
+
+		b2FloatW mA = b2LoadW(wvc->invMassA);
+		b2FloatW iA = b2LoadW(wvc->invIA);
+		b2FloatW mB = b2LoadW(wvc->invMassB);
+		b2FloatW iB = b2LoadW(wvc->invIB);
+
+		// tangent = b2Cross(normal, 1.0f)
+		b2FloatW normalX = b2LoadW(wvc->normalX);
+		b2FloatW normalY = b2LoadW(wvc->normalY);
+		b2FloatW tangentX = normalY;
+		b2FloatW tangentY = b2NegW(normalX);
+
+		for (int32 j = 0; j < b2_maxManifoldPoints; ++j)
+		{
+			const b2WideVelocityPoint* wp = wvc->points + j;
+			b2FloatW rAx = b2LoadW(wp->rAx);
+			b2FloatW rAy = b2LoadW(wp->rAy);
+			b2FloatW rBx = b2LoadW(wp->rBx);
+			b2FloatW rBy = b2LoadW(wp->rBy);
+			b2FloatW normalImpulse = b2LoadW(wp->normalImpulse);
+			b2FloatW tangentImpulse = b2LoadW(wp->tangentImpulse);
+
+			b2FloatW Px = b2AddW(b2MulW(normalImpulse, normalX), b2MulW(tangentImpulse, tangentX));
+			b2FloatW Py = b2AddW(b2MulW(normalImpulse, normalY), b2MulW(tangentImpulse, tangentY));
+			bA.a = b2SubW(bA.a, b2MulW(iA, b2CrossW(rAx, rAy, Px, Py)));
+			bA.x = b2SubW(bA.x, b2MulW(mA, Px));
+			bA.y = b2SubW(bA.y, b2MulW(mA, Py));
+			bB.a = b2AddW(bB.a, b2MulW(iB, b2CrossW(rBx, rBy, Px, Py)));
+			bB.x = b2AddW(bB.x, b2MulW(mB, Px));
+			bB.y = b2AddW(bB.y, b2MulW(mB, Py));
+		}
+
+		b2ScatterVelocities(m_velocities, wvc->indexA, wvc->writeA, bA);
+		b2ScatterVelocities(m_velocities, wvc->indexB, wvc->writeB, bB);
+	}
+
+	for (int32 i = m_colorStarts[b2_graphColorCount]; i < m_count; ++i)
+	{
+		WarmStartContact(m_velocityConstraints + m_colorConstraints[i]);
+	}
+}
+
+// Relative velocity at a contact point, vB + b2Cross(wB, rB) - vA - b2Cross(wA, rA).
+static inline void b2RelativeVelocityW(const b2WideBody& bA, const b2WideBody& bB,
+	b2FloatW rAx, b2FloatW rAy, b2FloatW rBx, b2FloatW rBy, b2FloatW* dvx, b2FloatW* dvy)
+{
+	*dvx = b2SubW(b2SubW(b2AddW(bB.x, b2NegW(b2MulW(bB.a, rBy))), bA.x), b2NegW(b2MulW(bA.a, rAy)));
+	*dvy = b2SubW(b2SubW(b2AddW(bB.y, b2MulW(bB.a, rBx)), bA.y), b2MulW(bA.a, rAx));
+}
+
+void b2ContactSolver::SolveVelocityGroup(int32 group)
+{
+	b2WideVelocityConstraint* wvc = m_wideVelocityConstraints + group;
+
+	b2WideBody bA = b2GatherVelocities(m_velocities, wvc->indexA);
+	b2WideBody bB = b2GatherVelocities(m_velocities, wvc->indexB);
+
+	b2FloatW mA = b2LoadW(wvc->invMassA);
+	b2FloatW iA = b2LoadW(wvc->invIA);
+	b2FloatW mB = b2LoadW(wvc->invMassB);
+	b2FloatW iB = b2LoadW(wvc->invIB);
+
+	b2FloatW normalX = b2LoadW(wvc->normalX);
+	b2FloatW normalY = b2LoadW(wvc->normalY);
+	b2FloatW tangentX = normalY;
+	b2FloatW tangentY = b2NegW(normalX);
+	b2FloatW friction = b2LoadW(wvc->friction);
+	b2FloatW tangentSpeed = b2LoadW(wvc->tangentSpeed);
+
+	b2FloatW rAx[b2_maxManifoldPoints], rAy[b2_maxManifoldPoints];
+	b2FloatW rBx[b2_maxManifoldPoints], rBy[b2_maxManifoldPoints];
+	b2FloatW normalImpulse[b2_maxManifoldPoints];
+	for (int32 j = 0; j < b2_maxManifoldPoints; ++j)
+	{
+		const b2WideVelocityPoint* wp = wvc->points + j;
+		rAx[j] = b2LoadW(wp->rAx);
+		rAy[j] = b2LoadW(wp->rAy);
+		rBx[j] = b2LoadW(wp->rBx);
+		rBy[j] = b2LoadW(wp->rBy);
+		normalImpulse[j] = b2LoadW(wp->normalImpulse);
+	}
+
+	// Solve tangent constraints first because non-penetration is more important
+	// than friction.
+	for (int32 j = 0; j < b2_maxManifoldPoints; ++j)
+	{
+		b2WideVelocityPoint* wp = wvc->points + j;
+
+		b2FloatW dvx, dvy;
+		b2RelativeVelocityW(bA, bB, rAx[j], rAy[j], rBx[j], rBy[j], &dvx, &dvy);
+
+		// Compute tangent force
+		b2FloatW vt = b2SubW(b2DotW(dvx, dvy, tangentX, tangentY), tangentSpeed);
+		b2FloatW lambda = b2MulW(b2LoadW(wp->tangentMass), b2NegW(vt));
+
+		// b2Clamp the accumulated force
+		b2FloatW tangentImpulse = b2LoadW(wp->tangentImpulse);
+		b2FloatW maxFriction = b2MulW(friction, normalImpulse[j]);
+		b2FloatW newImpulse = b2MaxW(b2NegW(maxFriction), b2MinW(b2AddW(tangentImpulse, lambda), maxFriction));
+		lambda = b2SubW(newImpulse, tangentImpulse);
+		b2StoreW(wp->tangentImpulse, newImpulse);
+
+		// Apply contact impulse
+		b2FloatW Px = b2MulW(lambda, tangentX);
+		b2FloatW Py = b2MulW(lambda, tangentY);
+
+		bA.x = b2SubW(bA.x, b2MulW(mA, Px));
+		bA.y = b2SubW(bA.y, b2MulW(mA, Py));
+		bA.a = b2SubW(bA.a, b2MulW(iA, b2CrossW(rAx[j], rAy[j], Px, Py)));
+
+		bB.x = b2AddW(bB.x, b2MulW(mB, Px));
+		bB.y = b2AddW(bB.y, b2MulW(mB, Py));
+		bB.a = b2AddW(bB.a, b2MulW(iB, b2CrossW(rBx[j], rBy[j], Px, Py)));
+	}
+
+	// Solve normal constraints. Lanes are solved by both methods when the group
+	// mixes them, each keeping its own result.
+	b2WideBody pointA = bA, pointB = bB;
+	b2FloatW pointImpulse[b2_maxManifoldPoints] = { normalImpulse[0], normalImpulse[1] };
+	if (wvc->blockMode != e_blockAll)
+	{
+		for (int32 j = 0; j < b2_maxManifoldPoints; ++j)
+		{
+			const b2WideVelocityPoint* wp = wvc->points + j;
+
+			b2FloatW dvx, dvy;
+			b2RelativeVelocityW(pointA, pointB, rAx[j], rAy[j], rBx[j], rBy[j], &dvx, &dvy);
+
+			// Compute normal impulse
+			b2FloatW vn = b2DotW(dvx, dvy, normalX, normalY);
+			b2FloatW lambda = b2MulW(b2NegW(b2LoadW(wp->normalMass)), b2SubW(vn, b2LoadW(wp->velocityBias)));
+
+			// b2Clamp the accumulated impulse
+			b2FloatW newImpulse = b2MaxW(b2AddW(pointImpulse[j], lambda), b2ZeroW());
+			lambda = b2SubW(newImpulse, pointImpulse[j]);
+			pointImpulse[j] = newImpulse;
+
+			// Apply contact impulse
+			b2FloatW Px = b2MulW(lambda, normalX);
+			b2FloatW Py = b2MulW(lambda, normalY);
+			pointA.x = b2SubW(pointA.x, b2MulW(mA, Px));
+			pointA.y = b2SubW(pointA.y, b2MulW(mA, Py));
+			pointA.a = b2SubW(pointA.a, b2MulW(iA, b2CrossW(rAx[j], rAy[j], Px, Py)));
+
+			pointB.x = b2AddW(pointB.x, b2MulW(mB, Px));
+			pointB.y = b2AddW(pointB.y, b2MulW(mB, Py));
+			pointB.a = b2AddW(pointB.a, b2MulW(iB, b2CrossW(rBx[j], rBy[j], Px, Py)));
+		}
+	}
+
+	b2WideBody blockA = bA, blockB = bB;
+	b2FloatW blockImpulse[b2_maxManifoldPoints] = { normalImpulse[0], normalImpulse[1] };
+	if (wvc->blockMode != e_blockNone)
+	{
+		// The block solver of SolveContactVelocity, with the four cases tried in
+		// every lane and the first valid one kept. Lanes with no valid case keep
+		// their impulses.
+		const b2WideVelocityPoint* cp1 = wvc->points + 0;
+		const b2WideVelocityPoint* cp2 = wvc->points + 1;
+
+		b2FloatW ax = normalImpulse[0];
+		b2FloatW ay = normalImpulse[1];
+
+		// Relative velocity at contact
+		b2FloatW dv1x, dv1y, dv2x, dv2y;
+		b2RelativeVelocityW(bA, bB, rAx[0], rAy[0], rBx[0], rBy[0], &dv1x, &dv1y);
+		b2RelativeVelocityW(bA, bB, rAx[1], rAy[1], rBx[1], rBy[1], &dv2x, &dv2y);
+
+		// Compute normal velocity
+		b2FloatW vn1 = b2DotW(dv1x, dv1y, normalX, normalY);
+		b2FloatW vn2 = b2DotW(dv2x, dv2y, normalX, normalY);
+
+		b2FloatW bx = b2SubW(vn1, b2LoadW(cp1->velocityBias));
+		b2FloatW by = b2SubW(vn2, b2LoadW(cp2->velocityBias));
+
+		// Compute b'
+		b2FloatW k11 = b2LoadW(wvc->k11);
+		b2FloatW k12 = b2LoadW(wvc->k12);
+		b2FloatW k22 = b2LoadW(wvc->k22);
+		bx = b2SubW(bx, b2AddW(b2MulW(k11, ax), b2MulW(k12, ay)));
+		by = b2SubW(by, b2AddW(b2MulW(k12, ax), b2MulW(k22, ay)));
+
+		b2FloatW zero = b2ZeroW();
+
+		// Case 1: vn = 0
+		b2FloatW x1x = b2NegW(b2AddW(b2MulW(b2LoadW(wvc->normalMass11), bx), b2MulW(b2LoadW(wvc->normalMass12), by)));
+		b2FloatW x1y = b2NegW(b2AddW(b2MulW(b2LoadW(wvc->normalMass21), bx), b2MulW(b2LoadW(wvc->normalMass22), by)));
+		b2FloatW valid1 = b2AndW(b2GreaterEqualW(x1x, zero), b2GreaterEqualW(x1y, zero));
+
+		// Case 2: vn1 = 0 and x2 = 0
+		b2FloatW x2x = b2MulW(b2NegW(b2LoadW(cp1->normalMass)), bx);
+		b2FloatW case2vn2 = b2AddW(b2MulW(k12, x2x), by);
+		b2FloatW valid2 = b2AndW(b2GreaterEqualW(x2x, zero), b2GreaterEqualW(case2vn2, zero));
+
+		// Case 3: vn2 = 0 and x1 = 0
+		b2FloatW x3y = b2MulW(b2NegW(b2LoadW(cp2->normalMass)), by);
+		b2FloatW case3vn1 = b2AddW(b2MulW(k12, x3y), bx);
+		b2FloatW valid3 = b2AndW(b2GreaterEqualW(x3y, zero), b2GreaterEqualW(case3vn1, zero));
+
+		// Case 4: x1 = 0 and x2 = 0
+		b2FloatW valid4 = b2AndW(b2GreaterEqualW(bx, zero), b2GreaterEqualW(by, zero));
+
+		// Pick the first valid case, blending from the last.
+		b2FloatW xx = ax, xy = ay;
+		xx = b2BlendW(xx, zero, valid4);
+		xy = b2BlendW(xy, zero, valid4);
+		xx = b2BlendW(xx, zero, valid3);
+		xy = b2BlendW(xy, x3y, valid3);
+		xx = b2BlendW(xx, x2x, valid2);
+		xy = b2BlendW(xy, zero, valid2);
+		xx = b2BlendW(xx, x1x, valid1);
+		xy = b2BlendW(xy, x1y, valid1);
+
+		// Get the incremental impulse
+		b2FloatW dx = b2SubW(xx, ax);
+		b2FloatW dy = b2SubW(xy, ay);
+
+		// Apply incremental impulse
+		b2FloatW P1x = b2MulW(dx, normalX);
+		b2FloatW P1y = b2MulW(dx, normalY);
+		b2FloatW P2x = b2MulW(dy, normalX);
+		b2FloatW P2y = b2MulW(dy, normalY);
+		blockA.x = b2SubW(blockA.x, b2MulW(mA, b2AddW(P1x, P2x)));
+		blockA.y = b2SubW(blockA.y, b2MulW(mA, b2AddW(P1y, P2y)));
+		blockA.a = b2SubW(blockA.a, b2MulW(iA, b2AddW(b2CrossW(rAx[0], rAy[0], P1x, P1y), b2CrossW(rAx[1], rAy[1], P2x, P2y))));
+
+		blockB.x = b2AddW(blockB.x, b2MulW(mB, b2AddW(P1x, P2x)));
+		blockB.y = b2AddW(blockB.y, b2MulW(mB, b2AddW(P1y, P2y)));
+		blockB.a = b2AddW(blockB.a, b2MulW(iB, b2AddW(b2CrossW(rBx[0], rBy[0], P1x, P1y), b2CrossW(rBx[1], rBy[1], P2x, P2y))));
+
+		// Accumulate
+		blockImpulse[0] = xx;
+		blockImpulse[1] = xy;
+	}
+
+	if (wvc->blockMode == e_blockMixed)
+	{
+		b2FloatW block = b2GreaterW(b2LoadW(wvc->block), b2ZeroW());
+		bA.x = b2BlendW(pointA.x, blockA.x, block);
+		bA.y = b2BlendW(pointA.y, blockA.y, block);
+		bA.a = b2BlendW(pointA.a, blockA.a, block);
+		bB.x = b2BlendW(pointB.x, blockB.x, block);
+		bB.y = b2BlendW(pointB.y, blockB.y, block);
+		bB.a = b2BlendW(pointB.a, blockB.a, block);
+		normalImpulse[0] = b2BlendW(pointImpulse[0], blockImpulse[0], block);
+		normalImpulse[1] = b2BlendW(pointImpulse[1], blockImpulse[1], block);
+	}
+	else if (wvc->blockMode == e_blockAll)
+	{
+		bA = blockA;
+		bB = blockB;
+		normalImpulse[0] = blockImpulse[0];
+		normalImpulse[1] = blockImpulse[1];
+	}
+	else
+	{
+		bA = pointA;
+		bB = pointB;
+		normalImpulse[0] = pointImpulse[0];
+		normalImpulse[1] = pointImpulse[1];
+	}
+
+	b2StoreW(wvc->points[0].normalImpulse, normalImpulse[0]);
+	b2StoreW(wvc->points[1].normalImpulse, normalImpulse[1]);
+
+	b2ScatterVelocities(m_velocities, wvc->indexA, wvc->writeA, bA);
+	b2ScatterVelocities(m_velocities, wvc->indexB, wvc->writeB, bB);
+}
+
+// Copies the lanes' impulses back into the velocity constraints, for StoreImpulses
+// and the listener.
+void b2ContactSolver::StoreImpulsesWide()
+{
+	for (int32 g = 0; g < m_wideCount; ++g)
+	{
+		const b2WideVelocityConstraint* wvc = m_wideVelocityConstraints + g;
+		for (int32 lane = 0; lane < b2_simdLanes; ++lane)
+		{
+			int32 i = wvc->constraintIndex[lane];
+			if (i < 0)
+			{
+				continue;
+			}
+
+			b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+			for (int32 j = 0; j < vc->pointCount; ++j)
+			{
+				vc->points[j].normalImpulse = wvc->points[j].normalImpulse[lane];
+				vc->points[j].tangentImpulse = wvc->points[j].tangentImpulse[lane];
+			}
+		}
+	}
+}
+
+// Returns the smallest separation found, or zero if none is smaller.
+float b2ContactSolver::SolvePositionGroup(int32 group)
+{
+	b2FloatW minSeparation = b2ZeroW();
+	b2FloatW zero = b2ZeroW();
+
+	const b2WideVelocityConstraint* wvc = m_wideVelocityConstraints + group;
+	const b2WidePositionConstraint* wpc = m_widePositionConstraints + group;
+
+	b2WideBody bA = b2GatherPositions(m_positions, wvc->indexA);
+	b2WideBody bB = b2GatherPositions(m_positions, wvc->indexB);
+
+	b2FloatW mA = b2LoadW(wpc->invMassA);
+	b2FloatW iA = b2LoadW(wpc->invIA);
+	b2FloatW mB = b2LoadW(wpc->invMassB);
+	b2FloatW iB = b2LoadW(wpc->invIB);
+	b2FloatW localCenterAx = b2LoadW(wpc->localCenterAx);
+	b2FloatW localCenterAy = b2LoadW(wpc->localCenterAy);
+	b2FloatW localCenterBx = b2LoadW(wpc->localCenterBx);
+	b2FloatW localCenterBy = b2LoadW(wpc->localCenterBy);
+	b2FloatW localNormalX = b2LoadW(wpc->localNormalX);
+	b2FloatW localNormalY = b2LoadW(wpc->localNormalY);
+	b2FloatW localPointX = b2LoadW(wpc->localPointX);
+	b2FloatW localPointY = b2LoadW(wpc->localPointY);
+	b2FloatW radiusA = b2LoadW(wpc->radiusA);
+	b2FloatW radiusB = b2LoadW(wpc->radiusB);
+	b2FloatW circles = b2GreaterW(b2LoadW(wpc->circles), zero);
+	b2FloatW faceB = b2GreaterW(b2LoadW(wpc->faceB), zero);
+	b2FloatW pointCount = b2LoadW(wpc->pointCount);
+
+	// Solve normal constraints
+	for (int32 j = 0; j < b2_maxManifoldPoints; ++j)
+	{
+		b2FloatW active = b2GreaterW(pointCount, b2SplatW((float)j));
+
+		b2WideRot qA = b2MakeRotW(bA.a);
+		b2WideRot qB = b2MakeRotW(bB.a);
+
+		// xf.p = c - b2Mul(xf.q, localCenter)
+		b2FloatW pAx = b2SubW(bA.x, b2SubW(b2MulW(qA.c, localCenterAx), b2MulW(qA.s, localCenterAy)));
+		b2FloatW pAy = b2SubW(bA.y, b2AddW(b2MulW(qA.s, localCenterAx), b2MulW(qA.c, localCenterAy)));
+		b2FloatW pBx = b2SubW(bB.x, b2SubW(b2MulW(qB.c, localCenterBx), b2MulW(qB.s, localCenterBy)));
+		b2FloatW pBy = b2SubW(bB.y, b2AddW(b2MulW(qB.s, localCenterBx), b2MulW(qB.c, localCenterBy)));
+
+		// b2PositionSolverManifold. The face cases share their math with the
+		// reference and incident transforms swapped.
+		b2FloatW refS = b2BlendW(qA.s, qB.s, faceB);
+		b2FloatW refC = b2BlendW(qA.c, qB.c, faceB);
+		b2FloatW refX = b2BlendW(pAx, pBx, faceB);
+		b2FloatW refY = b2BlendW(pAy, pBy, faceB);
+		b2FloatW incS = b2BlendW(qB.s, qA.s, faceB);
+		b2FloatW incC = b2BlendW(qB.c, qA.c, faceB);
+		b2FloatW incX = b2BlendW(pBx, pAx, faceB);
+		b2FloatW incY = b2BlendW(pBy, pAy, faceB);
+
+		b2FloatW localClipX = b2LoadW(wpc->localPointsX[j]);
+		b2FloatW localClipY = b2LoadW(wpc->localPointsY[j]);
+
+		b2FloatW normalX = b2SubW(b2MulW(refC, localNormalX), b2MulW(refS, localNormalY));
+		b2FloatW normalY = b2AddW(b2MulW(refS, localNormalX), b2MulW(refC, localNormalY));
+		b2FloatW planeX = b2AddW(b2SubW(b2MulW(refC, localPointX), b2MulW(refS, localPointY)), refX);
+		b2FloatW planeY = b2AddW(b2AddW(b2MulW(refS, localPointX), b2MulW(refC, localPointY)), refY);
+		b2FloatW clipX = b2AddW(b2SubW(b2MulW(incC, localClipX), b2MulW(incS, localClipY)), incX);
+		b2FloatW clipY = b2AddW(b2AddW(b2MulW(incS, localClipX), b2MulW(incC, localClipY)), incY);
+		b2FloatW separation = b2SubW(b2SubW(b2DotW(b2SubW(clipX, planeX), b2SubW(clipY, planeY), normalX, normalY), radiusA), radiusB);
+		b2FloatW pointX = clipX;
+		b2FloatW pointY = clipY;
+
+		// Ensure normal points from A to B
+		normalX = b2BlendW(normalX, b2NegW(normalX), faceB);
+		normalY = b2BlendW(normalY, b2NegW(normalY), faceB);
+
+		// Circles: from the center of A to the center of B. Circles have one point.
+		{
+			b2FloatW circleAx = b2AddW(b2SubW(b2MulW(qA.c, localPointX), b2MulW(qA.s, localPointY)), pAx);
+			b2FloatW circleAy = b2AddW(b2AddW(b2MulW(qA.s, localPointX), b2MulW(qA.c, localPointY)), pAy);
+			b2FloatW centerX = b2LoadW(wpc->localPointsX[0]);
+			b2FloatW centerY = b2LoadW(wpc->localPointsY[0]);
+			b2FloatW circleBx = b2AddW(b2SubW(b2MulW(qB.c, centerX), b2MulW(qB.s, centerY)), pBx);
+			b2FloatW circleBy = b2AddW(b2AddW(b2MulW(qB.s, centerX), b2MulW(qB.c, centerY)), pBy);
+
+			// b2Vec2::Normalize leaves short vectors as they are.
+			b2FloatW dx = b2SubW(circleBx, circleAx);
+			b2FloatW dy = b2SubW(circleBy, circleAy);
+			b2FloatW length = b2SqrtW(b2DotW(dx, dy, dx, dy));
+			b2FloatW invLength = b2DivW(b2SplatW(1.0f), length);
+			b2FloatW shortVector = b2LessW(length, b2SplatW(b2_epsilon));
+			b2FloatW circleNormalX = b2BlendW(b2MulW(dx, invLength), dx, shortVector);
+			b2FloatW circleNormalY = b2BlendW(b2MulW(dy, invLength), dy, shortVector);
+
+			b2FloatW half = b2SplatW(0.5f);
+			b2FloatW circleSeparation = b2SubW(b2SubW(b2DotW(dx, dy, circleNormalX, circleNormalY), radiusA), radiusB);
+
+			normalX = b2BlendW(normalX, circleNormalX, circles);
+			normalY = b2BlendW(normalY, circleNormalY, circles);
+			pointX = b2BlendW(pointX, b2MulW(half, b2AddW(circleAx, circleBx)), circles);
+			pointY = b2BlendW(pointY, b2MulW(half, b2AddW(circleAy, circleBy)), circles);
+			separation = b2BlendW(separation, circleSeparation, circles);
+		}
+
+		b2FloatW rAx = b2SubW(pointX, bA.x);
+		b2FloatW rAy = b2SubW(pointY, bA.y);
+		b2FloatW rBx = b2SubW(pointX, bB.x);
+		b2FloatW rBy = b2SubW(pointY, bB.y);
+
+		// Track max constraint error.
+		minSeparation = b2MinW(minSeparation, b2BlendW(zero, separation, active));
+
+		// Prevent large corrections and allow slop.
+		b2FloatW C = b2MulW(b2SplatW(b2_baumgarte), b2AddW(separation, b2SplatW(b2_linearSlop)));
+		C = b2MaxW(b2SplatW(-b2_maxLinearCorrection), b2MinW(C, zero));
+
+		// Compute the effective mass.
+		b2FloatW rnA = b2CrossW(rAx, rAy, normalX, normalY);
+		b2FloatW rnB = b2CrossW(rBx, rBy, normalX, normalY);
+		b2FloatW K = b2AddW(b2AddW(b2AddW(mA, mB), b2MulW(b2MulW(iA, rnA), rnA)), b2MulW(b2MulW(iB, rnB), rnB));
+
+		// Compute normal impulse
+		b2FloatW solvable = b2AndW(b2GreaterW(K, zero), active);
+		b2FloatW impulse = b2BlendW(zero, b2DivW(b2NegW(C), K), solvable);
+
+		b2FloatW Px = b2MulW(impulse, normalX);
+		b2FloatW Py = b2MulW(impulse, normalY);
+
+		bA.x = b2SubW(bA.x, b2MulW(mA, Px));
+		bA.y = b2SubW(bA.y, b2MulW(mA, Py));
+		bA.a = b2SubW(bA.a, b2MulW(iA, b2CrossW(rAx, rAy, Px, Py)));
+
+		bB.x = b2AddW(bB.x, b2MulW(mB, Px));
+		bB.y = b2AddW(bB.y, b2MulW(mB, Py));
+		bB.a = b2AddW(bB.a, b2MulW(iB, b2CrossW(rBx, rBy, Px, Py)));
+	}
+
+	b2ScatterPositions(m_positions, wvc->indexA, wvc->writeA, bA);
+	b2ScatterPositions(m_positions, wvc->indexB, wvc->writeB, bB);
+
+	float lanes[b2_simdLanes];
+	b2StoreW(lanes, minSeparation);
+	float result = 0.0f;
+	for (int32 i = 0; i < b2_simdLanes; ++i)
+	{
+		result = b2Min(result, lanes[i]);
+	}
+
+	return result;
+}
@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include "box2d/b2_body.h"
+#include "box2d/b2_island.h"
 #include "box2d/b2_draw.h"
 #include "box2d/b2_distance_joint.h"
 #include "box2d/b2_time_step.h"
@@ -75,8 +76,8 @@ b2DistanceJoint::b2DistanceJoint(const b2DistanceJointDef* def)
 
 void b2DistanceJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexA = m_bodyA->m_islandIndex;
-	m_indexB = m_bodyB->m_islandIndex;
+	m_indexA = data.island->GetIndex(m_bodyA);
+	m_indexB = data.island->GetIndex(m_bodyB);
 	m_localCenterA = m_bodyA->m_sweep.localCenter;
 	m_localCenterB = m_bodyB->m_sweep.localCenter;
 	m_invMassA = m_bodyA->m_invMass;
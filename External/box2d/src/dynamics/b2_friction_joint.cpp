@@ -22,6 +22,7 @@
 
 #include "box2d/b2_friction_joint.h"
 #include "box2d/b2_body.h"
+#include "box2d/b2_island.h"
 #include "box2d/b2_time_step.h"
 
 // Point-to-point constraint
@@ -59,8 +60,8 @@ b2FrictionJoint::b2FrictionJoint(const b2FrictionJointDef* def)
 
 void b2FrictionJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexA = m_bodyA->m_islandIndex;
-	m_indexB = m_bodyB->m_islandIndex;
+	m_indexA = data.island->GetIndex(m_bodyA);
+	m_indexB = data.island->GetIndex(m_bodyB);
 	m_localCenterA = m_bodyA->m_sweep.localCenter;
 	m_localCenterB = m_bodyB->m_sweep.localCenter;
 	m_invMassA = m_bodyA->m_invMass;
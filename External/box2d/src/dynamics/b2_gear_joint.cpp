@@ -24,6 +24,7 @@
 #include "box2d/b2_revolute_joint.h"
 #include "box2d/b2_prismatic_joint.h"
 #include "box2d/b2_body.h"
+#include "box2d/b2_island.h"
 #include "box2d/b2_time_step.h"
 
 // Gear Joint:
@@ -140,10 +141,10 @@ b2GearJoint::b2GearJoint(const b2GearJointDef* def)
 
 void b2GearJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexA = m_bodyA->m_islandIndex;
-	m_indexB = m_bodyB->m_islandIndex;
-	m_indexC = m_bodyC->m_islandIndex;
-	m_indexD = m_bodyD->m_islandIndex;
+	m_indexA = data.island->GetIndex(m_bodyA);
+	m_indexB = data.island->GetIndex(m_bodyB);
+	m_indexC = data.island->GetIndex(m_bodyC);
+	m_indexD = data.island->GetIndex(m_bodyD);
 	m_lcA = m_bodyA->m_sweep.localCenter;
 	m_lcB = m_bodyB->m_sweep.localCenter;
 	m_lcC = m_bodyC->m_sweep.localCenter;
@@ -26,12 +26,15 @@
 #include "box2d/b2_fixture.h"
 #include "box2d/b2_joint.h"
 #include "box2d/b2_stack_allocator.h"
+#include "box2d/b2_task.h"
 #include "box2d/b2_timer.h"
 #include "box2d/b2_world.h"
 
 #include "box2d/b2_island.h"
 #include "box2d/b2_contact_solver.h"
 
+#include <string.h>
+
 /*
 Position Correction Notes
 =========================
@@ -173,11 +176,23 @@ b2Island::b2Island(
 
 	m_velocities = (b2Velocity*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Velocity));
 	m_positions = (b2Position*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Position));
+
+	m_statics = nullptr;
+	m_staticCount = 0;
+	m_staticCapacity = 0;
+
+	m_impulses = nullptr;
+	m_taskExecutor = nullptr;
+	m_jointColors = nullptr;
 }
 
 b2Island::~b2Island()
 {
 	// Warning: the order should reverse the constructor order.
+	if (m_statics)
+	{
+		m_allocator->Free(m_statics);
+	}
 	m_allocator->Free(m_positions);
 	m_allocator->Free(m_velocities);
 	m_allocator->Free(m_joints);
@@ -185,6 +200,13 @@ b2Island::~b2Island()
 	m_allocator->Free(m_bodies);
 }
 
+void b2Island::ReserveStatics(int32 staticCapacity)
+{
+	b2Assert(m_statics == nullptr);
+	m_staticCapacity = staticCapacity;
+	m_statics = (b2IslandStatic*)m_allocator->Allocate(staticCapacity * sizeof(b2IslandStatic));
+}
+
 void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep)
 {
 	b2Timer timer;
@@ -201,9 +223,13 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		b2Vec2 v = b->m_linearVelocity;
 		float w = b->m_angularVelocity;
 
-		// Store positions for continuous collision.
-		b->m_sweep.c0 = b->m_sweep.c;
-		b->m_sweep.a0 = b->m_sweep.a;
+		// Store positions for continuous collision. Static bodies don't move, and may be
+		// in other islands being solved at the same time, so they're left alone.
+		if (b->m_type != b2_staticBody)
+		{
+			b->m_sweep.c0 = b->m_sweep.c;
+			b->m_sweep.a0 = b->m_sweep.a;
+		}
 
 		if (b->m_type == b2_dynamicBody)
 		{
@@ -235,6 +261,7 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	solverData.step = step;
 	solverData.positions = m_positions;
 	solverData.velocities = m_velocities;
+	solverData.island = this;
 
 	// Initialize velocity constraints.
 	b2ContactSolverDef contactSolverDef;
@@ -244,6 +271,7 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
 	contactSolverDef.allocator = m_allocator;
+	contactSolverDef.island = this;
 
 	b2ContactSolver contactSolver(&contactSolverDef);
 	contactSolver.InitializeVelocityConstraints();
@@ -258,15 +286,27 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		m_joints[i]->InitVelocityConstraints(solverData);
 	}
 
+	if (step.colorSolving && m_jointCount >= b2_minColoredConstraints)
+	{
+		ColorJoints();
+	}
+
 	profile->solveInit = timer.GetMilliseconds();
 
 	// Solve velocity constraints
 	timer.Reset();
 	for (int32 i = 0; i < step.velocityIterations; ++i)
 	{
-		for (int32 j = 0; j < m_jointCount; ++j)
+		if (m_jointColors)
+		{
+			SolveJointColors(solverData, false);
+		}
+		else
 		{
-			m_joints[j]->SolveVelocityConstraints(solverData);
+			for (int32 j = 0; j < m_jointCount; ++j)
+			{
+				m_joints[j]->SolveVelocityConstraints(solverData);
+			}
 		}
 
 		contactSolver.SolveVelocityConstraints();
@@ -317,10 +357,17 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		bool contactsOkay = contactSolver.SolvePositionConstraints();
 
 		bool jointsOkay = true;
-		for (int32 j = 0; j < m_jointCount; ++j)
+		if (m_jointColors)
 		{
-			bool jointOkay = m_joints[j]->SolvePositionConstraints(solverData);
-			jointsOkay = jointsOkay && jointOkay;
+			jointsOkay = SolveJointColors(solverData, true);
+		}
+		else
+		{
+			for (int32 j = 0; j < m_jointCount; ++j)
+			{
+				bool jointOkay = m_joints[j]->SolvePositionConstraints(solverData);
+				jointsOkay = jointsOkay && jointOkay;
+			}
 		}
 
 		if (contactsOkay && jointsOkay)
@@ -331,10 +378,21 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		}
 	}
 
+	if (m_jointColors)
+	{
+		m_allocator->Free(m_jointColors);
+		m_jointColors = nullptr;
+	}
+
 	// Copy state buffers back to the bodies
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
 		b2Body* body = m_bodies[i];
+		if (body->m_type == b2_staticBody)
+		{
+			continue;
+		}
+
 		body->m_sweep.c = m_positions[i].c;
 		body->m_sweep.a = m_positions[i].a;
 		body->m_linearVelocity = m_velocities[i].v;
@@ -386,6 +444,169 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	}
 }
 
+// Sorts the joints into colors, first fit. Joints write every body they touch, static
+// ones included, so every body counts. Gear joints reach two more bodies, and go to
+// the overflow.
+void b2Island::ColorJoints()
+{
+	m_jointColors = (int32*)m_allocator->Allocate(m_jointCount * sizeof(int32));
+
+	// Colors each body is in, one bit per color.
+	uint32* bodyColors = (uint32*)m_allocator->Allocate(m_bodyCount * sizeof(uint32));
+	memset(bodyColors, 0, m_bodyCount * sizeof(uint32));
+	int32* colors = (int32*)m_allocator->Allocate(m_jointCount * sizeof(int32));
+
+	// The overflow is counted as the last color.
+	int32 counts[b2_graphColorCount + 1] = {};
+	for (int32 i = 0; i < m_jointCount; ++i)
+	{
+		b2Joint* joint = m_joints[i];
+
+		int32 color = b2_graphColorCount;
+		if (joint->m_type != e_gearJoint)
+		{
+			int32 indexA = GetIndex(joint->m_bodyA);
+			int32 indexB = GetIndex(joint->m_bodyB);
+			uint32 used = bodyColors[indexA] | bodyColors[indexB];
+
+			color = 0;
+			while (color < b2_graphColorCount && (used & (1u << color)) != 0)
+			{
+				++color;
+			}
+
+			if (color < b2_graphColorCount)
+			{
+				bodyColors[indexA] |= 1u << color;
+				bodyColors[indexB] |= 1u << color;
+			}
+		}
+
+		colors[i] = color;
+		++counts[color];
+	}
+
+	int32 starts[b2_graphColorCount + 1];
+	int32 start = 0;
+	for (int32 color = 0; color <= b2_graphColorCount; ++color)
+	{
+		m_jointColorStarts[color] = start;
+		starts[color] = start;
+		start += counts[color];
+	}
+
+	for (int32 i = 0; i < m_jointCount; ++i)
+	{
+		m_jointColors[starts[colors[i]]++] = i;
+	}
+
+	m_allocator->Free(colors);
+	m_allocator->Free(bodyColors);
+}
+
+// Fewest joints a thread takes from a color.
+static const int32 b2_minJointColorRange = 16;
+
+// Solves a range of one color's joints. Nothing in a color shares a body, so the
+// ranges can be solved at the same time.
+class b2SolveJointColorTask : public b2Task
+{
+public:
+	b2SolveJointColorTask(b2Island* island, const b2SolverData& data, bool position, bool* okay)
+		: m_island(island), m_data(data), m_position(position), m_okay(okay), m_start(0)
+	{
+	}
+
+	void Execute(int32 begin, int32 end, int32 threadIndex) override
+	{
+		bool okay = m_island->SolveJointRange(m_data, m_position, m_start + begin, m_start + end);
+		if (m_position)
+		{
+			m_okay[threadIndex] = m_okay[threadIndex] && okay;
+		}
+	}
+
+	b2Island* m_island;
+	const b2SolverData& m_data;
+	bool m_position;
+	bool* m_okay;
+	int32 m_start;
+};
+
+// Solves the joint colors one after the other, then the overflow. Returns whether the
+// joints' position errors are small when solving positions.
+bool b2Island::SolveJointColors(const b2SolverData& data, bool position)
+{
+	int32 threadCount = m_taskExecutor ? m_taskExecutor->GetThreadCount() : 1;
+
+	// Each thread tracks its own result.
+	bool* okay = nullptr;
+	if (position)
+	{
+		okay = (bool*)m_allocator->Allocate(threadCount * sizeof(bool));
+		for (int32 i = 0; i < threadCount; ++i)
+		{
+			okay[i] = true;
+		}
+	}
+
+	b2SolveJointColorTask task(this, data, position, okay);
+	for (int32 color = 0; color < b2_graphColorCount; ++color)
+	{
+		int32 count = m_jointColorStarts[color + 1] - m_jointColorStarts[color];
+		if (count == 0)
+		{
+			continue;
+		}
+
+		task.m_start = m_jointColorStarts[color];
+		if (m_taskExecutor)
+		{
+			m_taskExecutor->ParallelFor(count, b2_minJointColorRange, &task);
+		}
+		else
+		{
+			task.Execute(0, count, 0);
+		}
+	}
+
+	bool jointsOkay = true;
+	if (position)
+	{
+		for (int32 i = 0; i < threadCount; ++i)
+		{
+			jointsOkay = jointsOkay && okay[i];
+		}
+
+		m_allocator->Free(okay);
+	}
+
+	bool overflowOkay = SolveJointRange(data, position, m_jointColorStarts[b2_graphColorCount], m_jointCount);
+	return jointsOkay && overflowOkay;
+}
+
+// Solves the colored joints in [begin, end). Returns whether their position errors
+// are small when solving positions.
+bool b2Island::SolveJointRange(const b2SolverData& data, bool position, int32 begin, int32 end)
+{
+	bool jointsOkay = true;
+	for (int32 i = begin; i < end; ++i)
+	{
+		b2Joint* joint = m_joints[m_jointColors[i]];
+		if (position)
+		{
+			bool jointOkay = joint->SolvePositionConstraints(data);
+			jointsOkay = jointsOkay && jointOkay;
+		}
+		else
+		{
+			joint->SolveVelocityConstraints(data);
+		}
+	}
+
+	return jointsOkay;
+}
+
 void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiIndexB)
 {
 	b2Assert(toiIndexA < m_bodyCount);
@@ -405,6 +626,7 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 	contactSolverDef.contacts = m_contacts;
 	contactSolverDef.count = m_contactCount;
 	contactSolverDef.allocator = m_allocator;
+	contactSolverDef.island = this;
 	contactSolverDef.step = subStep;
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
@@ -520,6 +742,23 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 
 void b2Island::Report(const b2ContactVelocityConstraint* constraints)
 {
+	if (m_impulses)
+	{
+		for (int32 i = 0; i < m_contactCount; ++i)
+		{
+			const b2ContactVelocityConstraint* vc = constraints + i;
+
+			b2ContactImpulse* impulse = m_impulses + i;
+			impulse->count = vc->pointCount;
+			for (int32 j = 0; j < vc->pointCount; ++j)
+			{
+				impulse->normalImpulses[j] = vc->points[j].normalImpulse;
+				impulse->tangentImpulses[j] = vc->points[j].tangentImpulse;
+			}
+		}
+		return;
+	}
+
 	if (m_listener == nullptr)
 	{
 		return;
@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include "box2d/b2_body.h"
+#include "box2d/b2_island.h"
 #include "box2d/b2_mouse_joint.h"
 #include "box2d/b2_time_step.h"
 
@@ -72,7 +73,7 @@ float b2MouseJoint::GetMaxForce() const
 
 void b2MouseJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexB = m_bodyB->m_islandIndex;
+	m_indexB = data.island->GetIndex(m_bodyB);
 	m_localCenterB = m_bodyB->m_sweep.localCenter;
 	m_invMassB = m_bodyB->m_invMass;
 	m_invIB = m_bodyB->m_invI;
@@ -0,0 +1,1061 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "box2d/b2_soft_body.h"
+#include "box2d/b2_block_allocator.h"
+#include "box2d/b2_body.h"
+#include "box2d/b2_broad_phase.h"
+#include "box2d/b2_chain_shape.h"
+#include "box2d/b2_circle_shape.h"
+#include "box2d/b2_contact.h"
+#include "box2d/b2_edge_shape.h"
+#include "box2d/b2_fixture.h"
+#include "box2d/b2_polygon_shape.h"
+#include "box2d/b2_simd.h"
+#include "box2d/b2_time_step.h"
+
+#include <algorithm>
+#include <new>
+#include <string.h>
+
+// A particle rests on a contact whose normal is at least this much up.
+static const float b2_minGroundNormal = 0.7f;
+
+// Grows an array to hold at least count elements, keeping the first used elements.
+template <typename T>
+static void b2GrowArray(T** array, int32* capacity, int32 used, int32 count)
+{
+	if (count <= *capacity)
+	{
+		return;
+	}
+
+	int32 newCapacity = b2Max(count, b2Max(16, 2 * *capacity));
+	T* newArray = (T*)b2Alloc(newCapacity * sizeof(T));
+	if (*array != nullptr)
+	{
+		memcpy(newArray, *array, used * sizeof(T));
+		b2Free(*array);
+	}
+	*array = newArray;
+	*capacity = newCapacity;
+}
+
+// The default contact filter, for filters that have no fixture.
+static bool b2ShouldCollide(const b2Filter& filterA, const b2Filter& filterB)
+{
+	if (filterA.groupIndex == filterB.groupIndex && filterA.groupIndex != 0)
+	{
+		return filterA.groupIndex > 0;
+	}
+
+	return (filterA.maskBits & filterB.categoryBits) != 0 && (filterA.categoryBits & filterB.maskBits) != 0;
+}
+
+// Packs a grid cell into 64 bits. The coordinates are offset so the keys sort by x,
+// then by y.
+static inline uint64 b2CellKey(int32 x, int32 y)
+{
+	return (uint64(uint32(x) ^ 0x80000000u) << 32) | uint64(uint32(y) ^ 0x80000000u);
+}
+
+static inline bool b2CellLess(const b2SoftCell& a, const b2SoftCell& b)
+{
+	return a.key < b.key || (a.key == b.key && a.index < b.index);
+}
+
+b2Vec2 b2SoftBody::GetParticlePosition(int32 index) const
+{
+	b2Assert(0 <= index && index < m_particleCount);
+	const int32 i = m_particleStart + index;
+	return b2Vec2(m_system->m_x[i], m_system->m_y[i]);
+}
+
+b2Vec2 b2SoftBody::GetParticleVelocity(int32 index) const
+{
+	b2Assert(0 <= index && index < m_particleCount);
+	const int32 i = m_particleStart + index;
+	return b2Vec2(m_system->m_vx[i], m_system->m_vy[i]);
+}
+
+b2Vec2 b2SoftBody::GetPosition() const
+{
+	const b2SoftBodySystem* s = m_system;
+	b2Vec2 sum(0.0f, 0.0f);
+	b2Vec2 mean(0.0f, 0.0f);
+	for (int32 i = m_particleStart; i < m_particleStart + m_particleCount; ++i)
+	{
+		mean.x += s->m_x[i];
+		mean.y += s->m_y[i];
+		if (s->m_invMass[i] > 0.0f)
+		{
+			float mass = 1.0f / s->m_invMass[i];
+			sum.x += mass * s->m_x[i];
+			sum.y += mass * s->m_y[i];
+		}
+	}
+
+	// Pinned particles only count when all of them are.
+	if (m_mass > 0.0f)
+	{
+		return (1.0f / m_mass) * sum;
+	}
+	return (1.0f / float(m_particleCount)) * mean;
+}
+
+b2Vec2 b2SoftBody::GetLinearVelocity() const
+{
+	if (m_mass == 0.0f)
+	{
+		return b2Vec2_zero;
+	}
+
+	const b2SoftBodySystem* s = m_system;
+	b2Vec2 sum(0.0f, 0.0f);
+	for (int32 i = m_particleStart; i < m_particleStart + m_particleCount; ++i)
+	{
+		if (s->m_invMass[i] > 0.0f)
+		{
+			float mass = 1.0f / s->m_invMass[i];
+			sum.x += mass * s->m_vx[i];
+			sum.y += mass * s->m_vy[i];
+		}
+	}
+	return (1.0f / m_mass) * sum;
+}
+
+void b2SoftBody::SetLinearVelocity(const b2Vec2& v)
+{
+	const b2Vec2 dv = v - GetLinearVelocity();
+	b2SoftBodySystem* s = m_system;
+	for (int32 i = m_particleStart; i < m_particleStart + m_particleCount; ++i)
+	{
+		s->m_vx[i] += s->m_gravityScale[i] * dv.x;
+		s->m_vy[i] += s->m_gravityScale[i] * dv.y;
+	}
+}
+
+void b2SoftBody::ApplyLinearImpulse(const b2Vec2& impulse)
+{
+	if (m_mass == 0.0f)
+	{
+		return;
+	}
+
+	const b2Vec2 dv = (1.0f / m_mass) * impulse;
+	b2SoftBodySystem* s = m_system;
+	for (int32 i = m_particleStart; i < m_particleStart + m_particleCount; ++i)
+	{
+		s->m_vx[i] += s->m_gravityScale[i] * dv.x;
+		s->m_vy[i] += s->m_gravityScale[i] * dv.y;
+	}
+}
+
+int32 b2SoftBody::GetOutline(b2Vec2* vertices, int32 maxCount, float alpha) const
+{
+	const b2SoftBodySystem* s = m_system;
+	const int32* outline = s->m_outlines + m_outlineStart;
+	const int32 count = b2Min(m_outlineCount, maxCount);
+	if (count < 3)
+	{
+		return 0;
+	}
+
+	for (int32 k = 0; k < count; ++k)
+	{
+		const int32 i = m_particleStart + outline[k];
+		vertices[k].x = (1.0f - alpha) * s->m_x0[i] + alpha * s->m_x[i];
+		vertices[k].y = (1.0f - alpha) * s->m_y0[i] + alpha * s->m_y[i];
+	}
+
+	// Push each vertex out along the normal between its neighbors. The neighbors are
+	// read before they are pushed.
+	const b2Vec2 first = vertices[0];
+	b2Vec2 prev = vertices[count - 1];
+	for (int32 k = 0; k < count; ++k)
+	{
+		const b2Vec2 current = vertices[k];
+		const b2Vec2 next = k + 1 < count ? vertices[k + 1] : first;
+		b2Vec2 normal(next.y - prev.y, prev.x - next.x);
+		normal.Normalize();
+		vertices[k] = current + s->m_radius[m_particleStart + outline[k]] * normal;
+		prev = current;
+	}
+
+	return count;
+}
+
+b2SoftBodySystem::b2SoftBodySystem()
+{
+	m_bodyList = nullptr;
+	m_bodyCount = 0;
+	m_subStepCount = 4;
+
+	m_x = nullptr;
+	m_y = nullptr;
+	m_x0 = nullptr;
+	m_y0 = nullptr;
+	m_px = nullptr;
+	m_py = nullptr;
+	m_vx = nullptr;
+	m_vy = nullptr;
+	m_invMass = nullptr;
+	m_gravityScale = nullptr;
+	m_damping = nullptr;
+	m_radius = nullptr;
+	m_owners = nullptr;
+	m_particleCount = 0;
+	m_particleCapacity = 0;
+
+	m_links = nullptr;
+	m_linkCount = 0;
+	m_linkCapacity = 0;
+
+	m_outlines = nullptr;
+	m_outlineCount = 0;
+	m_outlineCapacity = 0;
+
+	m_candidates = nullptr;
+	m_candidateCount = 0;
+	m_candidateCapacity = 0;
+
+	m_pairs = nullptr;
+	m_pairCount = 0;
+	m_pairCapacity = 0;
+
+	m_cells = nullptr;
+	m_cellCapacity = 0;
+}
+
+b2SoftBodySystem::~b2SoftBodySystem()
+{
+	// The soft bodies are in the world's block allocator, which frees them.
+	b2Free(m_x);
+	b2Free(m_y);
+	b2Free(m_x0);
+	b2Free(m_y0);
+	b2Free(m_px);
+	b2Free(m_py);
+	b2Free(m_vx);
+	b2Free(m_vy);
+	b2Free(m_invMass);
+	b2Free(m_gravityScale);
+	b2Free(m_damping);
+	b2Free(m_radius);
+	b2Free(m_owners);
+	b2Free(m_links);
+	b2Free(m_outlines);
+	b2Free(m_candidates);
+	b2Free(m_pairs);
+	b2Free(m_cells);
+}
+
+// Makes room for this many more particles, links and outline particles.
+void b2SoftBodySystem::Reserve(int32 moreParticles, int32 moreLinks, int32 moreOutlines)
+{
+	const int32 particleCount = m_particleCount + moreParticles;
+	if (particleCount > m_particleCapacity)
+	{
+		// Every particle array shares the capacity.
+		int32 capacity = m_particleCapacity;
+		b2GrowArray(&m_x, &capacity, m_particleCount, particleCount);
+		capacity = m_particleCapacity;
+		b2GrowArray(&m_y, &capacity, m_particleCount, particleCount);
+		capacity = m_particleCapacity;
+		b2GrowArray(&m_x0, &capacity, m_particleCount, particleCount);
+		capacity = m_particleCapacity;
+		b2GrowArray(&m_y0, &capacity, m_particleCount, particleCount);
+		capacity = m_particleCapacity;
+		b2GrowArray(&m_px, &capacity, m_particleCount, particleCount);
+		capacity = m_particleCapacity;
+		b2GrowArray(&m_py, &capacity, m_particleCount, particleCount);
+		capacity = m_particleCapacity;
+		b2GrowArray(&m_vx, &capacity, m_particleCount, particleCount);
+		capacity = m_particleCapacity;
+		b2GrowArray(&m_vy, &capacity, m_particleCount, particleCount);
+		capacity = m_particleCapacity;
+		b2GrowArray(&m_invMass, &capacity, m_particleCount, particleCount);
+		capacity = m_particleCapacity;
+		b2GrowArray(&m_gravityScale, &capacity, m_particleCount, particleCount);
+		capacity = m_particleCapacity;
+		b2GrowArray(&m_damping, &capacity, m_particleCount, particleCount);
+		capacity = m_particleCapacity;
+		b2GrowArray(&m_radius, &capacity, m_particleCount, particleCount);
+		capacity = m_particleCapacity;
+		b2GrowArray(&m_owners, &capacity, m_particleCount, particleCount);
+		m_particleCapacity = capacity;
+	}
+
+	b2GrowArray(&m_links, &m_linkCapacity, m_linkCount, m_linkCount + moreLinks);
+	b2GrowArray(&m_outlines, &m_outlineCapacity, m_outlineCount, m_outlineCount + moreOutlines);
+}
+
+b2SoftBody* b2SoftBodySystem::Create(const b2SoftBodyDef* def, b2BlockAllocator* allocator)
+{
+	b2Assert(def->count > 0);
+	b2Assert(def->outline == nullptr || def->outlineCount >= 3);
+
+	Reserve(def->count, def->linkCount, def->outlineCount);
+
+	void* mem = allocator->Allocate(sizeof(b2SoftBody));
+	b2SoftBody* body = new (mem) b2SoftBody;
+	body->m_system = this;
+	body->m_particleStart = m_particleCount;
+	body->m_particleCount = def->count;
+	body->m_linkStart = m_linkCount;
+	body->m_linkCount = def->linkCount;
+	body->m_outlineStart = m_outlineCount;
+	body->m_outlineCount = def->outlineCount;
+	body->m_candidateStart = 0;
+	body->m_candidateCount = 0;
+	body->m_mass = 0.0f;
+	body->m_friction = def->friction;
+	body->m_filter = def->filter;
+	body->m_groundCount = 0;
+	body->m_groundNormal.Set(0.0f, 1.0f);
+	body->m_userData = def->userData;
+
+	for (int32 k = 0; k < def->count; ++k)
+	{
+		const int32 i = m_particleCount + k;
+		const float mass = def->masses != nullptr ? def->masses[k] : def->mass;
+		b2Assert(mass >= 0.0f);
+
+		m_x[i] = m_x0[i] = m_px[i] = def->position.x + def->positions[k].x;
+		m_y[i] = m_y0[i] = m_py[i] = def->position.y + def->positions[k].y;
+		m_invMass[i] = mass > 0.0f ? 1.0f / mass : 0.0f;
+		m_gravityScale[i] = mass > 0.0f ? 1.0f : 0.0f;
+		m_vx[i] = m_gravityScale[i] * def->linearVelocity.x;
+		m_vy[i] = m_gravityScale[i] * def->linearVelocity.y;
+		m_damping[i] = def->linearDamping;
+		m_radius[i] = def->radii != nullptr ? def->radii[k] : def->radius;
+		m_owners[i] = body;
+		body->m_mass += mass;
+	}
+
+	for (int32 k = 0; k < def->linkCount; ++k)
+	{
+		const int32 a = def->links[2 * k + 0];
+		const int32 b = def->links[2 * k + 1];
+		b2Assert(0 <= a && a < def->count && 0 <= b && b < def->count && a != b);
+
+		b2SoftLink* link = m_links + m_linkCount + k;
+		link->indexA = m_particleCount + a;
+		link->indexB = m_particleCount + b;
+		link->length = b2Distance(def->positions[a], def->positions[b]);
+		link->compliance = def->compliances != nullptr ? def->compliances[k] : def->compliance;
+	}
+
+	// Outlines are kept relative to the body's first particle.
+	for (int32 k = 0; k < def->outlineCount; ++k)
+	{
+		b2Assert(0 <= def->outline[k] && def->outline[k] < def->count);
+		m_outlines[m_outlineCount + k] = def->outline[k];
+	}
+
+	m_particleCount += def->count;
+	m_linkCount += def->linkCount;
+	m_outlineCount += def->outlineCount;
+
+	UpdateBounds(body);
+
+	// Add to the soft body list.
+	body->m_prev = nullptr;
+	body->m_next = m_bodyList;
+	if (m_bodyList)
+	{
+		m_bodyList->m_prev = body;
+	}
+	m_bodyList = body;
+	++m_bodyCount;
+
+	return body;
+}
+
+void b2SoftBodySystem::Destroy(b2SoftBody* body, b2BlockAllocator* allocator)
+{
+	b2Assert(m_bodyCount > 0);
+
+	// Close the gap in each array. Everything after it belongs to later bodies.
+	const int32 particleStart = body->m_particleStart;
+	const int32 particleCount = body->m_particleCount;
+	const int32 particleTail = m_particleCount - particleStart - particleCount;
+	float* floats[] = { m_x, m_y, m_x0, m_y0, m_px, m_py, m_vx, m_vy, m_invMass, m_gravityScale, m_damping, m_radius };
+	for (float* array : floats)
+	{
+		memmove(array + particleStart, array + particleStart + particleCount, particleTail * sizeof(float));
+	}
+	memmove(m_owners + particleStart, m_owners + particleStart + particleCount, particleTail * sizeof(b2SoftBody*));
+	m_particleCount -= particleCount;
+
+	const int32 linkTail = m_linkCount - body->m_linkStart - body->m_linkCount;
+	memmove(m_links + body->m_linkStart, m_links + body->m_linkStart + body->m_linkCount, linkTail * sizeof(b2SoftLink));
+	m_linkCount -= body->m_linkCount;
+	for (int32 i = body->m_linkStart; i < m_linkCount; ++i)
+	{
+		m_links[i].indexA -= particleCount;
+		m_links[i].indexB -= particleCount;
+	}
+
+	const int32 outlineTail = m_outlineCount - body->m_outlineStart - body->m_outlineCount;
+	memmove(m_outlines + body->m_outlineStart, m_outlines + body->m_outlineStart + body->m_outlineCount, outlineTail * sizeof(int32));
+	m_outlineCount -= body->m_outlineCount;
+
+	for (b2SoftBody* b = m_bodyList; b; b = b->m_next)
+	{
+		if (b->m_particleStart > particleStart)
+		{
+			b->m_particleStart -= particleCount;
+			b->m_linkStart -= body->m_linkCount;
+			b->m_outlineStart -= body->m_outlineCount;
+		}
+	}
+
+	// Remove from the soft body list.
+	if (body->m_prev)
+	{
+		body->m_prev->m_next = body->m_next;
+	}
+
+	if (body->m_next)
+	{
+		body->m_next->m_prev = body->m_prev;
+	}
+
+	if (body == m_bodyList)
+	{
+		m_bodyList = body->m_next;
+	}
+
+	--m_bodyCount;
+	body->~b2SoftBody();
+	allocator->Free(body, sizeof(b2SoftBody));
+}
+
+void b2SoftBodySystem::ShiftOrigin(const b2Vec2& newOrigin)
+{
+	for (int32 i = 0; i < m_particleCount; ++i)
+	{
+		m_x[i] -= newOrigin.x;
+		m_y[i] -= newOrigin.y;
+		m_x0[i] -= newOrigin.x;
+		m_y0[i] -= newOrigin.y;
+		m_px[i] -= newOrigin.x;
+		m_py[i] -= newOrigin.y;
+	}
+
+	for (b2SoftBody* b = m_bodyList; b; b = b->m_next)
+	{
+		b->m_aabb.lowerBound -= newOrigin;
+		b->m_aabb.upperBound -= newOrigin;
+	}
+}
+
+// Collects the fixture children a soft body may touch during the step.
+struct b2SoftQueryWrapper
+{
+	bool QueryCallback(int32 proxyId)
+	{
+		b2FixtureProxy* proxy = (b2FixtureProxy*)broadPhase->GetUserData(proxyId);
+		b2Fixture* fixture = proxy->fixture;
+		if (fixture->IsSensor() || b2ShouldCollide(fixture->GetFilterData(), body->m_filter) == false)
+		{
+			return true;
+		}
+
+		// The proxy's AABB is fattened, the child's own is tighter.
+		b2AABB childAABB;
+		fixture->GetShape()->ComputeAABB(&childAABB, fixture->GetBody()->GetTransform(), proxy->childIndex);
+		if (b2TestOverlap(childAABB, aabb))
+		{
+			system->PushCandidate(fixture, proxy->childIndex, childAABB);
+		}
+		return true;
+	}
+
+	const b2BroadPhase* broadPhase;
+	b2SoftBodySystem* system;
+	const b2SoftBody* body;
+	b2AABB aabb;
+};
+
+void b2SoftBodySystem::PushCandidate(b2Fixture* fixture, int32 childIndex, const b2AABB& aabb)
+{
+	b2GrowArray(&m_candidates, &m_candidateCapacity, m_candidateCount, m_candidateCount + 1);
+	b2SoftCandidate* candidate = m_candidates + m_candidateCount;
+	candidate->fixture = fixture;
+	candidate->childIndex = childIndex;
+	candidate->aabb = aabb;
+	++m_candidateCount;
+}
+
+// Queries the broad-phase once, over everywhere the soft body's particles can reach
+// this step.
+void b2SoftBodySystem::FindCandidates(b2SoftBody* body, float dt, const b2Vec2& gravity, const b2BroadPhase* broadPhase)
+{
+	const int32 start = body->m_particleStart;
+	const int32 end = start + body->m_particleCount;
+	const float reach = dt * dt * gravity.Length() + b2_linearSlop;
+
+	const b2FloatW dtW = b2SplatW(dt);
+	b2FloatW lowerX = b2SplatW(b2_maxFloat), lowerY = lowerX;
+	b2FloatW upperX = b2SplatW(-b2_maxFloat), upperY = upperX;
+	int32 i = start;
+	for (; i + b2_simdLanes <= end; i += b2_simdLanes)
+	{
+		const b2FloatW r = b2LoadW(m_radius + i);
+		const b2FloatW x = b2LoadW(m_x + i);
+		const b2FloatW y = b2LoadW(m_y + i);
+		const b2FloatW x1 = b2AddW(x, b2MulW(dtW, b2LoadW(m_vx + i)));
+		const b2FloatW y1 = b2AddW(y, b2MulW(dtW, b2LoadW(m_vy + i)));
+		lowerX = b2MinW(lowerX, b2SubW(b2MinW(x, x1), r));
+		lowerY = b2MinW(lowerY, b2SubW(b2MinW(y, y1), r));
+		upperX = b2MaxW(upperX, b2AddW(b2MaxW(x, x1), r));
+		upperY = b2MaxW(upperY, b2AddW(b2MaxW(y, y1), r));
+	}
+
+	float lanes[4][b2_simdLanes];
+	b2StoreW(lanes[0], lowerX);
+	b2StoreW(lanes[1], lowerY);
+	b2StoreW(lanes[2], upperX);
+	b2StoreW(lanes[3], upperY);
+
+	b2AABB aabb;
+	aabb.lowerBound.Set(b2_maxFloat, b2_maxFloat);
+	aabb.upperBound.Set(-b2_maxFloat, -b2_maxFloat);
+	for (int32 lane = 0; lane < b2_simdLanes; ++lane)
+	{
+		aabb.lowerBound = b2Min(aabb.lowerBound, b2Vec2(lanes[0][lane], lanes[1][lane]));
+		aabb.upperBound = b2Max(aabb.upperBound, b2Vec2(lanes[2][lane], lanes[3][lane]));
+	}
+
+	for (; i < end; ++i)
+	{
+		const b2Vec2 r(m_radius[i], m_radius[i]);
+		const b2Vec2 p(m_x[i], m_y[i]);
+		const b2Vec2 p1 = p + dt * b2Vec2(m_vx[i], m_vy[i]);
+		aabb.lowerBound = b2Min(aabb.lowerBound, b2Min(p, p1) - r);
+		aabb.upperBound = b2Max(aabb.upperBound, b2Max(p, p1) + r);
+	}
+
+	aabb.lowerBound -= b2Vec2(reach, reach);
+	aabb.upperBound += b2Vec2(reach, reach);
+
+	body->m_candidateStart = m_candidateCount;
+
+	b2SoftQueryWrapper wrapper;
+	wrapper.broadPhase = broadPhase;
+	wrapper.system = this;
+	wrapper.body = body;
+	wrapper.aabb = aabb;
+	broadPhase->Query(&wrapper, aabb);
+
+	body->m_candidateCount = m_candidateCount - body->m_candidateStart;
+}
+
+// Finds the particles of different soft bodies that may touch during the step. The
+// particles are sorted into a grid of cells a little bigger than the largest particle.
+// Each run of particles in a cell is tested against itself and against the cells
+// after it, up and to the right, so each pair of cells is visited once.
+void b2SoftBodySystem::FindPairs(float dt)
+{
+	m_pairCount = 0;
+
+	float maxRadius = 0.0f;
+	float maxSpeedSquared = 0.0f;
+	for (int32 i = 0; i < m_particleCount; ++i)
+	{
+		maxRadius = b2Max(maxRadius, m_radius[i]);
+		maxSpeedSquared = b2Max(maxSpeedSquared, m_vx[i] * m_vx[i] + m_vy[i] * m_vy[i]);
+	}
+
+	// Particles closing in faster than this are caught by the next step's pairs.
+	const float margin = b2Min(2.0f * dt * b2Sqrt(maxSpeedSquared), maxRadius) + b2_linearSlop;
+	const float inverseCellSize = 1.0f / (2.0f * maxRadius + margin);
+
+	b2GrowArray(&m_cells, &m_cellCapacity, 0, m_particleCount);
+	for (int32 i = 0; i < m_particleCount; ++i)
+	{
+		const int32 x = int32(floorf(m_x[i] * inverseCellSize));
+		const int32 y = int32(floorf(m_y[i] * inverseCellSize));
+		m_cells[i].key = b2CellKey(x, y);
+		m_cells[i].index = i;
+	}
+	std::sort(m_cells, m_cells + m_particleCount, b2CellLess);
+
+	const b2SoftCell* cells = m_cells;
+	const b2SoftCell* cellsEnd = m_cells + m_particleCount;
+	const b2SoftCell* begin = cells;
+	while (begin != cellsEnd)
+	{
+		const uint64 key = begin->key;
+		const b2SoftCell* end = begin + 1;
+		while (end != cellsEnd && end->key == key)
+		{
+			++end;
+		}
+
+		for (const b2SoftCell* a = begin; a != end; ++a)
+		{
+			for (const b2SoftCell* b = a + 1; b != end; ++b)
+			{
+				TestPair(a->index, b->index, margin);
+			}
+		}
+
+		// The cell above follows this one in the sorted order.
+		const int32 x = int32(floorf(m_x[begin->index] * inverseCellSize));
+		const int32 y = int32(floorf(m_y[begin->index] * inverseCellSize));
+		const uint64 aboveKey = b2CellKey(x, y + 1);
+		const b2SoftCell* above = end;
+		for (; above != cellsEnd && above->key == aboveKey; ++above)
+		{
+			for (const b2SoftCell* a = begin; a != end; ++a)
+			{
+				TestPair(a->index, above->index, margin);
+			}
+		}
+
+		// The three cells to the right are one range of keys.
+		const uint64 lowerKey = b2CellKey(x + 1, y - 1);
+		const uint64 upperKey = b2CellKey(x + 1, y + 1);
+		b2SoftCell lower;
+		lower.key = lowerKey;
+		lower.index = 0;
+		const b2SoftCell* right = std::lower_bound(above, cellsEnd, lower, b2CellLess);
+		for (; right != cellsEnd && right->key <= upperKey; ++right)
+		{
+			for (const b2SoftCell* a = begin; a != end; ++a)
+			{
+				TestPair(a->index, right->index, margin);
+			}
+		}
+
+		begin = end;
+	}
+}
+
+// Keeps two particles as a pair if they are of different soft bodies and close enough.
+void b2SoftBodySystem::TestPair(int32 indexA, int32 indexB, float margin)
+{
+	const b2SoftBody* ownerA = m_owners[indexA];
+	const b2SoftBody* ownerB = m_owners[indexB];
+	if (ownerA == ownerB || m_invMass[indexA] + m_invMass[indexB] == 0.0f)
+	{
+		return;
+	}
+
+	const float reach = m_radius[indexA] + m_radius[indexB] + margin;
+	const float ex = m_x[indexB] - m_x[indexA];
+	const float ey = m_y[indexB] - m_y[indexA];
+	if (ex * ex + ey * ey >= reach * reach || b2ShouldCollide(ownerA->m_filter, ownerB->m_filter) == false)
+	{
+		return;
+	}
+
+	b2GrowArray(&m_pairs, &m_pairCapacity, m_pairCount, m_pairCount + 1);
+	m_pairs[m_pairCount].indexA = indexA;
+	m_pairs[m_pairCount].indexB = indexB;
+	++m_pairCount;
+}
+
+// Moves every particle by its velocity, after gravity, and remembers where it started.
+void b2SoftBodySystem::Integrate(float h, const b2Vec2& gravity)
+{
+	const b2FloatW hW = b2SplatW(h);
+	const b2FloatW gx = b2SplatW(h * gravity.x);
+	const b2FloatW gy = b2SplatW(h * gravity.y);
+
+	int32 i = 0;
+	for (; i + b2_simdLanes <= m_particleCount; i += b2_simdLanes)
+	{
+		const b2FloatW scale = b2LoadW(m_gravityScale + i);
+		const b2FloatW vx = b2AddW(b2LoadW(m_vx + i), b2MulW(scale, gx));
+		const b2FloatW vy = b2AddW(b2LoadW(m_vy + i), b2MulW(scale, gy));
+		const b2FloatW x = b2LoadW(m_x + i);
+		const b2FloatW y = b2LoadW(m_y + i);
+		b2StoreW(m_px + i, x);
+		b2StoreW(m_py + i, y);
+		b2StoreW(m_vx + i, vx);
+		b2StoreW(m_vy + i, vy);
+		b2StoreW(m_x + i, b2AddW(x, b2MulW(hW, vx)));
+		b2StoreW(m_y + i, b2AddW(y, b2MulW(hW, vy)));
+	}
+
+	for (; i < m_particleCount; ++i)
+	{
+		m_vx[i] += m_gravityScale[i] * h * gravity.x;
+		m_vy[i] += m_gravityScale[i] * h * gravity.y;
+		m_px[i] = m_x[i];
+		m_py[i] = m_y[i];
+		m_x[i] += h * m_vx[i];
+		m_y[i] += h * m_vy[i];
+	}
+}
+
+// Pulls each link back toward its rest length. The Lagrange multiplier starts at zero
+// every substep, so one XPBD iteration needs no stored multipliers.
+void b2SoftBodySystem::SolveLinks(float h)
+{
+	const float inverseHSquared = 1.0f / (h * h);
+	for (int32 k = 0; k < m_linkCount; ++k)
+	{
+		const b2SoftLink& link = m_links[k];
+		const int32 a = link.indexA;
+		const int32 b = link.indexB;
+		const float wA = m_invMass[a];
+		const float wB = m_invMass[b];
+		const float w = wA + wB + link.compliance * inverseHSquared;
+		if (w == 0.0f)
+		{
+			continue;
+		}
+
+		const float dx = m_x[b] - m_x[a];
+		const float dy = m_y[b] - m_y[a];
+		const float length = b2Sqrt(dx * dx + dy * dy);
+		if (length < b2_epsilon)
+		{
+			continue;
+		}
+
+		const float s = (length - link.length) / (w * length);
+		m_x[a] += wA * s * dx;
+		m_y[a] += wA * s * dy;
+		m_x[b] -= wB * s * dx;
+		m_y[b] -= wB * s * dy;
+	}
+}
+
+// Pushes overlapping particles of different soft bodies apart, by their masses, and takes
+// off the sliding the friction allows.
+void b2SoftBodySystem::SolvePairs(const b2Vec2& up, bool last)
+{
+	for (int32 k = 0; k < m_pairCount; ++k)
+	{
+		const int32 a = m_pairs[k].indexA;
+		const int32 b = m_pairs[k].indexB;
+		const float dx = m_x[b] - m_x[a];
+		const float dy = m_y[b] - m_y[a];
+		const float radius = m_radius[a] + m_radius[b];
+		const float distanceSquared = dx * dx + dy * dy;
+		if (distanceSquared >= radius * radius || distanceSquared < b2_epsilon * b2_epsilon)
+		{
+			continue;
+		}
+
+		const float distance = b2Sqrt(distanceSquared);
+		const float wA = m_invMass[a];
+		const float wB = m_invMass[b];
+		const float w = wA + wB;
+		const float penetration = radius - distance;
+		const float s = -penetration / (w * distance);
+		m_x[a] += wA * s * dx;
+		m_y[a] += wA * s * dy;
+		m_x[b] -= wB * s * dx;
+		m_y[b] -= wB * s * dy;
+
+		// Friction, on how far the particles slid past each other over the substep.
+		const b2Vec2 n(dx / distance, dy / distance);
+		const b2Vec2 motion(m_x[a] - m_px[a] - m_x[b] + m_px[b], m_y[a] - m_py[a] - m_y[b] + m_py[b]);
+		const b2Vec2 tangent = motion - b2Dot(motion, n) * n;
+		const float slide = tangent.Length();
+		if (slide > 0.0f)
+		{
+			const float friction = b2MixFriction(m_owners[a]->m_friction, m_owners[b]->m_friction);
+			const b2Vec2 t = (b2Min(1.0f, friction * penetration / slide) / w) * tangent;
+			m_x[a] -= wA * t.x;
+			m_y[a] -= wA * t.y;
+			m_x[b] += wB * t.x;
+			m_y[b] += wB * t.y;
+		}
+
+		if (last)
+		{
+			// The normal from b to a.
+			const b2Vec2 normal = -n;
+			const float upness = b2Dot(normal, up);
+			b2SoftBody* body = nullptr;
+			if (upness > b2_minGroundNormal)
+			{
+				body = m_owners[a];
+				body->m_groundNormal = normal;
+			}
+			else if (upness < -b2_minGroundNormal)
+			{
+				body = m_owners[b];
+				body->m_groundNormal = -normal;
+			}
+
+			if (body != nullptr)
+			{
+				++body->m_groundCount;
+			}
+		}
+	}
+}
+
+// Pushes a soft body's particles out of the fixtures it may touch, and takes off the
+// sliding the friction allows. Dynamic bodies get the impulse it took.
+void b2SoftBodySystem::SolveCandidates(b2SoftBody* body, float h, const b2Vec2& up, bool last)
+{
+	if (body->m_candidateCount == 0)
+	{
+		return;
+	}
+
+	const b2SoftCandidate* candidates = m_candidates + body->m_candidateStart;
+	const float inverseH = 1.0f / h;
+
+	b2CircleShape circle;
+	b2Transform xfB;
+	xfB.q.SetIdentity();
+
+	for (int32 i = body->m_particleStart; i < body->m_particleStart + body->m_particleCount; ++i)
+	{
+		if (m_invMass[i] == 0.0f)
+		{
+			continue;
+		}
+
+		circle.m_radius = m_radius[i];
+		b2Vec2 p(m_x[i], m_y[i]);
+		const b2Vec2 p0(m_px[i], m_py[i]);
+
+		for (int32 k = 0; k < body->m_candidateCount; ++k)
+		{
+			const b2SoftCandidate& candidate = candidates[k];
+			if (p.x + circle.m_radius < candidate.aabb.lowerBound.x || candidate.aabb.upperBound.x < p.x - circle.m_radius ||
+				p.y + circle.m_radius < candidate.aabb.lowerBound.y || candidate.aabb.upperBound.y < p.y - circle.m_radius)
+			{
+				continue;
+			}
+
+			const b2Fixture* fixture = candidate.fixture;
+			const b2Shape* shape = fixture->GetShape();
+			b2Body* rigid = candidate.fixture->GetBody();
+			const b2Transform& xfA = rigid->GetTransform();
+			xfB.p = p;
+
+			b2Manifold manifold;
+			switch (shape->GetType())
+			{
+			case b2Shape::e_circle:
+				b2CollideCircles(&manifold, (const b2CircleShape*)shape, xfA, &circle, xfB);
+				break;
+
+			case b2Shape::e_polygon:
+				b2CollidePolygonAndCircle(&manifold, (const b2PolygonShape*)shape, xfA, &circle, xfB);
+				break;
+
+			case b2Shape::e_edge:
+				b2CollideEdgeAndCircle(&manifold, (const b2EdgeShape*)shape, xfA, &circle, xfB);
+				break;
+
+			case b2Shape::e_chain:
+				{
+					b2EdgeShape edge;
+					((const b2ChainShape*)shape)->GetChildEdge(&edge, candidate.childIndex);
+					b2CollideEdgeAndCircle(&manifold, &edge, xfA, &circle, xfB);
+				}
+				break;
+
+			default:
+				manifold.pointCount = 0;
+				break;
+			}
+
+			if (manifold.pointCount == 0)
+			{
+				continue;
+			}
+
+			b2WorldManifold worldManifold;
+			worldManifold.Initialize(&manifold, xfA, shape->m_radius, xfB, circle.m_radius);
+			const float separation = worldManifold.separations[0];
+			const b2Vec2 normal = worldManifold.normal;
+
+			if (last && separation < b2_linearSlop && b2Dot(normal, up) > b2_minGroundNormal)
+			{
+				++body->m_groundCount;
+				body->m_groundNormal = normal;
+			}
+
+			if (separation >= 0.0f)
+			{
+				continue;
+			}
+
+			const b2Vec2 before = p;
+			p -= separation * normal;
+
+			// Slide no further than friction times the push allows, relative to the
+			// fixture's motion over the substep.
+			const b2Vec2 point = worldManifold.points[0];
+			const b2Vec2 motion = (p - p0) - h * rigid->GetLinearVelocityFromWorldPoint(point);
+			const b2Vec2 tangent = motion - b2Dot(motion, normal) * normal;
+			const float slide = tangent.Length();
+			if (slide > 0.0f)
+			{
+				const float friction = b2MixFriction(body->m_friction, fixture->GetFriction());
+				p -= b2Min(1.0f, -friction * separation / slide) * tangent;
+			}
+
+			if (rigid->GetType() == b2_dynamicBody)
+			{
+				const float mass = 1.0f / m_invMass[i];
+				rigid->ApplyLinearImpulse(-mass * inverseH * (p - before), point, true);
+			}
+		}
+
+		m_x[i] = p.x;
+		m_y[i] = p.y;
+	}
+}
+
+// The velocity that carried each particle from where it started the substep, damped.
+void b2SoftBodySystem::UpdateVelocities(float h)
+{
+	const float inverseH = 1.0f / h;
+	const b2FloatW inverseHW = b2SplatW(inverseH);
+	const b2FloatW hW = b2SplatW(h);
+	const b2FloatW one = b2SplatW(1.0f);
+	const b2FloatW zero = b2SplatW(0.0f);
+
+	int32 i = 0;
+	for (; i + b2_simdLanes <= m_particleCount; i += b2_simdLanes)
+	{
+		const b2FloatW scale = b2MulW(inverseHW, b2MaxW(zero, b2SubW(one, b2MulW(hW, b2LoadW(m_damping + i)))));
+		b2StoreW(m_vx + i, b2MulW(scale, b2SubW(b2LoadW(m_x + i), b2LoadW(m_px + i))));
+		b2StoreW(m_vy + i, b2MulW(scale, b2SubW(b2LoadW(m_y + i), b2LoadW(m_py + i))));
+	}
+
+	for (; i < m_particleCount; ++i)
+	{
+		const float scale = inverseH * b2Max(0.0f, 1.0f - h * m_damping[i]);
+		m_vx[i] = scale * (m_x[i] - m_px[i]);
+		m_vy[i] = scale * (m_y[i] - m_py[i]);
+	}
+}
+
+void b2SoftBodySystem::UpdateBounds(b2SoftBody* body)
+{
+	const int32 start = body->m_particleStart;
+	const int32 end = start + body->m_particleCount;
+
+	b2FloatW lowerX = b2SplatW(b2_maxFloat), lowerY = lowerX;
+	b2FloatW upperX = b2SplatW(-b2_maxFloat), upperY = upperX;
+	int32 i = start;
+	for (; i + b2_simdLanes <= end; i += b2_simdLanes)
+	{
+		const b2FloatW r = b2LoadW(m_radius + i);
+		const b2FloatW x = b2LoadW(m_x + i);
+		const b2FloatW y = b2LoadW(m_y + i);
+		lowerX = b2MinW(lowerX, b2SubW(x, r));
+		lowerY = b2MinW(lowerY, b2SubW(y, r));
+		upperX = b2MaxW(upperX, b2AddW(x, r));
+		upperY = b2MaxW(upperY, b2AddW(y, r));
+	}
+
+	float lanes[4][b2_simdLanes];
+	b2StoreW(lanes[0], lowerX);
+	b2StoreW(lanes[1], lowerY);
+	b2StoreW(lanes[2], upperX);
+	b2StoreW(lanes[3], upperY);
+
+	b2AABB& aabb = body->m_aabb;
+	aabb.lowerBound.Set(b2_maxFloat, b2_maxFloat);
+	aabb.upperBound.Set(-b2_maxFloat, -b2_maxFloat);
+	for (int32 lane = 0; lane < b2_simdLanes; ++lane)
+	{
+		aabb.lowerBound = b2Min(aabb.lowerBound, b2Vec2(lanes[0][lane], lanes[1][lane]));
+		aabb.upperBound = b2Max(aabb.upperBound, b2Vec2(lanes[2][lane], lanes[3][lane]));
+	}
+
+	for (; i < end; ++i)
+	{
+		const b2Vec2 r(m_radius[i], m_radius[i]);
+		const b2Vec2 p(m_x[i], m_y[i]);
+		aabb.lowerBound = b2Min(aabb.lowerBound, p - r);
+		aabb.upperBound = b2Max(aabb.upperBound, p + r);
+	}
+}
+
+void b2SoftBodySystem::Step(const b2TimeStep& step, const b2Vec2& gravity, const b2BroadPhase* broadPhase)
+{
+	if (m_particleCount == 0 || step.dt == 0.0f)
+	{
+		return;
+	}
+
+	const float dt = step.dt;
+	const float h = dt / float(m_subStepCount);
+
+	// Particles rest on contacts that push against gravity.
+	b2Vec2 up = -gravity;
+	up.Normalize();
+
+	memcpy(m_x0, m_x, m_particleCount * sizeof(float));
+	memcpy(m_y0, m_y, m_particleCount * sizeof(float));
+
+	// The fixtures and particles that may touch are found once, for every substep.
+	m_candidateCount = 0;
+	for (b2SoftBody* b = m_bodyList; b; b = b->m_next)
+	{
+		FindCandidates(b, dt, gravity, broadPhase);
+	}
+
+	m_pairCount = 0;
+	if (m_bodyCount > 1)
+	{
+		FindPairs(dt);
+	}
+
+	for (int32 subStep = 0; subStep < m_subStepCount; ++subStep)
+	{
+		// Ground contacts are counted in the last substep.
+		const bool last = subStep == m_subStepCount - 1;
+		if (last)
+		{
+			for (b2SoftBody* b = m_bodyList; b; b = b->m_next)
+			{
+				b->m_groundCount = 0;
+			}
+		}
+
+		Integrate(h, gravity);
+		SolveLinks(h);
+		SolvePairs(up, last);
+
+		for (b2SoftBody* b = m_bodyList; b; b = b->m_next)
+		{
+			SolveCandidates(b, h, up, last);
+		}
+
+		UpdateVelocities(h);
+	}
+
+	for (b2SoftBody* b = m_bodyList; b; b = b->m_next)
+	{
+		UpdateBounds(b);
+	}
+}
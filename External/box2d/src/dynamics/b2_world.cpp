@@ -38,6 +38,7 @@
 #include "box2d/b2_timer.h"
 #include "box2d/b2_world.h"
 
+#include <algorithm>
 #include <new>
 
 b2World::b2World(const b2Vec2& gravity)
@@ -52,6 +53,8 @@ b2World::b2World(const b2Vec2& gravity)
 	m_jointCount = 0;
 
 	m_warmStarting = true;
+	m_wideSolving = false;
+	m_colorSolving = false;
 	m_continuousPhysics = true;
 	m_subStepping = false;
 
@@ -69,6 +72,17 @@ b2World::b2World(const b2Vec2& gravity)
 	m_contactManager.m_allocator = &m_blockAllocator;
 
 	memset(&m_profile, 0, sizeof(b2Profile));
+
+	m_taskExecutor = nullptr;
+	m_threadAllocators = nullptr;
+	m_threadAllocatorCount = 0;
+
+	m_islandRanges = nullptr;
+	m_islandBodies = nullptr;
+	m_islandContacts = nullptr;
+	m_islandJoints = nullptr;
+	m_islandImpulses = nullptr;
+	m_islandProfiles = nullptr;
 }
 
 b2World::~b2World()
@@ -90,6 +104,8 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	SetTaskExecutor(nullptr);
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -112,6 +128,85 @@ void b2World::SetDebugDraw(b2Draw* debugDraw)
 	m_debugDraw = debugDraw;
 }
 
+void b2World::SetTaskExecutor(b2TaskExecutor* executor)
+{
+	b2Assert(IsLocked() == false);
+
+	for (int32 i = 0; i < m_threadAllocatorCount; ++i)
+	{
+		m_threadAllocators[i].~b2StackAllocator();
+	}
+	b2Free(m_threadAllocators);
+	m_threadAllocators = nullptr;
+	m_threadAllocatorCount = 0;
+
+	m_taskExecutor = executor;
+	m_contactManager.m_taskExecutor = executor;
+	m_contactManager.m_broadPhase.SetTaskExecutor(executor);
+	if (m_taskExecutor == nullptr)
+	{
+		return;
+	}
+
+	// One stack allocator per thread, islands solved at the same time can't share one.
+	m_threadAllocatorCount = b2Max(m_taskExecutor->GetThreadCount(), 1);
+	m_threadAllocators = (b2StackAllocator*)b2Alloc(m_threadAllocatorCount * sizeof(b2StackAllocator));
+	for (int32 i = 0; i < m_threadAllocatorCount; ++i)
+	{
+		new (m_threadAllocators + i) b2StackAllocator();
+	}
+}
+
+void b2World::SetBroadPhase(b2BroadPhaseType type, float cellSize)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	b2BroadPhase* broadPhase = &m_contactManager.m_broadPhase;
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			f->DestroyProxies(broadPhase);
+		}
+	}
+
+	broadPhase->SetType(type, cellSize);
+
+	// Disabled bodies have no proxies.
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		if (b->IsEnabled() == false)
+		{
+			continue;
+		}
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			f->CreateProxies(broadPhase, b->m_xf);
+		}
+	}
+}
+
+b2BroadPhaseType b2World::GetBroadPhase() const
+{
+	return m_contactManager.m_broadPhase.GetType();
+}
+
+void b2World::RebuildBroadPhase()
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	m_contactManager.m_broadPhase.RebuildTree();
+}
+
 b2Body* b2World::CreateBody(const b2BodyDef* def)
 {
 	b2Assert(IsLocked() == false);
@@ -372,6 +467,40 @@ void b2World::DestroyJoint(b2Joint* j)
 	}
 }
 
+b2SoftBody* b2World::CreateSoftBody(const b2SoftBodyDef* def)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return nullptr;
+	}
+
+	return m_softBodySystem.Create(def, &m_blockAllocator);
+}
+
+void b2World::DestroySoftBody(b2SoftBody* body)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	m_softBodySystem.Destroy(body, &m_blockAllocator);
+}
+
+void b2World::ReserveSoftBodies(int32 particleCount, int32 linkCount, int32 outlineCount)
+{
+	b2Assert(particleCount >= 0 && linkCount >= 0 && outlineCount >= 0);
+	m_softBodySystem.Reserve(particleCount, linkCount, outlineCount);
+}
+
+void b2World::SetSoftBodySubSteps(int32 count)
+{
+	b2Assert(count > 0);
+	m_softBodySystem.m_subStepCount = b2Max(count, 1);
+}
+
 //
 void b2World::SetAllowSleeping(bool flag)
 {
@@ -397,6 +526,11 @@ void b2World::Solve(const b2TimeStep& step)
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
 
+	// Islands are collected and solved in parallel when there are threads to spare.
+	// Gear joints reach bodies outside their own island, so those worlds are solved
+	// one island at a time.
+	bool parallel = m_taskExecutor != nullptr && m_threadAllocatorCount > 1;
+
 	// Size the island for the worst case.
 	b2Island island(m_bodyCount,
 		m_contactManager.m_contactCount,
@@ -416,11 +550,32 @@ void b2World::Solve(const b2TimeStep& step)
 	for (b2Joint* j = m_jointList; j; j = j->m_next)
 	{
 		j->m_islandFlag = false;
+		if (j->m_type == e_gearJoint)
+		{
+			parallel = false;
+		}
 	}
 
 	// Build and simulate all awake islands.
 	int32 stackSize = m_bodyCount;
 	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+
+	// Storage for the collected islands. Every contact and joint is in at most one
+	// island. Static bodies can be in many, but each time through one of its contacts
+	// or joints.
+	int32 islandCount = 0;
+	int32 islandBodyCount = 0;
+	int32 islandContactCount = 0;
+	int32 islandJointCount = 0;
+	if (parallel)
+	{
+		int32 contactCount = m_contactManager.m_contactCount;
+		m_islandRanges = (b2IslandRange*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandRange));
+		m_islandBodies = (b2Body**)m_stackAllocator.Allocate((m_bodyCount + contactCount + m_jointCount) * sizeof(b2Body*));
+		m_islandContacts = (b2Contact**)m_stackAllocator.Allocate(contactCount * sizeof(b2Contact*));
+		m_islandJoints = (b2Joint**)m_stackAllocator.Allocate(m_jointCount * sizeof(b2Joint*));
+	}
+
 	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
 	{
 		if (seed->m_flags & b2Body::e_islandFlag)
@@ -535,11 +690,50 @@ void b2World::Solve(const b2TimeStep& step)
 			}
 		}
 
-		b2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
-		m_profile.solveInit += profile.solveInit;
-		m_profile.solveVelocity += profile.solveVelocity;
-		m_profile.solvePosition += profile.solvePosition;
+		if (parallel)
+		{
+			// Store the island, it's solved with the rest once they're all found.
+			b2IslandRange* range = m_islandRanges + islandCount++;
+			range->bodyStart = islandBodyCount;
+			range->bodyCount = island.m_bodyCount;
+			range->staticCount = 0;
+			range->contactStart = islandContactCount;
+			range->contactCount = island.m_contactCount;
+			range->jointStart = islandJointCount;
+			range->jointCount = island.m_jointCount;
+			range->colored = step.colorSolving &&
+				(island.m_contactCount >= b2_minColoredConstraints || island.m_jointCount >= b2_minColoredConstraints);
+
+			for (int32 i = 0; i < island.m_bodyCount; ++i)
+			{
+				b2Body* b = island.m_bodies[i];
+				m_islandBodies[islandBodyCount++] = b;
+				if (b->GetType() == b2_staticBody)
+				{
+					++range->staticCount;
+				}
+			}
+			for (int32 i = 0; i < island.m_contactCount; ++i)
+			{
+				m_islandContacts[islandContactCount++] = island.m_contacts[i];
+			}
+			for (int32 i = 0; i < island.m_jointCount; ++i)
+			{
+				m_islandJoints[islandJointCount++] = island.m_joints[i];
+			}
+		}
+		else
+		{
+			// Islands are solved here one at a time, but big ones can still spread their
+			// colors across the executor's threads.
+			island.m_taskExecutor = m_threadAllocatorCount > 1 ? m_taskExecutor : nullptr;
+
+			b2Profile profile;
+			island.Solve(&profile, step, m_gravity, m_allowSleep);
+			m_profile.solveInit += profile.solveInit;
+			m_profile.solveVelocity += profile.solveVelocity;
+			m_profile.solvePosition += profile.solvePosition;
+		}
 
 		// Post solve cleanup.
 		for (int32 i = 0; i < island.m_bodyCount; ++i)
@@ -553,6 +747,23 @@ void b2World::Solve(const b2TimeStep& step)
 		}
 	}
 
+	if (parallel)
+	{
+		if (islandCount > 0)
+		{
+			SolveIslands(step, islandCount);
+		}
+
+		m_stackAllocator.Free(m_islandJoints);
+		m_stackAllocator.Free(m_islandContacts);
+		m_stackAllocator.Free(m_islandBodies);
+		m_stackAllocator.Free(m_islandRanges);
+		m_islandRanges = nullptr;
+		m_islandBodies = nullptr;
+		m_islandContacts = nullptr;
+		m_islandJoints = nullptr;
+	}
+
 	m_stackAllocator.Free(stack);
 
 	{
@@ -581,6 +792,125 @@ void b2World::Solve(const b2TimeStep& step)
 	}
 }
 
+// Solves the islands stored by Solve, a range of them per task. Big islands are left
+// for SolveIslands to solve a color at a time.
+class b2SolveIslandsTask : public b2Task
+{
+public:
+	b2SolveIslandsTask(b2World* world, const b2TimeStep& step)
+		: m_world(world), m_step(step)
+	{
+	}
+
+	void Execute(int32 begin, int32 end, int32 threadIndex) override
+	{
+		b2Assert(0 <= threadIndex && threadIndex < m_world->m_threadAllocatorCount);
+		b2StackAllocator* allocator = m_world->m_threadAllocators + threadIndex;
+
+		for (int32 i = begin; i < end; ++i)
+		{
+			if (m_world->m_islandRanges[i].colored == false)
+			{
+				m_world->SolveStoredIsland(m_step, i, allocator, nullptr);
+			}
+		}
+	}
+
+private:
+	b2World* m_world;
+	b2TimeStep m_step;
+};
+
+// Rebuilds a stored island and solves it. The executor, if given, spreads the island's
+// colors across its threads.
+void b2World::SolveStoredIsland(const b2TimeStep& step, int32 index, b2StackAllocator* allocator, b2TaskExecutor* executor)
+{
+	const b2IslandRange& range = m_islandRanges[index];
+
+	b2Island island(range.bodyCount, range.contactCount, range.jointCount, allocator, nullptr);
+	island.ReserveStatics(range.staticCount);
+	island.m_taskExecutor = executor;
+
+	b2Body** bodies = m_islandBodies + range.bodyStart;
+	for (int32 j = 0; j < range.bodyCount; ++j)
+	{
+		if (bodies[j]->GetType() == b2_staticBody)
+		{
+			island.AddStatic(bodies[j]);
+		}
+		else
+		{
+			island.Add(bodies[j]);
+		}
+	}
+	island.SortStatics();
+
+	for (int32 j = 0; j < range.contactCount; ++j)
+	{
+		island.Add(m_islandContacts[range.contactStart + j]);
+	}
+	for (int32 j = 0; j < range.jointCount; ++j)
+	{
+		island.Add(m_islandJoints[range.jointStart + j]);
+	}
+
+	if (m_islandImpulses)
+	{
+		island.m_impulses = m_islandImpulses + range.contactStart;
+	}
+
+	island.Solve(m_islandProfiles + index, step, m_gravity, m_allowSleep);
+}
+
+// Solve the collected islands across the executor's threads. Islands share nothing
+// but static bodies, which they only read. Contacts are then reported, and timings
+// added up, in island order, the same as solving them one at a time.
+void b2World::SolveIslands(const b2TimeStep& step, int32 islandCount)
+{
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+	int32 contactCount = m_islandRanges[islandCount - 1].contactStart + m_islandRanges[islandCount - 1].contactCount;
+
+	m_islandProfiles = (b2Profile*)m_stackAllocator.Allocate(islandCount * sizeof(b2Profile));
+	if (listener)
+	{
+		m_islandImpulses = (b2ContactImpulse*)m_stackAllocator.Allocate(contactCount * sizeof(b2ContactImpulse));
+	}
+
+	b2SolveIslandsTask task(this, step);
+	m_taskExecutor->ParallelFor(islandCount, 1, &task);
+
+	// Big islands are solved after, one at a time, with their colors spread across the
+	// threads instead.
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		if (m_islandRanges[i].colored)
+		{
+			SolveStoredIsland(step, i, &m_stackAllocator, m_taskExecutor);
+		}
+	}
+
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		m_profile.solveInit += m_islandProfiles[i].solveInit;
+		m_profile.solveVelocity += m_islandProfiles[i].solveVelocity;
+		m_profile.solvePosition += m_islandProfiles[i].solvePosition;
+	}
+
+	if (listener)
+	{
+		for (int32 i = 0; i < contactCount; ++i)
+		{
+			listener->PostSolve(m_islandContacts[i], m_islandImpulses + i);
+		}
+
+		m_stackAllocator.Free(m_islandImpulses);
+		m_islandImpulses = nullptr;
+	}
+
+	m_stackAllocator.Free(m_islandProfiles);
+	m_islandProfiles = nullptr;
+}
+
 // Find TOI contacts and solve them.
 void b2World::SolveTOI(const b2TimeStep& step)
 {
@@ -868,6 +1198,8 @@ void b2World::SolveTOI(const b2TimeStep& step)
 		subStep.positionIterations = 20;
 		subStep.velocityIterations = step.velocityIterations;
 		subStep.warmStarting = false;
+		subStep.wideSolving = false;
+		subStep.colorSolving = false;
 		island.SolveTOI(subStep, bA->m_islandIndex, bB->m_islandIndex);
 
 		// Reset island flags and synchronize broad-phase proxies.
@@ -931,6 +1263,10 @@ void b2World::Step(float dt, int32 velocityIterations, int32 positionIterations)
 	step.dtRatio = m_inv_dt0 * dt;
 
 	step.warmStarting = m_warmStarting;
+	step.wideSolving = m_wideSolving;
+	// Coloring changes the solve order, so unless asked for constraints are solved
+	// in the order stock box2d solves them.
+	step.colorSolving = m_colorSolving || m_wideSolving;
 
 	// Update contacts. This is where some contacts are destroyed.
 	{
@@ -955,6 +1291,14 @@ void b2World::Step(float dt, int32 velocityIterations, int32 positionIterations)
 		m_profile.solveTOI = timer.GetMilliseconds();
 	}
 
+	// Soft bodies push against the rigid bodies where they ended up.
+	if (m_softBodySystem.m_bodyCount > 0 && step.dt > 0.0f)
+	{
+		b2Timer timer;
+		m_softBodySystem.Step(step, m_gravity, &m_contactManager.m_broadPhase);
+		m_profile.solveSoftBodies = timer.GetMilliseconds();
+	}
+
 	if (step.dt > 0.0f)
 	{
 		m_inv_dt0 = step.inv_dt;
@@ -1036,6 +1380,148 @@ void b2World::RayCast(b2RayCastCallback* callback, const b2Vec2& point1, const b
 	m_contactManager.m_broadPhase.RayCast(&wrapper, input);
 }
 
+// Keeps the closest fixture each lane of a packet hits.
+struct b2WorldRayPacketWrapper
+{
+	float RayCastCallback(const b2RayCastInput& input, int32 proxyId, int32 lane)
+	{
+		b2FixtureProxy* proxy = (b2FixtureProxy*)broadPhase->GetUserData(proxyId);
+		b2Fixture* fixture = proxy->fixture;
+		b2RayCastOutput output;
+		if (fixture->RayCast(&output, input, proxy->childIndex) == false)
+		{
+			return input.maxFraction;
+		}
+
+		float fraction = output.fraction;
+		b2RayCastHit* hit = hits + rays[lane];
+		hit->fixture = fixture;
+		hit->point = (1.0f - fraction) * input.p1 + fraction * input.p2;
+		hit->normal = output.normal;
+		hit->fraction = fraction;
+		return fraction;
+	}
+
+	const b2BroadPhase* broadPhase;
+	b2RayCastHit* hits;
+
+	// The index of each lane's ray.
+	int32 rays[b2_rayPacketSize];
+};
+
+// Casts packets [begin, end). The rays are taken in the order of the low 32 bits
+// of their sort keys.
+static void b2CastRayPackets(const b2BroadPhase* broadPhase, const b2RayCastInput* inputs,
+	const uint64* keys, int32 count, b2RayCastHit* hits, int32 begin, int32 end)
+{
+	b2WorldRayPacketWrapper wrapper;
+	wrapper.broadPhase = broadPhase;
+	wrapper.hits = hits;
+
+	b2RayPacket packet;
+	for (int32 i = begin; i < end; ++i)
+	{
+		packet.Clear();
+		int32 last = b2Min(count, (i + 1) * b2_rayPacketSize);
+		for (int32 j = i * b2_rayPacketSize; j < last; ++j)
+		{
+			int32 ray = int32(keys[j] & 0xFFFFFFFF);
+			hits[ray].fixture = nullptr;
+			hits[ray].point = inputs[ray].p1;
+			hits[ray].normal.SetZero();
+			hits[ray].fraction = inputs[ray].maxFraction;
+			wrapper.rays[packet.Add(inputs[ray])] = ray;
+		}
+
+		broadPhase->RayCastPacket(&wrapper, &packet);
+	}
+}
+
+class b2RayPacketsTask : public b2Task
+{
+public:
+	void Execute(int32 begin, int32 end, int32 threadIndex) override
+	{
+		B2_NOT_USED(threadIndex);
+		b2CastRayPackets(broadPhase, inputs, keys, count, hits, begin, end);
+	}
+
+	const b2BroadPhase* broadPhase;
+	const b2RayCastInput* inputs;
+	const uint64* keys;
+	int32 count;
+	b2RayCastHit* hits;
+};
+
+// Puts a zero between each of the low 16 bits.
+static inline uint32 b2SpreadBits(uint32 x)
+{
+	x &= 0x0000FFFF;
+	x = (x | (x << 8)) & 0x00FF00FF;
+	x = (x | (x << 4)) & 0x0F0F0F0F;
+	x = (x | (x << 2)) & 0x33333333;
+	x = (x | (x << 1)) & 0x55555555;
+	return x;
+}
+
+void b2World::RayCastClosest(const b2RayCastInput* inputs, b2RayCastHit* hits, int32 count, bool parallel) const
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	// Sort keys. The high 32 bits are which way a ray points, then where it starts
+	// along a Morton curve over the starts' bounds. The low 32 bits are the ray.
+	uint64* keys = (uint64*)b2Alloc(count * sizeof(uint64));
+	b2AABB bounds;
+	bounds.lowerBound = inputs[0].p1;
+	bounds.upperBound = inputs[0].p1;
+	for (int32 i = 1; i < count; ++i)
+	{
+		bounds.lowerBound = b2Min(bounds.lowerBound, inputs[i].p1);
+		bounds.upperBound = b2Max(bounds.upperBound, inputs[i].p1);
+	}
+
+	b2Vec2 extents = bounds.upperBound - bounds.lowerBound;
+	float scaleX = extents.x > 0.0f ? 32767.0f / extents.x : 0.0f;
+	float scaleY = extents.y > 0.0f ? 32767.0f / extents.y : 0.0f;
+	for (int32 i = 0; i < count; ++i)
+	{
+		b2Vec2 p1 = inputs[i].p1;
+		b2Vec2 d = inputs[i].p2 - p1;
+		uint32 x = uint32(scaleX * (p1.x - bounds.lowerBound.x));
+		uint32 y = uint32(scaleY * (p1.y - bounds.lowerBound.y));
+		uint32 quadrant = (d.x < 0.0f ? 2u : 0u) | (d.y < 0.0f ? 1u : 0u);
+		uint32 key = (quadrant << 30) | b2SpreadBits(x) | (b2SpreadBits(y) << 1);
+		keys[i] = (uint64(key) << 32) | uint64(uint32(i));
+	}
+
+	if (count > b2_rayPacketSize)
+	{
+		std::sort(keys, keys + count);
+	}
+
+	const b2BroadPhase* broadPhase = &m_contactManager.m_broadPhase;
+	const int32 packetCount = (count + b2_rayPacketSize - 1) / b2_rayPacketSize;
+	if (parallel && m_taskExecutor != nullptr && m_taskExecutor->GetThreadCount() > 1 && packetCount > 1)
+	{
+		b2RayPacketsTask task;
+		task.broadPhase = broadPhase;
+		task.inputs = inputs;
+		task.keys = keys;
+		task.count = count;
+		task.hits = hits;
+		m_taskExecutor->ParallelFor(packetCount, 8, &task);
+	}
+	else
+	{
+		b2CastRayPackets(broadPhase, inputs, keys, count, hits, 0, packetCount);
+	}
+
+	b2Free(keys);
+}
+
 void b2World::DrawShape(b2Fixture* fixture, const b2Transform& xf, const b2Color& color)
 {
 	switch (fixture->GetType())
@@ -1254,6 +1740,8 @@ void b2World::ShiftOrigin(const b2Vec2& newOrigin)
 		j->ShiftOrigin(newOrigin);
 	}
 
+	m_softBodySystem.ShiftOrigin(newOrigin);
+
 	m_contactManager.m_broadPhase.ShiftOrigin(newOrigin);
 }
 
@@ -60,6 +60,7 @@ b2Rope::b2Rope()
 	m_p0s = nullptr;
 	m_vs = nullptr;
 	m_invMasses = nullptr;
+	m_arcLengths = nullptr;
 	m_gravity.SetZero();
 }
 
@@ -72,6 +73,7 @@ b2Rope::~b2Rope()
 	b2Free(m_p0s);
 	b2Free(m_vs);
 	b2Free(m_invMasses);
+	b2Free(m_arcLengths);
 }
 
 void b2Rope::Create(const b2RopeDef& def)
@@ -84,6 +86,7 @@ void b2Rope::Create(const b2RopeDef& def)
 	m_p0s = (b2Vec2*)b2Alloc(m_count * sizeof(b2Vec2));
 	m_vs = (b2Vec2*)b2Alloc(m_count * sizeof(b2Vec2));
 	m_invMasses = (float*)b2Alloc(m_count * sizeof(float));
+	m_arcLengths = (float*)b2Alloc(m_count * sizeof(float));
 
 	for (int32 i = 0; i < m_count; ++i)
 	{
@@ -126,6 +129,12 @@ void b2Rope::Create(const b2RopeDef& def)
 		c.spring = 0.0f;
 	}
 
+	m_arcLengths[0] = 0.0f;
+	for (int32 i = 0; i < m_stretchCount; ++i)
+	{
+		m_arcLengths[i + 1] = m_arcLengths[i] + m_stretchConstraints[i].L;
+	}
+
 	for (int32 i = 0; i < m_bendCount; ++i)
 	{
 		b2RopeBend& c = m_bendConstraints[i];
@@ -319,6 +328,11 @@ void b2Rope::Step(float dt, int32 iterations, const b2Vec2& position)
 		{
 			SolveStretch_XPBD(dt);
 		}
+
+		if (m_tuning.tethers)
+		{
+			SolveTethers();
+		}
 	}
 
 	// Constrain velocity
@@ -351,6 +365,50 @@ void b2Rope::Reset(const b2Vec2& position)
 	}
 }
 
+void b2Rope::SetBindPosition(int32 index, const b2Vec2& bindPosition)
+{
+	b2Assert(0 <= index && index < m_count);
+	m_bindPositions[index] = bindPosition;
+}
+
+void b2Rope::SetGravity(const b2Vec2& gravity)
+{
+	m_gravity = gravity;
+}
+
+// Pulls each vertex back within its rest length along the rope of the nearest vertex
+// without mass, one side at a time. Vertices without mass don't move, so each vertex
+// is projected straight onto its limit.
+void b2Rope::SolveTethers()
+{
+	for (int32 side = 0; side < 2; ++side)
+	{
+		int32 anchor = -1;
+		for (int32 k = 0; k < m_count; ++k)
+		{
+			const int32 i = side == 0 ? k : m_count - 1 - k;
+			if (m_invMasses[i] == 0.0f)
+			{
+				anchor = i;
+				continue;
+			}
+
+			if (anchor < 0)
+			{
+				continue;
+			}
+
+			const b2Vec2 d = m_ps[i] - m_ps[anchor];
+			const float L = b2Abs(m_arcLengths[i] - m_arcLengths[anchor]);
+			const float distance = d.Length();
+			if (distance > L)
+			{
+				m_ps[i] = m_ps[anchor] + (L / distance) * d;
+			}
+		}
+	}
+}
+
 void b2Rope::SolveStretch_PBD()
 {
 	const float stiffness = m_tuning.stretchStiffness;
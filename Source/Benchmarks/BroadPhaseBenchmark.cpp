@@ -0,0 +1,173 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file BroadPhaseBenchmark.cpp
+  * \author Joe Goldman
+  * \brief BroadPhaseBenchmark class definition
+  *
+  **/
+
+#include <Benchmarks/BroadPhaseBenchmark.hpp>
+#include <Physics/Box2d.hpp>
+
+#include <chrono> // steady_clock
+#include <cmath> // sqrt
+#include <cstdint> // uint32_t, uint64_t
+#include <iostream> // cout, endl
+#include <utility> // swap
+#include <vector> // vector
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief Counts the pairs UpdatePairs reports. The checksum doesn't depend on the
+	 *         order they come in, so broad-phases that find the same pairs match.
+	 */
+	struct PairCounter
+	{
+		long long Count = 0;
+		uint64_t Checksum = 0;
+
+		void AddPair(void* userDataA, void* userDataB)
+		{
+			uint64_t a = (uint64_t)(uintptr_t)userDataA;
+			uint64_t b = (uint64_t)(uintptr_t)userDataB;
+			if (a > b)
+				std::swap(a, b);
+
+			Count++;
+			Checksum += (a * 0x9E3779B97F4A7C15ull) ^ (b + 0x632BE59BD9B4E019ull);
+		}
+	};
+
+	/*!
+	 *  \brief A box proxy and how it wanders
+	 */
+	struct WanderingBox
+	{
+		b2Vec2 Position;
+		b2Vec2 Velocity;
+		int ProxyId;
+	};
+
+	/*!
+	 *  A repeatable random number in [-1, 1]
+	 */
+	static float Random(uint32_t& state)
+	{
+		state = state * 1664525u + 1013904223u;
+		return (float)(state >> 8) / (float)(1 << 23) - 1.0f;
+	}
+
+	static b2AABB BoxAABB(const b2Vec2& position)
+	{
+		b2AABB aabb;
+		aabb.lowerBound = position - b2Vec2(0.5f, 0.5f);
+		aabb.upperBound = position + b2Vec2(0.5f, 0.5f);
+		return aabb;
+	}
+
+	/*!
+	 *  Seconds since start
+	 */
+	static double Since(std::chrono::steady_clock::time_point start)
+	{
+		using namespace std::chrono;
+		return duration<double>(steady_clock::now() - start).count();
+	}
+
+	/*!
+	 *  Scatters count unit boxes over a square with about two square meters each, a
+	 *  quarter of them resting, then steps the rest around it. Prints the time to
+	 *  create the proxies and find their first pairs, and the mean time per step to
+	 *  move them and to update the pairs.
+	 */
+	void BroadPhaseBenchmark::Run()
+	{
+		using namespace std::chrono;
+
+		const int counts[] = { 1000, 10000, 100000 };
+		const b2BroadPhaseType types[] = { b2_treeBroadPhase, b2_sweepBroadPhase, b2_gridBroadPhase };
+		const char* typeNames[] = { "tree", "sweep", "grid" };
+		const float timeStep = 1.0f / 30.0f;
+		const float cellSize = 2.0f;
+		const int steps = 30;
+
+		std::cout << "Broad-phase pair finding, unit boxes moving at up to 3 m/s" << std::endl;
+		std::cout << "proxies\ttype\tbuild (ms)\tmove (ms per step)\tpairs (ms per step)"
+			"\tpairs per step\tsame pairs" << std::endl;
+
+		for (int count : counts)
+		{
+			const float halfSize = 0.5f * std::sqrt(2.0f * count);
+			uint64_t treeChecksum = 0;
+
+			for (int t = 0; t < 3; t++)
+			{
+				b2BroadPhase broadPhase;
+				broadPhase.SetType(types[t], cellSize);
+
+				uint32_t state = 12345u;
+				std::vector<WanderingBox> boxes(count);
+				for (int i = 0; i < count; i++)
+				{
+					boxes[i].Position.Set(halfSize * Random(state), halfSize * Random(state));
+					boxes[i].Velocity.Set(3.0f * Random(state), 3.0f * Random(state));
+					if (i % 4 == 0)
+						boxes[i].Velocity.SetZero();
+				}
+
+				PairCounter pairs;
+				steady_clock::time_point start = steady_clock::now();
+				for (int i = 0; i < count; i++)
+					boxes[i].ProxyId = broadPhase.CreateProxy(BoxAABB(boxes[i].Position), (void*)(uintptr_t)i);
+				broadPhase.UpdatePairs(&pairs);
+				const double build = Since(start);
+
+				double move = 0.0;
+				double update = 0.0;
+				for (int step = 0; step < steps; step++)
+				{
+					start = steady_clock::now();
+					for (WanderingBox& box : boxes)
+					{
+						if (box.Velocity.x == 0.0f && box.Velocity.y == 0.0f)
+							continue;
+
+						// turn back at the edges of the square
+						b2Vec2 displacement = timeStep * box.Velocity;
+						b2Vec2 next = box.Position + displacement;
+						if (next.x < -halfSize || next.x > halfSize)
+							box.Velocity.x = -box.Velocity.x;
+						if (next.y < -halfSize || next.y > halfSize)
+							box.Velocity.y = -box.Velocity.y;
+
+						box.Position = next;
+						broadPhase.MoveProxy(box.ProxyId, BoxAABB(box.Position), displacement);
+					}
+					move += Since(start);
+
+					start = steady_clock::now();
+					broadPhase.UpdatePairs(&pairs);
+					update += Since(start);
+				}
+
+				if (t == 0)
+					treeChecksum = pairs.Checksum;
+
+				std::cout << count << "\t" << typeNames[t] << "\t" << build * 1000.0 << "\t\t"
+					<< move * 1000.0 / steps << "\t\t\t" << update * 1000.0 / steps << "\t\t\t"
+					<< pairs.Count / (steps + 1) << "\t\t"
+					<< (pairs.Checksum == treeChecksum ? "yes" : "no") << std::endl;
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file BroadPhaseBenchmark.hpp
+  * \author Joe Goldman
+  * \brief BroadPhaseBenchmark class declaration
+  *
+  */
+
+#pragma once
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief	Measures finding pairs with each b2BroadPhaseType, for 1k, 10k and
+	 *			100k box proxies wandering around a square. Times moving the proxies
+	 *			and updating the pairs, and checks every type finds the same pairs.
+	 */
+	class BroadPhaseBenchmark
+	{
+	public:
+		static void Run();
+	};
+}
\ No newline at end of file
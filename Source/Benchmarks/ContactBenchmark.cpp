@@ -0,0 +1,152 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file ContactBenchmark.cpp
+  * \author Joe Goldman
+  * \brief ContactBenchmark class definition
+  *
+  **/
+
+#include <Benchmarks/ContactBenchmark.hpp>
+#include <Physics/Box2d.hpp>
+
+#include <chrono> // steady_clock
+#include <iostream> // cout, endl
+#include <vector> // vector
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief The fixture children a contact is between
+	 */
+	struct ContactKey
+	{
+		b2Fixture* FixtureA;
+		int IndexA;
+		b2Fixture* FixtureB;
+		int IndexB;
+	};
+
+	/*!
+	 *  Finds a contact the way AddPair used to, walking bodyB's contact list
+	 */
+	static b2Contact* FindInContactList(const ContactKey& key)
+	{
+		b2Body* bodyA = key.FixtureA->GetBody();
+		for (b2ContactEdge* edge = key.FixtureB->GetBody()->GetContactList(); edge; edge = edge->next)
+		{
+			if (edge->other != bodyA)
+				continue;
+
+			b2Contact* contact = edge->contact;
+			if (contact->GetFixtureA() == key.FixtureA && contact->GetFixtureB() == key.FixtureB
+				&& contact->GetChildIndexA() == key.IndexA && contact->GetChildIndexB() == key.IndexB)
+				return contact;
+			if (contact->GetFixtureA() == key.FixtureB && contact->GetFixtureB() == key.FixtureA
+				&& contact->GetChildIndexA() == key.IndexB && contact->GetChildIndexB() == key.IndexA)
+				return contact;
+		}
+
+		return nullptr;
+	}
+
+	/*!
+	 *  Average time of one lookup, in nanoseconds. Every lookup is of a body against
+	 *  the ground, the ground second, as the broad-phase pairs a landing body with it.
+	 */
+	template <class Func>
+	static double TimePerLookup(const std::vector<ContactKey>& keys, int passes, Func&& find)
+	{
+		using namespace std::chrono;
+		int found = 0;
+		const steady_clock::time_point start = steady_clock::now();
+		for (int pass = 0; pass < passes; pass++)
+		{
+			for (const ContactKey& key : keys)
+				found += find(key) != nullptr;
+		}
+		const double seconds = duration<double>(steady_clock::now() - start).count();
+
+		if (found != (int)keys.size() * passes)
+			std::cout << "Warning - ContactBenchmark - Lookups missed contacts" << std::endl;
+
+		return seconds * 1.0e9 / ((double)keys.size() * passes);
+	}
+
+	/*!
+	 *  Drops a single layer of thin tiles onto the ground for 1k to 4k bodies, then
+	 *  prints the mean broad-phase time of a step while they land, and the cost of
+	 *  checking whether a body and the ground already have a contact.
+	 */
+	void ContactBenchmark::Run()
+	{
+		const int counts[] = { 1000, 2000, 4000 };
+		const float timeStep = 1.0f / 30.0f;
+		const int steps = 60;
+
+		std::cout << "Contact lookup against a ground touching every body" << std::endl;
+		std::cout << "bodies\tground contacts\tbroad-phase (ms per step)\tcontact list (ns)"
+			"\thash set (ns)" << std::endl;
+
+		for (int count : counts)
+		{
+			b2World world(b2Vec2(0.0f, -10.0f));
+
+			b2BodyDef groundDef;
+			groundDef.position.Set(0.0f, -10.0f);
+			b2Body* ground = world.CreateBody(&groundDef);
+			b2PolygonShape groundBox;
+			groundBox.SetAsBox(50.0f, 10.0f);
+			ground->CreateFixture(&groundBox, 0.0f);
+
+			// one layer of tiles just above the ground, spread across its width
+			const float halfWidth = 45.0f / count;
+			b2PolygonShape tile;
+			tile.SetAsBox(halfWidth, 0.05f);
+			b2BodyDef tileDef;
+			tileDef.type = b2_dynamicBody;
+			for (int i = 0; i < count; i++)
+			{
+				tileDef.position.Set(-50.0f + (2 * i + 1) * 50.0f / count, 0.1f);
+				world.CreateBody(&tileDef)->CreateFixture(&tile, 1.0f);
+			}
+
+			double broadPhase = 0.0;
+			for (int step = 0; step < steps; step++)
+			{
+				world.Step(timeStep, 6, 2);
+				broadPhase += world.GetProfile().broadphase;
+			}
+
+			std::vector<ContactKey> keys;
+			for (b2ContactEdge* edge = ground->GetContactList(); edge; edge = edge->next)
+			{
+				b2Contact* contact = edge->contact;
+				if (contact->GetFixtureA()->GetBody() == ground)
+					keys.push_back({ contact->GetFixtureB(), contact->GetChildIndexB(),
+						contact->GetFixtureA(), contact->GetChildIndexA() });
+				else
+					keys.push_back({ contact->GetFixtureA(), contact->GetChildIndexA(),
+						contact->GetFixtureB(), contact->GetChildIndexB() });
+			}
+
+			const b2ContactSet& contactSet = world.GetContactManager().m_contactSet;
+			const double list = TimePerLookup(keys, 20, FindInContactList);
+			const double hashed = TimePerLookup(keys, 20, [&contactSet](const ContactKey& key)
+				{
+					return contactSet.Find(key.FixtureA, key.IndexA, key.FixtureB, key.IndexB);
+				});
+
+			std::cout << count << "\t" << keys.size() << "\t\t" << broadPhase / steps << "\t\t\t\t"
+				<< list << "\t\t\t" << hashed << std::endl;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file ContactBenchmark.hpp
+  * \author Joe Goldman
+  * \brief ContactBenchmark class declaration
+  *
+  */
+
+#pragma once
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief	Measures finding existing contacts when one static ground, the
+	 *			SetAsBox(50, 10) ground of the demos, touches thousands of bodies.
+	 *			Compares walking the ground's contact list against the contact
+	 *			manager's hash set, and times the broad-phase as the bodies land.
+	 */
+	class ContactBenchmark
+	{
+	public:
+		static void Run();
+	};
+}
\ No newline at end of file
@@ -0,0 +1,312 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file EntityBenchmark.cpp
+  * \author Joe Goldman
+  * \brief EntityBenchmark class definition
+  *
+  **/
+
+#include <Benchmarks/EntityBenchmark.hpp>
+#include <Core/ConstructRegistry.hpp>
+#include <Core/GameSession.hpp>
+#include <Constructs/SingleShape.hpp>
+#include <Graphics/Color.hpp>
+
+#include <algorithm> // max, shuffle
+#include <chrono> // steady_clock
+#include <iostream> // cout, endl
+#include <random> // mt19937
+#include <string> // string
+#include <vector> // vector
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief Construct with a small fixed update, standing in for a state machine step
+	 */
+	class BenchmarkConstruct final : public Construct
+	{
+	public:
+		using Construct::Construct;
+		float Value = 0.0f;
+
+	private:
+		void Notify(const Command* /*command*/) {}
+		void Create() {}
+		void Start() {}
+		void FixedUpdate(double alpha) { Value = Value * 0.99f + (float)alpha; }
+		void Update(double /*dt*/) {}
+		void End() {}
+		template <class T> friend class ConstructPool;
+	};
+
+	/*!
+	 *  \brief The old layout: a heap construct, the same size as a Construct, updated
+	 *         through a virtual call
+	 */
+	class LegacyConstruct
+	{
+	public:
+		virtual ~LegacyConstruct() = default;
+		virtual void FixedUpdate(double alpha) = 0;
+
+	protected:
+		ExistanceState m_state = ExistanceState::Standby;
+		b2World* m_world = nullptr;
+		ConstructRenderData m_renderData;
+	};
+
+	class LegacyBenchmarkConstruct final : public LegacyConstruct
+	{
+	public:
+		float Value = 0.0f;
+		void FixedUpdate(double alpha) { Value = Value * 0.99f + (float)alpha; }
+	};
+
+	/*!
+	 *  \brief The old layout: a heap entity that forwards its update to its construct
+	 */
+	struct LegacyEntity
+	{
+		int ID = 0;
+		std::string Name = "none";
+		void* GameSession = nullptr;
+		LegacyConstruct* Construct = nullptr;
+		Color RenderColor;
+
+		void FixedUpdate(double alpha)
+		{
+			if (Construct != nullptr)
+				Construct->FixedUpdate(alpha);
+		}
+	};
+
+	/*!
+	 *  Average time of a single entity's fixed update, in nanoseconds
+	 */
+	template <class Func>
+	static double TimePerEntity(int count, int passes, Func&& runPass)
+	{
+		using namespace std::chrono;
+		const steady_clock::time_point start = steady_clock::now();
+		for (int pass = 0; pass < passes; pass++)
+			runPass();
+		const double seconds = duration<double>(steady_clock::now() - start).count();
+
+		return seconds * 1.0e9 / ((double)count * passes);
+	}
+
+	/*!
+	 *  Times spawning and despawning entities, as projectiles and debris do: every frame
+	 *  a random tenth of a 10k population is despawned and replaced. It goes through a
+	 *  headless session's Spawn, Despawn and structural changes, the way a level does.
+	 */
+	void EntityBenchmark::RunChurn()
+	{
+		const int population = 10000;
+		const int churn = population / 10;
+		const int frames = 1000;
+
+		std::mt19937 random(1234);
+		std::uniform_int_distribution<int> pick(0, population - 1);
+		std::vector<int> victims(churn * frames);
+		for (int& victim : victims)
+			victim = pick(random);
+
+		SessionSettings settings;
+		settings.Headless = true;
+		settings.WorkerThreads = 0;
+		settings.LoadLevel = [](GameSession& /*gs*/) {};
+		GameSession gs(settings);
+		gs.Start();
+
+		auto spawn = [&gs]()
+		{
+			Entity* entity = gs.Spawn("churn");
+			entity->AddConstruct(gs.GetConstructRegistry()->Create<BenchmarkConstruct>(gs.GetWorld()));
+			return entity->GetHandle();
+		};
+
+		std::vector<EntityHandle> handles(population);
+		for (EntityHandle& handle : handles)
+			handle = spawn();
+		gs.ApplyStructuralChanges();
+
+		const double session = TimePerEntity(churn, frames, [&, frame = 0]() mutable
+			{
+				for (int i = 0; i < churn; i++)
+				{
+					EntityHandle& handle = handles[victims[frame * churn + i]];
+					gs.Despawn(handle);
+					handle = spawn();
+				}
+				gs.ApplyStructuralChanges();
+				frame++;
+			});
+
+		gs.End();
+
+		std::cout << "Spawn + despawn through GameSession (ns per entity), " << churn
+			<< " per frame out of " << population << std::endl;
+		std::cout << "session\t" << session << std::endl;
+	}
+
+	/*!
+	 *  Times despawning boxes while they stand on the ground, and spawning replacements
+	 *  that land where they were. The ground contacts of a despawned box end after its
+	 *  construct is gone, so this also checks that every box left standing is still
+	 *  counted as grounded.
+	 */
+	void EntityBenchmark::RunGroundedChurn()
+	{
+		const int population = 500;
+		const int churn = population / 10;
+		const int frames = 100;
+		const int settleSteps = 60;
+
+		SessionSettings settings;
+		settings.Headless = true;
+		settings.WorkerThreads = 0;
+		settings.LoadLevel = [](GameSession& /*gs*/) {};
+		GameSession gs(settings);
+		gs.Start();
+		b2World* world = gs.GetPhysics()->GetWorld();
+
+		SingleShape* ground = gs.GetConstructRegistry()->Create<SingleShape>(world);
+		ground->BodyDef.position.Set(0.0f, -10.0f);
+		ground->BodyDef.type = b2_staticBody;
+		ground->Shape.SetAsBox(50.0f, 10.0f);
+		gs.Spawn("ground")->AddConstruct(ground);
+
+		// a row of small boxes resting on the ground, a box width apart
+		auto spawn = [&gs, world](int column)
+		{
+			SingleShape* box = gs.GetConstructRegistry()->Create<SingleShape>(world);
+			box->BodyDef.position.Set(-45.0f + column * 0.18f, 0.05f);
+			box->BodyDef.type = b2_dynamicBody;
+			box->FixtureDef.density = 1.0f;
+			box->Shape.SetAsBox(0.05f, 0.05f);
+			Entity* entity = gs.Spawn("box");
+			entity->AddConstruct(box);
+			return entity->GetHandle();
+		};
+
+		std::vector<EntityHandle> handles(population);
+		for (int i = 0; i < population; i++)
+			handles[i] = spawn(i);
+		gs.ApplyStructuralChanges();
+		for (int step = 0; step < settleSteps; step++)
+			gs.FixedStep();
+
+		std::mt19937 random(1234);
+		std::uniform_int_distribution<int> pick(0, population - 1);
+		double seconds = 0.0;
+		for (int frame = 0; frame < frames; frame++)
+		{
+			using namespace std::chrono;
+			const steady_clock::time_point start = steady_clock::now();
+			for (int i = 0; i < churn; i++)
+			{
+				const int column = pick(random);
+				gs.Despawn(handles[column]);
+				handles[column] = spawn(column);
+			}
+			gs.ApplyStructuralChanges();
+			seconds += duration<double>(steady_clock::now() - start).count();
+
+			gs.FixedStep();
+		}
+
+		for (int step = 0; step < settleSteps; step++)
+			gs.FixedStep();
+
+		int grounded = 0;
+		for (const EntityHandle& handle : handles)
+			grounded += gs.GetEntity(handle)->GetConstruct().Query(ConstructQuery::IsGrounded);
+
+		gs.End();
+
+		std::cout << "Despawning grounded boxes (ns per box), " << churn << " per frame out of "
+			<< population << std::endl;
+		std::cout << "session\t" << seconds * 1.0e9 / ((double)churn * frames) << std::endl;
+		if (grounded != population)
+			std::cout << "Warning - EntityBenchmark - " << population - grounded
+				<< " boxes standing on the ground aren't grounded" << std::endl;
+	}
+
+	/*!
+	 *  Times the fixed update of 10k, 100k and 1M entities in both layouts and prints
+	 *  the per-entity cost. The legacy layout is also run in shuffled order, which is
+	 *  how its heap looks once a long session has spawned and freed entities. Then
+	 *  times spawn and despawn churn.
+	 */
+	void EntityBenchmark::Run()
+	{
+		const int counts[] = { 10000, 100000, 1000000 };
+		const double alpha = 1.0 / 30.0;
+
+		std::cout << "Entity fixed update (ns per entity)" << std::endl;
+		std::cout << "entities\tlegacy\tlegacy shuffled\tregistry" << std::endl;
+
+		for (int count : counts)
+		{
+			// about ten million updates per layout, at least a few passes each
+			const int passes = std::max(5, 10000000 / count);
+
+			// legacy layout, heap entities and constructs in creation order
+			std::vector<LegacyEntity*> entities;
+			entities.reserve(count);
+			for (int i = 0; i < count; i++)
+			{
+				LegacyEntity* entity = new LegacyEntity();
+				entity->ID = i + 1;
+				entity->Construct = new LegacyBenchmarkConstruct();
+				entities.push_back(entity);
+			}
+
+			const double legacy = TimePerEntity(count, passes, [&]()
+				{
+					for (LegacyEntity* entity : entities)
+						entity->FixedUpdate(alpha);
+				});
+
+			std::shuffle(entities.begin(), entities.end(), std::mt19937(1234));
+			const double shuffled = TimePerEntity(count, passes, [&]()
+				{
+					for (LegacyEntity* entity : entities)
+						entity->FixedUpdate(alpha);
+				});
+
+			for (LegacyEntity* entity : entities)
+			{
+				delete entity->Construct;
+				delete entity;
+			}
+
+			// registry layout
+			ConstructRegistry registry;
+			for (int i = 0; i < count; i++)
+				registry.Create<BenchmarkConstruct>(nullptr);
+
+			const double pooled = TimePerEntity(count, passes, [&]()
+				{
+					registry.FixedUpdate(alpha);
+				});
+
+			std::cout << count << "\t\t" << legacy << "\t" << shuffled << "\t\t" << pooled
+				<< std::endl;
+		}
+
+		RunChurn();
+		RunGroundedChurn();
+	}
+}
\ No newline at end of file
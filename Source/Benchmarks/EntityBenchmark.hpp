@@ -0,0 +1,38 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file EntityBenchmark.hpp
+  * \author Joe Goldman
+  * \brief EntityBenchmark class declaration
+  *
+  */
+
+#pragma once
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief	Measures the per-entity cost of a fixed update, walking heap allocated
+	 *			entities and their constructs (the old layout) against walking the
+	 *			ConstructRegistry, at 10k to 1M entities. Also measures spawning and
+	 *			despawning through a headless GameSession, and despawning boxes while
+	 *			they stand on the ground.
+	 */
+	class EntityBenchmark
+	{
+	public:
+		static void Run();
+
+	private:
+		static void RunChurn();
+		static void RunGroundedChurn();
+	};
+}
\ No newline at end of file
@@ -0,0 +1,176 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file FluidBenchmark.cpp
+  * \author Joe Goldman
+  * \brief FluidBenchmark class definition
+  *
+  **/
+
+#include <Benchmarks/FluidBenchmark.hpp>
+#include <Physics/Box2d.hpp>
+#include <Physics/ParticleFluid.hpp>
+#include <Core/JobSystem.hpp>
+
+#include <chrono> // steady_clock
+#include <cmath> // sqrt
+#include <iostream> // cout, endl
+
+namespace GenevaEngine
+{
+	static const int k_counts[] = { 50000, 100000, 200000 };
+	static const int k_circleCount = 2000;
+	static const int k_boxCount = 8;
+	static const int k_steps = 30;
+	static const float k_timeStep = 1.0f / 60.0f;
+	static const float k_gravity = -200.0f;
+
+	/*!
+	 *  Builds a static bin three times as wide as a square of count particles, and
+	 *  twice as tall
+	 *
+	 *      \param [in] world
+	 *      \param [in] width	of the square
+	 */
+	static void BuildBin(b2World& world, float width)
+	{
+		b2BodyDef bodyDef;
+		b2Body* bin = world.CreateBody(&bodyDef);
+		const float halfWidth = 1.5f * width;
+
+		b2PolygonShape box;
+		box.SetAsBox(halfWidth + 2.0f, 1.0f, b2Vec2(0.0f, -1.0f), 0.0f);
+		bin->CreateFixture(&box, 0.0f);
+		box.SetAsBox(1.0f, width, b2Vec2(-halfWidth - 1.0f, width), 0.0f);
+		bin->CreateFixture(&box, 0.0f);
+		box.SetAsBox(1.0f, width, b2Vec2(halfWidth + 1.0f, width), 0.0f);
+		bin->CreateFixture(&box, 0.0f);
+	}
+
+	/*!
+	 *  Fills the left third of the bin with a square of particles, and floats light
+	 *  boxes in the rest of it, where the wave will hit them
+	 *
+	 *      \param [in]     world
+	 *      \param [in,out] fluid
+	 *      \param [in]     count
+	 */
+	static void BuildDam(b2World& world, ParticleFluid& fluid, int count)
+	{
+		const float width = std::sqrt((float)count) * fluid.Spacing;
+		BuildBin(world, width);
+
+		b2AABB dam;
+		dam.lowerBound.Set(-1.5f * width, 0.0f);
+		dam.upperBound.Set(-0.5f * width, width);
+		fluid.Reserve(count);
+		fluid.CreateBox(dam);
+
+		b2BodyDef bodyDef;
+		bodyDef.type = b2_dynamicBody;
+		b2PolygonShape box;
+		box.SetAsBox(0.02f * width, 0.02f * width);
+		for (int i = 0; i < k_boxCount; i++)
+		{
+			bodyDef.position.Set(-0.4f * width + 1.8f * width * i / k_boxCount, 0.02f * width);
+			world.CreateBody(&bodyDef)->CreateFixture(&box, 0.5f);
+		}
+	}
+
+	/*!
+	 *  Breaks the dam, then prints how long a step took, per particle, and how many
+	 *  particles left the bin
+	 *
+	 *      \param [in] count
+	 *      \param [in] jobSystem	nullptr to step on this thread
+	 */
+	static void StepDam(int count, JobSystem* jobSystem)
+	{
+		using namespace std::chrono;
+
+		b2World world(b2Vec2(0.0f, k_gravity));
+		ParticleFluid fluid;
+		BuildDam(world, fluid, count);
+		const int created = fluid.GetParticleCount();
+
+		const steady_clock::time_point start = steady_clock::now();
+		for (int i = 0; i < k_steps; i++)
+		{
+			world.Step(k_timeStep, 8, 3);
+			fluid.Step(world, k_timeStep, jobSystem);
+		}
+		const double ms = duration<double, std::milli>(steady_clock::now() - start).count() / k_steps;
+
+		std::cout << created << "\t\t" << (jobSystem != nullptr ? jobSystem->GetThreadCount() : 1)
+			<< "\t" << ms << "\t\t" << 1000.0 * ms / created << "\t\t\t"
+			<< created - fluid.GetParticleCount() << std::endl;
+	}
+
+	/*!
+	 *  Drops a pile of rigid circles as big as the particles into a bin, which is
+	 *  how the levels made liquid before, and prints the time per circle. At the
+	 *  game's gravity small circles fall through each other in a step, so most of
+	 *  it goes to time of impact.
+	 */
+	static void StepCircles()
+	{
+		using namespace std::chrono;
+
+		b2World world(b2Vec2(0.0f, k_gravity));
+		ParticleFluid fluid;
+		const float width = std::sqrt((float)k_circleCount) * fluid.Spacing;
+		BuildBin(world, width);
+
+		b2BodyDef bodyDef;
+		bodyDef.type = b2_dynamicBody;
+		b2CircleShape circle;
+		circle.m_radius = 0.5f * fluid.Spacing;
+		const int columns = (int)(width / fluid.Spacing);
+		for (int i = 0; i < k_circleCount; i++)
+		{
+			bodyDef.position.Set(-1.5f * width + fluid.Spacing * (i % columns + 0.5f),
+				fluid.Spacing * (i / columns + 0.5f));
+			world.CreateBody(&bodyDef)->CreateFixture(&circle, 1.0f);
+		}
+
+		float toi = 0.0f;
+		const steady_clock::time_point start = steady_clock::now();
+		for (int i = 0; i < k_steps; i++)
+		{
+			world.Step(k_timeStep, 8, 3);
+			toi += world.GetProfile().solveTOI;
+		}
+		const double ms = duration<double, std::milli>(steady_clock::now() - start).count() / k_steps;
+
+		std::cout << k_circleCount << " rigid circles	" << ms << " ms per step, " << 1000.0 * ms / k_circleCount
+			<< " us per circle, " << 100.0 * toi / k_steps / ms << "% in time of impact" << std::endl;
+	}
+
+	/*!
+	 *  Breaks each dam on one thread and on the job system, then steps the circles
+	 */
+	void FluidBenchmark::Run()
+	{
+		JobSystem jobSystem;
+
+		std::cout << "Dam break, " << k_boxCount << " floating boxes, " << k_steps << " steps" << std::endl;
+		std::cout << "particles\tthreads\tstep (ms)\tper particle (us)\tlost" << std::endl;
+		for (int count : k_counts)
+		{
+			StepDam(count, nullptr);
+			StepDam(count, &jobSystem);
+		}
+
+		std::cout << std::endl;
+		StepCircles();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file FluidBenchmark.hpp
+  * \author Joe Goldman
+  * \brief FluidBenchmark class declaration
+  *
+  */
+
+#pragma once
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief	Breaks a dam of 50k, 100k and 200k fluid particles in a bin with boxes
+	 *			floating in it, stepping the particle fluid on one thread and on the
+	 *			job system. Prints the step time, the time per particle and the
+	 *			particles lost, then the cost of a pile of rigid circles for scale.
+	 */
+	class FluidBenchmark
+	{
+	public:
+		static void Run();
+	};
+}
\ No newline at end of file
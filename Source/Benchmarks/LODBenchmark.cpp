@@ -0,0 +1,144 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file LODBenchmark.cpp
+  * \author Joe Goldman
+  * \brief LODBenchmark class definition
+  *
+  **/
+
+#include <Benchmarks/LODBenchmark.hpp>
+#include <Physics/Box2d.hpp>
+#include <Physics/PhysicsLOD.hpp>
+
+#include <chrono> // steady_clock
+#include <iostream> // cout, endl
+
+namespace GenevaEngine
+{
+	static const int k_mixers = 40;
+	static const float k_mixerSpacing = 100.0f;
+	static const int k_boxesPerMixer = 60;
+	static const int k_steps = 300;
+	static const float k_timeStep = 1.0f / 60.0f;
+
+	/*!
+	 *  Builds a row of mixers along the x axis, each a static bin holding boxes and a
+	 *  kinematic paddle spinning in it
+	 *
+	 *      \param [in] world
+	 */
+	static void BuildLevel(b2World& world)
+	{
+		b2BodyDef bodyDef;
+		b2PolygonShape box;
+		const float left = -0.5f * k_mixerSpacing * (k_mixers - 1);
+
+		for (int i = 0; i < k_mixers; i++)
+		{
+			const float x = left + k_mixerSpacing * i;
+
+			// bin, a floor and two walls
+			bodyDef.type = b2_staticBody;
+			bodyDef.position.Set(x, 0.0f);
+			b2Body* bin = world.CreateBody(&bodyDef);
+			box.SetAsBox(12.0f, 0.5f);
+			bin->CreateFixture(&box, 0.0f);
+			box.SetAsBox(0.5f, 10.0f, b2Vec2(-12.0f, 10.0f), 0.0f);
+			bin->CreateFixture(&box, 0.0f);
+			box.SetAsBox(0.5f, 10.0f, b2Vec2(12.0f, 10.0f), 0.0f);
+			bin->CreateFixture(&box, 0.0f);
+
+			// paddle
+			bodyDef.type = b2_kinematicBody;
+			bodyDef.position.Set(x, 6.0f);
+			bodyDef.angularVelocity = 1.5f;
+			b2Body* paddle = world.CreateBody(&bodyDef);
+			box.SetAsBox(5.0f, 0.4f);
+			paddle->CreateFixture(&box, 0.0f);
+			bodyDef.angularVelocity = 0.0f;
+
+			// boxes
+			bodyDef.type = b2_dynamicBody;
+			box.SetAsBox(0.5f, 0.5f);
+			for (int j = 0; j < k_boxesPerMixer; j++)
+			{
+				bodyDef.position.Set(x - 10.0f + 1.25f * (j % 16), 12.0f + 1.25f * (j / 16));
+				world.CreateBody(&bodyDef)->CreateFixture(&box, 1.0f);
+			}
+		}
+	}
+
+	/*!
+	 *  \brief What stepping the level cost
+	 */
+	struct LevelCost
+	{
+		double StepTime = 0.0;	// milliseconds per step
+		double Frozen = 0.0;	// bodies frozen per step
+	};
+
+	/*!
+	 *  Steps the level, with a camera panning along it if there's a LOD
+	 *
+	 *      \param [in] lod	nullptr steps every body
+	 */
+	static LevelCost StepLevel(PhysicsLOD* lod)
+	{
+		using namespace std::chrono;
+
+		b2World world(b2Vec2(0.0f, -10.0f));
+		BuildLevel(world);
+
+		LevelCost cost;
+		double time = 0.0;
+		const float start = -0.5f * k_mixerSpacing * (k_mixers - 1);
+		for (int i = 0; i < k_steps; i++)
+		{
+			const steady_clock::time_point stepStart = steady_clock::now();
+			if (lod != nullptr)
+			{
+				// 60 m/s, the camera crosses three mixers
+				lod->SetCamera(b2Vec2(start + 1.0f * i, 10.0f));
+				lod->Update(world);
+				cost.Frozen += lod->GetFrozenCount();
+			}
+			world.Step(k_timeStep, 8, 3);
+			time += duration<double, std::milli>(steady_clock::now() - stepStart).count();
+		}
+
+		if (lod != nullptr)
+			lod->ThawAll();
+
+		cost.StepTime = time / k_steps;
+		cost.Frozen /= k_steps;
+		return cost;
+	}
+
+	/*!
+	 *  Steps the level without and with the LOD, and prints the cost of each
+	 */
+	void LODBenchmark::Run()
+	{
+		std::cout << k_mixers << " mixers of " << k_boxesPerMixer << " boxes, "
+			<< k_mixerSpacing << " m apart" << std::endl;
+		std::cout << "stepping\tstep (ms)\tfrozen bodies" << std::endl;
+
+		const LevelCost full = StepLevel(nullptr);
+		std::cout << "full\t\t" << full.StepTime << "\t\t" << full.Frozen << std::endl;
+
+		PhysicsLOD lod;
+		const LevelCost frozen = StepLevel(&lod);
+		std::cout << "LOD " << lod.Radius << " m\t" << frozen.StepTime << "\t\t" << frozen.Frozen
+			<< std::endl;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file LODBenchmark.hpp
+  * \author Joe Goldman
+  * \brief LODBenchmark class declaration
+  *
+  */
+
+#pragma once
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief	Measures a wide level of mixers, bins of boxes stirred by kinematic
+	 *			paddles that never let them sleep, stepped in full and with PhysicsLOD
+	 *			following a camera that pans along it. Prints the step times and how
+	 *			many bodies were frozen.
+	 */
+	class LODBenchmark
+	{
+	public:
+		static void Run();
+	};
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file RayCastBenchmark.cpp
+  * \author Joe Goldman
+  * \brief RayCastBenchmark class definition
+  *
+  **/
+
+#include <Benchmarks/RayCastBenchmark.hpp>
+#include <Physics/Box2d.hpp>
+#include <Physics/JobTaskExecutor.hpp>
+#include <Core/JobSystem.hpp>
+
+#include <chrono> // steady_clock
+#include <cmath> // sqrt
+#include <cstdint> // uint32_t
+#include <iostream> // cout, endl
+#include <vector> // vector
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief Keeps the closest hit of a ray
+	 */
+	class ClosestHit : public b2RayCastCallback
+	{
+	public:
+		b2Fixture* Fixture = nullptr;
+		float Fraction = 1.0f;
+
+		float ReportFixture(b2Fixture* fixture, const b2Vec2& /*point*/, const b2Vec2& /*normal*/,
+			float fraction) override
+		{
+			Fixture = fixture;
+			Fraction = fraction;
+			return fraction;
+		}
+	};
+
+	/*!
+	 *  A repeatable random number in [-1, 1]
+	 */
+	static float Random(uint32_t& state)
+	{
+		state = state * 1664525u + 1013904223u;
+		return (float)(state >> 8) / (float)(1 << 23) - 1.0f;
+	}
+
+	/*!
+	 *  Fills a world with count static boxes of mixed sizes, scattered over a square
+	 *  with about eight square meters each, and builds its tree top down
+	 *
+	 *      \param [in] world
+	 *      \param [in] count
+	 *      \param [in] halfSize	half the square's width
+	 */
+	static void BuildLevel(b2World& world, int count, float halfSize)
+	{
+		uint32_t state = 777u;
+		b2BodyDef bodyDef;
+		b2PolygonShape box;
+		for (int i = 0; i < count; i++)
+		{
+			bodyDef.position.Set(halfSize * Random(state), halfSize * Random(state));
+			bodyDef.angle = b2_pi * Random(state);
+			box.SetAsBox(1.25f + Random(state), 1.25f + Random(state));
+			world.CreateBody(&bodyDef)->CreateFixture(&box, 0.0f);
+		}
+		world.RebuildBroadPhase();
+	}
+
+	/*!
+	 *  Each agent casts a 2 m ray down to look for ground, and a ray of up to 30 m
+	 *  toward another agent to check the line of sight
+	 *
+	 *      \param [in] agents
+	 *      \param [in] halfSize	half the width of the square the agents stand on
+	 *
+	 *      \return The rays, the ground rays first.
+	 */
+	static std::vector<b2RayCastInput> MakeRays(int agents, float halfSize)
+	{
+		uint32_t state = 4242u;
+		std::vector<b2RayCastInput> rays(2 * agents);
+		for (int i = 0; i < agents; i++)
+		{
+			b2Vec2 position(halfSize * Random(state), halfSize * Random(state));
+
+			b2RayCastInput& ground = rays[i];
+			ground.p1 = position;
+			ground.p2 = position + b2Vec2(0.0f, -2.0f);
+			ground.maxFraction = 1.0f;
+
+			b2RayCastInput& sight = rays[agents + i];
+			sight.p1 = position;
+			sight.p2 = position + b2Vec2(30.0f * Random(state), 30.0f * Random(state));
+			sight.maxFraction = 1.0f;
+		}
+		return rays;
+	}
+
+	/*!
+	 *  Casts the rays at 1k, 4k and 16k agents one at a time, batched on this thread,
+	 *  and batched on the job system, and prints the time per ray
+	 */
+	void RayCastBenchmark::Run()
+	{
+		using namespace std::chrono;
+
+		const int agentCounts[] = { 1000, 4000, 16000 };
+		const int fixtures = 10000;
+		const int repeats = 5;
+		const float halfSize = std::sqrt(8.0f * fixtures) * 0.5f;
+
+		JobSystem jobSystem;
+		JobTaskExecutor executor(&jobSystem);
+
+		b2World world(b2Vec2(0.0f, -10.0f));
+		BuildLevel(world, fixtures, halfSize);
+
+		std::cout << "Ground and line of sight rays over " << fixtures << " static boxes" << std::endl;
+		std::cout << "rays\tone at a time (us)\tbatched (us)\tbatched, " << executor.GetThreadCount()
+			<< " threads (us)\thits" << std::endl;
+
+		for (int agents : agentCounts)
+		{
+			const std::vector<b2RayCastInput> rays = MakeRays(agents, halfSize);
+			const double count = (double)rays.size() * repeats;
+			std::vector<ClosestHit> single(rays.size());
+			std::vector<b2RayCastHit> batched(rays.size());
+			std::vector<b2RayCastHit> parallel(rays.size());
+
+			steady_clock::time_point start = steady_clock::now();
+			for (int r = 0; r < repeats; r++)
+			{
+				for (size_t i = 0; i < rays.size(); i++)
+				{
+					single[i] = ClosestHit();
+					world.RayCast(&single[i], rays[i].p1, rays[i].p2);
+				}
+			}
+			const double singleTime = duration<double, std::micro>(steady_clock::now() - start).count() / count;
+
+			start = steady_clock::now();
+			for (int r = 0; r < repeats; r++)
+				world.RayCastClosest(rays.data(), batched.data(), (int32)rays.size(), false);
+			const double batchedTime = duration<double, std::micro>(steady_clock::now() - start).count() / count;
+
+			world.SetTaskExecutor(&executor);
+			start = steady_clock::now();
+			for (int r = 0; r < repeats; r++)
+				world.RayCastClosest(rays.data(), parallel.data(), (int32)rays.size(), true);
+			const double parallelTime = duration<double, std::micro>(steady_clock::now() - start).count() / count;
+			world.SetTaskExecutor(nullptr);
+
+			int hits = 0;
+			int mismatches = 0;
+			for (size_t i = 0; i < rays.size(); i++)
+			{
+				hits += single[i].Fixture != nullptr;
+				if (batched[i].fixture != single[i].Fixture || parallel[i].fixture != single[i].Fixture
+					|| (single[i].Fixture != nullptr && (batched[i].fraction != single[i].Fraction
+					|| parallel[i].fraction != single[i].Fraction)))
+					mismatches++;
+			}
+
+			std::cout << rays.size() << "\t" << singleTime << "\t\t\t" << batchedTime << "\t\t"
+				<< parallelTime << "\t\t\t" << hits << std::endl;
+
+			if (mismatches > 0)
+				std::cout << "Warning - RayCastBenchmark - " << mismatches
+					<< " batched rays found a different hit" << std::endl;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file RayCastBenchmark.hpp
+  * \author Joe Goldman
+  * \brief RayCastBenchmark class declaration
+  *
+  */
+
+#pragma once
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief	Measures casting the ground and line of sight rays of thousands of
+	 *			agents over a level of static boxes, one b2World::RayCast at a time
+	 *			against the packets of b2World::RayCastClosest, which backs
+	 *			Physics::RayCastBatch, on one thread and on the job system. Checks
+	 *			every way finds the same hits.
+	 */
+	class RayCastBenchmark
+	{
+	public:
+		static void Run();
+	};
+}
\ No newline at end of file
@@ -0,0 +1,271 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file RopeBenchmark.cpp
+  * \author Joe Goldman
+  * \brief RopeBenchmark class definition
+  *
+  **/
+
+#include <Benchmarks/RopeBenchmark.hpp>
+#include <Physics/Box2d.hpp>
+#include <Core/GameSession.hpp>
+#include <Constructs/Web.hpp>
+
+#include <chrono> // steady_clock
+#include <iomanip> // setw
+#include <iostream> // cout, endl
+#include <memory> // unique_ptr
+#include <string> // string, to_string
+#include <vector> // vector
+
+namespace GenevaEngine
+{
+	static const int k_strands = 100;
+	static const int k_segments = 100;
+	static const float k_length = 20.0f;
+	static const float k_span = 16.0f;
+	static const float k_strandMass = 0.5f;
+	static const int k_steps = 120;
+	static const float k_timeStep = 1.0f / 30.0f;
+	static const int k_webSteps = 600;
+
+	/*!
+	 *  Where a strand's vertex starts. Strands hang in a V from two points k_span apart,
+	 *  so they start slack and swing.
+	 *
+	 *      \param [in] strand
+	 *      \param [in] vertex	0 to k_segments
+	 */
+	static b2Vec2 VertexPosition(int strand, int vertex)
+	{
+		const float half = 0.5f * k_segments;
+		const float depth = sqrtf(0.25f * (k_length * k_length - k_span * k_span));
+		const float t = (vertex - half) / half;
+		return b2Vec2(0.5f * k_span * t, 2.0f * strand - depth * (1.0f - b2Abs(t)));
+	}
+
+	/*!
+	 *  How far the strand's points are stretched past its length, as a fraction
+	 *
+	 *      \param [in] points	k_segments + 1 of them
+	 */
+	static float Stretch(const b2Vec2* points)
+	{
+		float length = 0.0f;
+		for (int i = 1; i <= k_segments; i++)
+			length += b2Distance(points[i - 1], points[i]);
+		return length / k_length - 1.0f;
+	}
+
+	/*!
+	 *  Prints one row of the results
+	 */
+	static void Report(const char* builtFrom, const std::string& iterations, double ms,
+		float stretch)
+	{
+		std::cout << std::left << std::setw(16) << builtFrom << std::setw(16) << iterations
+			<< std::setw(16) << ms << 100.0f * stretch << std::endl;
+	}
+
+	/*!
+	 *  Builds the strands as chains of point bodies joined by rigid distance joints,
+	 *  hung from a static body, then steps them
+	 *
+	 *      \param [in] velocityIterations
+	 */
+	static void StepChains(int velocityIterations)
+	{
+		using namespace std::chrono;
+
+		b2World world(b2Vec2(0.0f, -10.0f));
+		b2BodyDef bodyDef;
+		b2Body* ground = world.CreateBody(&bodyDef);
+
+		b2MassData massData;
+		massData.mass = k_strandMass / (k_segments - 1);
+		massData.center.SetZero();
+		massData.I = 0.0f;
+
+		std::vector<b2Body*> chains;
+		chains.reserve(k_strands * (k_segments + 1));
+		bodyDef.type = b2_dynamicBody;
+		for (int strand = 0; strand < k_strands; strand++)
+		{
+			chains.push_back(ground);
+			for (int vertex = 1; vertex < k_segments; vertex++)
+			{
+				bodyDef.position = VertexPosition(strand, vertex);
+				b2Body* body = world.CreateBody(&bodyDef);
+				body->SetMassData(&massData);
+				chains.push_back(body);
+			}
+			chains.push_back(ground);
+
+			b2Body** chain = chains.data() + strand * (k_segments + 1);
+			b2DistanceJointDef jointDef;
+			for (int vertex = 1; vertex <= k_segments; vertex++)
+			{
+				jointDef.Initialize(chain[vertex - 1], chain[vertex],
+					VertexPosition(strand, vertex - 1), VertexPosition(strand, vertex));
+				world.CreateJoint(&jointDef);
+			}
+		}
+
+		const steady_clock::time_point start = steady_clock::now();
+		for (int i = 0; i < k_steps; i++)
+			world.Step(k_timeStep, velocityIterations, 3);
+		const double ms = duration<double, std::milli>(steady_clock::now() - start).count();
+
+		float stretch = 0.0f;
+		std::vector<b2Vec2> points(k_segments + 1);
+		for (int strand = 0; strand < k_strands; strand++)
+		{
+			for (int vertex = 0; vertex <= k_segments; vertex++)
+			{
+				b2Body* body = chains[strand * (k_segments + 1) + vertex];
+				points[vertex] = body == ground ? VertexPosition(strand, vertex) : body->GetPosition();
+			}
+			stretch += Stretch(points.data());
+		}
+
+		Report("joints", std::to_string(velocityIterations), ms / k_steps, stretch / k_strands);
+	}
+
+	/*!
+	 *  Builds the strands as b2Ropes with their end vertices pinned, then steps them
+	 *
+	 *      \param [in] subSteps	rope steps per world step
+	 *      \param [in] iterations	per rope step
+	 *      \param [in] tethers
+	 */
+	static void StepRopes(int subSteps, int iterations, bool tethers)
+	{
+		using namespace std::chrono;
+
+		std::vector<b2Vec2> vertices(k_segments + 1);
+		std::vector<float> masses(k_segments + 1, k_strandMass / (k_segments - 1));
+		masses.front() = 0.0f;
+		masses.back() = 0.0f;
+
+		std::vector<std::unique_ptr<b2Rope>> ropes;
+		for (int strand = 0; strand < k_strands; strand++)
+		{
+			for (int vertex = 0; vertex <= k_segments; vertex++)
+				vertices[vertex] = VertexPosition(strand, vertex);
+
+			b2RopeDef def;
+			def.vertices = vertices.data();
+			def.count = k_segments + 1;
+			def.masses = masses.data();
+			def.gravity.Set(0.0f, -10.0f);
+			def.tuning.tethers = tethers;
+
+			ropes.push_back(std::make_unique<b2Rope>());
+			ropes.back()->Create(def);
+		}
+
+		const steady_clock::time_point start = steady_clock::now();
+		for (int i = 0; i < k_steps; i++)
+		{
+			for (std::unique_ptr<b2Rope>& rope : ropes)
+			{
+				for (int j = 0; j < subSteps; j++)
+					rope->Step(k_timeStep / subSteps, iterations, b2Vec2(0.0f, 0.0f));
+			}
+		}
+		const double ms = duration<double, std::milli>(steady_clock::now() - start).count();
+
+		float stretch = 0.0f;
+		for (std::unique_ptr<b2Rope>& rope : ropes)
+			stretch += Stretch(rope->GetVertices());
+
+		Report(tethers ? "tethered ropes" : "ropes", std::to_string(subSteps) + " x "
+			+ std::to_string(iterations), ms / k_steps, stretch / k_strands);
+	}
+
+	/*!
+	 *  Hangs a Web in a headless session and steps it. Prints the largest drift of any
+	 *  strand's anchors past the strand's length, and the mean drift at the last step.
+	 *  The strands' joints only give way by the world solver's slop.
+	 */
+	void RopeBenchmark::StepWeb()
+	{
+		using namespace std::chrono;
+
+		SessionSettings settings;
+		settings.Headless = true;
+		settings.WorkerThreads = 0;
+		settings.LoadLevel = [](GameSession& /*gs*/) {};
+		GameSession gs(settings);
+		gs.Start();
+
+		Web* web = gs.GetConstructRegistry()->Create<Web>(gs.GetPhysics()->GetWorld());
+		gs.Spawn("web")->AddConstruct(web);
+		gs.ApplyStructuralChanges();
+
+		// a strand's ends sit on its anchors
+		auto anchorDistance = [web](int strand)
+		{
+			const b2Rope& rope = web->GetStrand(strand);
+			return b2Distance(rope.GetVertices()[0], rope.GetVertices()[rope.GetVertexCount() - 1]);
+		};
+
+		std::vector<float> lengths(web->GetStrandCount());
+		for (int i = 0; i < web->GetStrandCount(); i++)
+			lengths[i] = anchorDistance(i);
+
+		float largest = 0.0f;
+		const steady_clock::time_point start = steady_clock::now();
+		for (int step = 0; step < k_webSteps; step++)
+		{
+			gs.FixedStep();
+			for (int i = 0; i < web->GetStrandCount(); i++)
+				largest = b2Max(largest, anchorDistance(i) - lengths[i]);
+		}
+		const double ms = duration<double, std::milli>(steady_clock::now() - start).count();
+
+		float last = 0.0f;
+		for (int i = 0; i < web->GetStrandCount(); i++)
+			last += b2Max(anchorDistance(i) - lengths[i], 0.0f);
+		last /= web->GetStrandCount();
+
+		gs.End();
+
+		std::cout << std::left << std::setw(16) << ms / k_webSteps
+			<< std::setw(24) << largest << last << std::endl;
+	}
+
+	/*!
+	 *  Steps the strands built each way, and prints the cost and stretch of each
+	 */
+	void RopeBenchmark::Run()
+	{
+		std::cout << k_strands << " strands of " << k_segments << " segments, " << k_steps
+			<< " steps" << std::endl;
+		std::cout << std::left << std::setw(16) << "built from" << std::setw(16) << "iterations"
+			<< std::setw(16) << "step (ms)" << "stretch (%)" << std::endl;
+
+		StepChains(8);
+		StepChains(32);
+		StepRopes(1, 2, false);
+		StepRopes(1, 8, false);
+		StepRopes(1, 2, true);
+		StepRopes(4, 1, true);
+
+		std::cout << "Web boxes anchored by strands, " << k_webSteps << " steps" << std::endl;
+		std::cout << std::left << std::setw(16) << "step (ms)"
+			<< std::setw(24) << "largest drift (m)" << "drift at the end (m)" << std::endl;
+
+		StepWeb();
+	}
+}
\ No newline at end of file
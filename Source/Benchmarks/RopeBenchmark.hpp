@@ -0,0 +1,39 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file RopeBenchmark.hpp
+  * \author Joe Goldman
+  * \brief RopeBenchmark class declaration
+  *
+  */
+
+#pragma once
+
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief	Hangs slack strands between fixed points, built as chains of bodies and
+	 *			distance joints, then as b2Ropes. Prints the step times, and how far the
+	 *			strands stretched past their length at each iteration count. Then hangs
+	 *			the Web's boxes in a headless GameSession, and prints how far the
+	 *			anchored boxes drift past their strands' length.
+	 */
+	class RopeBenchmark
+	{
+	public:
+		static void Run();
+
+	private:
+		static void StepWeb();
+	};
+}
\ No newline at end of file
@@ -0,0 +1,208 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file SoftBodyBenchmark.cpp
+  * \author Joe Goldman
+  * \brief SoftBodyBenchmark class definition
+  *
+  **/
+
+#include <Benchmarks/SoftBodyBenchmark.hpp>
+#include <Physics/Box2d.hpp>
+#include <Physics/SoftLattice.hpp>
+
+#include <chrono> // steady_clock
+#include <iostream> // cout, endl
+
+namespace GenevaEngine
+{
+	static const int k_columns = 50;
+	static const int k_rows = 20;
+	static const float k_size = 4.0f;
+	static const float k_spacing = 5.0f;
+	static const int k_steps = 300;
+	static const int k_resolutionSteps = 100;
+	static const int k_resolutions[] = { 3, 4, 6, 8, 12 };
+	static const float k_timeStep = 1.0f / 60.0f;
+
+	/*!
+	 *  Builds a static bin wide enough for the columns
+	 *
+	 *      \param [in] world
+	 */
+	static void BuildBin(b2World& world)
+	{
+		b2BodyDef bodyDef;
+		b2Body* bin = world.CreateBody(&bodyDef);
+		const float halfWidth = 0.5f * k_spacing * k_columns + 1.0f;
+
+		b2PolygonShape box;
+		box.SetAsBox(halfWidth, 1.0f, b2Vec2(0.0f, -1.0f), 0.0f);
+		bin->CreateFixture(&box, 0.0f);
+		box.SetAsBox(1.0f, 50.0f, b2Vec2(-halfWidth - 1.0f, 50.0f), 0.0f);
+		bin->CreateFixture(&box, 0.0f);
+		box.SetAsBox(1.0f, 50.0f, b2Vec2(halfWidth + 1.0f, 50.0f), 0.0f);
+		bin->CreateFixture(&box, 0.0f);
+	}
+
+	/*!
+	 *  Where the soft box in a column and row starts
+	 */
+	static b2Vec2 BoxPosition(int column, int row)
+	{
+		const float left = -0.5f * k_spacing * (k_columns - 1);
+		return b2Vec2(left + k_spacing * column, 0.5f * k_size + 1.0f + k_spacing * row);
+	}
+
+	/*!
+	 *  The old SoftBox: a center circle and four corner circles, with a distance joint
+	 *  from the center to each corner and around the corners
+	 *
+	 *      \param [in] world
+	 *      \param [in] center
+	 */
+	static void CreateJointBox(b2World& world, const b2Vec2& center)
+	{
+		const float h = 0.5f * k_size;
+		const b2Vec2 offsets[5] = { b2Vec2(0.0f, 0.0f), b2Vec2(-h, -h), b2Vec2(-h, h),
+			b2Vec2(h, h), b2Vec2(h, -h) };
+
+		b2BodyDef bodyDef;
+		bodyDef.type = b2_dynamicBody;
+		bodyDef.fixedRotation = true;
+		b2CircleShape circle;
+		b2Body* bodies[5];
+		for (int i = 0; i < 5; i++)
+		{
+			bodyDef.position = center + offsets[i];
+			circle.m_radius = i == 0 ? 0.2f * k_size : 0.1f * k_size;
+			bodies[i] = world.CreateBody(&bodyDef);
+			bodies[i]->CreateFixture(&circle, i == 0 ? 0.5f : 5.0f);
+		}
+
+		const int links[8][2] = { {0, 1}, {0, 2}, {0, 3}, {0, 4}, {1, 2}, {2, 3}, {3, 4}, {4, 1} };
+		b2DistanceJointDef jointDef;
+		for (const auto& link : links)
+		{
+			jointDef.bodyA = bodies[link[0]];
+			jointDef.bodyB = bodies[link[1]];
+			jointDef.length = b2Distance(jointDef.bodyA->GetPosition(), jointDef.bodyB->GetPosition());
+			b2LinearStiffness(jointDef.stiffness, jointDef.damping, 8.0f, 0.01f,
+				jointDef.bodyA, jointDef.bodyB);
+			world.CreateJoint(&jointDef);
+		}
+	}
+
+	/*!
+	 *  The lattice every soft box is made from, resolution particles on a side
+	 *
+	 *      \param [in] resolution
+	 */
+	static SoftLattice BuildLattice(int resolution)
+	{
+		SoftLattice lattice;
+		lattice.Columns = resolution;
+		lattice.Rows = resolution;
+		lattice.Size = b2Vec2(k_size, k_size);
+		lattice.Radius = 0.1f * k_size;
+		lattice.StructuralCompliance = 5.0e-5f;
+		lattice.ShearCompliance = 5.0e-5f;
+		lattice.BendCompliance = 5.0e-5f;
+		lattice.Build();
+		return lattice;
+	}
+
+	/*!
+	 *  Builds the bin and its soft boxes as joint rigs, then steps them
+	 *
+	 *      \return Milliseconds per step.
+	 */
+	static double StepJointBoxes()
+	{
+		using namespace std::chrono;
+
+		b2World world(b2Vec2(0.0f, -10.0f));
+		BuildBin(world);
+		for (int row = 0; row < k_rows; row++)
+		{
+			for (int column = 0; column < k_columns; column++)
+				CreateJointBox(world, BoxPosition(column, row));
+		}
+
+		const steady_clock::time_point start = steady_clock::now();
+		for (int i = 0; i < k_steps; i++)
+			world.Step(k_timeStep, 8, 3);
+		const double ms = duration<double, std::milli>(steady_clock::now() - start).count();
+
+		std::cout << "joints\t\t" << ms / k_steps << "\t\t" << world.GetBodyCount() - 1
+			<< " bodies, " << world.GetJointCount() << " joints" << std::endl;
+		return ms / k_steps;
+	}
+
+	/*!
+	 *  Builds the bin and its soft boxes from one shared lattice, then steps them
+	 *
+	 *      \param [in] lattice
+	 *      \param [in] steps
+	 *
+	 *      \return Milliseconds per step.
+	 */
+	static double StepSoftBoxes(const SoftLattice& lattice, int steps)
+	{
+		using namespace std::chrono;
+
+		b2World world(b2Vec2(0.0f, -10.0f));
+		BuildBin(world);
+		lattice.Reserve(world, k_rows * k_columns);
+		for (int row = 0; row < k_rows; row++)
+		{
+			for (int column = 0; column < k_columns; column++)
+			{
+				b2SoftBodyDef def = lattice.GetDef(BoxPosition(column, row));
+				def.linearDamping = 0.5f;
+				world.CreateSoftBody(&def);
+			}
+		}
+
+		const steady_clock::time_point start = steady_clock::now();
+		for (int i = 0; i < steps; i++)
+			world.Step(k_timeStep, 8, 3);
+		const double ms = duration<double, std::milli>(steady_clock::now() - start).count();
+		return ms / steps;
+	}
+
+	/*!
+	 *  Steps the soft boxes built both ways, and prints the cost of each
+	 */
+	void SoftBodyBenchmark::Run()
+	{
+		std::cout << k_columns * k_rows << " soft boxes, " << k_steps << " steps" << std::endl;
+		std::cout << "built from\tstep (ms)\tsolver objects" << std::endl;
+
+		const double joints = StepJointBoxes();
+		const SoftLattice lattice = BuildLattice(4);
+		const double softBodies = StepSoftBoxes(lattice, k_steps);
+		std::cout << "soft bodies\t" << softBodies << "\t\t" << k_columns * k_rows
+			<< " soft bodies" << std::endl;
+		std::cout << "speedup\t\t" << joints / softBodies << "x" << std::endl;
+
+		std::cout << std::endl << k_resolutionSteps << " steps by lattice resolution" << std::endl;
+		std::cout << "lattice\tparticles\tlinks\t\tstep (ms)" << std::endl;
+		for (int resolution : k_resolutions)
+		{
+			const SoftLattice lattice = BuildLattice(resolution);
+			const double ms = StepSoftBoxes(lattice, k_resolutionSteps);
+			std::cout << resolution << "x" << resolution << "\t" << k_columns * k_rows * lattice.GetParticleCount()
+				<< "\t\t" << k_columns * k_rows * lattice.GetLinkCount() << "\t\t" << ms << std::endl;
+		}
+	}
+}
\ No newline at end of file
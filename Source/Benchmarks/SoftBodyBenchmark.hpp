@@ -0,0 +1,34 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file SoftBodyBenchmark.hpp
+  * \author Joe Goldman
+  * \brief SoftBodyBenchmark class declaration
+  *
+  */
+
+#pragma once
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief	Drops rows of soft boxes into a long bin, built the old way from circle
+	 *			bodies and distance joints, then as box2d soft bodies. Prints the step
+	 *			times and how many solver objects each took, then how the soft body
+	 *			step time grows with the lattice resolution.
+	 */
+	class SoftBodyBenchmark
+	{
+	public:
+		static void Run();
+	};
+}
\ No newline at end of file
@@ -0,0 +1,200 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file StaticTreeBenchmark.cpp
+  * \author Joe Goldman
+  * \brief StaticTreeBenchmark class definition
+  *
+  **/
+
+#include <Benchmarks/StaticTreeBenchmark.hpp>
+#include <Physics/Box2d.hpp>
+#include <Physics/JobTaskExecutor.hpp>
+#include <Core/JobSystem.hpp>
+
+#include <chrono> // steady_clock
+#include <cmath> // sqrt
+#include <cstdint> // uint32_t
+#include <iostream> // cout, endl
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief Keeps the closest hit of each ray, and counts the rays that hit
+	 */
+	class ClosestHitCounter : public b2RayCastCallback
+	{
+	public:
+		int Hits = 0;
+
+		float ReportFixture(b2Fixture* /*fixture*/, const b2Vec2& /*point*/, const b2Vec2& /*normal*/,
+			float fraction) override
+		{
+			m_hit = true;
+			return fraction;
+		}
+
+		void Reset() { m_hit = false; }
+		void Count() { Hits += m_hit; }
+
+	private:
+		bool m_hit = false;
+	};
+
+	/*!
+	 *  \brief Counts the fixtures queries overlap
+	 */
+	class OverlapCounter : public b2QueryCallback
+	{
+	public:
+		long long Overlaps = 0;
+
+		bool ReportFixture(b2Fixture* /*fixture*/) override
+		{
+			Overlaps++;
+			return true;
+		}
+	};
+
+	/*!
+	 *  A repeatable random number in [-1, 1]
+	 */
+	static float Random(uint32_t& state)
+	{
+		state = state * 1664525u + 1013904223u;
+		return (float)(state >> 8) / (float)(1 << 23) - 1.0f;
+	}
+
+	/*!
+	 *  Fills a world with count static boxes of mixed sizes, scattered over a square
+	 *  with about eight square meters each
+	 *
+	 *      \param [in] world
+	 *      \param [in] count
+	 *      \param [in] halfSize	half the square's width
+	 */
+	static void BuildLevel(b2World& world, int count, float halfSize)
+	{
+		uint32_t state = 777u;
+		b2BodyDef bodyDef;
+		b2PolygonShape box;
+		for (int i = 0; i < count; i++)
+		{
+			bodyDef.position.Set(halfSize * Random(state), halfSize * Random(state));
+			bodyDef.angle = b2_pi * Random(state);
+			box.SetAsBox(1.25f + Random(state), 1.25f + Random(state));
+			world.CreateBody(&bodyDef)->CreateFixture(&box, 0.0f);
+		}
+	}
+
+	/*!
+	 *  \brief Ray casts and queries over the level, and what they found
+	 */
+	struct SceneCost
+	{
+		double RayCast = 0.0;	// microseconds per ray
+		double Query = 0.0;		// microseconds per query
+		int Hits = 0;
+		long long Overlaps = 0;
+	};
+
+	/*!
+	 *  Casts 20 m rays and queries 4 m boxes at the same places every time
+	 */
+	static SceneCost MeasureScene(const b2World& world, float halfSize)
+	{
+		using namespace std::chrono;
+		const int rays = 20000;
+		SceneCost cost;
+
+		uint32_t state = 4242u;
+		ClosestHitCounter hits;
+		steady_clock::time_point start = steady_clock::now();
+		for (int i = 0; i < rays; i++)
+		{
+			b2Vec2 p1(halfSize * Random(state), halfSize * Random(state));
+			b2Vec2 p2 = p1 + b2Vec2(20.0f * Random(state), 20.0f * Random(state));
+			hits.Reset();
+			world.RayCast(&hits, p1, p2);
+			hits.Count();
+		}
+		cost.RayCast = duration<double, std::micro>(steady_clock::now() - start).count() / rays;
+		cost.Hits = hits.Hits;
+
+		OverlapCounter overlaps;
+		start = steady_clock::now();
+		for (int i = 0; i < rays; i++)
+		{
+			b2AABB aabb;
+			aabb.lowerBound.Set(halfSize * Random(state), halfSize * Random(state));
+			aabb.upperBound = aabb.lowerBound + b2Vec2(4.0f, 4.0f);
+			world.QueryAABB(&overlaps, aabb);
+		}
+		cost.Query = duration<double, std::micro>(steady_clock::now() - start).count() / rays;
+		cost.Overlaps = overlaps.Overlaps;
+
+		return cost;
+	}
+
+	/*!
+	 *  Loads each level twice, rebuilding its tree once on the calling thread and once
+	 *  on the job system, and prints the tree and scene costs before and after
+	 */
+	void StaticTreeBenchmark::Run()
+	{
+		using namespace std::chrono;
+
+		const int counts[] = { 10000, 100000 };
+		JobSystem jobSystem;
+		JobTaskExecutor executor(&jobSystem);
+
+		std::cout << "Static tree built by insertion, then rebuilt top down" << std::endl;
+		std::cout << "fixtures\ttree\t\tbuild (ms)\theight\tquality\tray cast (us)\tquery (us)"
+			"\thits\toverlaps" << std::endl;
+
+		for (int count : counts)
+		{
+			const float halfSize = std::sqrt(8.0f * count) * 0.5f;
+
+			b2World world(b2Vec2(0.0f, -10.0f));
+			steady_clock::time_point start = steady_clock::now();
+			BuildLevel(world, count, halfSize);
+			const double load = duration<double, std::milli>(steady_clock::now() - start).count();
+			const SceneCost inserted = MeasureScene(world, halfSize);
+			std::cout << count << "\tinserted\t" << load << "\t\t" << world.GetTreeHeight() << "\t"
+				<< world.GetTreeQuality() << "\t" << inserted.RayCast << "\t\t" << inserted.Query
+				<< "\t\t" << inserted.Hits << "\t" << inserted.Overlaps << std::endl;
+
+			start = steady_clock::now();
+			world.RebuildBroadPhase();
+			const double rebuild = duration<double, std::milli>(steady_clock::now() - start).count();
+			const SceneCost rebuilt = MeasureScene(world, halfSize);
+			std::cout << count << "\trebuilt\t\t" << rebuild << "\t\t" << world.GetTreeHeight() << "\t"
+				<< world.GetTreeQuality() << "\t" << rebuilt.RayCast << "\t\t" << rebuilt.Query
+				<< "\t\t" << rebuilt.Hits << "\t" << rebuilt.Overlaps << std::endl;
+
+			if (rebuilt.Hits != inserted.Hits || rebuilt.Overlaps != inserted.Overlaps)
+				std::cout << "Warning - StaticTreeBenchmark - Rebuilt tree found different fixtures" << std::endl;
+
+			// the same level rebuilt across the job system's threads
+			b2World parallelWorld(b2Vec2(0.0f, -10.0f));
+			BuildLevel(parallelWorld, count, halfSize);
+			parallelWorld.SetTaskExecutor(&executor);
+			start = steady_clock::now();
+			parallelWorld.RebuildBroadPhase();
+			const double parallelRebuild = duration<double, std::milli>(steady_clock::now() - start).count();
+			parallelWorld.SetTaskExecutor(nullptr);
+			std::cout << count << "\trebuilt (" << executor.GetThreadCount() << " threads)\t"
+				<< parallelRebuild << "\t\t" << parallelWorld.GetTreeHeight() << "\t"
+				<< parallelWorld.GetTreeQuality() << std::endl;
+		}
+	}
+}
\ No newline at end of file
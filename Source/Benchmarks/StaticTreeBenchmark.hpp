@@ -0,0 +1,33 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file StaticTreeBenchmark.hpp
+  * \author Joe Goldman
+  * \brief StaticTreeBenchmark class declaration
+  *
+  */
+
+#pragma once
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief	Measures the broad-phase tree a level's static fixtures leave behind,
+	 *			inserted one at a time, against the tree b2World::RebuildBroadPhase
+	 *			builds over them at once. Compares height, quality and the cost of ray
+	 *			casts and queries, for 10k and 100k fixtures.
+	 */
+	class StaticTreeBenchmark
+	{
+	public:
+		static void Run();
+	};
+}
\ No newline at end of file
@@ -19,6 +19,7 @@
 
 #include <Constructs/Construct.hpp>
 #include <Core/State.hpp>
+#include <Physics/Physics.hpp>
 
 namespace GenevaEngine
 {
@@ -51,6 +52,83 @@ namespace GenevaEngine
 		Create();
 	}
 
+	/*!
+	 *  Creates a body in the construct's world. The body's user data points back to
+	 *  the construct, and the body is destroyed along with the construct.
+	 *
+	 *      \param [in] def
+	 *
+	 *      \return The new body.
+	 */
+	b2Body* Construct::CreateBody(const b2BodyDef* def)
+	{
+		b2BodyDef bodyDef = *def;
+		bodyDef.userData.pointer = reinterpret_cast<uintptr_t>(this);
+
+		b2Body* body = m_world->CreateBody(&bodyDef);
+		m_ownedBodies.push_back(body);
+		return body;
+	}
+
+	/*!
+	 *  Creates a joint in the construct's world, destroyed along with the construct
+	 *
+	 *      \param [in] def
+	 *
+	 *      \return The new joint.
+	 */
+	b2Joint* Construct::CreateJoint(const b2JointDef* def)
+	{
+		b2Joint* joint = m_world->CreateJoint(def);
+		m_ownedJoints.push_back(joint);
+		return joint;
+	}
+
+	/*!
+	 *  Creates a soft body in the construct's world. Its user data points back to the
+	 *  construct, and it is destroyed along with the construct.
+	 *
+	 *      \param [in] def
+	 *
+	 *      \return The new soft body.
+	 */
+	b2SoftBody* Construct::CreateSoftBody(const b2SoftBodyDef* def)
+	{
+		b2SoftBodyDef softBodyDef = *def;
+		softBodyDef.userData.pointer = reinterpret_cast<uintptr_t>(this);
+
+		b2SoftBody* softBody = m_world->CreateSoftBody(&softBodyDef);
+		m_ownedSoftBodies.push_back(softBody);
+		return softBody;
+	}
+
+	/*!
+	 *  Queues the construct's bodies, joints and soft bodies to be destroyed in physics' next batch,
+	 *  and stops rendering them and counting their ground contacts.
+	 *
+	 *      \param [in,out] physics
+	 */
+	void Construct::QueueDestroy(Physics& physics)
+	{
+		for (b2Joint* joint : m_ownedJoints)
+			physics.QueueDestroy(joint);
+		for (b2Body* body : m_ownedBodies)
+			physics.QueueDestroy(body);
+		for (b2SoftBody* softBody : m_ownedSoftBodies)
+			physics.QueueDestroy(softBody);
+
+		// the construct is freed before physics destroys its bodies
+		physics.ForgetGround(this);
+
+		m_ownedJoints.clear();
+		m_ownedBodies.clear();
+		m_ownedSoftBodies.clear();
+		m_renderData.BodyRenderList.clear();
+		m_renderData.JointRenderList.clear();
+		m_renderData.SoftBodyRenderList.clear();
+		m_renderData.RopeRenderList.clear();
+	}
+
 	void Construct::SetWorld(b2World* world)
 	{
 		m_world = world;
@@ -61,6 +139,34 @@ namespace GenevaEngine
 		return m_world;
 	}
 
+	bool Construct::IsCreated() const
+	{
+		return m_state == ExistanceState::Created;
+	}
+
+	/*!
+	 *  Answers a question about the construct's physical state
+	 *
+	 *      \param [in] query
+	 *
+	 *      \return IsGrounded: whether it is touching something it can stand on.
+	 */
+	bool Construct::Query(ConstructQuery query) const
+	{
+		switch (query)
+		{
+		case ConstructQuery::IsGrounded:
+			return m_groundContacts > 0;
+		}
+
+		return false;
+	}
+
+	b2Vec2 Construct::GetGroundNormal() const
+	{
+		return m_groundNormal;
+	}
+
 	const ConstructRenderData& Construct::GetConstructRenderData()
 	{
 		return m_renderData;
@@ -24,6 +24,7 @@
 namespace GenevaEngine
 {
 	class Command;
+	class Physics;
 
 	enum class ConstructQuery { IsGrounded };
 	enum class ExistanceState { Standby, Created };
@@ -40,10 +41,22 @@ namespace GenevaEngine
 		b2Vec2 bOffset = b2Vec2(0, 0);
 	};
 
+	struct SoftBodyRenderData
+	{
+		b2SoftBody* SoftBody = nullptr;		// drawn filled, inside its outline
+	};
+
+	struct RopeRenderData
+	{
+		const b2Rope* Rope = nullptr;		// drawn as a line through its vertices
+	};
+
 	struct ConstructRenderData
 	{
 		std::vector<BodyRenderData> BodyRenderList;
 		std::vector<JointRenderData> JointRenderList;
+		std::vector<SoftBodyRenderData> SoftBodyRenderList;
+		std::vector<RopeRenderData> RopeRenderList;
 		bool FillBetweenJoints = true;
 	};
 
@@ -53,6 +66,11 @@ namespace GenevaEngine
 		Construct(b2World* world);
 		void SetWorld(b2World* world);
 		b2World* GetWorld();
+		bool IsCreated() const;						// its box2d objects exist
+		bool Query(ConstructQuery query) const;
+
+		// normal of the last ground contact, pointing toward the construct
+		b2Vec2 GetGroundNormal() const;
 
 		// get data for rendering all the verts in graphics system
 		virtual const ConstructRenderData& GetConstructRenderData();
@@ -64,9 +82,26 @@ namespace GenevaEngine
 		b2World* m_world = nullptr;
 		// collection of data for graphics to use for rendering
 		ConstructRenderData m_renderData;
+		// pool and slot in the ConstructRegistry that owns this construct
+		int m_registryType = -1;
+		int m_registrySlot = -1;
+		// box2d objects made by this construct, destroyed with it
+		std::vector<b2Body*> m_ownedBodies;
+		std::vector<b2Joint*> m_ownedJoints;
+		std::vector<b2SoftBody*> m_ownedSoftBodies;
+		// touching contacts the construct stands on, kept by the GroundContactListener
+		int m_groundContacts = 0;
+		b2Vec2 m_groundNormal = b2Vec2(0, 1);
+
+		// create box2d objects that are destroyed when the construct is. Joints should
+		// only connect this construct's bodies, or bodies that outlive it.
+		b2Body* CreateBody(const b2BodyDef* def);
+		b2Joint* CreateJoint(const b2JointDef* def);
+		b2SoftBody* CreateSoftBody(const b2SoftBodyDef* def);
 
 		// private methods
 		void SafeCreate();							// does a safety check then calls Create()
+		void QueueDestroy(Physics& physics);		// hands owned box2d objects to physics
 		virtual void Notify(const Command* command) = 0;
 		virtual void Create() = 0;
 		virtual void Start() = 0;					// called once before first update
@@ -74,5 +109,7 @@ namespace GenevaEngine
 		virtual void Update(double dt) = 0;			// called on every rendered frame
 		virtual void End() = 0;						// called once after last update
 		friend class Entity;
+		friend class ConstructRegistry;
+		friend class GroundContactListener;
 	};
 }
\ No newline at end of file
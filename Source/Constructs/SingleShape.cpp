@@ -38,7 +38,7 @@ namespace GenevaEngine
 	void SingleShape::Create()
 	{
 		// create body
-		m_body = m_world->CreateBody(&BodyDef);
+		m_body = CreateBody(&BodyDef);
 		FixtureDef.shape = &Shape;
 		m_body->CreateFixture(&FixtureDef);
 
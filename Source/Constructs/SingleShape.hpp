@@ -22,7 +22,7 @@
 
 namespace GenevaEngine
 {
-	class SingleShape : public Construct
+	class SingleShape final : public Construct
 	{
 	public:
 		using Construct::Construct;
@@ -47,5 +47,6 @@ namespace GenevaEngine
 		void Update(double dt);			// called on every rendered frame
 		void End();						// called once after last update
 		friend class Entity;
+		template <class T> friend class ConstructPool;
 	};
 }
\ No newline at end of file
@@ -17,153 +17,84 @@
 
 #include <Constructs/SoftBox.hpp>
 #include <Gameplay/SoftBoxBehavior.hpp>
+#include <Physics/SoftLattice.hpp>
+
+#include <memory> // unique_ptr, make_unique
+#include <vector> // vector
 
 namespace GenevaEngine
 {
-	void SoftBox::Create()
+	// lattices already built, kept for every later soft box of the same shape. Soft
+	// boxes are created on the main thread, while structural changes are applied.
+	static std::vector<std::unique_ptr<SoftLattice>> s_lattices;
+
+	/*!
+	 *  Finds the built lattice with the wanted attributes, or builds it the first time
+	 *  they're asked for
+	 *
+	 *      \param [in] wanted	attributes set, not built
+	 *
+	 *      \return The built lattice, alive as long as the program.
+	 */
+	static const SoftLattice& FindLattice(const SoftLattice& wanted)
 	{
-		const bool drawCircles = false;
-		const b2Vec2 hsize = 0.5f * Size;
-		b2CircleShape shape;
-		b2FixtureDef fd;
-		b2BodyDef bd;
-
-		fd.shape = &shape;
-		fd.restitution = 0.5f;
-		bd.type = b2_dynamicBody;
-		bd.fixedRotation = true;
-
-		fd.density = 0.5;
-		shape.m_radius = InnerCircleRadius;
-		bd.position = StartPos;
-		m_bodies[0] = m_world->CreateBody(&bd);
-		m_bodies[0]->CreateFixture(&fd);
-
-		fd.density = 1.0f;
-		shape.m_radius = OuterCircleRadius;
-		bd.position -= hsize;
-		m_bodies[1] = m_world->CreateBody(&bd);
-		m_bodies[1]->CreateFixture(&shape, 5.0f);
-
-		bd.position.y += Size.y;
-		m_bodies[2] = m_world->CreateBody(&bd);
-		m_bodies[2]->CreateFixture(&shape, 5.0f);
-
-		bd.position.x += Size.x;
-		m_bodies[3] = m_world->CreateBody(&bd);
-		m_bodies[3]->CreateFixture(&shape, 5.0f);
-
-		bd.position.y -= Size.y;
-		m_bodies[4] = m_world->CreateBody(&bd);
-		m_bodies[4]->CreateFixture(&shape, 5.0f);
-
-		// add bodies and shapes to render data
-		if (drawCircles)
+		for (const std::unique_ptr<SoftLattice>& lattice : s_lattices)
 		{
-			for (int i = 0; i < 5; i++)
-			{
-				BodyRenderData brData;
-				brData.Body = m_bodies[i];
-				m_renderData.BodyRenderList.push_back(brData);
-			}
+			if (lattice->Columns == wanted.Columns && lattice->Rows == wanted.Rows &&
+				lattice->Size == wanted.Size && lattice->Mass == wanted.Mass &&
+				lattice->Radius == wanted.Radius &&
+				lattice->StructuralCompliance == wanted.StructuralCompliance &&
+				lattice->ShearCompliance == wanted.ShearCompliance &&
+				lattice->BendCompliance == wanted.BendCompliance)
+				return *lattice;
 		}
 
-		b2DistanceJointDef jd;
-		b2Vec2 p1, p2, d;
-
-		float frequencyHz = 8.0f;
-		float dampingRatio = 0.01f;
-
-		jd.bodyA = m_bodies[0];
-		jd.bodyB = m_bodies[1];
-		p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-		p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-		d = p2 - p1;
-		jd.length = d.Length();
-		b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-		m_joints[0] = m_world->CreateJoint(&jd);
-
-		jd.bodyA = m_bodies[0];
-		jd.bodyB = m_bodies[2];
-		p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-		p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-		d = p2 - p1;
-		jd.length = d.Length();
-		b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-		m_joints[1] = m_world->CreateJoint(&jd);
-
-		jd.bodyA = m_bodies[0];
-		jd.bodyB = m_bodies[3];
-		p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-		p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-		d = p2 - p1;
-		jd.length = d.Length();
-		b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-		m_joints[2] = m_world->CreateJoint(&jd);
-
-		jd.bodyA = m_bodies[0];
-		jd.bodyB = m_bodies[4];
-		p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-		p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-		d = p2 - p1;
-		jd.length = d.Length();
-		b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-		m_joints[3] = m_world->CreateJoint(&jd);
-
-		jd.bodyA = m_bodies[1];
-		jd.bodyB = m_bodies[2];
-		p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-		p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-		d = p2 - p1;
-		jd.length = d.Length();
-		b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-		m_joints[4] = m_world->CreateJoint(&jd);
-
-		jd.bodyA = m_bodies[2];
-		jd.bodyB = m_bodies[3];
-		p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-		p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-		d = p2 - p1;
-		jd.length = d.Length();
-		b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-		m_joints[5] = m_world->CreateJoint(&jd);
-
-		jd.bodyA = m_bodies[3];
-		jd.bodyB = m_bodies[4];
-		p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-		p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-		d = p2 - p1;
-		jd.length = d.Length();
-		b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-		m_joints[6] = m_world->CreateJoint(&jd);
-
-		jd.bodyA = m_bodies[4];
-		jd.bodyB = m_bodies[1];
-		p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-		p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-		d = p2 - p1;
-		jd.length = d.Length();
-		b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-		m_joints[7] = m_world->CreateJoint(&jd);
-
-		// add joints and to render data
-		for (int j = 4; j < 8; j++)
-		{
-			JointRenderData jrData;
-			jrData.Joint = m_joints[j];
-			m_renderData.JointRenderList.push_back(jrData);
-		}
+		s_lattices.push_back(std::make_unique<SoftLattice>(wanted));
+		s_lattices.back()->Build();
+		return *s_lattices.back();
+	}
 
-		// set center body
-		m_centerBody = m_bodies[0];
+	/*!
+	 *  Makes the soft body from the lattice of its attributes, with one compliance for
+	 *  every link. Boxes of the same shape share one lattice.
+	 */
+	void SoftBox::Create()
+	{
+		SoftLattice wanted;
+		wanted.Columns = Columns;
+		wanted.Rows = Rows;
+		wanted.Size = Size;
+		wanted.Mass = Mass;
+		wanted.Radius = ParticleRadius;
+		wanted.StructuralCompliance = Compliance;
+		wanted.ShearCompliance = Compliance;
+		wanted.BendCompliance = Compliance;
+		const SoftLattice& lattice = FindLattice(wanted);
+
+		b2SoftBodyDef def = lattice.GetDef(StartPos);
+		def.linearDamping = LinearDamping;
+		m_softBody = CreateSoftBody(&def);
+
+		// draw the outline, filled
+		SoftBodyRenderData sbrData;
+		sbrData.SoftBody = m_softBody;
+		m_renderData.SoftBodyRenderList.push_back(sbrData);
+		m_renderData.FillBetweenJoints = false;
 	}
 
 	void SoftBox::Start()
 	{
 	}
 
+	/*!
+	 *  Takes the soft body's ground contacts from the step, for ConstructQuery::IsGrounded.
+	 *  Soft bodies have no box2d contacts for the GroundContactListener to count.
+	 */
 	void SoftBox::FixedUpdate(double alpha)
 	{
+		m_groundContacts = m_softBody->GetGroundContactCount();
+		if (m_groundContacts > 0)
+			m_groundNormal = m_softBody->GetGroundNormal();
 	}
 
 	void SoftBox::Update(double dt)
@@ -205,27 +136,8 @@ namespace GenevaEngine
 		}
 	}
 
-	b2Body& SoftBox::GetCenterBody()
+	b2SoftBody& SoftBox::GetSoftBody()
 	{
-		return *m_centerBody;
-	}
-
-	const ConstructRenderData& SoftBox::GetConstructRenderData()
-	{
-		const float offsetDist = b2Sqrt(OuterCircleRadius * 2.0f);
-		const b2Vec2 center = m_bodies[0]->GetPosition();
-
-		//// adjust render offset of joints to wrap the outside of the shapes
-		for (int i = 0; i < 4; i++)
-		{
-			b2Vec2 anchorA = m_renderData.JointRenderList[i].Joint->GetAnchorA();
-			b2Vec2 anchorB = m_renderData.JointRenderList[i].Joint->GetAnchorB();
-			b2Vec2 outwardVecA = (anchorA - center).UnitVector();
-			b2Vec2 outwardVecB = (anchorB - center).UnitVector();
-			m_renderData.JointRenderList[i].aOffset = offsetDist * outwardVecA;
-			m_renderData.JointRenderList[i].bOffset = offsetDist * outwardVecB;
-		}
-
-		return m_renderData;
+		return *m_softBody;
 	}
 }
\ No newline at end of file
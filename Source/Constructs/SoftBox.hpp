@@ -23,33 +23,33 @@
 namespace GenevaEngine
 {
 	/*!
-	 *  \brief SoftBox system
+	 *  \brief SoftBox system. A box2d soft body built from a SoftLattice of Columns by
+	 *         Rows particles, outlined by the particles around its edge.
 	 */
-	class SoftBox : public Construct
+	class SoftBox final : public Construct
 	{
 	public:
 		// Construct(b2World* world) : m_world(world)
 		using Construct::Construct;
 
 		// Creation Attributes, Define these before creation
-		float InnerCircleRadius = 2.0f;
-		float OuterCircleRadius = 1.0f;
+		int Columns = 4;				// particles along the bottom, at least two
+		int Rows = 4;					// particles up the side, at least two
+		float ParticleRadius = 1.0f;
+		float Mass = 22.0f * b2_pi;		// of the whole box, what the old circles weighed
 		b2Vec2 StartPos = b2Vec2(0, 0);
 		b2Vec2 Size = b2Vec2(10.0f, 10.0f);
+		float Compliance = 5.0e-5f;		// softness of the links, the inverse of stiffness
+		float LinearDamping = 0.5f;		// settles soft boxes piled on each other
 
 		// Public Methods
-		b2Body& GetCenterBody();
+		b2SoftBody& GetSoftBody();
 		void EnableBehavior();
 
-		// implement this differently for SoftBox to get an outline of the shape
-		const ConstructRenderData& GetConstructRenderData();
-
 	private:
 		// Private members
-		b2Body* m_centerBody = nullptr;
+		b2SoftBody* m_softBody = nullptr;
 		State<SoftBox>* m_state = nullptr;
-		b2Body* m_bodies[5];
-		b2Joint* m_joints[8];
 
 		// Private Methods
 		void HandleStateTransitions(State<SoftBox>* nextState);
@@ -62,5 +62,6 @@ namespace GenevaEngine
 		void End();						// called once after last update
 		void Notify(const Command* command);
 		friend class Entity;
+		template <class T> friend class ConstructPool;
 	};
 }
\ No newline at end of file
@@ -24,7 +24,7 @@ namespace GenevaEngine
 		b2Body* ground = nullptr;
 		{
 			b2BodyDef bd;
-			ground = m_world->CreateBody(&bd);
+			ground = CreateBody(&bd);
 
 			b2EdgeShape shape;
 			shape.SetTwoSided(b2Vec2(-40.0f, 0.0f), b2Vec2(40.0f, 0.0f));
@@ -33,150 +33,157 @@ namespace GenevaEngine
 
 		{
 			b2PolygonShape shape;
-			b2PolygonShape shapes[4];
 			shape.SetAsBox(0.5f, 0.5f);
 
 			b2BodyDef bd;
 			bd.type = b2_dynamicBody;
 
-			bd.position.Set(-5.0f, 5.0f);
-			m_bodies[0] = m_world->CreateBody(&bd);
-			m_bodies[0]->CreateFixture(&shape, 5.0f);
-			shapes[0] = shape;
-
-			bd.position.Set(5.0f, 5.0f);
-			m_bodies[1] = m_world->CreateBody(&bd);
-			m_bodies[1]->CreateFixture(&shape, 5.0f);
-			shapes[1] = shape;
-
-			bd.position.Set(5.0f, 15.0f);
-			m_bodies[2] = m_world->CreateBody(&bd);
-			m_bodies[2]->CreateFixture(&shape, 5.0f);
-			shapes[2] = shape;
-
-			bd.position.Set(-5.0f, 15.0f);
-			m_bodies[3] = m_world->CreateBody(&bd);
-			m_bodies[3]->CreateFixture(&shape, 5.0f);
-			shapes[3] = shape;
-
-			// add bodies and shapes to render data
+			const b2Vec2 positions[4] = { b2Vec2(-5.0f, 5.0f), b2Vec2(5.0f, 5.0f),
+				b2Vec2(5.0f, 15.0f), b2Vec2(-5.0f, 15.0f) };
 			for (int i = 0; i < 4; i++)
 			{
+				bd.position = positions[i];
+				m_bodies[i] = CreateBody(&bd);
+				m_bodies[i]->CreateFixture(&shape, 5.0f);
+
+				// add bodies and shapes to render data
 				BodyRenderData brData;
 				brData.Body = m_bodies[i];
 				m_renderData.BodyRenderList.push_back(brData);
 			}
 
-			b2DistanceJointDef jd;
-			b2Vec2 p1, p2, d;
-
-			float frequencyHz = 2.0f;
-			float dampingRatio = 0.0f;
-
-			jd.bodyA = ground;
-			jd.bodyB = m_bodies[0];
-			jd.localAnchorA.Set(-10.0f, 0.0f);
-			jd.localAnchorB.Set(-0.5f, -0.5f);
-			p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-			p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-			d = p2 - p1;
-			jd.length = d.Length();
-			b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-			m_joints[0] = m_world->CreateJoint(&jd);
-
-			jd.bodyA = ground;
-			jd.bodyB = m_bodies[1];
-			jd.localAnchorA.Set(10.0f, 0.0f);
-			jd.localAnchorB.Set(0.5f, -0.5f);
-			p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-			p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-			d = p2 - p1;
-			jd.length = d.Length();
-			b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-			m_joints[1] = m_world->CreateJoint(&jd);
-
-			jd.bodyA = ground;
-			jd.bodyB = m_bodies[2];
-			jd.localAnchorA.Set(10.0f, 20.0f);
-			jd.localAnchorB.Set(0.5f, 0.5f);
-			p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-			p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-			d = p2 - p1;
-			jd.length = d.Length();
-			b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-			m_joints[2] = m_world->CreateJoint(&jd);
-
-			jd.bodyA = ground;
-			jd.bodyB = m_bodies[3];
-			jd.localAnchorA.Set(-10.0f, 20.0f);
-			jd.localAnchorB.Set(-0.5f, 0.5f);
-			p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-			p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-			d = p2 - p1;
-			jd.length = d.Length();
-			b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-			m_joints[3] = m_world->CreateJoint(&jd);
-
-			jd.bodyA = m_bodies[0];
-			jd.bodyB = m_bodies[1];
-			jd.localAnchorA.Set(0.5f, 0.0f);
-			jd.localAnchorB.Set(-0.5f, 0.0f);;
-			p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-			p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-			d = p2 - p1;
-			jd.length = d.Length();
-			b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-			m_joints[4] = m_world->CreateJoint(&jd);
-
-			jd.bodyA = m_bodies[1];
-			jd.bodyB = m_bodies[2];
-			jd.localAnchorA.Set(0.0f, 0.5f);
-			jd.localAnchorB.Set(0.0f, -0.5f);
-			p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-			p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-			d = p2 - p1;
-			jd.length = d.Length();
-			b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-			m_joints[5] = m_world->CreateJoint(&jd);
-
-			jd.bodyA = m_bodies[2];
-			jd.bodyB = m_bodies[3];
-			jd.localAnchorA.Set(-0.5f, 0.0f);
-			jd.localAnchorB.Set(0.5f, 0.0f);
-			p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-			p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-			d = p2 - p1;
-			jd.length = d.Length();
-			b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-			m_joints[6] = m_world->CreateJoint(&jd);
-
-			jd.bodyA = m_bodies[3];
-			jd.bodyB = m_bodies[0];
-			jd.localAnchorA.Set(0.0f, -0.5f);
-			jd.localAnchorB.Set(0.0f, 0.5f);
-			p1 = jd.bodyA->GetWorldPoint(jd.localAnchorA);
-			p2 = jd.bodyB->GetWorldPoint(jd.localAnchorB);
-			d = p2 - p1;
-			jd.length = d.Length();
-			b2LinearStiffness(jd.stiffness, jd.damping, frequencyHz, dampingRatio, jd.bodyA, jd.bodyB);
-			m_joints[7] = m_world->CreateJoint(&jd);
-
-			// add joints and to render data
-			for (int j = 0; j < 8; j++)
-			{
-				JointRenderData jrData;
-				jrData.Joint = m_joints[j];
-				m_renderData.JointRenderList.push_back(jrData);
-			}
+			// from the ground out to each box
+			AddStrand(ground, b2Vec2(-10.0f, 0.0f), m_bodies[0], b2Vec2(-0.5f, -0.5f));
+			AddStrand(ground, b2Vec2(10.0f, 0.0f), m_bodies[1], b2Vec2(0.5f, -0.5f));
+			AddStrand(ground, b2Vec2(10.0f, 20.0f), m_bodies[2], b2Vec2(0.5f, 0.5f));
+			AddStrand(ground, b2Vec2(-10.0f, 20.0f), m_bodies[3], b2Vec2(-0.5f, 0.5f));
+
+			// around the boxes
+			AddStrand(m_bodies[0], b2Vec2(0.5f, 0.0f), m_bodies[1], b2Vec2(-0.5f, 0.0f));
+			AddStrand(m_bodies[1], b2Vec2(0.0f, 0.5f), m_bodies[2], b2Vec2(0.0f, -0.5f));
+			AddStrand(m_bodies[2], b2Vec2(-0.5f, 0.0f), m_bodies[3], b2Vec2(0.5f, 0.0f));
+			AddStrand(m_bodies[3], b2Vec2(0.0f, -0.5f), m_bodies[0], b2Vec2(0.0f, 0.5f));
 		}
 	}
 
+	/*!
+	 *  Strings a strand straight between two anchors, with SegmentsPerStrand segments.
+	 *  Its end vertices have no mass, so they follow the anchors. A distance joint keeps
+	 *  the anchors within the strand's length. Call from Create or later, the bodies
+	 *  must outlive the web.
+	 *
+	 *      \param [in] bodyA			null to anchor to a world point
+	 *      \param [in] localAnchorA	on bodyA, or in the world
+	 *      \param [in] bodyB			null to anchor to a world point
+	 *      \param [in] localAnchorB	on bodyB, or in the world
+	 *
+	 *      \return The strand's index.
+	 */
+	int Web::AddStrand(b2Body* bodyA, const b2Vec2& localAnchorA, b2Body* bodyB,
+		const b2Vec2& localAnchorB)
+	{
+		b2Assert(SegmentsPerStrand >= 2);
+
+		// world points are local points of a static body at the origin
+		Strand strand;
+		strand.BodyA = bodyA != nullptr ? bodyA : GetWorldAnchor();
+		strand.BodyB = bodyB != nullptr ? bodyB : GetWorldAnchor();
+		strand.LocalAnchorA = localAnchorA;
+		strand.LocalAnchorB = localAnchorB;
+
+		const b2Vec2 pA = strand.BodyA->GetWorldPoint(localAnchorA);
+		const b2Vec2 pB = strand.BodyB->GetWorldPoint(localAnchorB);
+
+		// a rope only pulls: no further apart than the strand's length, as close as they like
+		b2DistanceJointDef jd;
+		jd.Initialize(strand.BodyA, strand.BodyB, pA, pB);
+		jd.minLength = 0.0f;
+		CreateJoint(&jd);
+
+		const int count = SegmentsPerStrand + 1;
+		std::vector<b2Vec2> vertices(count);
+		std::vector<float> masses(count, StrandMass / (count - 2));
+		for (int i = 0; i < count; i++)
+			vertices[i] = pA + ((float)i / SegmentsPerStrand) * (pB - pA);
+		masses.front() = 0.0f;
+		masses.back() = 0.0f;
+
+		b2RopeDef def;
+		def.vertices = vertices.data();
+		def.count = count;
+		def.masses = masses.data();
+		def.gravity = m_world->GetGravity();
+		def.tuning = Tuning;
+
+		strand.Rope = std::make_unique<b2Rope>();
+		strand.Rope->Create(def);
+
+		RopeRenderData rrData;
+		rrData.Rope = strand.Rope.get();
+		m_renderData.RopeRenderList.push_back(rrData);
+
+		m_strands.push_back(std::move(strand));
+		return (int)m_strands.size() - 1;
+	}
+
+	b2RopeTuning Web::DefaultTuning()
+	{
+		b2RopeTuning tuning;
+		tuning.tethers = true;
+		return tuning;
+	}
+
+	/*!
+	 *  The static body world point anchors are local to, made by the first one
+	 *
+	 *      \return The body, at the origin.
+	 */
+	b2Body* Web::GetWorldAnchor()
+	{
+		if (m_worldAnchor == nullptr)
+		{
+			b2BodyDef bd;
+			m_worldAnchor = CreateBody(&bd);
+		}
+		return m_worldAnchor;
+	}
+
+	int Web::GetStrandCount() const
+	{
+		return (int)m_strands.size();
+	}
+
+	const b2Rope& Web::GetStrand(int index) const
+	{
+		return *m_strands[index].Rope;
+	}
+
 	void Web::Start()
 	{
 	}
 
+	/*!
+	 *  Steps every strand after the world, in SubSteps, with its ends moved to its
+	 *  anchors and the world's gravity. The strands' joints have already held the
+	 *  bodies in the world step.
+	 *
+	 *      \param [in] alpha	the fixed time-step
+	 */
 	void Web::FixedUpdate(double alpha)
 	{
+		const float dt = (float)alpha;
+		const b2Vec2 gravity = m_world->GetGravity();
+		const b2Vec2 origin(0, 0);	// bind positions are already in world coordinates
+		for (Strand& strand : m_strands)
+		{
+			b2Rope& rope = *strand.Rope;
+			const int last = rope.GetVertexCount() - 1;
+			rope.SetGravity(gravity);
+			rope.SetBindPosition(0, strand.BodyA->GetWorldPoint(strand.LocalAnchorA));
+			rope.SetBindPosition(last, strand.BodyB->GetWorldPoint(strand.LocalAnchorB));
+			for (int i = 0; i < SubSteps; i++)
+				rope.Step(dt / SubSteps, Iterations, origin);
+		}
 	}
 
 	void Web::Update(double dt)
@@ -20,27 +20,62 @@
 #include <Constructs/Construct.hpp>
 #include <Core/State.hpp>
 
+#include <memory> // unique_ptr
+#include <vector> // vector
+
 namespace GenevaEngine
 {
-	class Web : public Construct
+	/*!
+	 *  \brief Web system. Four boxes hung from the ground by strands of b2Rope. Ropes
+	 *         are solved with position based dynamics, and stay stiff in a few
+	 *         iterations where chains of joints need many. A strand hangs under gravity
+	 *         with its ends on its anchors. A rope can't pull on bodies, so each strand
+	 *         also gets a distance joint that keeps its anchors no further apart than
+	 *         the strand's length, and lets them come closer, like a rope would.
+	 */
+	class Web final : public Construct
 	{
 	public:
 		// Construct(b2World* world) : m_world(world)
 		using Construct::Construct;
 
 		// Creation Attributes, Define these before creation
+		int SegmentsPerStrand = 32;
+		float StrandMass = 0.5f;		// of a whole strand, spread over its free vertices
+		int SubSteps = 4;				// rope steps per fixed step, stiffer than iterations
+		int Iterations = 1;				// rope solver iterations per sub-step
+		b2RopeTuning Tuning = DefaultTuning();
+
+		// tethered, so long strands keep their length in a few iterations
+		static b2RopeTuning DefaultTuning();
 
 		// Public Methods
 		void EnableBehavior();
+		int AddStrand(b2Body* bodyA, const b2Vec2& localAnchorA, b2Body* bodyB,
+			const b2Vec2& localAnchorB);
+		int GetStrandCount() const;
+		const b2Rope& GetStrand(int index) const;
 
 	private:
+		// a rope and the anchors its ends follow
+		struct Strand
+		{
+			std::unique_ptr<b2Rope> Rope;
+			b2Body* BodyA = nullptr;
+			b2Body* BodyB = nullptr;
+			b2Vec2 LocalAnchorA = b2Vec2(0, 0);
+			b2Vec2 LocalAnchorB = b2Vec2(0, 0);
+		};
+
 		// Private Members
 		State<Web>* m_state = nullptr;
 		b2Body* m_bodies[4];
-		b2Joint* m_joints[8];
+		b2Body* m_worldAnchor = nullptr;	// static, at the origin, for world point anchors
+		std::vector<Strand> m_strands;
 
 		// Private Methods
 		void HandleStateTransitions(State<Web>* nextState);
+		b2Body* GetWorldAnchor();
 
 		// Construct virtual functions, used by Entity
 		void Notify(const Command* command);
@@ -50,5 +85,6 @@ namespace GenevaEngine
 		void Update(double dt);			// called on every rendered frame
 		void End();						// called once after last update
 		friend class Entity;
+		template <class T> friend class ConstructPool;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file ConstructRegistry.cpp
+  * \author Joe Goldman
+  * \brief ConstructRegistry class definition
+  *
+  **/
+
+#include <Core/ConstructRegistry.hpp>
+#include <Core/Profiler.hpp>
+
+#include <iostream> // cout, endl
+
+namespace GenevaEngine
+{
+	// static members
+	std::atomic<int> ConstructRegistry::s_typeCount{ 0 };
+
+	/*!
+	 *  Destroys a construct, in whichever pool it came from. Its slot is reused by the
+	 *  next construct of the same type.
+	 *
+	 *      \param [in] construct
+	 */
+	void ConstructRegistry::Destroy(Construct* construct)
+	{
+		if (construct == nullptr)
+			return;
+
+		if (construct->m_registryType < 0 || construct->m_registryType >= (int)m_pools.size())
+		{
+			std::cout << "Warning - ConstructRegistry::Destroy - Construct isn't from a registry"
+				<< std::endl;
+			return;
+		}
+
+		// the ground contact listener would count the contacts of its bodies against
+		// the freed slot as they end
+		if (construct->m_groundContacts != 0)
+			std::cout << "Warning - ConstructRegistry::Destroy - Construct is still counted as grounded"
+				<< std::endl;
+
+		m_pools[construct->m_registryType]->Destroy(construct->m_registrySlot);
+	}
+
+	/*!
+	 *  Called every physics update. Runs FixedUpdate on every construct, a type at a time.
+	 *
+	 *      \param [in] alpha
+	 */
+	void ConstructRegistry::FixedUpdate(double alpha)
+	{
+		PROFILE_ZONE("Constructs FixedUpdate");
+
+		for (std::unique_ptr<ConstructPoolBase>& pool : m_pools)
+		{
+			if (pool != nullptr)
+				pool->FixedUpdate(alpha);
+		}
+	}
+
+	/*!
+	 *  Called every render update. Runs Update on every construct, a type at a time.
+	 *
+	 *      \param [in] dt
+	 */
+	void ConstructRegistry::Update(double dt)
+	{
+		PROFILE_ZONE("Constructs Update");
+
+		for (std::unique_ptr<ConstructPoolBase>& pool : m_pools)
+		{
+			if (pool != nullptr)
+				pool->Update(dt);
+		}
+	}
+
+	/*!
+	 *  Returns the number of constructs alive, across all pools
+	 *
+	 *      \return The construct count.
+	 */
+	int ConstructRegistry::GetCount() const
+	{
+		int count = 0;
+		for (const std::unique_ptr<ConstructPoolBase>& pool : m_pools)
+		{
+			if (pool != nullptr)
+				count += pool->GetCount();
+		}
+
+		return count;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file ConstructRegistry.hpp
+  * \author Joe Goldman
+  * \brief ConstructPool and ConstructRegistry class declarations. Constructs are stored
+  * contiguously, sorted by type, and updated a whole type at a time.
+  *
+  */
+
+#pragma once
+
+#include <Constructs/Construct.hpp>
+#include <Core/ObjectPool.hpp>
+
+#include <atomic> // atomic
+#include <memory> // unique_ptr
+#include <utility> // forward
+#include <vector> // vector
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief Type erased interface to a ConstructPool, so the registry can keep pools
+	 *         of every construct type in one array.
+	 */
+	class ConstructPoolBase
+	{
+	public:
+		virtual ~ConstructPoolBase() = default;
+
+		virtual void Destroy(int slot) = 0;
+		virtual void FixedUpdate(double alpha) = 0;		// updates every construct in the pool
+		virtual void Update(double dt) = 0;				// updates every construct in the pool
+		virtual int GetCount() const = 0;				// constructs alive in the pool
+	};
+
+	/*!
+	 *  \brief Stores constructs of a single type in an ObjectPool, so they are contiguous,
+	 *         never move, and reuse the slots of destroyed constructs. The pool knows the
+	 *         exact type, so updates are direct calls, not virtual ones.
+	 */
+	template <class T>
+	class ConstructPool : public ConstructPoolBase
+	{
+	public:
+		template <class... Args>
+		T* Create(int& slot, Args&&... args);
+		void Destroy(int slot);
+		void FixedUpdate(double alpha);
+		void Update(double dt);
+		int GetCount() const;
+
+		// calls func(T&) on every construct alive in the pool
+		template <class Func>
+		void ForEach(Func&& func);
+
+	private:
+		ObjectPool<T> m_constructs;
+	};
+
+	/*!
+	 *  \brief Owns every construct in the session, in one pool per construct type. Pools
+	 *         are kept in the order their type was first created, so an update walks the
+	 *         constructs type by type and memory order.
+	 */
+	class ConstructRegistry
+	{
+	public:
+		ConstructRegistry() = default;
+		ConstructRegistry(const ConstructRegistry&) = delete;
+		ConstructRegistry& operator=(const ConstructRegistry&) = delete;
+
+		// creates a construct of type T in its pool, args go to T's constructor
+		template <class T, class... Args>
+		T* Create(Args&&... args);
+		// destroys a construct made by Create. Doesn't call End.
+		void Destroy(Construct* construct);
+
+		// batch updates, one pool at a time
+		void FixedUpdate(double alpha);
+		void Update(double dt);
+
+		// calls func(T&) on every construct of type T
+		template <class T, class Func>
+		void ForEach(Func&& func);
+
+		int GetCount() const;
+
+	private:
+		// indexed by type id, null for types this registry hasn't created
+		std::vector<std::unique_ptr<ConstructPoolBase>> m_pools;
+
+		static std::atomic<int> s_typeCount;
+
+		template <class T>
+		static int TypeId();
+		template <class T>
+		ConstructPool<T>& GetPool();
+	};
+
+	template <class T>
+	template <class... Args>
+	T* ConstructPool<T>::Create(int& slot, Args&&... args)
+	{
+		return m_constructs.Create(slot, std::forward<Args>(args)...);
+	}
+
+	template <class T>
+	void ConstructPool<T>::Destroy(int slot)
+	{
+		m_constructs.Destroy(slot);
+	}
+
+	/*!
+	 *  Runs FixedUpdate on the pool's constructs. Constructs that haven't been created
+	 *  yet, like ones waiting for their entity to spawn, are skipped.
+	 */
+	template <class T>
+	void ConstructPool<T>::FixedUpdate(double alpha)
+	{
+		m_constructs.ForEach([alpha](T& construct)
+			{
+				if (construct.IsCreated())
+					construct.FixedUpdate(alpha);
+			});
+	}
+
+	template <class T>
+	void ConstructPool<T>::Update(double dt)
+	{
+		m_constructs.ForEach([dt](T& construct)
+			{
+				if (construct.IsCreated())
+					construct.Update(dt);
+			});
+	}
+
+	template <class T>
+	int ConstructPool<T>::GetCount() const
+	{
+		return m_constructs.GetCount();
+	}
+
+	template <class T>
+	template <class Func>
+	void ConstructPool<T>::ForEach(Func&& func)
+	{
+		m_constructs.ForEach(std::forward<Func>(func));
+	}
+
+	/*!
+	 *  Creates a construct in T's pool and tags it with where it lives, so it can be
+	 *  destroyed without knowing its type.
+	 *
+	 *      \param [in] args	T's constructor arguments
+	 *
+	 *      \return The new construct.
+	 */
+	template <class T, class... Args>
+	T* ConstructRegistry::Create(Args&&... args)
+	{
+		int slot = -1;
+		T* construct = GetPool<T>().Create(slot, std::forward<Args>(args)...);
+		construct->m_registryType = TypeId<T>();
+		construct->m_registrySlot = slot;
+
+		return construct;
+	}
+
+	template <class T, class Func>
+	void ConstructRegistry::ForEach(Func&& func)
+	{
+		GetPool<T>().ForEach(std::forward<Func>(func));
+	}
+
+	/*!
+	 *  Returns a unique id for T. Ids are handed out in the order types are first used.
+	 */
+	template <class T>
+	int ConstructRegistry::TypeId()
+	{
+		static const int id = s_typeCount++;
+		return id;
+	}
+
+	/*!
+	 *  Returns T's pool, creating it the first time
+	 */
+	template <class T>
+	ConstructPool<T>& ConstructRegistry::GetPool()
+	{
+		const int id = TypeId<T>();
+		if (id >= (int)m_pools.size())
+			m_pools.resize(id + 1);
+		if (m_pools[id] == nullptr)
+			m_pools[id] = std::make_unique<ConstructPool<T>>();
+
+		return static_cast<ConstructPool<T>&>(*m_pools[id]);
+	}
+}
\ No newline at end of file
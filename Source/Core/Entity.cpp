@@ -24,15 +24,12 @@
 namespace GenevaEngine
 {
 	// static members
-	int Entity::m_entityCount = 0;
+	std::atomic<int> Entity::m_entityCount{ 0 };
 
 	/*!
-	 *  Constructor.
+	 *  Constructor. Called by the GameSession's entity pool, see GameSession::Spawn.
 	 *
 	 *      \param [in] gs
-	 *      \param [in] bodyDef
-	 *      \param [in] fixtureDef
-	 *      \param [in] shapeDef
 	 *      \param [in] name
 	 */
 	Entity::Entity(GameSession* gs, std::string name) :
@@ -40,7 +37,6 @@ namespace GenevaEngine
 		Name(name),
 		ID(++m_entityCount)
 	{
-		m_gameSession->AddEntity(this); // add to gamesession entities
 	}
 
 	// First call to entity from gamesession
@@ -49,6 +45,11 @@ namespace GenevaEngine
 		Spawn();
 	}
 
+	EntityHandle Entity::GetHandle() const
+	{
+		return m_handle;
+	}
+
 	Construct& Entity::GetConstruct() const
 	{
 		return *m_construct;
@@ -61,12 +62,16 @@ namespace GenevaEngine
 			m_construct->SafeCreate();
 	}
 
-	// Add a composite of box2d objects and properties
+	// Add a composite of box2d objects and properties. It must come from the session's
+	// ConstructRegistry, which owns it and runs its updates.
 	void Entity::AddConstruct(Construct* construct)
 	{
 		// TODO: allow for an entity to have multiple constructs
 		if (m_construct != nullptr)
-			delete m_construct;
+		{
+			m_construct->QueueDestroy(*m_gameSession->GetPhysics());
+			m_gameSession->GetConstructRegistry()->Destroy(m_construct);
+		}
 
 		m_construct = construct;
 	}
@@ -82,31 +87,10 @@ namespace GenevaEngine
 			m_construct->Notify(command);
 	}
 
-	/*!
-	 *  Called every render update. dt is the FrameTime
-	 *
-	 *      \param [in] dt
-	 */
-	void Entity::Update(double dt)
-	{
-		if (m_construct != nullptr)
-			m_construct->Update(dt);
-	}
-
-	/*!
-	 *  Called every physics update. alpha is time between physics steps
-	 *
-	 *      \param [in] alpha
-	 */
-	void Entity::FixedUpdate(double alpha)
-	{
-		if (m_construct != nullptr)
-			m_construct->FixedUpdate(alpha);
-	}
-
 	/*!
 	 *  Entity is being removed from the game.
-	 *  Clean up pointers and memory that belongs to the Entity
+	 *  Clean up pointers and memory that belongs to the Entity. The construct's bodies
+	 *  and joints are queued, physics destroys them in a batch.
 	 */
 	void Entity::End()
 	{
@@ -114,7 +98,8 @@ namespace GenevaEngine
 		if (m_construct != nullptr)
 		{
 			m_construct->End();
-			delete m_construct;
+			m_construct->QueueDestroy(*m_gameSession->GetPhysics());
+			m_gameSession->GetConstructRegistry()->Destroy(m_construct);
 			m_construct = nullptr;
 		}
 	}
@@ -126,7 +111,10 @@ namespace GenevaEngine
 	 */
 	void Entity::SetRenderColor(int palette_color_id)
 	{
-		m_render_color = m_gameSession->GetGraphics()->GetPaletteColor(palette_color_id);
+		// headless sessions have no graphics, and no palette
+		Graphics* graphics = m_gameSession->GetGraphics();
+		if (graphics != nullptr)
+			m_render_color = graphics->GetPaletteColor(palette_color_id);
 	}
 
 	/*!
@@ -19,6 +19,8 @@
 
 #include <Graphics/Color.hpp>
 
+#include <atomic> // atomic
+#include <cstdint> // uint32_t
 #include <string> // string
 
 namespace GenevaEngine
@@ -27,9 +29,30 @@ namespace GenevaEngine
 	class Controller;
 	class Command;
 	class Construct;
+	template <class T, int ChunkSize> class ObjectPool;
+
+	/*!
+	 *  \brief Refers to an entity without keeping it alive. Safe to hold across frames,
+	 *         GameSession::GetEntity returns nullptr for it once the entity is gone, even
+	 *         if its slot has been reused.
+	 */
+	struct EntityHandle
+	{
+		int Slot = -1;
+		uint32_t Generation = 0;
+
+		bool IsNull() const { return Slot < 0; }
+		bool operator==(const EntityHandle& other) const
+		{
+			return Slot == other.Slot && Generation == other.Generation;
+		}
+		bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+	};
 
 	/*!
 	 *  \brief An object that populates the game. Like a UE4 Actor or Unity GameObject.
+	 *         Entities live in the GameSession's entity pool, make them with
+	 *         GameSession::Spawn.
 	 */
 	class Entity
 	{
@@ -38,14 +61,12 @@ namespace GenevaEngine
 		const int ID;							// unique ID
 		std::string Name;						// A recognizable name for debugging
 
-		// Constructor
-		Entity(GameSession* gs, std::string name = "none");
-
 		// Public methods
-		void Spawn();							// puts this instance into the game
+		EntityHandle GetHandle() const;			// handle that can be held across frames
+		void Spawn();							// creates the construct's box2d objects
 		float FrameTime();						// Dt since last frame was rendered
 		void Notify(const Command* command);	// Notify Construct of incoming commands
-		void AddConstruct(Construct* Construct);// Add composite of box2d objects and properties
+		void AddConstruct(Construct* Construct);// Add composite made by the ConstructRegistry
 		Construct& GetConstruct() const;		// Get construct (box2d composite)
 		void SetRenderColor(int colorID);		// Set base color for rendering (from palette ID)
 		void SetRenderColor(Color color);		// Set base color for rendering
@@ -53,20 +74,27 @@ namespace GenevaEngine
 
 	private:
 		// increments on entity construction to create a unique id
-		static int m_entityCount;
+		static std::atomic<int> m_entityCount;
 
 		// object references
 		GameSession* m_gameSession = nullptr;
 		Construct* m_construct = nullptr;
 
+		// where the entity lives in the GameSession's entity pool
+		EntityHandle m_handle;
+		// queued to despawn at the next structural change
+		bool m_despawning = false;
+
+		// Constructor (only called by the entity pool)
+		Entity(GameSession* gs, std::string name);
+
 		// base color for rendering
 		Color m_render_color;
 
 		//  Game loop (only called by GameSession)
 		void Start();							// called once before first update
-		void FixedUpdate(double alpha);			// called on fixed physics time-steps
-		void Update(double dt);					// called on every rendered frame
 		void End();								// called once after last update
 		friend class GameSession;
+		template <class T, int ChunkSize> friend class ObjectPool;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,192 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file FramePacer.cpp
+  * \author Joe Goldman
+  * \brief FramePacer class definition
+  *
+  **/
+
+#include <Core/FramePacer.hpp>
+#include <Core/Profiler.hpp>
+
+#include <algorithm> // max
+#include <chrono> // steady_clock
+#include <cmath> // sqrt, abs
+#include <iostream> // cout, endl
+#include <thread> // sleep_for, yield
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h> // timeBeginPeriod
+#pragma comment(lib, "winmm.lib")
+#endif
+
+namespace GenevaEngine
+{
+	/*!
+	 *  Constructor. On windows, asks for 1ms timer resolution so sleeps are short
+	 *  enough to pace with. The default resolution is ~15ms.
+	 */
+	FramePacer::FramePacer()
+	{
+#ifdef _WIN32
+		timeBeginPeriod(1);
+#endif
+		Reset();
+	}
+
+	/*!
+	 *  Destructor. Gives back the timer resolution.
+	 */
+	FramePacer::~FramePacer()
+	{
+#ifdef _WIN32
+		timeEndPeriod(1);
+#endif
+	}
+
+	/*!
+	 *  Waits out the rest of the frame. Sleeps while there's comfortably more time
+	 *  left than a sleep tends to overshoot by, then spins until the deadline.
+	 *  A frame that is already late ends right away, and the next deadline is measured
+	 *  from now so the loop doesn't rush to catch up.
+	 */
+	void FramePacer::WaitForNextFrame()
+	{
+		PROFILE_ZONE("Frame pacing");
+
+		if (TargetFrameRate <= 0.0)
+		{
+			RecordFrame(Now());
+			return;
+		}
+
+		m_deadline += TargetFrameTime();
+		double now = Now();
+		if (now >= m_deadline)
+		{
+			m_deadline = now;
+		}
+		else
+		{
+			SleepUntil(m_deadline);
+
+			// spin the last stretch, sleep isn't precise enough for it
+			while ((now = Now()) < m_deadline)
+				std::this_thread::yield();
+		}
+
+		RecordFrame(now);
+	}
+
+	/*!
+	 *  Restarts pacing from the current time. Stats are kept.
+	 */
+	void FramePacer::Reset()
+	{
+		m_deadline = Now();
+		m_lastFrameEnd = m_deadline;
+	}
+
+	/*!
+	 *  Sleeps in 1ms slices until the deadline is within the spin threshold,
+	 *  learning how late this machine's sleeps wake up as it goes.
+	 *
+	 *      \param [in] deadline
+	 */
+	void FramePacer::SleepUntil(double deadline)
+	{
+		const double slice = 0.001;
+		double now = Now();
+		while (deadline - now > SpinThreshold + slice + m_sleepOvershoot)
+		{
+			const double before = now;
+			std::this_thread::sleep_for(std::chrono::microseconds(1000));
+			now = Now();
+
+			// moving average of how far past the slice the sleep went
+			const double overshoot = std::max(0.0, (now - before) - slice);
+			m_sleepOvershoot += 0.1 * (overshoot - m_sleepOvershoot);
+		}
+	}
+
+	/*!
+	 *  Adds a frame to the frame time stats
+	 *
+	 *      \param [in] frameEnd
+	 */
+	void FramePacer::RecordFrame(double frameEnd)
+	{
+		const double frameTime = frameEnd - m_lastFrameEnd;
+		m_lastFrameEnd = frameEnd;
+
+		m_frameCount++;
+		const double delta = frameTime - m_meanFrameTime;
+		m_meanFrameTime += delta / m_frameCount;
+		m_frameTimeM2 += delta * (frameTime - m_meanFrameTime);
+
+		if (TargetFrameRate > 0.0)
+			m_maxJitter = std::max(m_maxJitter, std::abs(frameTime - TargetFrameTime()));
+	}
+
+	int FramePacer::GetFrameCount() const
+	{
+		return m_frameCount;
+	}
+
+	double FramePacer::GetMeanFrameTime() const
+	{
+		return m_meanFrameTime;
+	}
+
+	double FramePacer::GetJitter() const
+	{
+		if (m_frameCount < 2)
+			return 0.0;
+
+		return std::sqrt(m_frameTimeM2 / (m_frameCount - 1));
+	}
+
+	double FramePacer::GetMaxJitter() const
+	{
+		return m_maxJitter;
+	}
+
+	/*!
+	 *  Prints the frame time stats
+	 */
+	void FramePacer::PrintReport() const
+	{
+		std::cout << "Frames: " << m_frameCount << ", target " << TargetFrameRate << " fps"
+			<< std::endl;
+		std::cout << "Frame time (ms): mean " << GetMeanFrameTime() * 1000.0
+			<< ", jitter " << GetJitter() * 1000.0
+			<< ", max jitter " << GetMaxJitter() * 1000.0 << std::endl;
+	}
+
+	/*!
+	 *  returns the time in seconds
+	 *
+	 *      \return returns the time in seconds
+	 */
+	double FramePacer::Now() const
+	{
+		using namespace std::chrono;
+		return duration<double>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	double FramePacer::TargetFrameTime() const
+	{
+		return 1.0 / TargetFrameRate;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file FramePacer.hpp
+  * \author Joe Goldman
+  * \brief FramePacer class declaration. Holds the game loop to a target frame rate.
+  *
+  */
+
+#pragma once
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief Holds the game loop to a target frame rate without pinning a core. Sleeps
+	 *         for most of the time left in a frame, then spins for the last stretch so
+	 *         the frame still ends on time. Keeps frame-time jitter stats.
+	 */
+	class FramePacer
+	{
+	public:
+		FramePacer();
+		~FramePacer();
+
+		// Attributes
+		double TargetFrameRate = 60.0;	// frames per second, 0 or less runs unpaced
+		double SpinThreshold = 0.002;	// seconds before the deadline to stop sleeping
+
+		// pacing
+		void WaitForNextFrame();		// called once at the end of every frame
+		void Reset();					// restart pacing, i.e. after a pause
+
+		// stats, times are in seconds
+		int GetFrameCount() const;
+		double GetMeanFrameTime() const;
+		double GetJitter() const;		// standard deviation of the frame time
+		double GetMaxJitter() const;	// worst distance of a frame time from the target
+		void PrintReport() const;
+
+	private:
+		// time when the current frame should end, and when the last one did
+		double m_deadline = 0.0;
+		double m_lastFrameEnd = 0.0;
+
+		// estimate of how late sleep_for wakes up on this machine
+		double m_sleepOvershoot = 0.0;
+
+		// running frame time stats (Welford)
+		int m_frameCount = 0;
+		double m_meanFrameTime = 0.0;
+		double m_frameTimeM2 = 0.0;
+		double m_maxJitter = 0.0;
+
+		double Now() const;
+		double TargetFrameTime() const;
+		void SleepUntil(double deadline);
+		void RecordFrame(double frameEnd);
+	};
+}
\ No newline at end of file
@@ -22,23 +22,57 @@
 #include <Physics/Physics.hpp>
 #include <Input/Input.hpp>
 #include <Core/Entity.hpp>
+#include <Input/Controller.hpp>
+#include <Core/Profiler.hpp>
+
+#include <algorithm> // sort
+#include <iostream> // cout, endl
+#include <chrono> // steady_clock
 
 namespace GenevaEngine
 {
 	// declare static variables
 	double GameSession::FrameTime = 0.01;
-	float GameSession::TimeStep = 0.01f;
+	float GameSession::TimeStep = 1.0f / 30.0f;	// rendering interpolates between steps
 
 	/*!
-	 *  Constructor. Initialize and start core systems
+	 *  Constructor. Initialize core systems. Headless sessions skip graphics.
+	 *
+	 *      \param [in] settings
 	 */
-	GameSession::GameSession()
+	GameSession::GameSession(SessionSettings settings) : m_settings(settings)
 	{
+		m_framePacer.TargetFrameRate = m_settings.TargetFrameRate;
+		m_stepScheduler.TimeStep = TimeStep;
+		m_stepScheduler.MaxStepsPerFrame = m_settings.MaxStepsPerFrame;
+		m_stepScheduler.StepBudget = m_settings.StepBudget;
+		m_stepScheduler.AdaptiveIterations = m_settings.AdaptiveIterations;
+		m_jobSystem = new JobSystem(m_settings.WorkerThreads);
+
 		m_physics = new Physics(this);
 		m_input = new Input(this);
-		m_graphics = new Graphics(this);
+		if (!m_settings.Headless)
+			m_graphics = new Graphics(this);
+	}
+
+	/*!
+	 *  Starts the session, runs the loop until it's done, then ends the session
+	 */
+	void GameSession::Run()
+	{
+		if (!m_settings.ProfilePath.empty())
+			Profiler::Start();
 
 		Start();
+
+		if (m_settings.Headless)
+			HeadlessLoop();
+		else if (m_settings.PipelinedFrames)
+			PipelinedGameLoop();
+		else
+			GameLoop();
+
+		End();
 	}
 
 	Physics* GameSession::GetPhysics()
@@ -56,27 +90,58 @@ namespace GenevaEngine
 		return m_graphics;
 	}
 
+	JobSystem* GameSession::GetJobSystem()
+	{
+		return m_jobSystem;
+	}
+
+	ConstructRegistry* GameSession::GetConstructRegistry()
+	{
+		return &m_constructs;
+	}
+
+	bool GameSession::IsHeadless() const
+	{
+		return m_settings.Headless;
+	}
+
+	const SessionSettings& GameSession::GetSettings() const
+	{
+		return m_settings;
+	}
+
+	const HeadlessReport& GameSession::GetHeadlessReport() const
+	{
+		return m_headlessReport;
+	}
+
 	/*!
-	 *  Starts the core systems and enter game loop
+	 *  Starts the core systems, loads the level and starts the entities
 	 */
 	void GameSession::Start()
 	{
 		// start systems
-		m_graphics->Start();
+		if (m_graphics != nullptr)
+			m_graphics->Start();
 		m_physics->Start();
 		m_input->Start();
+		m_input->SetInputScript(m_settings.InputScript);
 
 		// Load level
 		// TODO: level loading should be done at run-time with a config file
-		SoftBoxDemo::Load(*this);
+		if (m_settings.LoadLevel != nullptr)
+			m_settings.LoadLevel(*this);
+		else
+			SoftBoxDemo::Load(*this);
 		//HardBoxBehaviorDemo::Load(*this);
 		//WebDemo::Load(*this);
 
 		// start entities
-		for (Entity* entity : m_entities)
-			entity->Start();
+		ApplyStructuralChanges();
 
-		GameLoop();
+		// the level's fixtures went into the broad-phase one at a time, a tree built
+		// over them all at once is faster to query for the rest of the session
+		m_physics->RebuildBroadPhase();
 	}
 
 	/*!
@@ -86,40 +151,118 @@ namespace GenevaEngine
 	{
 		// initialize time variables
 		double currentTime = Time();
-		double accumulator = 0.0;
+		m_framePacer.Reset();
 
 		while (!WindowIsClosed())
 		{
+			PROFILE_ZONE("Frame");
+
 			// time calculations
 			double newTime = Time();
 			FrameTime = newTime - currentTime;
 			if (FrameTime > 0.25)
 				FrameTime = 0.25;
 			currentTime = newTime;
-			accumulator += FrameTime;
+			m_stepScheduler.AddFrameTime(FrameTime);
 
 			//// -----------------------------------------------------
 			/// Game Loop Execution
 			// -------------------------------------------------------
 
 			m_input->Update(FrameTime); 				// Input
-
-			// fixed time-step update loop
-			while (accumulator >= TimeStep)
+			SetPhysicsCamera();
+
+			// fixed time-step update loop, capped and budgeted by the scheduler
+			while (m_stepScheduler.NextStep())
+				FixedStep();							// Physics, Constructs (fixed update)
+
+			// render update, bodies are drawn alpha of the way from the last step to this one
+			const double alpha = m_stepScheduler.GetAlpha();
+			m_constructs.Update(FrameTime);				// Constructs, a type at a time
+			m_graphics->CaptureSnapshot((float)alpha);	// Render
+			m_graphics->SwapSnapshots();
+			m_graphics->Update(FrameTime);
+			m_framePacer.WaitForNextFrame();			// Frame pacing
+
+			// Pausing, block on window events until unpaused or closed
+			if (Paused)
 			{
-				m_physics->Update(TimeStep);			// Physics (fixed update)
-				for (Entity* entity : m_entities)		// Entities and their Constructs
-					entity->FixedUpdate(TimeStep);
+				while (Paused && !WindowIsClosed())
+					m_input->WaitForEvents();
 
-				accumulator -= TimeStep;
+				// the paused time doesn't count toward the next frame
+				newTime = Time();
+				m_framePacer.Reset();
 			}
 
-			// render update
-			const double alpha = accumulator / TimeStep;
-			for (Entity* entity : m_entities)			// Entities and their Constructs
-				entity->Update(FrameTime);
+			//// -----------------------------------------------------
+			/// Game Loop Execution
+			// -------------------------------------------------------
+
+			currentTime = newTime;
+		}
+	}
+
+	/*!
+	 *  Pipelined game loop. While the main thread renders the snapshot of frame N, a
+	 *  worker runs the fixed steps and entity updates of frame N+1. Input and rendering
+	 *  stay on the main thread, GLFW needs them there.
+	 */
+	void GameSession::PipelinedGameLoop()
+	{
+		// initialize time variables
+		double currentTime = Time();
+		m_framePacer.Reset();
+
+		// first snapshot, so there's something to draw on the first frame
+		m_graphics->CaptureSnapshot(0.0f);
+		m_graphics->SwapSnapshots();
+
+		while (!WindowIsClosed())
+		{
+			PROFILE_ZONE("Frame");
+
+			// time calculations
+			double newTime = Time();
+			FrameTime = newTime - currentTime;
+			if (FrameTime > 0.25)
+				FrameTime = 0.25;
+			currentTime = newTime;
+			m_stepScheduler.AddFrameTime(FrameTime);
+
+			//// -----------------------------------------------------
+			/// Game Loop Execution
+			// -------------------------------------------------------
+
+			m_input->Update(FrameTime); 				// Input
+			SetPhysicsCamera();
+
+			// simulate the next frame on a worker, the scheduler is only touched there
+			// until the wait below
+			JobCounter simulation;
+			const double frameTime = FrameTime;
+			m_jobSystem->Submit([this, frameTime]() { Simulate(frameTime); }, &simulation);
+
+			// render the last frame meanwhile, it only reads the front snapshot
 			m_graphics->Update(FrameTime); 				// Render
-			while (Paused) { newTime = Time(); };		// Pausing
+
+			// the world is done stepping, capture it for the next frame
+			m_jobSystem->Wait(simulation);
+			const double alpha = m_stepScheduler.GetAlpha();
+			m_graphics->CaptureSnapshot((float)alpha);
+			m_graphics->SwapSnapshots();
+			m_framePacer.WaitForNextFrame();			// Frame pacing
+
+			// Pausing, block on window events until unpaused or closed
+			if (Paused)
+			{
+				while (Paused && !WindowIsClosed())
+					m_input->WaitForEvents();
+
+				// the paused time doesn't count toward the next frame
+				newTime = Time();
+				m_framePacer.Reset();
+			}
 
 			//// -----------------------------------------------------
 			/// Game Loop Execution
@@ -127,8 +270,101 @@ namespace GenevaEngine
 
 			currentTime = newTime;
 		}
+	}
 
-		End();
+	/*!
+	 *  Runs the fixed steps and entity updates of one frame. Doesn't touch input or
+	 *  graphics, so it can run on a worker while the main thread renders.
+	 *
+	 *      \param [in] frameTime
+	 */
+	void GameSession::Simulate(double frameTime)
+	{
+		PROFILE_ZONE("Simulate");
+
+		while (m_stepScheduler.NextStep())
+			FixedStep();								// Physics, Constructs (fixed update)
+
+		m_constructs.Update(frameTime);
+	}
+
+	/*!
+	 *  Tells physics where the camera is, so it knows which islands to freeze. Runs on
+	 *  the main thread after input moved the camera, before the frame's steps.
+	 */
+	void GameSession::SetPhysicsCamera()
+	{
+		if (m_settings.PhysicsLOD && m_graphics != nullptr)
+			m_physics->GetLOD().SetCamera(m_graphics->GetCamera()->Position);
+	}
+
+	/*!
+	 *  One fixed time-step. Steps physics with the solver iterations the step scheduler
+	 *  picked, runs the constructs' fixed updates, then applies the spawns and despawns
+	 *  they queued, while the world isn't stepping.
+	 */
+	void GameSession::FixedStep()
+	{
+		PROFILE_ZONE("FixedStep");
+
+		m_physics->SetIterations(m_stepScheduler.GetVelocityIterations(),
+			m_stepScheduler.GetPositionIterations());
+		m_physics->Update(TimeStep);					// Physics (fixed update)
+		m_constructs.FixedUpdate(TimeStep);				// Constructs, a type at a time
+		ApplyStructuralChanges();						// Spawns and despawns
+	}
+
+	/*!
+	 *  Headless loop. Runs a fixed number of time-steps as fast as possible, without
+	 *  rendering, then fills out the headless report with the step timings.
+	 */
+	void GameSession::HeadlessLoop()
+	{
+		const int steps = m_settings.HeadlessSteps;
+		std::vector<double> stepTimes;
+		stepTimes.reserve(steps);
+
+		// every step stands in for a rendered frame
+		FrameTime = TimeStep;
+
+		const double startTime = Time();
+		for (int i = 0; i < steps; i++)
+		{
+			PROFILE_ZONE("Frame");
+			const double stepStart = Time();
+
+			m_input->Update(TimeStep); 					// Input (scripted)
+			FixedStep();								// Physics, Constructs (fixed update)
+			m_constructs.Update(TimeStep);
+
+			stepTimes.push_back(Time() - stepStart);
+		}
+		const double totalTime = Time() - startTime;
+
+		// fill out report
+		m_headlessReport = HeadlessReport();
+		m_headlessReport.Steps = steps;
+		m_headlessReport.TotalTime = totalTime;
+		if (steps > 0)
+		{
+			std::sort(stepTimes.begin(), stepTimes.end());
+			double sum = 0.0;
+			for (double t : stepTimes)
+				sum += t;
+
+			m_headlessReport.StepsPerSecond = totalTime > 0.0 ? steps / totalTime : 0.0;
+			m_headlessReport.MeanStepTime = sum / steps;
+			m_headlessReport.MinStepTime = stepTimes.front();
+			m_headlessReport.MaxStepTime = stepTimes.back();
+			m_headlessReport.P99StepTime = stepTimes[(size_t)((steps - 1) * 0.99)];
+		}
+
+		std::cout << "Headless: " << steps << " steps in " << totalTime << "s, "
+			<< m_headlessReport.StepsPerSecond << " steps/sec" << std::endl;
+		std::cout << "Step time (ms): mean " << m_headlessReport.MeanStepTime * 1000.0
+			<< ", min " << m_headlessReport.MinStepTime * 1000.0
+			<< ", p99 " << m_headlessReport.P99StepTime * 1000.0
+			<< ", max " << m_headlessReport.MaxStepTime * 1000.0 << std::endl;
 	}
 
 	/*!
@@ -145,25 +381,143 @@ namespace GenevaEngine
 			system->End();
 
 		// delete entities
-		for (Entity* entity : m_entities)
-			delete entity;
+		m_entityPool.DestroyAll();
+		m_entities.clear();
 
 		// delete systems
 		for (System* system : m_systems)
 			delete system;
 
-		// public flag for closing down the program in main()
-		IsRunning = false;
+		// job system goes last, systems may use it up until they're deleted
+		delete m_jobSystem;
+		m_jobSystem = nullptr;
+
+		// the workers are gone, nothing else is recording
+		if (!m_settings.ProfilePath.empty())
+		{
+			Profiler::Stop();
+			Profiler::WriteChromeTrace(m_settings.ProfilePath);
+		}
+
+		if (!m_settings.Headless)
+		{
+			m_framePacer.PrintReport();
+			m_stepScheduler.PrintReport();
+		}
+	}
+
+	/*!
+	 *  Creates an entity in the entity pool. It joins the game, and its construct is
+	 *  created, at the next structural change.
+	 *
+	 *      \param [in] name
+	 *
+	 *      \return The new entity.
+	 */
+	Entity* GameSession::Spawn(std::string name)
+	{
+		std::lock_guard<std::mutex> lock(m_structuralMutex);
+
+		int slot = -1;
+		Entity* entity = m_entityPool.Create(slot, this, name);
+		entity->m_handle.Slot = slot;
+		entity->m_handle.Generation = m_entityPool.GetGeneration(slot);
+
+		m_spawnQueue.push_back(entity);
+		return entity;
+	}
+
+	/*!
+	 *  Queues an entity to be removed from the game at the next structural change.
+	 *  Despawning an entity that's already gone does nothing.
+	 *
+	 *      \param [in] handle
+	 */
+	void GameSession::Despawn(EntityHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(m_structuralMutex);
+		m_despawnQueue.push_back(handle);
+	}
+
+	/*!
+	 *  Applies the queued despawns, then the queued spawns, in one batch. Despawned
+	 *  entities end, all of their bodies and joints are destroyed together, and their
+	 *  pool slots are freed. Spawned entities are added and started. Anything queued
+	 *  while the batch is applied waits for the next one.
+	 */
+	void GameSession::ApplyStructuralChanges()
+	{
+		PROFILE_ZONE("Structural changes");
+
+		// take the queues, the batches keep their capacity between calls
+		{
+			std::lock_guard<std::mutex> lock(m_structuralMutex);
+			m_despawnBatch.swap(m_despawnQueue);
+			m_spawnBatch.swap(m_spawnQueue);
+		}
+
+		if (!m_despawnBatch.empty())
+		{
+			// resolve handles, an entity despawned twice or already gone is skipped
+			for (EntityHandle handle : m_despawnBatch)
+			{
+				Entity* entity = GetEntity(handle);
+				if (entity != nullptr && !entity->m_despawning)
+				{
+					entity->m_despawning = true;
+					m_despawning.push_back(entity);
+				}
+			}
+			m_despawnBatch.clear();
+
+			// end them, their box2d objects are queued in physics
+			for (Entity* entity : m_despawning)
+				entity->End();
+
+			// drop references, then free the slots
+			auto despawning = [](const Entity* entity) { return entity->m_despawning; };
+			m_entities.erase(std::remove_if(m_entities.begin(), m_entities.end(), despawning),
+				m_entities.end());
+			m_spawnBatch.erase(std::remove_if(m_spawnBatch.begin(), m_spawnBatch.end(),
+				despawning), m_spawnBatch.end());
+
+			Controller* controller = m_input->GetPlayerController();
+			std::lock_guard<std::mutex> lock(m_structuralMutex);
+			for (Entity* entity : m_despawning)
+			{
+				if (controller != nullptr && controller->GetPossessed() == entity)
+					controller->Possess(nullptr);
+				m_entityPool.Destroy(entity->m_handle.Slot);
+			}
+			m_despawning.clear();
+		}
+
+		// despawned constructs, and constructs an entity replaced, left their box2d
+		// objects queued. Their bodies point at freed constructs, they mustn't collide.
+		m_physics->DestroyQueued();
+
+		// spawns
+		for (Entity* entity : m_spawnBatch)
+		{
+			m_entities.push_back(entity);
+			entity->Start();
+		}
+		m_spawnBatch.clear();
 	}
 
 	/*!
-	 *  Adds an entity to GameSession's array of entity
+	 *  Looks up an entity by handle
 	 *
-	 *      \param [in,out] entity
+	 *      \param [in] handle
+	 *
+	 *      \return The entity, or nullptr if it's been destroyed.
 	 */
-	void GameSession::AddEntity(Entity* entity)
+	Entity* GameSession::GetEntity(EntityHandle handle)
 	{
-		m_entities.push_back(entity);
+		if (handle.IsNull())
+			return nullptr;
+
+		return m_entityPool.Get(handle.Slot, handle.Generation);
 	}
 
 	/*!
@@ -183,7 +537,9 @@ namespace GenevaEngine
 	 */
 	double GameSession::Time()
 	{
-		return glfwGetTime();
+		// steady_clock rather than glfwGetTime, so headless sessions never touch GLFW
+		using namespace std::chrono;
+		return duration<double>(steady_clock::now().time_since_epoch()).count();
 	}
 
 	b2World* GameSession::GetWorld()
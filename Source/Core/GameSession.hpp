@@ -25,44 +25,147 @@
 #include <Physics/Physics.hpp>
 #include <Graphics/Graphics.hpp>
 #include <Input/Input.hpp>
-
+#include <Core/FramePacer.hpp>
+#include <Core/StepScheduler.hpp>
+#include <Core/JobSystem.hpp>
+#include <Core/ConstructRegistry.hpp>
+#include <Core/ObjectPool.hpp>
+#include <Core/Entity.hpp>
+
+#include <mutex> // mutex
+#include <string> // string
 #include <vector> // vector
 
 namespace GenevaEngine
 {
-	class Entity;
 	class System;
 
+	/*!
+	 *  \brief Options for a GameSession, set before the session runs
+	 */
+	struct SessionSettings
+	{
+		// headless sessions only build Physics and Input, no window or GPU is needed
+		bool Headless = false;
+		// number of fixed time-steps a headless session runs before ending
+		int HeadlessSteps = 1000;
+		// frame rate the game loop is paced to, 0 or less runs unpaced
+		double TargetFrameRate = 60.0;
+		// most fixed time-steps a frame takes, time owed past that is dropped. 0 or
+		// less is uncapped.
+		int MaxStepsPerFrame = 4;
+		// seconds a frame may spend stepping before the time it still owes is dropped,
+		// 0 or less is unlimited
+		double StepBudget = 0.012;
+		// give steps fewer solver iterations when the full count won't fit the budget
+		bool AdaptiveIterations = true;
+		// worker threads in the job system, -1 uses one per core minus the main thread
+		int WorkerThreads = -1;
+		// solve physics islands across the job system's threads. Results are the same
+		// as solving on one thread.
+		bool ParallelPhysics = true;
+		// spread big islands across the threads a color at a time. Results are the same
+		// for any thread count, but differ slightly from solving in the original order.
+		bool ColoredIslands = false;
+		// solve contacts several at a time in SIMD lanes. Results differ slightly from
+		// the one at a time solver, but are the same from run to run. Off by default so
+		// gameplay steps exactly as stock box2d does.
+		bool WideContactSolver = false;
+		// structure the broad-phase keeps fixtures in. The grid and sweep-and-prune suit
+		// dense scenes of similarly sized fixtures.
+		b2BroadPhaseType BroadPhase = b2_treeBroadPhase;
+		// the grid's cell size, and the size past which sweep-and-prune scans a fixture on
+		// its own
+		float BroadPhaseCellSize = 2.0f;
+		// freeze the islands farther than PhysicsLODRadius from the camera, and thaw them
+		// when it comes back. Headless sessions have no camera, and freeze nothing.
+		bool PhysicsLOD = true;
+		float PhysicsLODRadius = 150.0f;
+		// how much farther than the radius a simulated island has to be before it
+		// freezes, so islands near the edge don't freeze and thaw over and over
+		float PhysicsLODHysteresis = 20.0f;
+		// step the next frame on a worker while this one renders. Frames show the
+		// simulation one frame late, in exchange for render and physics overlapping.
+		bool PipelinedFrames = false;
+		// level to load on start, nullptr loads the default level
+		void (*LoadLevel)(GameSession& gs) = nullptr;
+		// key events fed to Input in place of GLFW when headless
+		std::vector<ScriptedKeyEvent> InputScript;
+		// records the session with the Profiler and writes a Chrome trace here when it
+		// ends, empty doesn't record
+		std::string ProfilePath;
+	};
+
+	/*!
+	 *  \brief Step timings measured during a headless run. Times are in seconds.
+	 */
+	struct HeadlessReport
+	{
+		int Steps = 0;
+		double TotalTime = 0.0;
+		double StepsPerSecond = 0.0;
+		double MeanStepTime = 0.0;
+		double MinStepTime = 0.0;
+		double MaxStepTime = 0.0;
+		double P99StepTime = 0.0;
+	};
+
 	/*!
 	 *  \brief GameSession contains the control flow and initialization of all the systems.
 	 */
 	class GameSession
 	{
 	public:
-		GameSession();
+		GameSession(SessionSettings settings = SessionSettings());
 
 		// Attributes
 		static double FrameTime;
 		static float TimeStep;
 		bool Paused = false;
-		bool IsRunning = true; // flag tells main when to return
+
+		// starts the systems, runs the game loop (or headless loop) and ends the session
+		void Run();
 
 		// getters
 		Physics* GetPhysics();
 		Input* GetInput();
-		Graphics* GetGraphics();
+		Graphics* GetGraphics();				// nullptr when headless
+		JobSystem* GetJobSystem();				// shared by the session and its systems
+		ConstructRegistry* GetConstructRegistry();	// owns and updates every construct
+		bool IsHeadless() const;
+		const SessionSettings& GetSettings() const;
+		const HeadlessReport& GetHeadlessReport() const;
 
 		// Game loop helper
 		bool WindowIsClosed();
 
-		// systems and entities add themselves to gamesession on consturction
+		// systems add themselves to gamesession on consturction
 		void AddSystem(System* system);
-		void AddEntity(Entity* entity);
+
+		// entities are made in, and looked up from, the session's entity pool. Spawns
+		// and despawns are queued, and applied together between fixed steps. Give a
+		// spawned entity its construct before then.
+		Entity* Spawn(std::string name = "none");
+		void Despawn(EntityHandle handle);
+		Entity* GetEntity(EntityHandle handle);	// nullptr once the entity is gone
 
 		// box2d
 		b2World* GetWorld();
 
 	private:
+		// settings this session was created with
+		SessionSettings m_settings;
+		HeadlessReport m_headlessReport;
+
+		// holds the game loop to the target frame rate
+		FramePacer m_framePacer;
+
+		// decides how many fixed steps a frame takes, and their solver iterations
+		StepScheduler m_stepScheduler;
+
+		// threads shared by the session and its systems
+		JobSystem* m_jobSystem = nullptr;
+
 		// system references
 		Physics* m_physics = nullptr;
 		Graphics* m_graphics = nullptr;
@@ -72,11 +175,35 @@ namespace GenevaEngine
 		std::vector<System*> m_systems;
 		std::vector<Entity*> m_entities;
 
+		// storage for the entities, slots are reused as entities come and go
+		ObjectPool<Entity> m_entityPool;
+
+		// structural changes waiting for the next safe point
+		std::mutex m_structuralMutex;
+		std::vector<Entity*> m_spawnQueue;
+		std::vector<EntityHandle> m_despawnQueue;
+
+		// the queues being applied, swapped out so more can be queued meanwhile
+		std::vector<Entity*> m_spawnBatch;
+		std::vector<EntityHandle> m_despawnBatch;
+		std::vector<Entity*> m_despawning;
+
+		// the entities' constructs, stored and updated by type
+		ConstructRegistry m_constructs;
+
 		double Time();
 		void Start();
 		void GameLoop();
+		void PipelinedGameLoop();
+		void HeadlessLoop();
+		void Simulate(double frameTime);
+		void FixedStep();
+		void SetPhysicsCamera();
+		void ApplyStructuralChanges();
 		void End();
 
 		friend Graphics;
+		friend class EntityBenchmark;	// drives structural changes without a game loop
+		friend class RopeBenchmark;		// steps a web without a game loop
 	};
 }
\ No newline at end of file
@@ -0,0 +1,250 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file JobSystem.cpp
+  * \author Joe Goldman
+  * \brief JobSystem class definition
+  *
+  **/
+
+#include <Core/JobSystem.hpp>
+
+#include <algorithm> // min, max
+#include <cassert> // assert
+
+namespace GenevaEngine
+{
+	// the job system this thread is a worker of, and its index there
+	static thread_local const JobSystem* t_jobSystem = nullptr;
+	static thread_local int t_threadIndex = 0;
+
+	/*!
+	 *  Constructor. Starts the worker threads.
+	 *
+	 *      \param [in] workerCount
+	 */
+	JobSystem::JobSystem(int workerCount)
+		: m_owner(std::this_thread::get_id())
+	{
+		if (workerCount < 0)
+			workerCount = std::max(0, (int)std::thread::hardware_concurrency() - 1);
+
+		for (int i = 0; i < workerCount + 1; i++)
+			m_queues.push_back(std::make_unique<JobQueue>());
+
+		for (int i = 1; i <= workerCount; i++)
+			m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+
+	/*!
+	 *  Destructor. Wakes and joins the worker threads.
+	 */
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_running = false;
+		}
+		m_wake.notify_all();
+
+		for (std::thread& worker : m_workers)
+			worker.join();
+	}
+
+	int JobSystem::GetThreadCount() const
+	{
+		return (int)m_queues.size();
+	}
+
+	int JobSystem::GetThreadIndex() const
+	{
+		return t_jobSystem == this ? t_threadIndex : 0;
+	}
+
+	/*!
+	 *  Whether the calling thread may submit and wait. Every other thread would run
+	 *  jobs as thread 0 alongside the owner, and share its per-thread scratch.
+	 *
+	 *      \return true for the thread that made the job system and for workers
+	 */
+	bool JobSystem::IsOwnThread() const
+	{
+		return t_jobSystem == this || std::this_thread::get_id() == m_owner;
+	}
+
+	/*!
+	 *  Pushes a job onto the calling thread's queue.
+	 *
+	 *      \param [in]     job
+	 *      \param [in,out] counter	incremented now, decremented when the job is done
+	 */
+	void JobSystem::Submit(Job job, JobCounter* counter)
+	{
+		assert(IsOwnThread());
+		if (counter != nullptr)
+			counter->m_count.fetch_add(1, std::memory_order_relaxed);
+
+		const int index = GetThreadIndex();
+
+		{
+			std::lock_guard<std::mutex> lock(m_queues[index]->Mutex);
+			m_queues[index]->Jobs.push_back({ std::move(job), counter });
+		}
+
+		// take the sleep lock so a worker can't miss the wake up between its check and wait
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_queuedJobs.fetch_add(1, std::memory_order_relaxed);
+		}
+		m_wake.notify_one();
+	}
+
+	/*!
+	 *  Runs queued jobs on the calling thread until the counter reaches zero. With
+	 *  nothing left to take, the rest are running on other threads: sleeps until a
+	 *  counter is done or more jobs are queued.
+	 *
+	 *      \param [in] counter
+	 */
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		assert(IsOwnThread());
+		const int index = GetThreadIndex();
+		while (!counter.IsDone())
+		{
+			if (TryRunJob(index))
+				continue;
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_counterDone.wait(lock, [this, &counter]() { return counter.IsDone() || m_queuedJobs > 0; });
+		}
+	}
+
+	/*!
+	 *  Splits [0, count) into batches and runs them across the threads. The calling
+	 *  thread runs the first batch itself, then helps with the rest.
+	 *
+	 *      \param [in] count
+	 *      \param [in] minBatch
+	 *      \param [in] job			called with (begin, end, threadIndex)
+	 */
+	void JobSystem::ParallelFor(int count, int minBatch, const RangeJob& job)
+	{
+		assert(IsOwnThread());
+		if (count <= 0)
+			return;
+
+		// a few batches per thread evens out batches that take longer than others
+		minBatch = std::max(1, minBatch);
+		const int batchCount = std::min((count + minBatch - 1) / minBatch, GetThreadCount() * 4);
+		if (batchCount <= 1)
+		{
+			job(0, count, GetThreadIndex());
+			return;
+		}
+
+		const int batchSize = (count + batchCount - 1) / batchCount;
+		JobCounter counter;
+		for (int begin = batchSize; begin < count; begin += batchSize)
+		{
+			const int end = std::min(begin + batchSize, count);
+			Submit([this, &job, begin, end]() { job(begin, end, GetThreadIndex()); }, &counter);
+		}
+
+		job(0, std::min(batchSize, count), GetThreadIndex());
+		Wait(counter);
+	}
+
+	/*!
+	 *  Runs one job from this thread's queue, or one stolen from another thread's
+	 *
+	 *      \param [in] threadIndex
+	 *
+	 *      \return true if a job was run
+	 */
+	bool JobSystem::TryRunJob(int threadIndex)
+	{
+		Entry entry;
+		if (!PopJob(threadIndex, entry) && !StealJob(threadIndex, entry))
+			return false;
+
+		m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		entry.Work();
+
+		// take the sleep lock so a waiter can't miss the wake up between its check and wait
+		if (entry.Counter != nullptr && entry.Counter->m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_sleepMutex);
+			}
+			m_counterDone.notify_all();
+		}
+
+		return true;
+	}
+
+	/*!
+	 *  Pops the newest job off this thread's own queue
+	 */
+	bool JobSystem::PopJob(int threadIndex, Entry& entry)
+	{
+		JobQueue& queue = *m_queues[threadIndex];
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+		if (queue.Jobs.empty())
+			return false;
+
+		entry = std::move(queue.Jobs.back());
+		queue.Jobs.pop_back();
+		return true;
+	}
+
+	/*!
+	 *  Steals the oldest job from another thread's queue, starting with the next thread
+	 */
+	bool JobSystem::StealJob(int threadIndex, Entry& entry)
+	{
+		const int count = (int)m_queues.size();
+		for (int i = 1; i < count; i++)
+		{
+			JobQueue& queue = *m_queues[(threadIndex + i) % count];
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			if (queue.Jobs.empty())
+				continue;
+
+			entry = std::move(queue.Jobs.front());
+			queue.Jobs.pop_front();
+			return true;
+		}
+
+		return false;
+	}
+
+	/*!
+	 *  Worker thread body. Runs jobs until the job system shuts down, sleeping when
+	 *  there are none queued anywhere.
+	 *
+	 *      \param [in] threadIndex
+	 */
+	void JobSystem::WorkerLoop(int threadIndex)
+	{
+		t_jobSystem = this;
+		t_threadIndex = threadIndex;
+
+		while (m_running)
+		{
+			if (TryRunJob(threadIndex))
+				continue;
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_wake.wait(lock, [this]() { return !m_running || m_queuedJobs > 0; });
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file JobSystem.hpp
+  * \author Joe Goldman
+  * \brief JobSystem class declaration. Work-stealing thread pool shared
+  * by the game session and its systems.
+  *
+  */
+
+#pragma once
+
+#include <atomic> // atomic
+#include <condition_variable> // condition_variable
+#include <deque> // deque
+#include <functional> // function
+#include <memory> // unique_ptr
+#include <mutex> // mutex
+#include <thread> // thread
+#include <vector> // vector
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief Counts unfinished jobs. Jobs submitted with a counter decrement it when
+	 *         they finish, and JobSystem::Wait returns once it reaches zero.
+	 */
+	class JobCounter
+	{
+	public:
+		bool IsDone() const { return m_count.load(std::memory_order_acquire) == 0; }
+
+	private:
+		std::atomic<int> m_count{ 0 };
+		friend class JobSystem;
+	};
+
+	/*!
+	 *  \brief Work-stealing thread pool. Every thread has its own job deque; a thread
+	 *         pops its newest job first and steals the oldest job from another thread
+	 *         when it runs dry. Threads waiting on a counter run jobs until none are
+	 *         left to take, then sleep until the counter is done. Only the thread that
+	 *         made the job system and its workers may submit or wait: the maker shares
+	 *         thread index 0 with no one, so callers can keep per-thread scratch by
+	 *         thread index. Each job system numbers its own threads.
+	 */
+	class JobSystem
+	{
+	public:
+		using Job = std::function<void()>;
+		using RangeJob = std::function<void(int begin, int end, int threadIndex)>;
+
+		// workerCount < 0 uses one worker per core, minus the calling thread
+		JobSystem(int workerCount = -1);
+		~JobSystem();
+
+		// threads that run jobs, workers plus the thread that owns the job system
+		int GetThreadCount() const;
+		// index of the calling thread, 0 for any thread that isn't one of this job
+		// system's workers. Only the thread that made the job system may run jobs as 0.
+		int GetThreadIndex() const;
+
+		// job submission
+		void Submit(Job job, JobCounter* counter = nullptr);
+		void Wait(JobCounter& counter);
+
+		// splits [0, count) into batches of at least minBatch and runs them across the
+		// threads. Blocks until all batches are done.
+		void ParallelFor(int count, int minBatch, const RangeJob& job);
+
+	private:
+		struct Entry
+		{
+			Job Work;
+			JobCounter* Counter = nullptr;
+		};
+
+		struct JobQueue
+		{
+			std::mutex Mutex;
+			std::deque<Entry> Jobs;
+		};
+
+		// one queue per thread, index 0 belongs to the thread that made the job system
+		std::vector<std::unique_ptr<JobQueue>> m_queues;
+		std::vector<std::thread> m_workers;
+		std::thread::id m_owner;
+
+		// idle workers sleep until a job is submitted, waiters until a counter is done
+		std::atomic<bool> m_running{ true };
+		std::atomic<int> m_queuedJobs{ 0 };
+		std::mutex m_sleepMutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_counterDone;
+
+		bool IsOwnThread() const;
+		bool TryRunJob(int threadIndex);
+		bool PopJob(int threadIndex, Entry& entry);
+		bool StealJob(int threadIndex, Entry& entry);
+		void WorkerLoop(int threadIndex);
+	};
+}
\ No newline at end of file
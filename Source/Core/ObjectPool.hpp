@@ -0,0 +1,197 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file ObjectPool.hpp
+  * \author Joe Goldman
+  * \brief ObjectPool class declaration and definition. Chunked slot allocator with
+  * generation counts, used for entities and constructs.
+  *
+  */
+
+#pragma once
+
+#include <cstdint> // uint32_t
+#include <memory> // unique_ptr
+#include <new> // placement new
+#include <utility> // forward
+#include <vector> // vector
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief Stores objects of one type in fixed size chunks of slots. Objects never move,
+	 *         freed slots are reused before new ones, and chunks are only allocated as the
+	 *         pool grows, so creating and destroying objects doesn't touch the heap once
+	 *         the pool has warmed up. Every slot counts how many times it was freed, so a
+	 *         (slot, generation) pair stays safe to look up after the object is gone.
+	 *         Not thread safe.
+	 */
+	template <class T, int ChunkSize = 256>
+	class ObjectPool
+	{
+	public:
+		ObjectPool() = default;
+		ObjectPool(const ObjectPool&) = delete;
+		ObjectPool& operator=(const ObjectPool&) = delete;
+		~ObjectPool();
+
+		// constructs a T in a free slot, slot is set to the slot it was put in
+		template <class... Args>
+		T* Create(int& slot, Args&&... args);
+		// destroys the object in the slot, its generation goes up
+		void Destroy(int slot);
+		void DestroyAll();
+
+		// the object in the slot, or nullptr if it's been destroyed since generation
+		T* Get(int slot, uint32_t generation);
+		uint32_t GetGeneration(int slot) const;
+		int GetCount() const;
+
+		// calls func(T&) on every object alive in the pool, in slot order. func may create
+		// objects, they may or may not be visited.
+		template <class Func>
+		void ForEach(Func&& func);
+
+	private:
+		struct Chunk
+		{
+			alignas(T) unsigned char Storage[sizeof(T) * ChunkSize];
+			uint32_t Generations[ChunkSize];
+			bool Alive[ChunkSize] = {};
+			int Used = 0;		// slots handed out so far, from the front of the chunk
+
+			Chunk() { for (uint32_t& generation : Generations) generation = 1; }
+			T* Get(int i) { return reinterpret_cast<T*>(Storage) + i; }
+		};
+
+		std::vector<std::unique_ptr<Chunk>> m_chunks;
+		std::vector<int> m_freeSlots;
+		int m_count = 0;
+	};
+
+	/*!
+	 *  Destructor. Destroys the objects still alive in the pool.
+	 */
+	template <class T, int ChunkSize>
+	ObjectPool<T, ChunkSize>::~ObjectPool()
+	{
+		DestroyAll();
+	}
+
+	/*!
+	 *  Constructs a T in the most recently freed slot, or the next unused one, adding
+	 *  a chunk if the last one is full.
+	 *
+	 *      \param [out] slot	the slot the object was put in
+	 *      \param [in]  args	T's constructor arguments
+	 *
+	 *      \return The new object.
+	 */
+	template <class T, int ChunkSize>
+	template <class... Args>
+	T* ObjectPool<T, ChunkSize>::Create(int& slot, Args&&... args)
+	{
+		if (!m_freeSlots.empty())
+		{
+			slot = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}
+		else
+		{
+			if (m_chunks.empty() || m_chunks.back()->Used == ChunkSize)
+				m_chunks.push_back(std::make_unique<Chunk>());
+
+			slot = ((int)m_chunks.size() - 1) * ChunkSize + m_chunks.back()->Used++;
+		}
+
+		Chunk& chunk = *m_chunks[slot / ChunkSize];
+		T* object = new (chunk.Get(slot % ChunkSize)) T(std::forward<Args>(args)...);
+		chunk.Alive[slot % ChunkSize] = true;
+		m_count++;
+
+		return object;
+	}
+
+	/*!
+	 *  Destroys the object in the slot and frees the slot. Does nothing if it's already free.
+	 *
+	 *      \param [in] slot
+	 */
+	template <class T, int ChunkSize>
+	void ObjectPool<T, ChunkSize>::Destroy(int slot)
+	{
+		Chunk& chunk = *m_chunks[slot / ChunkSize];
+		const int i = slot % ChunkSize;
+		if (!chunk.Alive[i])
+			return;
+
+		chunk.Get(i)->~T();
+		chunk.Alive[i] = false;
+		chunk.Generations[i]++;
+		m_freeSlots.push_back(slot);
+		m_count--;
+	}
+
+	/*!
+	 *  Destroys every object in the pool. The chunks are kept for reuse.
+	 */
+	template <class T, int ChunkSize>
+	void ObjectPool<T, ChunkSize>::DestroyAll()
+	{
+		for (int c = 0; c < (int)m_chunks.size(); c++)
+		{
+			for (int i = 0; i < m_chunks[c]->Used; i++)
+				Destroy(c * ChunkSize + i);
+		}
+	}
+
+	template <class T, int ChunkSize>
+	T* ObjectPool<T, ChunkSize>::Get(int slot, uint32_t generation)
+	{
+		if (slot < 0 || slot >= (int)m_chunks.size() * ChunkSize)
+			return nullptr;
+
+		Chunk& chunk = *m_chunks[slot / ChunkSize];
+		const int i = slot % ChunkSize;
+		if (!chunk.Alive[i] || chunk.Generations[i] != generation)
+			return nullptr;
+
+		return chunk.Get(i);
+	}
+
+	template <class T, int ChunkSize>
+	uint32_t ObjectPool<T, ChunkSize>::GetGeneration(int slot) const
+	{
+		return m_chunks[slot / ChunkSize]->Generations[slot % ChunkSize];
+	}
+
+	template <class T, int ChunkSize>
+	int ObjectPool<T, ChunkSize>::GetCount() const
+	{
+		return m_count;
+	}
+
+	template <class T, int ChunkSize>
+	template <class Func>
+	void ObjectPool<T, ChunkSize>::ForEach(Func&& func)
+	{
+		// by index, creating an object can grow m_chunks. Chunks themselves don't move.
+		for (size_t c = 0; c < m_chunks.size(); c++)
+		{
+			Chunk& chunk = *m_chunks[c];
+			for (int i = 0; i < chunk.Used; i++)
+			{
+				if (chunk.Alive[i])
+					func(*chunk.Get(i));
+			}
+		}
+	}
+}
\ No newline at end of file
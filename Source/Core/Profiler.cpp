@@ -0,0 +1,189 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file Profiler.cpp
+  * \author Joe Goldman
+  * \brief Profiler class definition
+  *
+  **/
+
+#include <Core/Profiler.hpp>
+
+#include <algorithm> // min
+#include <atomic> // atomic
+#include <chrono> // steady_clock
+#include <cstdint> // INT64_MAX
+#include <fstream> // ofstream
+#include <iostream> // cout, endl
+#include <memory> // unique_ptr
+#include <mutex> // mutex
+#include <vector> // vector
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief A finished zone. Times are in nanoseconds.
+	 */
+	struct ProfileEvent
+	{
+		const char* Name;
+		int64_t Start;
+		int64_t End;
+	};
+
+	/*!
+	 *  \brief One thread's recorded zones. Buffers outlive their threads, so a trace
+	 *         can be written after the job system shuts down.
+	 */
+	struct ProfileThreadBuffer
+	{
+		int ThreadId = 0;
+		int Dropped = 0;
+		std::vector<ProfileEvent> Events;
+	};
+
+	static std::atomic<bool> s_recording{ false };
+	static std::mutex s_buffersMutex;
+	static std::vector<std::unique_ptr<ProfileThreadBuffer>> s_buffers;
+	static thread_local ProfileThreadBuffer* t_buffer = nullptr;
+
+	/*!
+	 *  Returns the calling thread's buffer, registering it the first time
+	 */
+	static ProfileThreadBuffer& GetThreadBuffer()
+	{
+		if (t_buffer == nullptr)
+		{
+			std::lock_guard<std::mutex> lock(s_buffersMutex);
+			s_buffers.push_back(std::make_unique<ProfileThreadBuffer>());
+			t_buffer = s_buffers.back().get();
+			t_buffer->ThreadId = (int)s_buffers.size() - 1;
+		}
+
+		return *t_buffer;
+	}
+
+	/*!
+	 *  Clears the last recording and starts a new one
+	 */
+	void Profiler::Start()
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_buffersMutex);
+			for (std::unique_ptr<ProfileThreadBuffer>& buffer : s_buffers)
+			{
+				buffer->Events.clear();
+				buffer->Dropped = 0;
+			}
+		}
+
+		s_recording.store(true, std::memory_order_relaxed);
+	}
+
+	void Profiler::Stop()
+	{
+		s_recording.store(false, std::memory_order_relaxed);
+	}
+
+	bool Profiler::IsRecording()
+	{
+		return s_recording.load(std::memory_order_relaxed);
+	}
+
+	int64_t Profiler::Now()
+	{
+		using namespace std::chrono;
+		return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	/*!
+	 *  Adds a zone to the calling thread's buffer
+	 *
+	 *      \param [in] name	must outlive the profiler, i.e. a string literal
+	 *      \param [in] start
+	 *      \param [in] end
+	 */
+	void Profiler::Record(const char* name, int64_t start, int64_t end)
+	{
+		if (!IsRecording())
+			return;
+
+		ProfileThreadBuffer& buffer = GetThreadBuffer();
+		if ((int)buffer.Events.size() >= k_maxEventsPerThread)
+		{
+			buffer.Dropped++;
+			return;
+		}
+
+		buffer.Events.push_back({ name, start, end });
+	}
+
+	/*!
+	 *  Writes every thread's zones as complete ("X") events in Chrome's trace_event
+	 *  format. Times are written in microseconds, from the earliest zone.
+	 *
+	 *      \param [in] path
+	 *
+	 *      \return false if the file can't be written
+	 */
+	bool Profiler::WriteChromeTrace(const std::string& path)
+	{
+		std::ofstream file(path);
+		if (!file)
+		{
+			std::cout << "Warning - Profiler::WriteChromeTrace - Can't write " << path
+				<< std::endl;
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(s_buffersMutex);
+
+		int64_t origin = INT64_MAX;
+		int eventCount = 0;
+		int dropped = 0;
+		for (const std::unique_ptr<ProfileThreadBuffer>& buffer : s_buffers)
+		{
+			for (const ProfileEvent& event : buffer->Events)
+				origin = std::min(origin, event.Start);
+			eventCount += (int)buffer->Events.size();
+			dropped += buffer->Dropped;
+		}
+
+		file << "{\"traceEvents\":[\n";
+		bool first = true;
+		for (const std::unique_ptr<ProfileThreadBuffer>& buffer : s_buffers)
+		{
+			// thread name, so the trace viewer labels the rows
+			file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+				<< "\"tid\":" << buffer->ThreadId << ",\"args\":{\"name\":\""
+				<< (buffer->ThreadId == 0 ? "Main" : "Thread ") ;
+			if (buffer->ThreadId != 0)
+				file << buffer->ThreadId;
+			file << "\"}}";
+			first = false;
+
+			for (const ProfileEvent& event : buffer->Events)
+			{
+				file << ",\n{\"name\":\"" << event.Name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+					<< buffer->ThreadId << ",\"ts\":" << (event.Start - origin) / 1000.0
+					<< ",\"dur\":" << (event.End - event.Start) / 1000.0 << "}";
+			}
+		}
+		file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+		std::cout << "Profiler: wrote " << eventCount << " zones to " << path;
+		if (dropped > 0)
+			std::cout << " (" << dropped << " dropped, buffers were full)";
+		std::cout << std::endl;
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file Profiler.hpp
+  * \author Joe Goldman
+  * \brief Profiler and ProfileZone class declarations. Records timed zones on every
+  * thread and writes them out as a Chrome trace (chrome://tracing, Perfetto).
+  *
+  */
+
+#pragma once
+
+#include <cstdint> // int64_t
+#include <string> // string
+
+// set to 0 to compile the zones out entirely
+#ifndef GENEVA_PROFILER
+#define GENEVA_PROFILER 1
+#endif
+
+#define GENEVA_PROFILE_CONCAT_INNER(a, b) a##b
+#define GENEVA_PROFILE_CONCAT(a, b) GENEVA_PROFILE_CONCAT_INNER(a, b)
+
+#if GENEVA_PROFILER
+// times the rest of the enclosing scope. name must be a string literal.
+#define PROFILE_ZONE(name) \
+	GenevaEngine::ProfileZone GENEVA_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name)
+#endif
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief Collects timed zones while recording. Every thread records into its own
+	 *         buffer, so recording takes no locks. Zones nest by time, a zone that starts
+	 *         and ends inside another is drawn under it in the trace.
+	 */
+	class Profiler
+	{
+	public:
+		// most zones a thread keeps per recording, later ones are dropped
+		static constexpr int k_maxEventsPerThread = 1 << 20;
+
+		// recording. Start clears the last recording. Don't start or write while other
+		// threads are recording.
+		static void Start();
+		static void Stop();
+		static bool IsRecording();
+
+		// nanoseconds on the profiler's clock
+		static int64_t Now();
+
+		// adds a zone on the calling thread. name must outlive the profiler.
+		static void Record(const char* name, int64_t start, int64_t end);
+
+		// writes the recording as Chrome trace_event JSON, returns false if it can't
+		static bool WriteChromeTrace(const std::string& path);
+	};
+
+	/*!
+	 *  \brief Records a zone from its construction to its destruction. Use PROFILE_ZONE.
+	 *         Costs one flag check when the profiler isn't recording.
+	 */
+	class ProfileZone
+	{
+	public:
+		ProfileZone(const char* name) : m_name(name),
+			m_start(Profiler::IsRecording() ? Profiler::Now() : -1)
+		{
+		}
+
+		~ProfileZone()
+		{
+			if (m_start >= 0)
+				Profiler::Record(m_name, m_start, Profiler::Now());
+		}
+
+	private:
+		const char* m_name;
+		int64_t m_start;
+	};
+}
\ No newline at end of file
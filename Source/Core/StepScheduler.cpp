@@ -0,0 +1,197 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file StepScheduler.cpp
+  * \author Joe Goldman
+  * \brief StepScheduler class definition
+  *
+  **/
+
+#include <Core/StepScheduler.hpp>
+
+#include <chrono> // steady_clock
+#include <cmath> // floor
+#include <iostream> // cout, endl
+
+namespace GenevaEngine
+{
+	// weight of the newest measurement in the step cost averages
+	static const double k_costSmoothing = 0.1;
+
+	/*!
+	 *  Starts a frame, adding its time to the accumulator
+	 *
+	 *      \param [in] frameTime	seconds since the last frame
+	 */
+	void StepScheduler::AddFrameTime(double frameTime)
+	{
+		m_accumulator += frameTime;
+		m_frameSteps = 0;
+		m_frameStepTime = 0.0;
+		m_stepStart = -1.0;
+		m_frameCount++;
+	}
+
+	/*!
+	 *  Finishes timing the last step, then decides whether to take another. Stops when
+	 *  the accumulator is short of a step, or when the frame hits MaxStepsPerFrame or
+	 *  runs out of StepBudget, dropping the steps it still owes. The first step the
+	 *  frame owes is always taken, so the game keeps moving however slow steps get.
+	 *
+	 *      \return true if another step should be taken
+	 */
+	bool StepScheduler::NextStep()
+	{
+		// cost of the step that just ran
+		if (m_stepStart >= 0.0)
+		{
+			const double cost = Now() - m_stepStart;
+			m_frameStepTime += cost;
+			m_stepCost[m_level] = m_stepCost[m_level] == 0.0 ? cost
+				: m_stepCost[m_level] + (cost - m_stepCost[m_level]) * k_costSmoothing;
+			m_stepStart = -1.0;
+
+			// the levels above aren't being measured, let their costs fall off so they
+			// get tried again once the load drops
+			for (int level = 0; level < m_level; level++)
+				m_stepCost[level] *= 1.0 - k_costSmoothing;
+		}
+
+		if (m_accumulator < TimeStep)
+			return false;
+
+		if (MaxStepsPerFrame > 0 && m_frameSteps >= MaxStepsPerFrame)
+		{
+			m_cappedFrames++;
+			DropOwedSteps();
+			return false;
+		}
+
+		m_level = ChooseLevel();
+		if (StepBudget > 0.0 && m_frameSteps > 0
+			&& m_frameStepTime + m_stepCost[m_level] > StepBudget)
+		{
+			m_overBudgetFrames++;
+			DropOwedSteps();
+			return false;
+		}
+
+		m_accumulator -= TimeStep;
+		m_frameSteps++;
+		m_stepCount[m_level]++;
+		m_stepStart = Now();
+		return true;
+	}
+
+	int StepScheduler::GetVelocityIterations() const
+	{
+		return k_levels[m_level].Velocity;
+	}
+
+	int StepScheduler::GetPositionIterations() const
+	{
+		return k_levels[m_level].Position;
+	}
+
+	double StepScheduler::GetAlpha() const
+	{
+		return m_accumulator / TimeStep;
+	}
+
+	int StepScheduler::GetFrameCount() const
+	{
+		return m_frameCount;
+	}
+
+	int StepScheduler::GetStepCount(int level) const
+	{
+		return m_stepCount[level];
+	}
+
+	int StepScheduler::GetCappedFrames() const
+	{
+		return m_cappedFrames;
+	}
+
+	int StepScheduler::GetOverBudgetFrames() const
+	{
+		return m_overBudgetFrames;
+	}
+
+	double StepScheduler::GetDilatedTime() const
+	{
+		return m_dilatedTime;
+	}
+
+	/*!
+	 *  Prints the step stats to the console
+	 */
+	void StepScheduler::PrintReport() const
+	{
+		std::cout << "Steps by solver iterations (velocity/position):";
+		for (int level = 0; level < k_levelCount; level++)
+		{
+			std::cout << " " << k_levels[level].Velocity << "/" << k_levels[level].Position
+				<< " " << m_stepCount[level];
+		}
+		std::cout << std::endl;
+		std::cout << "Step limits: " << m_cappedFrames << " capped frames, "
+			<< m_overBudgetFrames << " over budget frames, " << m_dilatedTime
+			<< "s of game time dropped" << std::endl;
+	}
+
+	/*!
+	 *  returns the time in seconds
+	 *
+	 *      \return returns the time in seconds
+	 */
+	double StepScheduler::Now() const
+	{
+		using namespace std::chrono;
+		return duration<double>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	/*!
+	 *  Picks the most iterations that let the rest of the frame's steps fit in what's
+	 *  left of the budget, going by the measured cost of a step at each level
+	 *
+	 *      \return index into k_levels
+	 */
+	int StepScheduler::ChooseLevel() const
+	{
+		if (!AdaptiveIterations || StepBudget <= 0.0)
+			return 0;
+
+		int owedSteps = (int)std::floor(m_accumulator / TimeStep);
+		if (MaxStepsPerFrame > 0 && owedSteps > MaxStepsPerFrame - m_frameSteps)
+			owedSteps = MaxStepsPerFrame - m_frameSteps;
+
+		const double budgetLeft = StepBudget - m_frameStepTime;
+		for (int level = 0; level < k_levelCount; level++)
+		{
+			if (m_stepCost[level] * owedSteps <= budgetLeft)
+				return level;
+		}
+
+		return k_levelCount - 1;
+	}
+
+	/*!
+	 *  Drops the whole steps left in the accumulator. The remainder is kept, so
+	 *  rendering still interpolates smoothly.
+	 */
+	void StepScheduler::DropOwedSteps()
+	{
+		const double dropped = std::floor(m_accumulator / TimeStep) * TimeStep;
+		m_accumulator -= dropped;
+		m_dilatedTime += dropped;
+	}
+}
\ No newline at end of file
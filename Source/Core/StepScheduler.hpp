@@ -0,0 +1,87 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file StepScheduler.hpp
+  * \author Joe Goldman
+  * \brief StepScheduler class declaration. Decides how many fixed time-steps a frame
+  * takes, and how many solver iterations each one gets.
+  *
+  */
+
+#pragma once
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief Runs the fixed time-step accumulator on a time budget. A frame takes the
+	 *         steps its time owes, up to MaxStepsPerFrame and as many as fit in
+	 *         StepBudget. Time owed past that is dropped, so the game runs slower than
+	 *         real time (time dilation) instead of every frame taking longer than the
+	 *         last. Steps are given fewer solver iterations when the full count wouldn't
+	 *         fit in what's left of the budget. Keeps stats on how often each happens.
+	 */
+	class StepScheduler
+	{
+	public:
+		// solver iterations a step can get, from full quality down
+		struct IterationLevel
+		{
+			int Velocity;
+			int Position;
+		};
+		static constexpr int k_levelCount = 3;
+		static constexpr IterationLevel k_levels[k_levelCount] = { { 6, 2 }, { 4, 2 }, { 2, 1 } };
+
+		// Attributes
+		double TimeStep = 1.0 / 30.0;	// seconds of game time per step
+		int MaxStepsPerFrame = 4;		// 0 or less is uncapped
+		double StepBudget = 0.012;		// seconds of stepping per frame, 0 or less is unlimited
+		bool AdaptiveIterations = true;	// false always steps at full quality
+
+		// scheduling. Call AddFrameTime once a frame, then step while NextStep is true.
+		void AddFrameTime(double frameTime);
+		bool NextStep();
+		int GetVelocityIterations() const;	// for the step NextStep just allowed
+		int GetPositionIterations() const;
+		double GetAlpha() const;			// how far the accumulator is into the next step
+
+		// stats, times are in seconds
+		int GetFrameCount() const;
+		int GetStepCount(int level) const;
+		int GetCappedFrames() const;		// frames that hit MaxStepsPerFrame
+		int GetOverBudgetFrames() const;	// frames that ran out of StepBudget
+		double GetDilatedTime() const;		// game time dropped in total
+		void PrintReport() const;
+
+	private:
+		double m_accumulator = 0.0;
+
+		// the frame being stepped
+		int m_frameSteps = 0;
+		double m_frameStepTime = 0.0;
+		double m_stepStart = -1.0;	// negative when no step is running
+		int m_level = 0;
+
+		// running average of a step's cost at each level, 0 until one is measured
+		double m_stepCost[k_levelCount] = {};
+
+		// stats
+		int m_frameCount = 0;
+		int m_stepCount[k_levelCount] = {};
+		int m_cappedFrames = 0;
+		int m_overBudgetFrames = 0;
+		double m_dilatedTime = 0.0;
+
+		double Now() const;
+		int ChooseLevel() const;
+		void DropOwedSteps();
+	};
+}
\ No newline at end of file
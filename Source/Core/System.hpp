@@ -26,6 +26,10 @@ namespace GenevaEngine
 	 */
 	class System
 	{
+	public:
+		// systems are deleted through System*
+		virtual ~System() = default;
+
 	protected:
 		GameSession* m_gameSession = nullptr;
 	private:
@@ -12,14 +12,175 @@
   * \file Main.cpp
   * \author Joe Goldman
   * \brief Launches engine in main()
+  *
+  * Usage: GenevaEngine [--headless [steps]] [--fps rate] [--threads count]
+  *        [--pipelined] [--level name] [--profile trace.json] [--max-steps count]
+  *        [--step-budget seconds] [--fixed-iterations] [--serial-physics]
+  *        [--wide-contacts] [--colored-islands] [--broadphase tree|sweep|grid]
   */
 
 #include <Core/GameSession.hpp>
+#include <Levels/IncludeAllLevels.hpp>
+#include <Benchmarks/EntityBenchmark.hpp>
+#include <Benchmarks/ContactBenchmark.hpp>
+#include <Benchmarks/BroadPhaseBenchmark.hpp>
+#include <Benchmarks/StaticTreeBenchmark.hpp>
+#include <Benchmarks/RayCastBenchmark.hpp>
+#include <Benchmarks/LODBenchmark.hpp>
+#include <Benchmarks/SoftBodyBenchmark.hpp>
+#include <Benchmarks/RopeBenchmark.hpp>
+#include <Benchmarks/FluidBenchmark.hpp>
 
-int main()
+#include <cstdlib> // atoi, atof
+#include <cstring> // strcmp
+#include <iostream> // cout, endl
+
+/*!
+ *  Looks up a level's Load function by class name
+ *
+ *      \param [in] name
+ *
+ *      \return The level's Load function, or nullptr if there is no level with that name
+ */
+static void (*FindLevel(const char* name))(GenevaEngine::GameSession&)
+{
+	if (strcmp(name, "SoftBoxDemo") == 0)
+		return GenevaEngine::SoftBoxDemo::Load;
+	if (strcmp(name, "HardBoxBehaviorDemo") == 0)
+		return GenevaEngine::HardBoxBehaviorDemo::Load;
+	if (strcmp(name, "WebDemo") == 0)
+		return GenevaEngine::WebDemo::Load;
+	if (strcmp(name, "FluidDemo") == 0)
+		return GenevaEngine::FluidDemo::Load;
+
+	return nullptr;
+}
+
+/*!
+ *  Looks up a benchmark's Run function by name
+ *
+ *      \param [in] name
+ *
+ *      \return The benchmark's Run function, or nullptr if there is no benchmark with that name
+ */
+static void (*FindBenchmark(const char* name))()
+{
+	if (strcmp(name, "entities") == 0)
+		return GenevaEngine::EntityBenchmark::Run;
+	if (strcmp(name, "contacts") == 0)
+		return GenevaEngine::ContactBenchmark::Run;
+	if (strcmp(name, "broadphase") == 0)
+		return GenevaEngine::BroadPhaseBenchmark::Run;
+	if (strcmp(name, "statictree") == 0)
+		return GenevaEngine::StaticTreeBenchmark::Run;
+	if (strcmp(name, "raycast") == 0)
+		return GenevaEngine::RayCastBenchmark::Run;
+	if (strcmp(name, "lod") == 0)
+		return GenevaEngine::LODBenchmark::Run;
+	if (strcmp(name, "softbody") == 0)
+		return GenevaEngine::SoftBodyBenchmark::Run;
+	if (strcmp(name, "rope") == 0)
+		return GenevaEngine::RopeBenchmark::Run;
+	if (strcmp(name, "fluid") == 0)
+		return GenevaEngine::FluidBenchmark::Run;
+
+	return nullptr;
+}
+
+int main(int argc, char** argv)
 {
-	GenevaEngine::GameSession gs;
-	while (gs.IsRunning) {}
+	GenevaEngine::SessionSettings settings;
+
+	// command line options
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--headless") == 0)
+		{
+			settings.Headless = true;
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+				settings.HeadlessSteps = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+		{
+			settings.TargetFrameRate = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			settings.WorkerThreads = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--max-steps") == 0 && i + 1 < argc)
+		{
+			settings.MaxStepsPerFrame = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--step-budget") == 0 && i + 1 < argc)
+		{
+			settings.StepBudget = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--fixed-iterations") == 0)
+		{
+			settings.AdaptiveIterations = false;
+		}
+		else if (strcmp(argv[i], "--serial-physics") == 0)
+		{
+			settings.ParallelPhysics = false;
+		}
+		else if (strcmp(argv[i], "--wide-contacts") == 0)
+		{
+			settings.WideContactSolver = true;
+		}
+		else if (strcmp(argv[i], "--colored-islands") == 0)
+		{
+			settings.ColoredIslands = true;
+		}
+		else if (strcmp(argv[i], "--broadphase") == 0 && i + 1 < argc)
+		{
+			i++;
+			if (strcmp(argv[i], "tree") == 0)
+				settings.BroadPhase = b2_treeBroadPhase;
+			else if (strcmp(argv[i], "sweep") == 0)
+				settings.BroadPhase = b2_sweepBroadPhase;
+			else if (strcmp(argv[i], "grid") == 0)
+				settings.BroadPhase = b2_gridBroadPhase;
+			else
+			{
+				std::cout << "Unknown broadphase: " << argv[i] << std::endl;
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--pipelined") == 0)
+		{
+			settings.PipelinedFrames = true;
+		}
+		else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+		{
+			settings.LoadLevel = FindLevel(argv[++i]);
+			if (settings.LoadLevel == nullptr)
+			{
+				std::cout << "Unknown level: " << argv[i] << std::endl;
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+		{
+			settings.ProfilePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc)
+		{
+			// benchmarks run on their own, without a session
+			void (*benchmark)() = FindBenchmark(argv[++i]);
+			if (benchmark == nullptr)
+			{
+				std::cout << "Unknown benchmark: " << argv[i] << std::endl;
+				return 1;
+			}
+
+			benchmark();
+			return 0;
+		}
+	}
+
+	GenevaEngine::GameSession gs(settings);
+	gs.Run();
 
 	return 0;
 }
\ No newline at end of file
@@ -17,12 +17,10 @@
 
 #include <Gameplay/SingleShapeBehavior.hpp>
 #include <Input/Command.hpp>
-#include <Physics/RayCastCallback.hpp>
 #include <Constructs/Construct.hpp>
 #include <Constructs/SingleShape.hpp>
 #include <Core/State.hpp>
 #include <Core/GameSession.hpp>
-#include <Utilities/BodyUtils.hpp>
 
 namespace GenevaEngine
 {
@@ -82,15 +80,8 @@ namespace GenevaEngine
 		if (body->GetLinearVelocity().y > 0)
 			return nullptr;
 
-		// check for grounded
-		RayCastCallback callback;
-		float rayCastLength = BodyUtils::GetHalfHeight(*body) + 0.01f;
-		b2Vec2 p1 = body->GetPosition();
-		b2Vec2 p2 = body->GetPosition() + b2Vec2(0, rayCastLength * -1.0f);
-
-		singleShape->GetWorld()->RayCast(&callback, p1, p2);
-
-		if (callback.Hit)
+		// check for grounded, kept up to date from its contacts
+		if (singleShape->Query(ConstructQuery::IsGrounded))
 		{
 			return new Grounded_SingleShape();
 		}
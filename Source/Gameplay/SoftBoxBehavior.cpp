@@ -16,7 +16,6 @@
   **/
 #include <Gameplay/SoftBoxBehavior.hpp>
 #include <Input/Command.hpp>
-#include <Physics/RayCastCallback.hpp>
 #include <Constructs/Construct.hpp>
 #include <Constructs/SoftBox.hpp>
 #include <Core/State.hpp>
@@ -35,7 +34,7 @@ namespace GenevaEngine
 		switch ((int)command->GetType())
 		{
 		case Command::Jump:
-			SoftBoxBehavior::Jump(*owner, 5000.0f);
+			SoftBoxBehavior::Jump(*owner, 120.0f);
 			return new Airborne_SoftBox();
 
 		case Command::Move:
@@ -48,7 +47,7 @@ namespace GenevaEngine
 	State<SoftBox>* Grounded_SoftBox::Update(SoftBox* softBox, double dt)
 	{
 		// apply horizontal movement from xAxis input
-		SoftBoxBehavior::Move(*softBox, (float)dt, xAxis, 5000.0f);
+		SoftBoxBehavior::Move(*softBox, (float)dt, xAxis, 450.0f);
 
 		return nullptr;
 	}
@@ -74,22 +73,15 @@ namespace GenevaEngine
 	State<SoftBox>* Airborne_SoftBox::Update(SoftBox* softBox, double dt)
 	{
 		// apply horizontal movement from xAxis input
-		SoftBoxBehavior::Move(*softBox, (float)dt, xAxis, 5000.0f);
+		SoftBoxBehavior::Move(*softBox, (float)dt, xAxis, 450.0f);
 
 		// first check for downward vel
-		b2Body& body = softBox->GetCenterBody();
+		b2SoftBody& body = softBox->GetSoftBody();
 		if (body.GetLinearVelocity().y > 0)
 			return nullptr;
 
-		// check for grounded
-		RayCastCallback callback;
-		float rayCastLength = softBox->Size.y + 0.01f;
-		b2Vec2 p1 = body.GetPosition();
-		b2Vec2 p2 = body.GetPosition() + b2Vec2(0, rayCastLength * -1.0f);
-
-		softBox->GetWorld()->RayCast(&callback, p1, p2);
-
-		if (callback.Hit)
+		// check for grounded, kept up to date from its contacts
+		if (softBox->Query(ConstructQuery::IsGrounded))
 		{
 			return new Grounded_SoftBox();
 		}
@@ -100,11 +92,15 @@ namespace GenevaEngine
 	{
 	}
 
+	/*!
+	 *  Pushes the whole soft body sideways. Strengths are changes in velocity per
+	 *  second, every particle's velocity changes by the same amount.
+	 */
 	void SoftBoxBehavior::Move(SoftBox& softBox, float dt, float x_axis,
 		float moveStrength, float maxVelocity)
 	{
 		// get body
-		b2Body& body = softBox.GetCenterBody();
+		b2SoftBody& body = softBox.GetSoftBody();
 
 		// calculate force
 		float adjustedStr = moveStrength * body.GetMass() * dt;
@@ -115,7 +111,7 @@ namespace GenevaEngine
 			forceX = -1.0f * adjustedStr;
 
 		// apply force
-		body.ApplyLinearImpulseToCenter(b2Vec2(forceX, 0), true);
+		body.ApplyLinearImpulse(b2Vec2(forceX, 0));
 
 		// max velocity
 		b2Vec2 velocity = body.GetLinearVelocity();
@@ -125,8 +121,8 @@ namespace GenevaEngine
 
 	void SoftBoxBehavior::Jump(SoftBox& softBox, float jumpStrength)
 	{
-		b2Body& body = softBox.GetCenterBody();
+		b2SoftBody& body = softBox.GetSoftBody();
 		b2Vec2 force(0, body.GetMass() * jumpStrength);
-		body.ApplyLinearImpulseToCenter(force, true);
+		body.ApplyLinearImpulse(force);
 	}
 }
\ No newline at end of file
@@ -23,6 +23,8 @@
 #include <Graphics/Shader.hpp>
 #include <Core/Entity.hpp>
 #include <Core/GameSession.hpp>
+#include <Physics/Physics.hpp>
+#include <Core/Profiler.hpp>
 
 namespace GenevaEngine
 {
@@ -61,6 +63,7 @@ namespace GenevaEngine
 
 		// configure global opengl state
 		glEnable(GL_DEPTH_TEST);
+		glEnable(GL_PROGRAM_POINT_SIZE);
 
 		// create, save, and assign shaders. TODO: do this with a config file
 		glLineWidth(2.0f);
@@ -72,6 +75,10 @@ namespace GenevaEngine
 		m_line_shader =
 			new Shader("Shaders/LineShader.vert", "Shaders/LineShader.frag");
 		m_line_shader->DrawType = GL_LINES;
+		// point shader
+		m_point_shader =
+			new Shader("Shaders/PointShader.vert", "Shaders/PointShader.frag");
+		m_point_shader->DrawType = GL_POINTS;
 
 		// set clear color
 		Graphics::SetClearColor(GetPaletteColor(1));
@@ -84,18 +91,22 @@ namespace GenevaEngine
 	{
 		delete (m_triangle_shader);
 		delete (m_line_shader);
+		delete (m_point_shader);
 
 		// glfw: terminate, clearing all previously allocated GLFW resources.
 		glfwTerminate();
 	}
 
 	/*!
-	 *  Updates the graphics.
+	 *  Updates the graphics. Draws the front snapshot, the entities themselves are only
+	 *  read when a snapshot is captured.
 	 *
 	 *      \param [in] dt
 	 */
 	void Graphics::Update(double dt)
 	{
+		PROFILE_ZONE("Render");
+
 		// check for close window
 		if (glfwGetKey(m_window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 			glfwSetWindowShouldClose(m_window, true);
@@ -108,61 +119,131 @@ namespace GenevaEngine
 		m_camera.BuildProjectionMatrix(proj, 0.0f, SCR_WIDTH, SCR_HEIGHT);
 		m_triangle_shader->UpdateProjection(proj);
 		m_line_shader->UpdateProjection(proj);
+		m_point_shader->UpdateProjection(proj);
 
 		// render entities
-		for (Entity* entity : m_gameSession->m_entities)
-			RenderEntity(*entity);
+		DrawSnapshot(m_snapshots[m_frontSnapshot], proj);
 		Flush();
 
 		// glfw: swap buffers
+		PROFILE_ZONE("Swap buffers");
 		glfwSwapBuffers(m_window);
 	}
 
 	/*!
-	 *  Renders the entity.
+	 *  Copies every entity's construct into the back snapshot. Must not run while the
+	 *  world is stepping.
+	 *
+	 *      \param [in] alpha	how far between the last two physics steps to draw bodies
+	 */
+	void Graphics::CaptureSnapshot(float alpha)
+	{
+		PROFILE_ZONE("Capture snapshot");
+
+		RenderSnapshot& snapshot = m_snapshots[1 - m_frontSnapshot];
+		snapshot.Clear();
+
+		for (Entity* entity : m_gameSession->m_entities)
+			CaptureEntity(*entity, snapshot, alpha);
+
+		CaptureFluid(snapshot);
+	}
+
+	/*!
+	 *  Copies the particle fluid's positions into the snapshot, as they were at the
+	 *  last step.
+	 *
+	 *      \param [in,out] snapshot
+	 */
+	void Graphics::CaptureFluid(RenderSnapshot& snapshot)
+	{
+		const ParticleFluid& fluid = m_gameSession->GetPhysics()->GetFluid();
+		const float* x = fluid.GetPositionX();
+		const float* y = fluid.GetPositionY();
+		const int count = fluid.GetParticleCount();
+
+		snapshot.Particles.resize(count);
+		for (int i = 0; i < count; i++)
+			snapshot.Particles[i].Set(x[i], y[i]);
+		snapshot.ParticleSize = fluid.Spacing;
+	}
+
+	/*!
+	 *  The last captured snapshot becomes the one that's drawn
+	 */
+	void Graphics::SwapSnapshots()
+	{
+		m_frontSnapshot = 1 - m_frontSnapshot;
+	}
+
+	/*!
+	 *  Copies the entity's construct into the snapshot as world space shapes, with its
+	 *  bodies, joint anchors and soft body outlines interpolated between the last two
+	 *  physics steps. Ropes are copied as they were at the last step.
 	 *
-	 *      \param [in,out] entity
+	 *      \param [in]     entity
+	 *      \param [in,out] snapshot
+	 *      \param [in]     alpha
 	 */
-	void Graphics::RenderEntity(Entity& entity)
+	void Graphics::CaptureEntity(Entity& entity, RenderSnapshot& snapshot, float alpha)
 	{
 		// draw entities contruct (composite of box2d bodies)
 		const Color color = entity.GetRenderColor();
 		Construct& construct = entity.GetConstruct();
 		const ConstructRenderData& constructData = construct.GetConstructRenderData();
+		const Physics* physics = m_gameSession->GetPhysics();
 
-		// render each joint
+		// capture each joint
 		if (constructData.FillBetweenJoints)
 		{
 			const int count = constructData.JointRenderList.size();
 			for (int i = 0; i < count; i++)
 			{
-				const b2Joint* joint = constructData.JointRenderList[i].Joint;
+				b2Joint* joint = constructData.JointRenderList[i].Joint;
 				const b2Vec2 offset = constructData.JointRenderList[i].aOffset;
-				m_transformedVerts[i] = joint->GetAnchorA() + offset;
+				m_transformedVerts[i] =
+					physics->GetInterpolatedPoint(joint->GetBodyA(), joint->GetAnchorA(), alpha)
+					+ offset;
 			}
 
-			DrawSolidPolygon(m_transformedVerts, count, color);
+			AddShape(snapshot, RenderShape::Type::Polygon, m_transformedVerts, count, 0.0f, color);
 		}
 		else
 		{
 			for (const JointRenderData jointData : constructData.JointRenderList)
 			{
 				b2Joint* joint = jointData.Joint;
-				DrawSegment(
-					joint->GetAnchorA() + jointData.aOffset,
-					joint->GetAnchorB() + jointData.bOffset,
-					color);
+				m_transformedVerts[0] = physics->GetInterpolatedPoint(
+					joint->GetBodyA(), joint->GetAnchorA(), alpha) + jointData.aOffset;
+				m_transformedVerts[1] = physics->GetInterpolatedPoint(
+					joint->GetBodyB(), joint->GetAnchorB(), alpha) + jointData.bOffset;
+				AddShape(snapshot, RenderShape::Type::Segment, m_transformedVerts, 2, 0.0f, color);
 			}
 		}
 
-		// render each body
+		// capture each soft body, filled inside its outline
+		for (const SoftBodyRenderData softBodyData : constructData.SoftBodyRenderList)
+		{
+			const int count = softBodyData.SoftBody->GetOutline(m_transformedVerts,
+				(int)(sizeof(m_transformedVerts) / sizeof(b2Vec2)), alpha);
+			if (count > 0)
+				AddShape(snapshot, RenderShape::Type::Polygon, m_transformedVerts, count, 0.0f, color);
+		}
+
+		// capture each rope, straight from its vertices, however many it has
+		for (const RopeRenderData ropeData : constructData.RopeRenderList)
+		{
+			AddShape(snapshot, RenderShape::Type::LineStrip, ropeData.Rope->GetVertices(),
+				ropeData.Rope->GetVertexCount(), 0.0f, color);
+		}
+
+		// capture each body
 		for (const BodyRenderData bodyData : constructData.BodyRenderList)
 		{
 			b2Shape* shape = bodyData.Body->GetFixtureList()->GetShape();
 			b2Body* body = bodyData.Body;
-			b2Transform xf = body->GetTransform();
+			b2Transform xf = physics->GetInterpolatedTransform(body, alpha);
 			b2PolygonShape* polygon = nullptr;
-			b2CircleShape* circle = nullptr;
 
 			switch (shape->GetType())
 			{
@@ -172,12 +253,15 @@ namespace GenevaEngine
 				for (int i = 0; i < polygon->m_count; i++)
 					m_transformedVerts[i] = b2Mul(xf, polygon->m_vertices[i]);
 
-				DrawSolidPolygon(m_transformedVerts, polygon->m_count, color);
+				AddShape(snapshot, RenderShape::Type::Polygon, m_transformedVerts,
+					polygon->m_count, 0.0f, color);
 				break;
 
 			case b2Shape::e_chain:
 			case b2Shape::e_circle:
-				DrawCircle(body->GetPosition(), shape->m_radius, color);
+				m_transformedVerts[0] = xf.p;
+				AddShape(snapshot, RenderShape::Type::Circle, m_transformedVerts, 1,
+					shape->m_radius, color);
 				break;
 
 			case b2Shape::e_edge:
@@ -187,6 +271,73 @@ namespace GenevaEngine
 		}
 	}
 
+	/*!
+	 *  Appends a shape and its verts to the snapshot
+	 */
+	void Graphics::AddShape(RenderSnapshot& snapshot, RenderShape::Type type,
+		const b2Vec2* vertices, int vertexCount, float radius, const Color& color)
+	{
+		RenderShape shape;
+		shape.ShapeType = type;
+		shape.FirstVertex = (int)snapshot.Vertices.size();
+		shape.VertexCount = vertexCount;
+		shape.Radius = radius;
+		shape.ShapeColor = color;
+
+		snapshot.Vertices.insert(snapshot.Vertices.end(), vertices, vertices + vertexCount);
+		snapshot.Shapes.push_back(shape);
+	}
+
+	/*!
+	 *  Draws every shape in the snapshot, then its particles as points as wide as the
+	 *  particle spacing on screen.
+	 *
+	 *      \param [in] snapshot
+	 *      \param [in] projection	the camera's, to size the points in pixels
+	 */
+	void Graphics::DrawSnapshot(const RenderSnapshot& snapshot, const float* projection)
+	{
+		for (const RenderShape& shape : snapshot.Shapes)
+		{
+			const b2Vec2* vertices = snapshot.Vertices.data() + shape.FirstVertex;
+
+			switch (shape.ShapeType)
+			{
+			case RenderShape::Type::Polygon:
+				DrawSolidPolygon(vertices, shape.VertexCount, shape.ShapeColor);
+				break;
+
+			case RenderShape::Type::Circle:
+				DrawCircle(vertices[0], shape.Radius, shape.ShapeColor);
+				break;
+
+			case RenderShape::Type::Segment:
+				DrawSegment(vertices[0], vertices[1], shape.ShapeColor);
+				break;
+
+			case RenderShape::Type::LineStrip:
+				DrawLineStrip(vertices, shape.VertexCount, shape.ShapeColor);
+				break;
+			}
+		}
+
+		if (!snapshot.Particles.empty())
+		{
+			int width, height;
+			glfwGetFramebufferSize(m_window, &width, &height);
+			const float pixels = snapshot.ParticleSize * projection[0] * 0.5f * width;
+			m_point_shader->Points(snapshot.Particles.data(), (int)snapshot.Particles.size(),
+				GetPaletteColor(4), b2Max(pixels, 1.0f));
+		}
+	}
+
+	void RenderSnapshot::Clear()
+	{
+		Vertices.clear();
+		Shapes.clear();
+		Particles.clear();
+	}
+
 	/*!
 	 *  Sets window the clear color.
 	 *
@@ -276,6 +427,15 @@ namespace GenevaEngine
 		m_line_shader->Vertex(p2, color);
 	}
 
+	void Graphics::DrawLineStrip(const b2Vec2* vertices, int vertexCount, const Color& color)
+	{
+		for (int i = 1; i < vertexCount; ++i)
+		{
+			m_line_shader->Vertex(vertices[i - 1], color);
+			m_line_shader->Vertex(vertices[i], color);
+		}
+	}
+
 	/*!
 	 *  Flush the remaining buffers to be rendered
 	 */
@@ -283,6 +443,7 @@ namespace GenevaEngine
 	{
 		m_line_shader->Flush();
 		m_triangle_shader->Flush();
+		m_point_shader->Flush();
 	}
 
 	/*!
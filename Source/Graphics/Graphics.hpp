@@ -23,6 +23,7 @@
 #include <iostream> // cout, endl
 #include <unordered_map> // unordered_map
 #include <string> // string
+#include <vector> // vector
 
 #include <Core/System.hpp>
 #include <Graphics/Camera.hpp>
@@ -33,6 +34,35 @@ namespace GenevaEngine
 {
 	class Entity;
 
+	/*!
+	 *  \brief A shape ready to draw, in world space. Its verts live in the snapshot's
+	 *         vertex array.
+	 */
+	struct RenderShape
+	{
+		enum class Type { Polygon, Circle, Segment, LineStrip };
+
+		Type ShapeType = Type::Polygon;
+		int FirstVertex = 0;		// index into RenderSnapshot::Vertices
+		int VertexCount = 0;		// circles and segments don't use all their verts
+		float Radius = 0.0f;		// circles only
+		Color ShapeColor;
+	};
+
+	/*!
+	 *  \brief Everything needed to draw one frame, copied out of the entities' constructs.
+	 *         Graphics draws from a snapshot, so it never reads a b2World that's stepping.
+	 */
+	struct RenderSnapshot
+	{
+		std::vector<b2Vec2> Vertices;
+		std::vector<RenderShape> Shapes;
+		std::vector<b2Vec2> Particles;		// fluid particles, drawn as points
+		float ParticleSize = 0.0f;			// in world units
+
+		void Clear();
+	};
+
 	/*!
 	 *  \brief Sets up shaders, window, and renders the game. Uses GLFW
 	 */
@@ -67,21 +97,35 @@ namespace GenevaEngine
 		GLFWwindow* m_window;
 		Shader* m_triangle_shader = nullptr;
 		Shader* m_line_shader = nullptr;
+		Shader* m_point_shader = nullptr;
 
 		// Assets, mapped to keys
 		std::unordered_map<std::string, Shader> m_shaders;
 
+		// double buffered render snapshots, drawn from the front, captured into the back
+		RenderSnapshot m_snapshots[2];
+		int m_frontSnapshot = 0;
+
 		// verts used in a single shape perspective transformation
 		b2Vec2 m_transformedVerts[512];
 
 		// debug camera methods
 		void UpdateCameraMovement();
 
+		// snapshot methods
+		void CaptureSnapshot(float alpha);		// copies the entities into the back snapshot
+		void SwapSnapshots();					// the back snapshot becomes the drawn one
+		void CaptureEntity(Entity& entity, RenderSnapshot& snapshot, float alpha);
+		void CaptureFluid(RenderSnapshot& snapshot);
+		void AddShape(RenderSnapshot& snapshot, RenderShape::Type type, const b2Vec2* vertices,
+			int vertexCount, float radius, const Color& color);
+
 		// render methods
-		void RenderEntity(Entity& entity);
+		void DrawSnapshot(const RenderSnapshot& snapshot, const float* projection);
 		void DrawCircle(const b2Vec2& center, float radius, const Color& color);
 		void DrawSolidPolygon(const b2Vec2* vertices, int vertexCount, const Color& color);
 		void DrawSegment(const b2Vec2& p1, const b2Vec2& p2, const Color& color);
+		void DrawLineStrip(const b2Vec2* vertices, int vertexCount, const Color& color);
 		void Flush();
 
 		// inherited mebers, methods, and constructors
@@ -15,6 +15,9 @@
   */
 
 #include <Graphics/Shader.hpp>
+#include <Core/Profiler.hpp>
+
+#include <algorithm> // copy, fill
 
 namespace GenevaEngine
 {
@@ -88,13 +91,15 @@ namespace GenevaEngine
 		glUseProgram(m_programId);
 		m_vertexAttribute = 0;
 		m_colorAttribute = 1;
+		m_sizeAttribute = 2;
 
-		// Generate 1 vertex buffer and 2 vertex arrays
+		// Generate 1 vertex array and 3 vertex buffers
 		glGenVertexArrays(1, &m_vaoId);
 		glGenBuffers(3, m_vboIds);
 		glBindVertexArray(m_vaoId);
 		glEnableVertexAttribArray(m_vertexAttribute);
 		glEnableVertexAttribArray(m_colorAttribute);
+		glEnableVertexAttribArray(m_sizeAttribute);
 
 		// Vertex buffer
 		glBindBuffer(GL_ARRAY_BUFFER, m_vboIds[0]);
@@ -103,6 +108,9 @@ namespace GenevaEngine
 		glBindBuffer(GL_ARRAY_BUFFER, m_vboIds[1]);
 		glVertexAttribPointer(m_colorAttribute, 4, GL_FLOAT, GL_FALSE, 0, BUFFER_OFFSET(0));
 		glBufferData(GL_ARRAY_BUFFER, sizeof(m_colors), m_colors, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, m_vboIds[2]);
+		glVertexAttribPointer(m_sizeAttribute, 1, GL_FLOAT, GL_FALSE, 0, BUFFER_OFFSET(0));
+		glBufferData(GL_ARRAY_BUFFER, sizeof(m_sizes), m_sizes, GL_DYNAMIC_DRAW);
 
 		// save uniform location for later use
 		m_projectionUniform = glGetUniformLocation(m_programId, "projectionMatrix");
@@ -123,7 +131,7 @@ namespace GenevaEngine
 		if (m_vaoId)
 		{
 			glDeleteVertexArrays(1, &m_vaoId);
-			glDeleteBuffers(2, m_vboIds);
+			glDeleteBuffers(3, m_vboIds);
 		}
 	}
 
@@ -153,6 +161,50 @@ namespace GenevaEngine
 		++m_count;
 	}
 
+	/*!
+	 *   add a point to be rendered by the shader, for shaders drawing GL_POINTS.
+	 *
+	 *      \param [in] v
+	 *      \param [in] c
+	 *      \param [in] size	in pixels
+	 */
+	void Shader::Vertex(const b2Vec2& v, const Color& c, float size)
+	{
+		if (m_count == k_maxVertices)
+			Flush();
+
+		m_vertices[m_count] = v;
+		m_colors[m_count] = c;
+		m_sizes[m_count] = size;
+		++m_count;
+	}
+
+	/*!
+	 *   add many points of one color and size, copied into the buffer a batch at a
+	 *   time, for shaders drawing GL_POINTS.
+	 *
+	 *      \param [in] points
+	 *      \param [in] count
+	 *      \param [in] c
+	 *      \param [in] size	in pixels
+	 */
+	void Shader::Points(const b2Vec2* points, int count, const Color& c, float size)
+	{
+		while (count > 0)
+		{
+			if (m_count == k_maxVertices)
+				Flush();
+
+			const int batch = b2Min(count, k_maxVertices - m_count);
+			std::copy(points, points + batch, m_vertices + m_count);
+			std::fill(m_colors + m_count, m_colors + m_count + batch, c);
+			std::fill(m_sizes + m_count, m_sizes + m_count + batch, size);
+			m_count += batch;
+			points += batch;
+			count -= batch;
+		}
+	}
+
 	/*!
 	 *  Flushes the remaining vertices in the buffer to get rendered
 	 */
@@ -161,6 +213,7 @@ namespace GenevaEngine
 		if (m_count == 0)
 			return;
 
+		PROFILE_ZONE("Shader::Flush");
 		glUseProgram(m_programId);
 
 		glUniformMatrix4fv(m_projectionUniform, 1, GL_FALSE, m_projectionMatrix);
@@ -173,8 +226,14 @@ namespace GenevaEngine
 		glBindBuffer(GL_ARRAY_BUFFER, m_vboIds[1]);
 		glBufferSubData(GL_ARRAY_BUFFER, 0, m_count * sizeof(Color), m_colors); // m_colors);
 
-		if (DrawType == GL_TRIANGLES)
-		{ // TRIANGLES
+		if (DrawType == GL_POINTS)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, m_vboIds[2]);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, m_count * sizeof(float), m_sizes);
+		}
+
+		if (DrawType == GL_TRIANGLES || DrawType == GL_POINTS)
+		{ // TRIANGLES, POINTS
 			glEnable(GL_BLEND);
 			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 			glDrawArrays(DrawType, 0, m_count);
@@ -54,6 +54,8 @@ namespace GenevaEngine
 		// render methods
 		void UpdateProjection(float* projection);
 		void Vertex(const b2Vec2& v, const Color& c);
+		void Vertex(const b2Vec2& v, const Color& c, float size);
+		void Points(const b2Vec2* points, int count, const Color& c, float size);
 		void Flush();
 
 	private:
@@ -61,13 +63,15 @@ namespace GenevaEngine
 		static constexpr int k_maxVertices = 4096;
 		b2Vec2 m_vertices[k_maxVertices];
 		Color m_colors[k_maxVertices];
+		float m_sizes[k_maxVertices]; // in pixels, points only
 		int32 m_count = 0;
 		GLuint m_programId = -1;
 		GLuint m_vaoId;
-		GLuint m_vboIds[2];
+		GLuint m_vboIds[3];
 		GLint m_projectionUniform;
 		GLint m_vertexAttribute;
 		GLint m_colorAttribute;
+		GLint m_sizeAttribute;
 		float* m_projectionMatrix;
 
 		// utility function for checking shader compilation/linking errors.
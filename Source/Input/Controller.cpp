@@ -108,4 +108,14 @@ namespace GenevaEngine
 	{
 		m_entity = entity;
 	}
+
+	/*!
+	 *  Returns the possessed entity
+	 *
+	 *      \return The entity, or nullptr if nothing is possessed.
+	 */
+	Entity* Controller::GetPossessed() const
+	{
+		return m_entity;
+	}
 }
\ No newline at end of file
@@ -71,6 +71,7 @@ namespace GenevaEngine
 		void BindCommand(int key, Command* command);
 		void BindCommand(std::list<AxisKeys> keys_pairs, Command* command);
 		void Possess(Entity* entity);
+		Entity* GetPossessed() const;
 
 	private:
 		std::list<KeyBinding> keypress_binds;
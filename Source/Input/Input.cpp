@@ -20,6 +20,9 @@
 #include <Input/Command.hpp>
 #include <Input/Controller.hpp>
 #include <Graphics/Camera.hpp>
+#include <Core/Profiler.hpp>
+
+#include <algorithm> // stable_sort
 
 namespace GenevaEngine
 {
@@ -30,8 +33,9 @@ namespace GenevaEngine
 	 */
 	void Input::Start()
 	{
-		// keys
-		SetupKeyInputs(m_gameSession->GetGraphics()->GetWindow());
+		// keys, headless sessions have no window to take key events from
+		if (!m_gameSession->IsHeadless())
+			SetupKeyInputs(m_gameSession->GetGraphics()->GetWindow());
 
 		// set up player controller
 		// commands deleted in ~Controller
@@ -64,14 +68,75 @@ namespace GenevaEngine
 	 */
 	void Input::Update(double dt)
 	{
+		PROFILE_ZONE("Input");
+
 		UpdateKeyStates();
-		glfwPollEvents();
+		if (m_gameSession->IsHeadless())
+			PlayInputScript();
+		else
+			glfwPollEvents();
+
+		ProcessSessionKeys();
 
 		if (m_playerController != nullptr)
 			m_playerController->HandleInput();
 
-		if (DevCheatsOn)
+		if (DevCheatsOn && !m_gameSession->IsHeadless())
 			ProcessDevCheats(m_gameSession->GetGraphics()->GetWindow(), dt);
+
+		m_frame++;
+	}
+
+	/*!
+	 *  Sets the key events to play back in a headless session. An empty script
+	 *  acts as a null input source.
+	 *
+	 *      \param [in] script
+	 */
+	void Input::SetInputScript(std::vector<ScriptedKeyEvent> script)
+	{
+		std::stable_sort(script.begin(), script.end(),
+			[](const ScriptedKeyEvent& a, const ScriptedKeyEvent& b) { return a.Frame < b.Frame; });
+
+		m_script = script;
+		m_scriptCursor = 0;
+	}
+
+	/*!
+	 *  Sends the script's key events for this frame, as if GLFW had reported them
+	 */
+	void Input::PlayInputScript()
+	{
+		while (m_scriptCursor < m_script.size() && m_script[m_scriptCursor].Frame <= m_frame)
+		{
+			const ScriptedKeyEvent& event = m_script[m_scriptCursor];
+			KeyStateEvent(event.Key, event.IsDown);
+			m_scriptCursor++;
+		}
+	}
+
+	/*!
+	 *  Sleeps until GLFW has window events, then handles them. Used in place of
+	 *  Update while paused, so a paused session doesn't spin.
+	 */
+	void Input::WaitForEvents()
+	{
+		UpdateKeyStates();
+		glfwWaitEvents();
+		ProcessSessionKeys();
+
+		// the render update that normally checks escape doesn't run while paused
+		if (KeyPressed(GLFW_KEY_ESCAPE))
+			glfwSetWindowShouldClose(m_gameSession->GetGraphics()->GetWindow(), true);
+	}
+
+	/*!
+	 *  Keys that control the session rather than an entity. P toggles pause.
+	 */
+	void Input::ProcessSessionKeys()
+	{
+		if (KeyPressed(GLFW_KEY_P))
+			m_gameSession->Paused = !m_gameSession->Paused;
 	}
 
 	/*!
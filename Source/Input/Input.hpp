@@ -21,6 +21,7 @@
 #include <GLFW/glfw3.h> // GLFW
 
 #include <map>
+#include <vector>
 
 #include <Core/System.hpp>
 
@@ -29,6 +30,16 @@ namespace GenevaEngine
 	class Command;
 	class Controller;
 
+	/*!
+	 *  \brief A key event fed to Input on a given frame, used in place of GLFW when headless
+	 */
+	struct ScriptedKeyEvent
+	{
+		int Frame = 0;
+		int Key = 0;
+		bool IsDown = true;
+	};
+
 	/*!
 	 *  \brief Core system for handling input
 	 */
@@ -51,10 +62,21 @@ namespace GenevaEngine
 		// Player controller
 		Controller* GetPlayerController(); // TODO: add player IDs for multiplayer
 
+		// Scripted input, replaces GLFW polling in headless sessions
+		void SetInputScript(std::vector<ScriptedKeyEvent> script);
+
+		// Blocks until GLFW has window events, used while the session is paused
+		void WaitForEvents();
+
 	private:
 		// key state data
 		static std::map<int, KeyState> keys;
 
+		// scripted input, sorted by frame
+		std::vector<ScriptedKeyEvent> m_script;
+		size_t m_scriptCursor = 0;
+		int m_frame = 0;
+
 		// controllers
 		Controller* m_playerController = nullptr;
 
@@ -65,6 +87,11 @@ namespace GenevaEngine
 		void UpdateKeyStates();
 		// The GLFW callback for key events.  Sends events to all KeyInput instances
 		static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+		// sends the scripted key events for the current frame
+		void PlayInputScript();
+
+		// keys that control the session itself, like pausing
+		void ProcessSessionKeys();
 
 		// process input from GLFW for camera cheats I set up during GLFW tutorials
 		void ProcessDevCheats(GLFWwindow* window, double dt);
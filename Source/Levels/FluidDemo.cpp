@@ -0,0 +1,94 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file FluidDemo.cpp
+  * \author Joe Goldman
+  * \brief FluidDemo class definition
+  *
+  **/
+
+#include <Levels/FluidDemo.hpp>
+#include <Core/GameSession.hpp>
+#include <Core/Entity.hpp>
+#include <Constructs/SingleShape.hpp>
+#include <Input/Controller.hpp>
+
+namespace GenevaEngine
+{
+	/*!
+	 *  Creates a static box in the tank's color
+	 *
+	 *      \param [in] gs
+	 *      \param [in] center
+	 *      \param [in] halfWidth
+	 *      \param [in] halfHeight
+	 */
+	static void CreateWall(GameSession& gs, const b2Vec2& center, float halfWidth, float halfHeight)
+	{
+		SingleShape* wall = gs.GetConstructRegistry()->Create<SingleShape>(gs.GetPhysics()->GetWorld());
+		wall->BodyDef.position = center;
+		wall->BodyDef.type = b2_staticBody;
+		wall->FixtureDef.density = 0.0f;
+		wall->Shape.SetAsBox(halfWidth, halfHeight);
+		Entity* wall_entity = gs.Spawn("wall");
+		wall_entity->AddConstruct(wall);
+		wall_entity->SetRenderColor(2);
+	}
+
+	void FluidDemo::Load(GameSession& gs)
+	{
+		// get world from physics system
+		b2World* world = gs.GetPhysics()->GetWorld();
+
+		// create the tank
+		CreateWall(gs, b2Vec2(0.0f, -10.0f), 62.0f, 10.0f);
+		CreateWall(gs, b2Vec2(-61.0f, 20.0f), 1.0f, 20.0f);
+		CreateWall(gs, b2Vec2(61.0f, 20.0f), 1.0f, 20.0f);
+
+		// create a dam of water on the left of the tank, it breaks when the level starts
+		ParticleFluid& fluid = gs.GetPhysics()->GetFluid();
+		b2AABB dam;
+		dam.lowerBound.Set(-60.0f, 0.0f);
+		dam.upperBound.Set(-20.0f, 25.0f);
+		fluid.CreateBox(dam);
+
+		// create construct
+		SingleShape* hero = gs.GetConstructRegistry()->Create<SingleShape>(world);
+		hero->BodyDef.position.Set(30.0f, 3.0f);
+		hero->BodyDef.type = b2_dynamicBody;
+		hero->BodyDef.linearDamping = 0.1f;
+		hero->FixtureDef.density = 1.0f;
+		hero->FixtureDef.friction = 3.0f;
+		hero->Shape.SetAsBox(3.0f, 3.0f);
+		hero->EnableBehavior();
+		// create entity
+		Entity* hero_entity = gs.Spawn("hero");
+		hero_entity->AddConstruct(hero);
+		hero_entity->SetRenderColor(5);
+		gs.GetInput()->GetPlayerController()->Possess(hero_entity);
+
+		// create light boxes that fall onto the dam and float on the wave
+		for (size_t i = 0; i < 4; i++)
+		{
+			// create  construct
+			SingleShape* box = gs.GetConstructRegistry()->Create<SingleShape>(world);
+			box->BodyDef.position.Set(-52.0f + i * 8.0f, 30.0f);
+			box->BodyDef.type = b2_dynamicBody;
+			box->FixtureDef.density = 0.3f;
+			box->FixtureDef.friction = 0.3f;
+			box->Shape.SetAsBox(2.0f, 2.0f);
+			// create entity
+			Entity* box_entity = gs.Spawn("box");
+			box_entity->AddConstruct(box);
+			box_entity->SetRenderColor(3);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+/**
+ * \file FluidDemo.hpp
+ * \author Joe Goldman
+ * \brief FluidDemo level declaration
+ *
+ */
+
+#pragma once
+
+#include <Levels/Level.hpp>
+
+namespace GenevaEngine
+{
+	class GameSession;
+
+	class FluidDemo : public Level
+	{
+	public:
+		static void Load(GameSession& gs);
+	};
+}
\ No newline at end of file
@@ -29,18 +29,18 @@ namespace GenevaEngine
 		b2World* world = gs.GetPhysics()->GetWorld();
 
 		// create construct
-		SingleShape* ground = new SingleShape(world);
+		SingleShape* ground = gs.GetConstructRegistry()->Create<SingleShape>(world);
 		ground->BodyDef.position.Set(0.0f, -10.0f);
 		ground->BodyDef.type = b2_staticBody;
 		ground->FixtureDef.density = 0.0f;
 		ground->Shape.SetAsBox(50.0f, 10.0f);
 		// create entity
-		Entity* ground_entity = new Entity(&gs, "box");
+		Entity* ground_entity = gs.Spawn("box");
 		ground_entity->AddConstruct(ground);
 		ground_entity->SetRenderColor(2);
 
 		// create construct
-		SingleShape* hero = new SingleShape(world);
+		SingleShape* hero = gs.GetConstructRegistry()->Create<SingleShape>(world);
 		hero->BodyDef.position.Set(5.0f, 5.0f);
 		hero->BodyDef.type = b2_dynamicBody;
 		hero->BodyDef.linearDamping = 0.1f;
@@ -49,7 +49,7 @@ namespace GenevaEngine
 		hero->Shape.SetAsBox(3.0f, 3.0f);
 		hero->EnableBehavior();
 		// create entity
-		Entity* hero_entity = new Entity(&gs, "hero");
+		Entity* hero_entity = gs.Spawn("hero");
 		hero_entity->AddConstruct(hero);
 		hero_entity->SetRenderColor(5);
 		gs.GetInput()->GetPlayerController()->Possess(hero_entity);
@@ -58,14 +58,14 @@ namespace GenevaEngine
 		for (size_t i = 0; i < 50; i++)
 		{
 			// create  construct
-			SingleShape* box = new SingleShape(world);
+			SingleShape* box = gs.GetConstructRegistry()->Create<SingleShape>(world);
 			box->BodyDef.position.Set(0, i * 5.0f);
 			box->BodyDef.type = b2_dynamicBody;
 			box->FixtureDef.density = 0.01f;
 			box->FixtureDef.friction = 0.3f;
 			box->Shape.SetAsBox(1.0f, 1.0f);
 			// create entity
-			Entity* box_entity = new Entity(&gs, "box");
+			Entity* box_entity = gs.Spawn("box");
 			box_entity->AddConstruct(box);
 			box_entity->SetRenderColor(3);
 		}
@@ -19,4 +19,5 @@
 
 #include <Levels/WebDemo.hpp>
 #include <Levels/HardBoxBehaviorDemo.hpp>
-#include <Levels/SoftBoxDemo.hpp>
\ No newline at end of file
+#include <Levels/SoftBoxDemo.hpp>
+#include <Levels/FluidDemo.hpp>
\ No newline at end of file
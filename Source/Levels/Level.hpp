@@ -26,11 +26,13 @@ namespace GenevaEngine
 	 *			Currently, levels are a simple series of class
 	 *			instantiations called inside GameSession::Start()
 	 *
+	 *			Each level declares a static Load(GameSession& gs), so it can be
+	 *			handed to SessionSettings::LoadLevel. (A static Load can't override
+	 *			a virtual one, which gcc and clang reject.)
+	 *
 	 *			The future plan is to instantiate levels from a JSON file.
 	 */
 	class Level
 	{
-	public:
-		virtual void Load(GameSession& gs) = 0;
 	};
 }
\ No newline at end of file
@@ -30,21 +30,21 @@ namespace GenevaEngine
 		b2World* world = gs.GetPhysics()->GetWorld();
 
 		// create construct
-		SingleShape* ground = new SingleShape(world);
+		SingleShape* ground = gs.GetConstructRegistry()->Create<SingleShape>(world);
 		ground->BodyDef.position.Set(0.0f, -10.0f);
 		ground->BodyDef.type = b2_staticBody;
 		ground->FixtureDef.density = 0.0f;
 		ground->Shape.SetAsBox(50.0f, 10.0f);
 		// create entity
-		Entity* ground_entity = new Entity(&gs, "box");
+		Entity* ground_entity = gs.Spawn("box");
 		ground_entity->AddConstruct(ground);
 		ground_entity->SetRenderColor(2);
 
 		// create construct
-		SoftBox* softbox = new SoftBox(world);
+		SoftBox* softbox = gs.GetConstructRegistry()->Create<SoftBox>(world);
 		softbox->EnableBehavior();
 		// create entity
-		Entity* softbox_entity = new Entity(&gs, "softbox");
+		Entity* softbox_entity = gs.Spawn("softbox");
 		softbox_entity->AddConstruct(softbox);
 		softbox_entity->SetRenderColor(3);
 		gs.GetInput()->GetPlayerController()->Possess(softbox_entity);
@@ -28,8 +28,8 @@ namespace GenevaEngine
 		b2World* world = gs.GetPhysics()->GetWorld();
 
 		// create entity
-		Entity* web_entity = new Entity(&gs, "web");
-		web_entity->AddConstruct(new Web(world));
+		Entity* web_entity = gs.Spawn("web");
+		web_entity->AddConstruct(gs.GetConstructRegistry()->Create<Web>(world));
 		web_entity->SetRenderColor(5);
 	}
 }
\ No newline at end of file
@@ -20,4 +20,5 @@
   // Disable warning messages from box2d: C26812 C26495
 #pragma warning( disable : 26812 26495)
 
-#include <box2d/box2d.h> // box2d
\ No newline at end of file
+#include <box2d/box2d.h> // box2d
+#include <box2d/b2_rope.h> // b2Rope, stepped by the constructs that own them
\ No newline at end of file
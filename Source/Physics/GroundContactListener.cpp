@@ -0,0 +1,149 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file GroundContactListener.cpp
+  * \author Joe Goldman
+  * \brief GroundContactListener class definition
+  *
+  **/
+
+#include <Physics/GroundContactListener.hpp>
+#include <Constructs/Construct.hpp>
+
+namespace GenevaEngine
+{
+	/*!
+	 *  Returns the construct that made a body, nullptr if it wasn't made by one
+	 */
+	static Construct* GetConstruct(b2Fixture* fixture)
+	{
+		return reinterpret_cast<Construct*>(fixture->GetBody()->GetUserData().pointer);
+	}
+
+	/*!
+	 *  Starts tracking a contact that began touching
+	 *
+	 *      \param [in] contact
+	 */
+	void GroundContactListener::BeginContact(b2Contact* contact)
+	{
+		Classify(contact, m_contacts[contact]);
+	}
+
+	/*!
+	 *  Stops counting a contact that stopped touching, or is being destroyed
+	 *
+	 *      \param [in] contact
+	 */
+	void GroundContactListener::EndContact(b2Contact* contact)
+	{
+		const auto found = m_contacts.find(contact);
+		if (found == m_contacts.end())
+			return;
+
+		SetGround(found->second.A, nullptr, b2Vec2_zero);
+		SetGround(found->second.B, nullptr, b2Vec2_zero);
+		m_contacts.erase(found);
+	}
+
+	/*!
+	 *  Classifies a touching contact again, its normal turns as the bodies slide
+	 *
+	 *      \param [in] contact
+	 *      \param [in] oldManifold
+	 */
+	void GroundContactListener::PreSolve(b2Contact* contact, const b2Manifold* /*oldManifold*/)
+	{
+		const auto found = m_contacts.find(contact);
+		if (found != m_contacts.end())
+			Classify(contact, found->second);
+	}
+
+	/*!
+	 *  Stops counting contacts for a construct that's about to be freed. Its bodies are
+	 *  destroyed after it's gone, and their contacts end then. The other side of those
+	 *  contacts is still counted until they do.
+	 *
+	 *      \param [in] construct
+	 */
+	void GroundContactListener::Forget(Construct* construct)
+	{
+		if (construct->m_groundContacts == 0)
+			return;
+
+		for (auto& entry : m_contacts)
+		{
+			if (entry.second.A == construct)
+				entry.second.A = nullptr;
+			if (entry.second.B == construct)
+				entry.second.B = nullptr;
+		}
+
+		construct->m_groundContacts = 0;
+	}
+
+	/*!
+	 *  Works out which of a contact's constructs it is ground for, and counts it for
+	 *  them. The world manifold's normal points from fixture A to fixture B.
+	 *
+	 *      \param [in] contact
+	 *      \param [in,out] ground	the constructs it was ground for until now
+	 */
+	void GroundContactListener::Classify(b2Contact* contact, GroundContact& ground)
+	{
+		b2Fixture* fixtureA = contact->GetFixtureA();
+		b2Fixture* fixtureB = contact->GetFixtureB();
+		Construct* constructA = GetConstruct(fixtureA);
+		Construct* constructB = GetConstruct(fixtureB);
+		if (fixtureA->IsSensor() || fixtureB->IsSensor() || constructA == constructB)
+		{
+			SetGround(ground.A, nullptr, b2Vec2_zero);
+			SetGround(ground.B, nullptr, b2Vec2_zero);
+			return;
+		}
+
+		// up is against gravity
+		b2Vec2 up = -fixtureA->GetBody()->GetWorld()->GetGravity();
+		if (up.Normalize() < b2_epsilon)
+			up.Set(0.0f, 1.0f);
+
+		b2WorldManifold manifold;
+		contact->GetWorldManifold(&manifold);
+		const b2Vec2 normal = manifold.normal;
+
+		SetGround(ground.A, b2Dot(-normal, up) >= k_minGroundNormal ? constructA : nullptr, -normal);
+		SetGround(ground.B, b2Dot(normal, up) >= k_minGroundNormal ? constructB : nullptr, normal);
+	}
+
+	/*!
+	 *  Moves one side of a contact's ground count from the construct it was counted
+	 *  for to another
+	 *
+	 *      \param [in,out] side	the construct it was counted for, nullptr for none
+	 *      \param [in] construct	the construct to count it for, nullptr for none
+	 *      \param [in] normal		the ground normal, pointing toward the construct
+	 */
+	void GroundContactListener::SetGround(Construct*& side, Construct* construct, const b2Vec2& normal)
+	{
+		if (side != construct)
+		{
+			if (side != nullptr)
+				side->m_groundContacts--;
+			if (construct != nullptr)
+				construct->m_groundContacts++;
+			side = construct;
+		}
+
+		if (construct != nullptr)
+			construct->m_groundNormal = normal;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file GroundContactListener.hpp
+  * \author Joe Goldman
+  * \brief GroundContactListener class declaration
+  *
+  */
+
+#pragma once
+
+#include <Physics/Box2d.hpp>
+
+#include <unordered_map> // unordered_map
+
+namespace GenevaEngine
+{
+	class Construct;
+
+	/*!
+	 *  \brief	Counts the contacts each construct stands on, as they begin, change and
+	 *			end. A contact is ground for a construct when its normal, pointing away
+	 *			from the other fixture, is within about 45 degrees of straight up.
+	 *			Contacts between a construct's own bodies, and sensors, aren't ground.
+	 */
+	class GroundContactListener : public b2ContactListener
+	{
+	public:
+		void BeginContact(b2Contact* contact) override;
+		void EndContact(b2Contact* contact) override;
+		void PreSolve(b2Contact* contact, const b2Manifold* oldManifold) override;
+
+		// stops counting contacts for a construct before it's freed
+		void Forget(Construct* construct);
+
+	private:
+		// the constructs a touching contact is ground for, nullptr on the sides it isn't
+		struct GroundContact
+		{
+			Construct* A = nullptr;
+			Construct* B = nullptr;
+		};
+
+		// smallest dot product of a ground normal with up
+		static constexpr float k_minGroundNormal = 0.7f;
+
+		std::unordered_map<const b2Contact*, GroundContact> m_contacts;
+
+		void Classify(b2Contact* contact, GroundContact& ground);
+		void SetGround(Construct*& side, Construct* construct, const b2Vec2& normal);
+	};
+}
\ No newline at end of file
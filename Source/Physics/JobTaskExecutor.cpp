@@ -0,0 +1,52 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file JobTaskExecutor.cpp
+  * \author Joe Goldman
+  * \brief JobTaskExecutor class definition
+  *
+  **/
+
+#include <Physics/JobTaskExecutor.hpp>
+#include <Core/JobSystem.hpp>
+
+namespace GenevaEngine
+{
+	/*!
+	 *  Constructor
+	 *
+	 *      \param [in] jobSystem	must outlive the executor
+	 */
+	JobTaskExecutor::JobTaskExecutor(JobSystem* jobSystem) : m_jobSystem(jobSystem)
+	{
+	}
+
+	int32 JobTaskExecutor::GetThreadCount() const
+	{
+		return m_jobSystem->GetThreadCount();
+	}
+
+	/*!
+	 *  Runs the task over [0, count) across the job system's threads, blocks until
+	 *  it's done
+	 *
+	 *      \param [in] count
+	 *      \param [in] minRange	fewest items in a range
+	 *      \param [in] task
+	 */
+	void JobTaskExecutor::ParallelFor(int32 count, int32 minRange, b2Task* task)
+	{
+		m_jobSystem->ParallelFor(count, minRange, [task](int begin, int end, int threadIndex)
+			{
+				task->Execute(begin, end, threadIndex);
+			});
+	}
+}
\ No newline at end of file
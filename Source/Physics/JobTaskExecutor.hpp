@@ -0,0 +1,41 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+ /**
+  * \file JobTaskExecutor.hpp
+  * \author Joe Goldman
+  * \brief JobTaskExecutor class declaration. Runs box2d's parallel work on the job system.
+  *
+  */
+
+#pragma once
+
+#include <Physics/Box2d.hpp>
+
+namespace GenevaEngine
+{
+	class JobSystem;
+
+	/*!
+	 *  \brief Hands the ranges box2d wants run in parallel to the session's job system.
+	 *         Thread indices are the job system's, so box2d can keep per thread state.
+	 */
+	class JobTaskExecutor : public b2TaskExecutor
+	{
+	public:
+		JobTaskExecutor(JobSystem* jobSystem);
+
+		int32 GetThreadCount() const override;
+		void ParallelFor(int32 count, int32 minRange, b2Task* task) override;
+
+	private:
+		JobSystem* m_jobSystem;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,1052 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file ParticleFluid.cpp
+  * \author Joe Goldman
+  * \brief ParticleFluid class definition
+  *
+  **/
+
+#include <Physics/ParticleFluid.hpp>
+#include <Core/JobSystem.hpp>
+#include <box2d/b2_simd.h> // b2FloatW, shared with the box2d solvers
+
+#include <algorithm> // sort, stable_partition
+#include <cmath> // floorf, sqrtf
+#include <cstring> // memset
+#include <utility> // swap
+
+namespace GenevaEngine
+{
+	static const int k_lanes = b2_simdLanes;
+
+	// a particle's neighbors are within this many Spacings of it, it's also the cell size
+	static const float k_reachScale = 2.0f;
+	// artificial pressure is measured against neighbors this far apart, as a part of reach
+	static const float k_pressureDistance = 0.2f;
+	// most a particle moves in one solve, as a part of Spacing, so deep columns don't blow up
+	static const float k_maxCorrection = 0.2f;
+	// neighbors closer than this push along no direction
+	static const float k_minDistanceSquared = 1.0e-12f;
+	// padding particles are this far away, too far to be anyone's neighbor
+	static const float k_farAway = 1.0e18f;
+	// bits of the cell keys sorted by each radix pass
+	static const int k_radixBits = 11;
+
+	// loaded at k_lanes - n, the first n lanes are 1 and the rest 0
+	static const float k_laneMask[2 * k_lanes] = {
+		1, 1, 1, 1,
+#if b2_simdLanes == 8
+		1, 1, 1, 1, 0, 0, 0, 0,
+#endif
+		0, 0, 0, 0 };
+
+	static inline float SumW(b2FloatW a)
+	{
+		float lanes[k_lanes];
+		b2StoreW(lanes, a);
+		float sum = 0.0f;
+		for (int i = 0; i < k_lanes; i++)
+			sum += lanes[i];
+		return sum;
+	}
+
+	static inline uint32 HashCell(int32 x, int32 y)
+	{
+		return ((uint32)x * 73856093u) ^ ((uint32)y * 19349663u);
+	}
+
+	/*!
+	 *  The default contact filter, between the particles and a fixture
+	 */
+	static bool ShouldCollide(const b2Filter& filterA, const b2Filter& filterB)
+	{
+		if (filterA.groupIndex == filterB.groupIndex && filterA.groupIndex != 0)
+			return filterA.groupIndex > 0;
+
+		return (filterA.maskBits & filterB.categoryBits) != 0
+			&& (filterA.categoryBits & filterB.maskBits) != 0;
+	}
+
+	ParticleFluid::ParticleFluid()
+	{
+		Bounds.lowerBound.Set(-1000.0f, -1000.0f);
+		Bounds.upperBound.Set(1000.0f, 1000.0f);
+		Pad();
+	}
+
+	/*!
+	 *  Reserves every particle array for count particles, so creating up to that many
+	 *  doesn't allocate
+	 *
+	 *      \param [in] count
+	 */
+	void ParticleFluid::Reserve(int count)
+	{
+		const size_t size = (size_t)count + k_lanes;
+		for (std::vector<float>* values : { &m_x, &m_y, &m_vx, &m_vy, &m_px, &m_py, &m_lambda,
+			&m_density, &m_dx, &m_dy, &m_scratch })
+			values->reserve(size);
+		m_keys.reserve(size);
+		m_order.reserve(size);
+		m_sortKeys.reserve(size);
+		m_sortOrder.reserve(size);
+	}
+
+	void ParticleFluid::CreateParticle(const b2Vec2& position, const b2Vec2& velocity)
+	{
+		const int i = m_count++;
+		Pad();
+		m_x[i] = m_px[i] = position.x;
+		m_y[i] = m_py[i] = position.y;
+		m_vx[i] = velocity.x;
+		m_vy[i] = velocity.y;
+	}
+
+	/*!
+	 *  Fills a box with particles, Spacing apart
+	 *
+	 *      \param [in] box
+	 *      \param [in] velocity	of every particle
+	 *
+	 *      \return How many particles were created.
+	 */
+	int ParticleFluid::CreateBox(const b2AABB& box, const b2Vec2& velocity)
+	{
+		const b2Vec2 size = box.upperBound - box.lowerBound;
+		const int columns = b2Max(0, (int)(size.x / Spacing));
+		const int rows = b2Max(0, (int)(size.y / Spacing));
+		Reserve(m_count + columns * rows);
+
+		const b2Vec2 corner = box.lowerBound + b2Vec2(0.5f * Spacing, 0.5f * Spacing);
+		for (int row = 0; row < rows; row++)
+		{
+			for (int column = 0; column < columns; column++)
+				CreateParticle(corner + Spacing * b2Vec2((float)column, (float)row), velocity);
+		}
+		return columns * rows;
+	}
+
+	void ParticleFluid::Clear()
+	{
+		m_count = 0;
+		Pad();
+	}
+
+	int ParticleFluid::GetParticleCount() const
+	{
+		return m_count;
+	}
+
+	const float* ParticleFluid::GetPositionX() const
+	{
+		return m_x.data();
+	}
+
+	const float* ParticleFluid::GetPositionY() const
+	{
+		return m_y.data();
+	}
+
+	/*!
+	 *  Sizes every particle array to the particles and a full set of lanes after them.
+	 *  The padding is far from everything, so the kernels read it as no neighbor.
+	 */
+	void ParticleFluid::Pad()
+	{
+		const size_t size = (size_t)m_count + k_lanes;
+		for (std::vector<float>* values : { &m_x, &m_y, &m_vx, &m_vy, &m_px, &m_py, &m_lambda,
+			&m_density, &m_dx, &m_dy, &m_scratch })
+			values->resize(size);
+
+		for (int i = m_count; i < (int)size; i++)
+		{
+			m_x[i] = m_y[i] = m_px[i] = m_py[i] = k_farAway;
+			m_vx[i] = m_vy[i] = m_lambda[i] = m_dx[i] = m_dy[i] = 0.0f;
+			m_density[i] = 1.0f;
+		}
+	}
+
+	/*!
+	 *  Works out the kernel's reach, and the density and density gradient of a particle
+	 *  in a square of particles Spacing apart. That's rest density.
+	 */
+	void ParticleFluid::UpdateKernel()
+	{
+		m_reach = k_reachScale * Spacing;
+		const float reach2 = m_reach * m_reach;
+		const int span = (int)k_reachScale + 1;
+
+		m_restSum = 0.0f;
+		float gradient = 0.0f;
+		for (int row = -span; row <= span; row++)
+		{
+			for (int column = -span; column <= span; column++)
+			{
+				const float r2 = Spacing * Spacing * (float)(row * row + column * column);
+				if (r2 >= reach2)
+					continue;
+
+				const float q = reach2 - r2;
+				const float s = m_reach - sqrtf(r2);
+				m_restSum += q * q * q;
+				gradient += s * s * s * s;
+			}
+		}
+
+		// the spiky gradient, scaled to the density kernel's rest density
+		m_gradientScale = 7.5f * reach2 * m_reach / m_restSum;
+		m_restGradient = m_gradientScale * m_gradientScale * gradient;
+	}
+
+	/*!
+	 *  Runs a job over [0, count) on the job system, or on this thread if there isn't one
+	 */
+	void ParticleFluid::ForEach(int count, int minBatch,
+		const std::function<void(int, int, int)>& job)
+	{
+		if (m_jobSystem != nullptr)
+			m_jobSystem->ParallelFor(count, minBatch, job);
+		else if (count > 0)
+			job(0, count, 0);
+	}
+
+	/*!
+	 *  Steps the particles over the world's step, in SubSteps. Each particle step moves
+	 *  the particles, sorts them into the grid, then solves their density Iterations
+	 *  times, pushing them out of the fixtures after each solve. The velocity it took
+	 *  is smoothed by the neighbors' for viscosity. The bodies have already stepped, so
+	 *  each particle step meets them where they were partway through. Dynamic bodies get
+	 *  the impulses the particles pushed them by at the end, so the world sees them on
+	 *  its next step.
+	 *
+	 *      \param [in,out] world
+	 *      \param [in]     dt			the world's time-step
+	 *      \param [in]     jobSystem	spreads the cells across its threads, can be null
+	 */
+	void ParticleFluid::Step(b2World& world, float dt, JobSystem* jobSystem)
+	{
+		if (m_count == 0 || dt <= 0.0f || SubSteps <= 0)
+			return;
+
+		m_jobSystem = jobSystem;
+		m_threadCount = jobSystem != nullptr ? jobSystem->GetThreadCount() : 1;
+		UpdateKernel();
+
+		FindFixtures(world, dt);
+		m_impulses.assign(m_threadCount * m_fixtures.size(), Impulse{ b2Vec2(0.0f, 0.0f), 0.0f });
+
+		const float h = dt / SubSteps;
+		const b2Vec2 gravity = world.GetGravity();
+		for (int subStep = 0; subStep < SubSteps; subStep++)
+		{
+			MoveFixtures(dt - subStep * h, dt - (subStep + 1) * h);
+			Predict(h, gravity);
+			BuildGrid();
+			FindContacts();
+
+			// the particles are pushed out of the fixtures after each solve, so there's one
+			const int cellCount = (int)m_cells.size();
+			const int iterations = b2Max(Iterations, 1);
+			for (int iteration = 0; iteration < iterations; iteration++)
+			{
+				const bool last = iteration == iterations - 1;
+				ForEach(cellCount, 64, [this](int begin, int end, int /*threadIndex*/)
+				{
+					SolveDensity(begin, end);
+				});
+				ForEach(cellCount, 64, [this](int begin, int end, int /*threadIndex*/)
+				{
+					SolvePositions(begin, end);
+				});
+				ForEach(cellCount, 64, [this, h, last](int begin, int end, int threadIndex)
+				{
+					Correct(begin, end, h, last ? threadIndex : -1);
+				});
+			}
+
+			UpdateVelocities(h);
+			ForEach(cellCount, 64, [this](int begin, int end, int /*threadIndex*/)
+			{
+				ApplyViscosity(begin, end);
+			});
+			std::swap(m_vx, m_dx);
+			std::swap(m_vy, m_dy);
+		}
+
+		ApplyImpulses();
+		DestroyOutside();
+		m_jobSystem = nullptr;
+	}
+
+	/*!
+	 *  Finds the fixtures the particles can reach this step, with one query of the
+	 *  world around all of them. A chain's edges are kept one by one, and only those
+	 *  near the particles.
+	 *
+	 *      \param [in] world
+	 *      \param [in] dt
+	 */
+	void ParticleFluid::FindFixtures(b2World& world, float dt)
+	{
+		b2Vec2 lower(b2_maxFloat, b2_maxFloat);
+		b2Vec2 upper(-b2_maxFloat, -b2_maxFloat);
+		float speed2 = 0.0f;
+		for (int i = 0; i < m_count; i++)
+		{
+			lower = b2Min(lower, b2Vec2(m_x[i], m_y[i]));
+			upper = b2Max(upper, b2Vec2(m_x[i], m_y[i]));
+			speed2 = b2Max(speed2, m_vx[i] * m_vx[i] + m_vy[i] * m_vy[i]);
+		}
+
+		const float reach = (sqrtf(speed2) + world.GetGravity().Length() * dt) * dt + Spacing;
+		m_queryBounds.lowerBound = b2Max(lower - b2Vec2(reach, reach), Bounds.lowerBound);
+		m_queryBounds.upperBound = b2Min(upper + b2Vec2(reach, reach), Bounds.upperBound);
+
+		m_queried.clear();
+		m_fixtures.clear();
+		if (m_queryBounds.IsValid())
+			world.QueryAABB(this, m_queryBounds);
+
+		// the query reports a fixture once for each of its children it overlaps
+		std::sort(m_queried.begin(), m_queried.end());
+		m_queried.erase(std::unique(m_queried.begin(), m_queried.end()), m_queried.end());
+		// bodies the particles can't push go last, so a box can't squeeze particles through a wall
+		std::stable_partition(m_queried.begin(), m_queried.end(), [](b2Fixture* fixture)
+		{
+			return fixture->GetBody()->GetType() == b2_dynamicBody;
+		});
+
+		m_pushReach = 0.0f;
+		for (b2Fixture* fixture : m_queried)
+		{
+			const b2Body* body = fixture->GetBody();
+			if (body->GetType() == b2_staticBody)
+				continue;
+
+			const b2AABB& aabb = fixture->GetAABB(0);
+			const b2Vec2 arm = b2Max(aabb.upperBound - body->GetWorldCenter(),
+				body->GetWorldCenter() - aabb.lowerBound);
+			const float speed = body->GetLinearVelocity().Length() +
+				b2Abs(body->GetAngularVelocity()) * arm.Length();
+			m_pushReach = b2Max(m_pushReach, speed * dt);
+		}
+
+		for (b2Fixture* fixture : m_queried)
+		{
+			// where the body is now, until MoveFixtures winds it back
+			const b2Transform& transform = fixture->GetBody()->GetTransform();
+			const int32 childCount = fixture->GetShape()->GetChildCount();
+			for (int32 child = 0; child < childCount; child++)
+			{
+				if (childCount == 1 || b2TestOverlap(fixture->GetAABB(child), m_queryBounds))
+					m_fixtures.push_back(FluidFixture{ fixture, child, transform, transform });
+			}
+		}
+	}
+
+	/*!
+	 *  Moves the fixtures back to where their bodies were during a particle step.
+	 *  The world has already stepped the bodies, so they're wound back along their
+	 *  velocities, and the particles meet a body that moves a little each particle
+	 *  step instead of one that jumped the whole world step at once.
+	 *
+	 *      \param [in] before	time from the start of the particle step to the end of the world step
+	 *      \param [in] after	time from the end of the particle step to the end of the world step
+	 */
+	void ParticleFluid::MoveFixtures(float before, float after)
+	{
+		for (FluidFixture& fixture : m_fixtures)
+		{
+			const b2Body* body = fixture.Fixture->GetBody();
+			const b2Vec2& center = body->GetWorldCenter();
+			const b2Vec2& velocity = body->GetLinearVelocity();
+			const float angle = body->GetAngle();
+			const float spin = body->GetAngularVelocity();
+
+			fixture.Previous.q.Set(angle - before * spin);
+			fixture.Previous.p = center - before * velocity - b2Mul(fixture.Previous.q, body->GetLocalCenter());
+			fixture.Transform.q.Set(angle - after * spin);
+			fixture.Transform.p = center - after * velocity - b2Mul(fixture.Transform.q, body->GetLocalCenter());
+		}
+	}
+
+	bool ParticleFluid::ReportFixture(b2Fixture* fixture)
+	{
+		if (!fixture->IsSensor() && ShouldCollide(Filter, fixture->GetFilterData()))
+			m_queried.push_back(fixture);
+		return true;
+	}
+
+	/*!
+	 *  Moves every particle by its velocity, with gravity, to where the density solve
+	 *  starts from
+	 *
+	 *      \param [in] h		the particle step
+	 *      \param [in] gravity
+	 */
+	void ParticleFluid::Predict(float h, const b2Vec2& gravity)
+	{
+		ForEach(m_count, 1024, [this, h, gravity](int begin, int end, int /*threadIndex*/)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				m_vx[i] += h * gravity.x;
+				m_vy[i] += h * gravity.y;
+				m_px[i] = m_x[i] + h * m_vx[i];
+				m_py[i] = m_y[i] + h * m_vy[i];
+			}
+		});
+	}
+
+	/*!
+	 *  Sorts the particles by the cell they're predicted in, row by row, then makes a
+	 *  cell for each run of particles with the same key, and hashes them into the
+	 *  table. Each cell keeps the runs of particles in the three cells of the rows
+	 *  below, at, and above it, which hold all of its particles' neighbors. Positions
+	 *  are clamped to Bounds, so the keys fit however far a particle flies.
+	 */
+	void ParticleFluid::BuildGrid()
+	{
+		const float inverseReach = 1.0f / m_reach;
+		b2Vec2 lower(b2_maxFloat, b2_maxFloat);
+		b2Vec2 upper(-b2_maxFloat, -b2_maxFloat);
+		for (int i = 0; i < m_count; i++)
+		{
+			const b2Vec2 p(b2Clamp(m_px[i], Bounds.lowerBound.x, Bounds.upperBound.x),
+				b2Clamp(m_py[i], Bounds.lowerBound.y, Bounds.upperBound.y));
+			lower = b2Min(lower, p);
+			upper = b2Max(upper, p);
+		}
+
+		m_lowerX = (int32)floorf(lower.x * inverseReach);
+		m_lowerY = (int32)floorf(lower.y * inverseReach);
+		const int32 upperX = (int32)floorf(upper.x * inverseReach);
+		const int32 upperY = (int32)floorf(upper.y * inverseReach);
+		m_width = upperX - m_lowerX + 1;
+		b2Assert((double)m_width * (upperY - m_lowerY + 1) < 4294967296.0);
+
+		m_keys.resize(m_count);
+		m_order.resize(m_count);
+		ForEach(m_count, 1024, [this, inverseReach](int begin, int end, int /*threadIndex*/)
+		{
+			const b2AABB& bounds = Bounds;
+			for (int i = begin; i < end; i++)
+			{
+				const int32 x = (int32)floorf(b2Clamp(m_px[i], bounds.lowerBound.x,
+					bounds.upperBound.x) * inverseReach) - m_lowerX;
+				const int32 y = (int32)floorf(b2Clamp(m_py[i], bounds.lowerBound.y,
+					bounds.upperBound.y) * inverseReach) - m_lowerY;
+				m_keys[i] = (uint32)y * (uint32)m_width + (uint32)x;
+				m_order[i] = i;
+			}
+		});
+
+		SortParticles();
+
+		m_cells.clear();
+		for (int i = 0; i < m_count; i++)
+		{
+			if (i > 0 && m_keys[i] == m_keys[i - 1])
+				continue;
+
+			if (!m_cells.empty())
+				m_cells.back().End = i;
+
+			Cell cell;
+			cell.X = (int32)(m_keys[i] % (uint32)m_width) + m_lowerX;
+			cell.Y = (int32)(m_keys[i] / (uint32)m_width) + m_lowerY;
+			cell.Begin = i;
+			cell.End = m_count;
+			m_cells.push_back(cell);
+		}
+
+		size_t tableSize = 64;
+		while (tableSize < 2 * m_cells.size())
+			tableSize *= 2;
+		m_table.assign(tableSize, -1);
+		const uint32 mask = (uint32)tableSize - 1;
+		for (int32 index = 0; index < (int32)m_cells.size(); index++)
+		{
+			uint32 i = HashCell(m_cells[index].X, m_cells[index].Y) & mask;
+			while (m_table[i] != -1)
+				i = (i + 1) & mask;
+			m_table[i] = index;
+		}
+
+		ForEach((int)m_cells.size(), 256, [this](int begin, int end, int /*threadIndex*/)
+		{
+			for (int index = begin; index < end; index++)
+			{
+				Cell& cell = m_cells[index];
+				for (int row = 0; row < 3; row++)
+				{
+					// the cells of a row are next to each other in the sort
+					cell.RowBegin[row] = cell.RowEnd[row] = 0;
+					bool found = false;
+					for (int32 x = cell.X - 1; x <= cell.X + 1; x++)
+					{
+						const int32 other = FindCell(x, cell.Y + row - 1);
+						if (other < 0)
+							continue;
+
+						if (!found)
+							cell.RowBegin[row] = m_cells[other].Begin;
+						cell.RowEnd[row] = m_cells[other].End;
+						found = true;
+					}
+				}
+			}
+		});
+	}
+
+	/*!
+	 *  Sorts the particles by their keys, with a radix sort of as many passes as the
+	 *  keys have bits, then moves every particle array into the sorted order
+	 */
+	void ParticleFluid::SortParticles()
+	{
+		uint32 largest = 0;
+		for (int i = 0; i < m_count; i++)
+			largest = b2Max(largest, m_keys[i]);
+
+		m_sortKeys.resize(m_count);
+		m_sortOrder.resize(m_count);
+		const uint32 radix = 1u << k_radixBits;
+		int32 offsets[1 << k_radixBits];
+		for (int shift = 0; shift == 0 || (shift < 32 && (largest >> shift) != 0);
+			shift += k_radixBits)
+		{
+			memset(offsets, 0, sizeof(offsets));
+			for (int i = 0; i < m_count; i++)
+				offsets[(m_keys[i] >> shift) & (radix - 1)]++;
+
+			int32 total = 0;
+			for (uint32 digit = 0; digit < radix; digit++)
+			{
+				const int32 count = offsets[digit];
+				offsets[digit] = total;
+				total += count;
+			}
+
+			for (int i = 0; i < m_count; i++)
+			{
+				const int32 to = offsets[(m_keys[i] >> shift) & (radix - 1)]++;
+				m_sortKeys[to] = m_keys[i];
+				m_sortOrder[to] = m_order[i];
+			}
+			std::swap(m_keys, m_sortKeys);
+			std::swap(m_order, m_sortOrder);
+		}
+
+		for (std::vector<float>* values : { &m_x, &m_y, &m_vx, &m_vy, &m_px, &m_py })
+		{
+			ForEach(m_count, 4096, [this, values](int begin, int end, int /*threadIndex*/)
+			{
+				const float* from = values->data();
+				for (int i = begin; i < end; i++)
+					m_scratch[i] = from[m_order[i]];
+			});
+			std::swap(*values, m_scratch);
+		}
+		Pad();
+	}
+
+	/*!
+	 *  Looks a cell up in the table
+	 *
+	 *      \return The cell's index, or -1 if no particle is in it.
+	 */
+	int32 ParticleFluid::FindCell(int32 x, int32 y) const
+	{
+		const uint32 mask = (uint32)m_table.size() - 1;
+		uint32 i = HashCell(x, y) & mask;
+		while (m_table[i] != -1)
+		{
+			const Cell& cell = m_cells[m_table[i]];
+			if (cell.X == x && cell.Y == y)
+				return m_table[i];
+			i = (i + 1) & mask;
+		}
+		return -1;
+	}
+
+	/*!
+	 *  Finds the cells each fixture may touch, by looking up the cells its bounds
+	 *  cover, or by testing every cell if it covers more cells than there are. The
+	 *  contacts are sorted by cell, so each cell's particles are pushed out by one
+	 *  thread.
+	 */
+	void ParticleFluid::FindContacts()
+	{
+		m_contacts.clear();
+		const float inverseReach = 1.0f / m_reach;
+		// the fixture bounds are where the bodies end the step, particles pushed by a
+		// body before then have to meet the fixtures they're pushed into
+		const float radius = 0.5f * Spacing + b2_linearSlop + m_pushReach;
+		const int32 upperX = m_lowerX + m_width - 1;
+		const int32 upperY = m_cells.empty() ? m_lowerY : m_cells.back().Y;
+
+		for (int32 index = 0; index < (int32)m_fixtures.size(); index++)
+		{
+			const FluidFixture& fixture = m_fixtures[index];
+			const b2AABB& aabb = fixture.Fixture->GetAABB(fixture.ChildIndex);
+			const int32 x0 = b2Max(m_lowerX, (int32)floorf(b2Max(aabb.lowerBound.x - radius,
+				Bounds.lowerBound.x) * inverseReach));
+			const int32 y0 = b2Max(m_lowerY, (int32)floorf(b2Max(aabb.lowerBound.y - radius,
+				Bounds.lowerBound.y) * inverseReach));
+			const int32 x1 = b2Min(upperX, (int32)floorf(b2Min(aabb.upperBound.x + radius,
+				Bounds.upperBound.x) * inverseReach));
+			const int32 y1 = b2Min(upperY, (int32)floorf(b2Min(aabb.upperBound.y + radius,
+				Bounds.upperBound.y) * inverseReach));
+			if (x0 > x1 || y0 > y1)
+				continue;
+
+			if ((double)(x1 - x0 + 1) * (y1 - y0 + 1) <= (double)m_cells.size())
+			{
+				for (int32 y = y0; y <= y1; y++)
+				{
+					for (int32 x = x0; x <= x1; x++)
+					{
+						const int32 cell = FindCell(x, y);
+						if (cell >= 0)
+							m_contacts.push_back(Contact{ cell, index });
+					}
+				}
+			}
+			else
+			{
+				for (int32 cell = 0; cell < (int32)m_cells.size(); cell++)
+				{
+					const Cell& c = m_cells[cell];
+					if (x0 <= c.X && c.X <= x1 && y0 <= c.Y && c.Y <= y1)
+						m_contacts.push_back(Contact{ cell, index });
+				}
+			}
+		}
+
+		std::sort(m_contacts.begin(), m_contacts.end(), [](const Contact& a, const Contact& b)
+		{
+			return a.Cell < b.Cell || (a.Cell == b.Cell && a.Fixture < b.Fixture);
+		});
+
+		for (Cell& cell : m_cells)
+			cell.ContactBegin = cell.ContactEnd = 0;
+		for (int32 i = 0; i < (int32)m_contacts.size(); i++)
+		{
+			Cell& cell = m_cells[m_contacts[i].Cell];
+			if (cell.ContactBegin == cell.ContactEnd)
+				cell.ContactBegin = i;
+			cell.ContactEnd = i + 1;
+		}
+	}
+
+	/*!
+	 *  Works out each particle's density, and the lambda that scales its push toward
+	 *  rest density. Density only pushes particles apart, unless Cohesion lets it pull
+	 *  them together below rest density. The neighbors are taken a full set of lanes
+	 *  at a time, with the lanes past the end of a run masked off.
+	 *
+	 *      \param [in] begin	first cell
+	 *      \param [in] end		one past the last cell
+	 */
+	void ParticleFluid::SolveDensity(int begin, int end)
+	{
+		const b2FloatW reach = b2SplatW(m_reach);
+		const b2FloatW reach2 = b2SplatW(m_reach * m_reach);
+		const b2FloatW gradientScale = b2SplatW(m_gradientScale);
+		const b2FloatW minDistance2 = b2SplatW(k_minDistanceSquared);
+		const b2FloatW zero = b2SplatW(0.0f);
+		const float inverseRestSum = 1.0f / m_restSum;
+		const float relaxation = Relaxation * m_restGradient;
+		const float* px = m_px.data();
+		const float* py = m_py.data();
+
+		for (int index = begin; index < end; index++)
+		{
+			const Cell& cell = m_cells[index];
+			for (int32 i = cell.Begin; i < cell.End; i++)
+			{
+				const b2FloatW xi = b2SplatW(px[i]);
+				const b2FloatW yi = b2SplatW(py[i]);
+				b2FloatW density = zero, gradientX = zero, gradientY = zero, gradient2 = zero;
+
+				for (int row = 0; row < 3; row++)
+				{
+					const int32 rowEnd = cell.RowEnd[row];
+					for (int32 j = cell.RowBegin[row]; j < rowEnd; j += k_lanes)
+					{
+						const b2FloatW mask = b2LoadW(k_laneMask + k_lanes - b2Min(rowEnd - j, k_lanes));
+						const b2FloatW dx = b2SubW(xi, b2LoadW(px + j));
+						const b2FloatW dy = b2SubW(yi, b2LoadW(py + j));
+						const b2FloatW r2 = b2AddW(b2MulW(dx, dx), b2MulW(dy, dy));
+						const b2FloatW q = b2MaxW(b2SubW(reach2, r2), zero);
+						const b2FloatW r = b2SqrtW(b2MaxW(r2, minDistance2));
+						const b2FloatW s = b2MaxW(b2SubW(reach, r), zero);
+						const b2FloatW g = b2DivW(b2MulW(b2MulW(s, s), b2MulW(gradientScale, mask)), r);
+						const b2FloatW gx = b2MulW(g, dx);
+						const b2FloatW gy = b2MulW(g, dy);
+
+						density = b2AddW(density, b2MulW(b2MulW(q, b2MulW(q, q)), mask));
+						gradientX = b2AddW(gradientX, gx);
+						gradientY = b2AddW(gradientY, gy);
+						gradient2 = b2AddW(gradient2, b2AddW(b2MulW(gx, gx), b2MulW(gy, gy)));
+					}
+				}
+
+				const float sumX = SumW(gradientX);
+				const float sumY = SumW(gradientY);
+				m_density[i] = SumW(density) * inverseRestSum;
+				const float constraint = b2Max(m_density[i] - 1.0f, -Cohesion);
+				m_lambda[i] = -constraint
+					/ (SumW(gradient2) + sumX * sumX + sumY * sumY + relaxation);
+			}
+		}
+	}
+
+	/*!
+	 *  Works out how far each particle moves toward rest density, from its lambda and
+	 *  its neighbors'. Neighbors much closer than Spacing push apart a little more, the
+	 *  artificial pressure, which keeps particles from clumping where it's sparse.
+	 *
+	 *      \param [in] begin	first cell
+	 *      \param [in] end		one past the last cell
+	 */
+	void ParticleFluid::SolvePositions(int begin, int end)
+	{
+		const float reach2 = m_reach * m_reach;
+		const float q0 = reach2 * (1.0f - k_pressureDistance * k_pressureDistance);
+		const b2FloatW inverseQ0 = b2SplatW(1.0f / (q0 * q0 * q0));
+		const b2FloatW pressure = b2SplatW(-ArtificialPressure / m_restGradient);
+		const b2FloatW reach = b2SplatW(m_reach);
+		const b2FloatW reach2W = b2SplatW(reach2);
+		const b2FloatW gradientScale = b2SplatW(m_gradientScale);
+		const b2FloatW minDistance2 = b2SplatW(k_minDistanceSquared);
+		const b2FloatW zero = b2SplatW(0.0f);
+		const float* px = m_px.data();
+		const float* py = m_py.data();
+		const float* lambda = m_lambda.data();
+
+		for (int index = begin; index < end; index++)
+		{
+			const Cell& cell = m_cells[index];
+			for (int32 i = cell.Begin; i < cell.End; i++)
+			{
+				const b2FloatW xi = b2SplatW(px[i]);
+				const b2FloatW yi = b2SplatW(py[i]);
+				const b2FloatW lambdaI = b2SplatW(lambda[i]);
+				b2FloatW deltaX = zero, deltaY = zero;
+
+				for (int row = 0; row < 3; row++)
+				{
+					const int32 rowEnd = cell.RowEnd[row];
+					for (int32 j = cell.RowBegin[row]; j < rowEnd; j += k_lanes)
+					{
+						const b2FloatW mask = b2LoadW(k_laneMask + k_lanes - b2Min(rowEnd - j, k_lanes));
+						const b2FloatW dx = b2SubW(xi, b2LoadW(px + j));
+						const b2FloatW dy = b2SubW(yi, b2LoadW(py + j));
+						const b2FloatW r2 = b2AddW(b2MulW(dx, dx), b2MulW(dy, dy));
+						const b2FloatW q = b2MaxW(b2SubW(reach2W, r2), zero);
+						const b2FloatW r = b2SqrtW(b2MaxW(r2, minDistance2));
+						const b2FloatW s = b2MaxW(b2SubW(reach, r), zero);
+						const b2FloatW g = b2DivW(b2MulW(b2MulW(s, s), b2MulW(gradientScale, mask)), r);
+
+						// (W / W0)^4
+						b2FloatW w = b2MulW(b2MulW(q, b2MulW(q, q)), inverseQ0);
+						w = b2MulW(w, w);
+						const b2FloatW scale = b2MulW(g, b2AddW(b2AddW(lambdaI, b2LoadW(lambda + j)),
+							b2MulW(pressure, b2MulW(w, w))));
+
+						deltaX = b2AddW(deltaX, b2MulW(scale, dx));
+						deltaY = b2AddW(deltaY, b2MulW(scale, dy));
+					}
+				}
+
+				m_dx[i] = -SumW(deltaX);
+				m_dy[i] = -SumW(deltaY);
+			}
+		}
+	}
+
+	/*!
+	 *  Moves each particle by its correction, clamped to the most one solve may move
+	 *  it, then pushes the particles of each cell out of the fixtures near it. Only the
+	 *  last solve of a particle step keeps the impulses, the earlier pushes are undone
+	 *  by the solves after them. The impulses go in the thread's own slots.
+	 *
+	 *      \param [in] begin		first cell
+	 *      \param [in] end			one past the last cell
+	 *      \param [in] h			the particle step
+	 *      \param [in] threadIndex	-1 to not keep the impulses
+	 */
+	void ParticleFluid::Correct(int begin, int end, float h, int threadIndex)
+	{
+		Impulse* impulses = threadIndex >= 0 ?
+			m_impulses.data() + threadIndex * m_fixtures.size() : nullptr;
+		const float maxCorrection = k_maxCorrection * Spacing;
+		const float maxCorrection2 = maxCorrection * maxCorrection;
+		for (int index = begin; index < end; index++)
+		{
+			const Cell& cell = m_cells[index];
+			for (int32 i = cell.Begin; i < cell.End; i++)
+			{
+				const float length2 = m_dx[i] * m_dx[i] + m_dy[i] * m_dy[i];
+				const float scale = length2 > maxCorrection2 ? maxCorrection / sqrtf(length2) : 1.0f;
+				m_px[i] += scale * m_dx[i];
+				m_py[i] += scale * m_dy[i];
+			}
+
+			for (int32 k = cell.ContactBegin; k < cell.ContactEnd; k++)
+			{
+				const int32 fixture = m_contacts[k].Fixture;
+				for (int32 i = cell.Begin; i < cell.End; i++)
+					Collide(i, m_fixtures[fixture], h, impulses != nullptr ? impulses + fixture : nullptr);
+			}
+		}
+	}
+
+	/*!
+	 *  Pushes a particle out of a fixture, and takes off the sliding the friction
+	 *  allows, relative to the fixture's motion. The push is added to the impulse on
+	 *  the fixture's body, if there is one.
+	 *
+	 *      \param [in]     particle
+	 *      \param [in]     fixture
+	 *      \param [in]     h			the particle step
+	 *      \param [in,out] impulse	can be null
+	 */
+	void ParticleFluid::Collide(int32 particle, const FluidFixture& fixture, float h,
+		Impulse* impulse)
+	{
+		b2CircleShape circle;
+		circle.m_radius = 0.5f * Spacing;
+		b2Transform xfB;
+		xfB.p.Set(m_px[particle], m_py[particle]);
+		xfB.q.SetIdentity();
+
+		const b2Shape* shape = fixture.Fixture->GetShape();
+		b2Body* body = fixture.Fixture->GetBody();
+		const b2Transform& xfA = fixture.Transform;
+
+		// a particle that crosses the fixture's middle in one step, or that the fixture
+		// moves over, would be pushed out the far side, so it's stopped where it went
+		// in. The start is carried along with the body, to test the motion between them.
+		const b2Vec2 start = b2Mul(xfA, b2MulT(fixture.Previous, b2Vec2(m_x[particle], m_y[particle])));
+		b2RayCastInput input;
+		input.p1 = start;
+		input.p2 = xfB.p;
+		input.maxFraction = 1.0f;
+		b2RayCastOutput output;
+		if (input.p1 != input.p2 && shape->RayCast(&output, input, xfA, fixture.ChildIndex))
+			xfB.p = start + output.fraction * (input.p2 - start) + b2_linearSlop * output.normal;
+
+		b2Manifold manifold;
+		switch (shape->GetType())
+		{
+		case b2Shape::e_circle:
+			b2CollideCircles(&manifold, (const b2CircleShape*)shape, xfA, &circle, xfB);
+			break;
+
+		case b2Shape::e_polygon:
+			b2CollidePolygonAndCircle(&manifold, (const b2PolygonShape*)shape, xfA, &circle, xfB);
+			break;
+
+		case b2Shape::e_edge:
+			b2CollideEdgeAndCircle(&manifold, (const b2EdgeShape*)shape, xfA, &circle, xfB);
+			break;
+
+		case b2Shape::e_chain:
+			{
+				b2EdgeShape edge;
+				((const b2ChainShape*)shape)->GetChildEdge(&edge, fixture.ChildIndex);
+				b2CollideEdgeAndCircle(&manifold, &edge, xfA, &circle, xfB);
+			}
+			break;
+
+		default:
+			manifold.pointCount = 0;
+			break;
+		}
+
+		b2Vec2 p = xfB.p;
+		b2Vec2 point = p;
+		if (manifold.pointCount > 0)
+		{
+			b2WorldManifold worldManifold;
+			worldManifold.Initialize(&manifold, xfA, shape->m_radius, xfB, circle.m_radius);
+			const float separation = worldManifold.separations[0];
+			if (separation < 0.0f)
+			{
+				const b2Vec2 normal = worldManifold.normal;
+				point = worldManifold.points[0];
+				p -= separation * normal;
+
+				// slide no further than friction times the push allows
+				const b2Vec2 motion = p - start;
+				const b2Vec2 tangent = motion - b2Dot(motion, normal) * normal;
+				const float slide = tangent.Length();
+				if (slide > 0.0f)
+				{
+					const float friction = b2MixFriction(Friction, fixture.Fixture->GetFriction());
+					p -= b2Min(1.0f, -friction * separation / slide) * tangent;
+				}
+			}
+		}
+
+		const b2Vec2 before(m_px[particle], m_py[particle]);
+		if (p == before)
+			return;
+
+		m_px[particle] = p.x;
+		m_py[particle] = p.y;
+
+		if (impulse != nullptr && TwoWayCoupling && body->GetType() == b2_dynamicBody)
+		{
+			const float mass = Density * Spacing * Spacing;
+			const b2Vec2 push = (-mass / h) * (p - before);
+			impulse->Linear += push;
+			impulse->Angular += b2Cross(point - b2Mul(xfA, body->GetLocalCenter()), push);
+		}
+	}
+
+	/*!
+	 *  Each particle's velocity is what carried it to its solved position, which is
+	 *  where it starts the next particle step
+	 *
+	 *      \param [in] h	the particle step
+	 */
+	void ParticleFluid::UpdateVelocities(float h)
+	{
+		const float inverseH = 1.0f / h;
+		ForEach(m_count, 1024, [this, inverseH](int begin, int end, int /*threadIndex*/)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				m_vx[i] = inverseH * (m_px[i] - m_x[i]);
+				m_vy[i] = inverseH * (m_py[i] - m_y[i]);
+				m_x[i] = m_px[i];
+				m_y[i] = m_py[i];
+			}
+		});
+	}
+
+	/*!
+	 *  Moves each particle's velocity toward its neighbors', weighed by the density
+	 *  kernel over their density. The new velocities go in the correction arrays, so
+	 *  every particle reads its neighbors' velocities from before.
+	 *
+	 *      \param [in] begin	first cell
+	 *      \param [in] end		one past the last cell
+	 */
+	void ParticleFluid::ApplyViscosity(int begin, int end)
+	{
+		const b2FloatW reach2 = b2SplatW(m_reach * m_reach);
+		const b2FloatW zero = b2SplatW(0.0f);
+		const float viscosity = Viscosity / m_restSum;
+		const float* px = m_px.data();
+		const float* py = m_py.data();
+		const float* vx = m_vx.data();
+		const float* vy = m_vy.data();
+		const float* density = m_density.data();
+
+		for (int index = begin; index < end; index++)
+		{
+			const Cell& cell = m_cells[index];
+			for (int32 i = cell.Begin; i < cell.End; i++)
+			{
+				const b2FloatW xi = b2SplatW(px[i]);
+				const b2FloatW yi = b2SplatW(py[i]);
+				const b2FloatW vxi = b2SplatW(vx[i]);
+				const b2FloatW vyi = b2SplatW(vy[i]);
+				b2FloatW sumX = zero, sumY = zero;
+
+				for (int row = 0; row < 3; row++)
+				{
+					const int32 rowEnd = cell.RowEnd[row];
+					for (int32 j = cell.RowBegin[row]; j < rowEnd; j += k_lanes)
+					{
+						const b2FloatW mask = b2LoadW(k_laneMask + k_lanes - b2Min(rowEnd - j, k_lanes));
+						const b2FloatW dx = b2SubW(xi, b2LoadW(px + j));
+						const b2FloatW dy = b2SubW(yi, b2LoadW(py + j));
+						const b2FloatW q = b2MaxW(b2SubW(reach2, b2AddW(b2MulW(dx, dx), b2MulW(dy, dy))), zero);
+						const b2FloatW w = b2DivW(b2MulW(b2MulW(q, b2MulW(q, q)), mask), b2LoadW(density + j));
+
+						sumX = b2AddW(sumX, b2MulW(w, b2SubW(b2LoadW(vx + j), vxi)));
+						sumY = b2AddW(sumY, b2MulW(w, b2SubW(b2LoadW(vy + j), vyi)));
+					}
+				}
+
+				m_dx[i] = vx[i] + viscosity * SumW(sumX);
+				m_dy[i] = vy[i] + viscosity * SumW(sumY);
+			}
+		}
+	}
+
+	/*!
+	 *  Adds up each fixture's impulses from every thread, and applies them to its
+	 *  body if it's dynamic
+	 */
+	void ParticleFluid::ApplyImpulses()
+	{
+		if (!TwoWayCoupling)
+			return;
+
+		const size_t fixtureCount = m_fixtures.size();
+		for (size_t index = 0; index < fixtureCount; index++)
+		{
+			b2Body* body = m_fixtures[index].Fixture->GetBody();
+			if (body->GetType() != b2_dynamicBody)
+				continue;
+
+			Impulse impulse = { b2Vec2(0.0f, 0.0f), 0.0f };
+			for (int thread = 0; thread < m_threadCount; thread++)
+			{
+				impulse.Linear += m_impulses[thread * fixtureCount + index].Linear;
+				impulse.Angular += m_impulses[thread * fixtureCount + index].Angular;
+			}
+
+			if (impulse.Linear.LengthSquared() > 0.0f || impulse.Angular != 0.0f)
+			{
+				body->ApplyLinearImpulseToCenter(impulse.Linear, true);
+				body->ApplyAngularImpulse(impulse.Angular, true);
+			}
+		}
+	}
+
+	/*!
+	 *  Destroys the particles outside Bounds, and any that aren't a number anymore,
+	 *  keeping the rest in order
+	 */
+	void ParticleFluid::DestroyOutside()
+	{
+		int count = 0;
+		for (int i = 0; i < m_count; i++)
+		{
+			const bool inside = Bounds.lowerBound.x <= m_x[i] && m_x[i] <= Bounds.upperBound.x
+				&& Bounds.lowerBound.y <= m_y[i] && m_y[i] <= Bounds.upperBound.y;
+			if (!inside)
+				continue;
+
+			m_x[count] = m_px[count] = m_x[i];
+			m_y[count] = m_py[count] = m_y[i];
+			m_vx[count] = m_vx[i];
+			m_vy[count] = m_vy[i];
+			count++;
+		}
+
+		if (count != m_count)
+		{
+			m_count = count;
+			Pad();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file ParticleFluid.hpp
+  * \author Joe Goldman
+  * \brief ParticleFluid class declaration
+  *
+  */
+
+#pragma once
+
+#include <Physics/Box2d.hpp>
+
+#include <functional> // function
+#include <vector> // vector
+
+namespace GenevaEngine
+{
+	class JobSystem;
+
+	/*!
+	 *  \brief	A fluid of many small particles, solved as position based fluids: each
+	 *			step the particles are moved, then pushed apart or together until every
+	 *			particle's neighborhood is at rest density. Particles are kept as arrays
+	 *			of each value, sorted into a hashed grid of cells as wide as a particle's
+	 *			reach, so a particle's neighbors are the particles of three runs of cells.
+	 *			The density kernels run over those runs in SIMD lanes, and the cells are
+	 *			spread across the job system. The particles are pushed out of the fixtures
+	 *			of the world, and push dynamic bodies back.
+	 */
+	class ParticleFluid : private b2QueryCallback
+	{
+	public:
+		// Attributes, can be changed between steps
+		float Spacing = 0.5f;				// between particles at rest, twice their radius
+		float Density = 1.0f;				// mass per area, like a fixture's
+		int SubSteps = 4;					// particle steps per world step
+		int Iterations = 2;					// density solves per particle step
+		float Viscosity = 0.05f;			// how much particles move with their neighbors
+		float Cohesion = 0.0f;				// how far below rest density particles pull together
+		float ArtificialPressure = 0.02f;	// keeps particles from clumping
+		float Relaxation = 0.5f;			// softens the density solve, higher is softer
+		float Friction = 0.2f;				// against fixtures, mixed with the fixture's
+		bool TwoWayCoupling = true;			// dynamic bodies are pushed back by the particles
+		b2Filter Filter;					// which fixtures the particles collide with
+		b2AABB Bounds;						// particles that leave it are destroyed
+
+		ParticleFluid();
+
+		// particles
+		void Reserve(int count);
+		void CreateParticle(const b2Vec2& position, const b2Vec2& velocity = b2Vec2(0, 0));
+		int CreateBox(const b2AABB& box, const b2Vec2& velocity = b2Vec2(0, 0));
+		void Clear();
+
+		// steps the particles after the world. The job system can be null.
+		void Step(b2World& world, float dt, JobSystem* jobSystem);
+
+		// the particles are sorted every step, an index only holds until the next one
+		int GetParticleCount() const;
+		const float* GetPositionX() const;
+		const float* GetPositionY() const;
+
+	private:
+		// a run of particles in one grid cell, and the runs of cells around it
+		struct Cell
+		{
+			int32 X;
+			int32 Y;
+			int32 Begin;
+			int32 End;
+			int32 RowBegin[3];		// the particles of the three cells in each row
+			int32 RowEnd[3];		// below, at, and above this cell
+			int32 ContactBegin;
+			int32 ContactEnd;
+		};
+
+		// a cell whose particles may touch a fixture
+		struct Contact
+		{
+			int32 Cell;
+			int32 Fixture;
+		};
+
+		// a fixture, or one edge of a chain, the particles may touch this step, and
+		// where its body was at the start and end of the particle step
+		struct FluidFixture
+		{
+			b2Fixture* Fixture;
+			int32 ChildIndex;
+			b2Transform Previous;
+			b2Transform Transform;
+		};
+
+		// what the particles pushed a fixture by, about its body's center
+		struct Impulse
+		{
+			b2Vec2 Linear;
+			float Angular;
+		};
+
+		// particles, with padding after the last one for the SIMD lanes
+		int m_count = 0;
+		std::vector<float> m_x, m_y;		// at the start of the particle step
+		std::vector<float> m_vx, m_vy;
+		std::vector<float> m_px, m_py;		// predicted, solved for density
+		std::vector<float> m_lambda;
+		std::vector<float> m_density;		// 1 at rest
+		std::vector<float> m_dx, m_dy;		// corrections, then velocities after viscosity
+		std::vector<float> m_scratch;
+
+		// the grid. Cells are sorted by row then column, and found through the table.
+		std::vector<uint32> m_keys;
+		std::vector<int32> m_order;
+		std::vector<uint32> m_sortKeys;
+		std::vector<int32> m_sortOrder;
+		std::vector<Cell> m_cells;
+		std::vector<int32> m_table;
+		int32 m_lowerX = 0;
+		int32 m_lowerY = 0;
+		int32 m_width = 0;
+
+		// fixtures found by the world query, the cells near them, and per thread impulses
+		b2AABB m_queryBounds;
+		// farthest a moving body can push a particle in one step
+		float m_pushReach = 0.0f;
+		std::vector<b2Fixture*> m_queried;
+		std::vector<FluidFixture> m_fixtures;
+		std::vector<Contact> m_contacts;
+		std::vector<Impulse> m_impulses;
+		int m_threadCount = 1;
+		JobSystem* m_jobSystem = nullptr;
+
+		// kernel constants, from Spacing
+		float m_reach = 0.0f;
+		float m_restSum = 1.0f;				// density kernel summed over rest neighbors
+		float m_gradientScale = 0.0f;
+		float m_restGradient = 1.0f;		// squared density gradients at rest
+
+		void Pad();
+		void UpdateKernel();
+		void ForEach(int count, int minBatch, const std::function<void(int, int, int)>& job);
+
+		void FindFixtures(b2World& world, float dt);
+		bool ReportFixture(b2Fixture* fixture) override;
+		void MoveFixtures(float before, float after);
+
+		void Predict(float h, const b2Vec2& gravity);
+		void BuildGrid();
+		void SortParticles();
+		int32 FindCell(int32 x, int32 y) const;
+		void FindContacts();
+		void SolveDensity(int begin, int end);
+		void SolvePositions(int begin, int end);
+		void Correct(int begin, int end, float h, int threadIndex);
+		void Collide(int32 particle, const FluidFixture& fixture, float h, Impulse* impulse);
+		void UpdateVelocities(float h);
+		void ApplyViscosity(int begin, int end);
+		void ApplyImpulses();
+		void DestroyOutside();
+	};
+}
\ No newline at end of file
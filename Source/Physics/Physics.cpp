@@ -16,14 +16,36 @@
   **/
 
 #include <Physics/Physics.hpp>
+#include <Core/GameSession.hpp>
+#include <Core/Profiler.hpp>
+
+#include <algorithm> // min, max
 
 namespace GenevaEngine
 {
 	/*!
-	 *  Starts the physics system, before game loop.
+	 *  Starts the physics system, before game loop. Islands are solved on the job system
+	 *  unless the session turned parallel physics off, big islands a color at a time if
+	 *  it turned colored islands on, and contacts in SIMD lanes if it turned the wide
+	 *  contact solver on. The broad-phase is the one the session picked. Contacts are
+	 *  listened to so constructs know when they're grounded. Islands far from the
+	 *  camera are frozen, if the session asked for it.
 	 */
 	void Physics::Start()
 	{
+		m_world.SetContactListener(&m_groundContacts);
+		m_lod.Radius = m_gameSession->GetSettings().PhysicsLODRadius;
+		m_lod.Hysteresis = m_gameSession->GetSettings().PhysicsLODHysteresis;
+		m_world.SetWideSolving(m_gameSession->GetSettings().WideContactSolver);
+		m_world.SetColorSolving(m_gameSession->GetSettings().ColoredIslands);
+		m_world.SetBroadPhase(m_gameSession->GetSettings().BroadPhase,
+			m_gameSession->GetSettings().BroadPhaseCellSize);
+
+		if (m_gameSession->GetSettings().ParallelPhysics)
+		{
+			m_taskExecutor = new JobTaskExecutor(m_gameSession->GetJobSystem());
+			m_world.SetTaskExecutor(m_taskExecutor);
+		}
 	}
 
 	/*!
@@ -31,16 +53,268 @@ namespace GenevaEngine
 	 */
 	void Physics::End()
 	{
+		// the world frees everything left when it goes, no need to destroy one by one
+		m_bodiesToDestroy.clear();
+		m_jointsToDestroy.clear();
+		m_softBodiesToDestroy.clear();
+
+		// the job system goes after the systems end
+		m_world.SetTaskExecutor(nullptr);
+		delete m_taskExecutor;
+		m_taskExecutor = nullptr;
 	}
 
 	/*!
-	 *  Updates the physics system
+	 *  Updates the physics system. The particle fluid steps after the world, so it
+	 *  meets the bodies where they ended up, on the same job system as the islands.
+	 *  Objects queued since the last structural changes, by a construct replaced in a
+	 *  frame update, are destroyed before the world steps.
 	 *
 	 *      \param [in] dt
 	 */
 	void Physics::Update(double dt)
 	{
-		m_world.Step((float)dt, k_velocity_iterations, k_position_iterations);
+		PROFILE_ZONE("Physics");
+
+		DestroyQueued();
+
+		{
+			PROFILE_ZONE("Physics LOD");
+			m_lod.Update(m_world);
+		}
+
+		SavePreviousTransforms();
+
+		const int64_t stepStart = Profiler::IsRecording() ? Profiler::Now() : -1;
+		m_world.Step((float)dt, m_velocityIterations, m_positionIterations);
+		if (stepStart >= 0)
+			RecordStepProfile(stepStart);
+
+		{
+			PROFILE_ZONE("Particle fluid");
+			m_fluid.Step(m_world, (float)dt,
+				m_taskExecutor != nullptr ? m_gameSession->GetJobSystem() : nullptr);
+		}
+	}
+
+	/*!
+	 *  Adds box2d's timings of the last step to the profiler, under a zone for the step.
+	 *  box2d only reports how long each phase took, so the phases are laid out in the
+	 *  order the step runs them: collide, solve (init, velocity and position, then
+	 *  broadphase at its end), TOI, then soft bodies. Island timings are summed over all
+	 *  islands, and with the parallel solver over every thread, so they can add up to
+	 *  more than their parent. Each zone is cut off at its parent's span, so the trace
+	 *  still nests.
+	 *
+	 *      \param [in] stepStart	profiler time the step started
+	 */
+	void Physics::RecordStepProfile(int64_t stepStart)
+	{
+		const b2Profile& profile = m_world.GetProfile();
+		auto ns = [](float ms) { return (int64_t)(ms * 1.0e6); };
+		auto record = [](const char* name, int64_t start, int64_t end, int64_t parentStart,
+			int64_t parentEnd)
+		{
+			start = std::min(std::max(start, parentStart), parentEnd);
+			end = std::min(std::max(end, start), parentEnd);
+			Profiler::Record(name, start, end);
+		};
+
+		const int64_t stepEnd = stepStart + ns(profile.step);
+		Profiler::Record("b2World::Step", stepStart, stepEnd);
+
+		const int64_t solveStart = std::min(stepStart + ns(profile.collide), stepEnd);
+		const int64_t solveEnd = std::min(solveStart + ns(profile.solve), stepEnd);
+		record("Collide", stepStart, solveStart, stepStart, stepEnd);
+		record("Solve", solveStart, solveEnd, stepStart, stepEnd);
+
+		int64_t time = solveStart;
+		record("Solve init", time, time + ns(profile.solveInit), solveStart, solveEnd);
+		time += ns(profile.solveInit);
+		record("Solve velocity", time, time + ns(profile.solveVelocity), solveStart, solveEnd);
+		time += ns(profile.solveVelocity);
+		record("Solve position", time, time + ns(profile.solvePosition), solveStart, solveEnd);
+		record("Broadphase", solveEnd - ns(profile.broadphase), solveEnd, solveStart, solveEnd);
+
+		record("Solve TOI", solveEnd, solveEnd + ns(profile.solveTOI), stepStart, stepEnd);
+		time = solveEnd + ns(profile.solveTOI);
+		record("Solve soft bodies", time, time + ns(profile.solveSoftBodies), stepStart, stepEnd);
+	}
+
+	void Physics::SetIterations(int velocity, int position)
+	{
+		m_velocityIterations = velocity;
+		m_positionIterations = position;
+	}
+
+	PhysicsLOD& Physics::GetLOD()
+	{
+		return m_lod;
+	}
+
+	ParticleFluid& Physics::GetFluid()
+	{
+		return m_fluid;
+	}
+
+	/*!
+	 *  Builds the broad-phase tree again, top down over every fixture. The tree the
+	 *  level's fixtures were inserted into one at a time is left with more overlap
+	 *  between its nodes, which every ray cast and pair query pays for. Only the tree
+	 *  broad-phase is rebuilt. Its time shows up in the profiler's trace.
+	 */
+	void Physics::RebuildBroadPhase()
+	{
+		if (m_world.GetBroadPhase() != b2_treeBroadPhase || m_world.GetProxyCount() == 0)
+			return;
+
+		PROFILE_ZONE("Broad-phase rebuild");
+		m_world.RebuildBroadPhase();
+	}
+
+	/*!
+	 *  Ray casts a batch of rays for the closest fixture each one hits. Rays that start
+	 *  near each other share a walk of the broad-phase, which tests each node against
+	 *  several of them at once, instead of every ray walking it alone behind a virtual
+	 *  callback. Must not be called while the world is stepping.
+	 *
+	 *      \param [in] rays		each from p1 to p1 + maxFraction * (p2 - p1)
+	 *      \param [in] parallel	spread the rays across the job system, if physics uses it
+	 *
+	 *      \return The hit of each ray, fixture is nullptr for rays that hit nothing.
+	 */
+	const std::vector<b2RayCastHit>& Physics::RayCastBatch(const std::vector<b2RayCastInput>& rays,
+		bool parallel)
+	{
+		m_rayCastHits.resize(rays.size());
+		m_world.RayCastClosest(rays.data(), m_rayCastHits.data(), (int32)rays.size(), parallel);
+		return m_rayCastHits;
+	}
+
+	void Physics::ForgetGround(Construct* construct)
+	{
+		m_groundContacts.Forget(construct);
+	}
+
+	void Physics::QueueDestroy(b2Body* body)
+	{
+		m_bodiesToDestroy.push_back(body);
+	}
+
+	void Physics::QueueDestroy(b2Joint* joint)
+	{
+		m_jointsToDestroy.push_back(joint);
+	}
+
+	void Physics::QueueDestroy(b2SoftBody* softBody)
+	{
+		m_softBodiesToDestroy.push_back(softBody);
+	}
+
+	/*!
+	 *  Destroys the queued joints, then the queued bodies, then the queued soft bodies.
+	 *  Joints go first, destroying a body also destroys its joints. Must not be called
+	 *  while the world is stepping.
+	 */
+	void Physics::DestroyQueued()
+	{
+		for (b2Joint* joint : m_jointsToDestroy)
+			m_world.DestroyJoint(joint);
+
+		for (b2Body* body : m_bodiesToDestroy)
+		{
+			// the next body given the slot saves its own transform
+			if (body->GetUserData().slot >= 0)
+				m_freeSlots.push_back(body->GetUserData().slot);
+			m_lod.Forget(body);
+			m_world.DestroyBody(body);
+		}
+
+		for (b2SoftBody* softBody : m_softBodiesToDestroy)
+			m_world.DestroySoftBody(softBody);
+
+		m_jointsToDestroy.clear();
+		m_bodiesToDestroy.clear();
+		m_softBodiesToDestroy.clear();
+	}
+
+	/*!
+	 *  Saves the transform of every non static body before it steps. Sleeping ones
+	 *  are saved too, a body woken during the step moves from where it slept. A body
+	 *  without a slot is given one.
+	 */
+	void Physics::SavePreviousTransforms()
+	{
+		for (b2Body* body = m_world.GetBodyList(); body != nullptr; body = body->GetNext())
+		{
+			if (body->GetType() == b2_staticBody)
+				continue;
+
+			int32& slot = body->GetUserData().slot;
+			if (slot < 0)
+			{
+				if (!m_freeSlots.empty())
+				{
+					slot = m_freeSlots.back();
+					m_freeSlots.pop_back();
+				}
+				else
+				{
+					slot = (int32)m_previousTransforms.size();
+					m_previousTransforms.emplace_back();
+				}
+			}
+			m_previousTransforms[slot] = body->GetTransform();
+		}
+	}
+
+	/*!
+	 *  Blends the body's transform from before the last step with its current one.
+	 *  Static bodies, and bodies made since the last step, are at their current one.
+	 *
+	 *      \param [in] body
+	 *      \param [in] alpha	0 is the previous step, 1 is the current step
+	 *
+	 *      \return The interpolated transform.
+	 */
+	b2Transform Physics::GetInterpolatedTransform(const b2Body* body, float alpha) const
+	{
+		const b2Transform& current = body->GetTransform();
+		const int32 slot = body->GetUserData().slot;
+		if (slot < 0 || body->GetType() == b2_staticBody)
+			return current;
+
+		const b2Transform& xf0 = m_previousTransforms[slot];
+
+		// rotate the short way around
+		const float angle0 = xf0.q.GetAngle();
+		float delta = current.q.GetAngle() - angle0;
+		if (delta > b2_pi)
+			delta -= 2.0f * b2_pi;
+		else if (delta < -b2_pi)
+			delta += 2.0f * b2_pi;
+
+		b2Transform xf;
+		xf.p = (1.0f - alpha) * xf0.p + alpha * current.p;
+		xf.q.Set(angle0 + alpha * delta);
+		return xf;
+	}
+
+	/*!
+	 *  Moves a point attached to a body, given where it is now, to where it is in the
+	 *  body's interpolated transform.
+	 *
+	 *      \param [in] body
+	 *      \param [in] worldPoint	the point's current world position
+	 *      \param [in] alpha
+	 *
+	 *      \return The interpolated world position.
+	 */
+	b2Vec2 Physics::GetInterpolatedPoint(const b2Body* body, const b2Vec2& worldPoint,
+		float alpha) const
+	{
+		const b2Vec2 localPoint = b2MulT(body->GetTransform(), worldPoint);
+		return b2Mul(GetInterpolatedTransform(body, alpha), localPoint);
 	}
 
 	/*!
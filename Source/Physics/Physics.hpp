@@ -18,8 +18,15 @@
 #pragma once
 
 #include <Physics/Box2d.hpp>
+#include <Physics/JobTaskExecutor.hpp>
+#include <Physics/GroundContactListener.hpp>
+#include <Physics/PhysicsLOD.hpp>
+#include <Physics/ParticleFluid.hpp>
 #include <Core/System.hpp>
 
+#include <cstdint> // int64_t
+#include <vector> // vector
+
 namespace GenevaEngine
 {
 	/*!
@@ -30,13 +37,75 @@ namespace GenevaEngine
 	public:
 		b2World* GetWorld();
 
+		// where a body is between the last step (alpha 0) and the current one (alpha 1)
+		b2Transform GetInterpolatedTransform(const b2Body* body, float alpha) const;
+		b2Vec2 GetInterpolatedPoint(const b2Body* body, const b2Vec2& worldPoint,
+			float alpha) const;
+
+		// bodies, joints and soft bodies are destroyed together in a batch, between steps
+		void QueueDestroy(b2Body* body);
+		void QueueDestroy(b2Joint* joint);
+		void QueueDestroy(b2SoftBody* softBody);
+		void DestroyQueued();
+
+		// stops counting ground contacts for a construct that's going, its bodies'
+		// contacts end after it's gone
+		void ForgetGround(Construct* construct);
+
+		// constraint solver iterations for the following steps
+		void SetIterations(int velocity, int position);
+
+		// freezes islands far from the camera and interest points, see PhysicsLOD
+		PhysicsLOD& GetLOD();
+
+		// water and goo, stepped after the world and pushed out of its fixtures
+		ParticleFluid& GetFluid();
+
+		// builds the broad-phase tree again over every fixture at once. Call once a
+		// level is loaded.
+		void RebuildBroadPhase();
+
+		// the closest fixture each ray hits, in the order of the rays. Rays are cast in
+		// packets, spread across the job system when parallel and parallel physics is on.
+		// The hits stay valid until the next call.
+		const std::vector<b2RayCastHit>& RayCastBatch(const std::vector<b2RayCastInput>& rays,
+			bool parallel = true);
+
 	private:
 		// box2d
-		const int32 k_velocity_iterations = 6; // setting for constraint solver
-		const int32 k_position_iterations = 2; // setting for constraint solver
+		int32 m_velocityIterations = 6; // setting for constraint solver
+		int32 m_positionIterations = 2; // setting for constraint solver
 		b2Vec2 m_gravity = b2Vec2(0, -200.0f);
 		b2World m_world = b2World(m_gravity);
 
+		// solves the world's islands on the job system, nullptr solves them serially
+		JobTaskExecutor* m_taskExecutor = nullptr;
+
+		// counts the contacts each construct stands on, for ConstructQuery::IsGrounded
+		GroundContactListener m_groundContacts;
+
+		// freezes the islands no one is near
+		PhysicsLOD m_lod;
+
+		// spread across the job system when parallel physics is on
+		ParticleFluid m_fluid;
+
+		// transforms of the non static bodies before the last step, at the slot in
+		// their user data. Slots of destroyed bodies are reused.
+		std::vector<b2Transform> m_previousTransforms;
+		std::vector<int32> m_freeSlots;
+
+		// waiting for the next DestroyQueued
+		std::vector<b2Body*> m_bodiesToDestroy;
+		std::vector<b2Joint*> m_jointsToDestroy;
+		std::vector<b2SoftBody*> m_softBodiesToDestroy;
+
+		// returned by RayCastBatch, kept so batches don't allocate once their size settles
+		std::vector<b2RayCastHit> m_rayCastHits;
+
+		void SavePreviousTransforms();
+		void RecordStepProfile(int64_t stepStart);
+
 		// inherited members, methods, and constructors
 		using System::System;
 		void Start();
@@ -0,0 +1,195 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file PhysicsLOD.cpp
+  * \author Joe Goldman
+  * \brief PhysicsLOD class definition
+  *
+  **/
+
+#include <Physics/PhysicsLOD.hpp>
+
+namespace GenevaEngine
+{
+	void PhysicsLOD::SetCamera(const b2Vec2& position)
+	{
+		m_hasCamera = true;
+		m_camera = position;
+	}
+
+	/*!
+	 *  Walks the world's islands the way box2d builds them, through touching contacts
+	 *  and joints but not through static bodies, and freezes the ones with no body
+	 *  near an interest point. Islands that have one are thawed. Bodies box2d put to
+	 *  sleep by itself are left asleep, it wakes them if their island starts moving.
+	 *  Without any interest points nothing is frozen.
+	 *
+	 *      \param [in,out] world
+	 */
+	void PhysicsLOD::Update(b2World& world)
+	{
+		if (!m_hasCamera && InterestPoints.empty())
+		{
+			ThawAll();
+			return;
+		}
+
+		if (--m_stepsToUpdate > 0)
+			return;
+		m_stepsToUpdate = k_updateInterval;
+
+		if (++m_walk == 0)
+			m_walk = 1;
+		for (b2Body* seed = world.GetBodyList(); seed != nullptr; seed = seed->GetNext())
+		{
+			if (seed->GetType() == b2_staticBody || !seed->IsEnabled() || !Visit(seed))
+				continue;
+
+			m_island.clear();
+			m_stack.push_back(seed);
+			bool wanted = false;
+			while (!m_stack.empty())
+			{
+				b2Body* body = m_stack.back();
+				m_stack.pop_back();
+				m_island.push_back(body);
+				wanted = wanted || IsWanted(body);
+
+				for (b2ContactEdge* ce = body->GetContactList(); ce != nullptr; ce = ce->next)
+				{
+					b2Contact* contact = ce->contact;
+					if (!contact->IsEnabled() || !contact->IsTouching()
+						|| contact->GetFixtureA()->IsSensor() || contact->GetFixtureB()->IsSensor())
+						continue;
+
+					b2Body* other = ce->other;
+					if (other->GetType() != b2_staticBody && Visit(other))
+						m_stack.push_back(other);
+				}
+
+				for (b2JointEdge* je = body->GetJointList(); je != nullptr; je = je->next)
+				{
+					b2Body* other = je->other;
+					if (other->GetType() != b2_staticBody && other->IsEnabled() && Visit(other))
+						m_stack.push_back(other);
+				}
+			}
+
+			for (b2Body* body : m_island)
+			{
+				if (wanted)
+					Thaw(body);
+				else
+					Freeze(body);
+			}
+		}
+	}
+
+	/*!
+	 *  Stamps a body as reached by this update's walk
+	 *
+	 *      \param [in,out] body
+	 *
+	 *      \return Whether it wasn't reached before.
+	 */
+	bool PhysicsLOD::Visit(b2Body* body) const
+	{
+		uint32& visit = body->GetUserData().visit;
+		if (visit == m_walk)
+			return false;
+
+		visit = m_walk;
+		return true;
+	}
+
+	/*!
+	 *  Whether a body is close enough to an interest point to be simulated. A frozen
+	 *  body has to come within the radius, a simulated one has to leave the radius
+	 *  plus the hysteresis, so bodies near the edge don't flicker between the two.
+	 *
+	 *      \param [in] body
+	 *
+	 *      \return Whether it is wanted.
+	 */
+	bool PhysicsLOD::IsWanted(b2Body* body) const
+	{
+		const float radius = m_frozen.count(body) > 0 ? Radius : Radius + Hysteresis;
+		const float radiusSquared = radius * radius;
+		const b2Vec2& position = body->GetPosition();
+
+		if (m_hasCamera && b2DistanceSquared(position, m_camera) <= radiusSquared)
+			return true;
+		for (const b2Vec2& point : InterestPoints)
+		{
+			if (b2DistanceSquared(position, point) <= radiusSquared)
+				return true;
+		}
+		return false;
+	}
+
+	/*!
+	 *  Saves an awake body's velocities and puts it to sleep. A frozen body box2d woke
+	 *  since is saved again, it has moved on from the old velocities.
+	 *
+	 *      \param [in,out] body
+	 */
+	void PhysicsLOD::Freeze(b2Body* body)
+	{
+		if (!body->IsAwake())
+			return;
+
+		FrozenBody& frozen = m_frozen[body];
+		frozen.LinearVelocity = body->GetLinearVelocity();
+		frozen.AngularVelocity = body->GetAngularVelocity();
+		body->SetAwake(false);
+	}
+
+	/*!
+	 *  Wakes a frozen body with its saved velocities. One box2d already woke keeps the
+	 *  velocities it has now.
+	 *
+	 *      \param [in,out] body
+	 */
+	void PhysicsLOD::Thaw(b2Body* body)
+	{
+		const auto frozen = m_frozen.find(body);
+		if (frozen == m_frozen.end())
+			return;
+
+		if (!body->IsAwake())
+		{
+			body->SetAwake(true);
+			body->SetLinearVelocity(frozen->second.LinearVelocity);
+			body->SetAngularVelocity(frozen->second.AngularVelocity);
+		}
+		m_frozen.erase(frozen);
+	}
+
+	void PhysicsLOD::ThawAll()
+	{
+		while (!m_frozen.empty())
+			Thaw(m_frozen.begin()->first);
+
+		m_hasCamera = false;
+		m_stepsToUpdate = 0;
+	}
+
+	void PhysicsLOD::Forget(b2Body* body)
+	{
+		m_frozen.erase(body);
+	}
+
+	int PhysicsLOD::GetFrozenCount() const
+	{
+		return (int)m_frozen.size();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file PhysicsLOD.hpp
+  * \author Joe Goldman
+  * \brief PhysicsLOD class declaration
+  *
+  */
+
+#pragma once
+
+#include <Physics/Box2d.hpp>
+
+#include <unordered_map> // unordered_map
+#include <vector> // vector
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief	Freezes the islands of bodies far from every interest point, and thaws
+	 *			them when one comes back. A frozen island is put to sleep with its
+	 *			velocities saved, and wakes with them restored, so it carries on where
+	 *			it left off. Islands are frozen whole, a body touching or jointed to a
+	 *			simulated one is always simulated too.
+	 */
+	class PhysicsLOD
+	{
+	public:
+		// bodies within Radius of an interest point are simulated
+		float Radius = 150.0f;
+		// a simulated body has to be this much farther than Radius before it can freeze
+		float Hysteresis = 20.0f;
+		// points besides the camera to simulate around, kept until changed
+		std::vector<b2Vec2> InterestPoints;
+
+		// the camera moves every frame, set it before the frame's steps
+		void SetCamera(const b2Vec2& position);
+
+		// freezes and thaws islands, every few steps. Call before the world steps.
+		void Update(b2World& world);
+
+		// wakes every frozen body, and forgets about the camera
+		void ThawAll();
+
+		// a body is about to be destroyed
+		void Forget(b2Body* body);
+
+		int GetFrozenCount() const;
+
+	private:
+		// velocities of a frozen body, from before it was put to sleep
+		struct FrozenBody
+		{
+			b2Vec2 LinearVelocity;
+			float AngularVelocity;
+		};
+
+		// steps between updates. Hysteresis covers what bodies move in between.
+		static const int k_updateInterval = 8;
+
+		bool m_hasCamera = false;
+		b2Vec2 m_camera = b2Vec2(0, 0);
+		int m_stepsToUpdate = 0;
+
+		std::unordered_map<b2Body*, FrozenBody> m_frozen;
+
+		// stamped into the user data of the bodies each update's walk reaches. Starts
+		// past zero, the stamp new bodies have.
+		uint32 m_walk = 0;
+
+		// reused by every update
+		std::vector<b2Body*> m_stack;
+		std::vector<b2Body*> m_island;
+
+		bool Visit(b2Body* body) const;
+		bool IsWanted(b2Body* body) const;
+		void Freeze(b2Body* body);
+		void Thaw(b2Body* body);
+	};
+}
\ No newline at end of file
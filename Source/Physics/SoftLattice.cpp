@@ -0,0 +1,161 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file SoftLattice.cpp
+  * \author Joe Goldman
+  * \brief SoftLattice class definition
+  *
+  **/
+
+#include <Physics/SoftLattice.hpp>
+
+namespace GenevaEngine
+{
+	/*!
+	 *  Lays out the particles, then the links kind by kind, then the outline. Every
+	 *  array is sized first, so none of them grow while they're filled.
+	 */
+	void SoftLattice::Build()
+	{
+		b2Assert(Columns >= 2 && Rows >= 2);
+
+		const int structuralCount = (Columns - 1) * Rows + Columns * (Rows - 1);
+		const int shearCount = 2 * (Columns - 1) * (Rows - 1);
+		const int bendCount = b2Max(Columns - 2, 0) * Rows + Columns * b2Max(Rows - 2, 0);
+		const int linkCount = structuralCount + shearCount + bendCount;
+
+		m_positions.clear();
+		m_links.clear();
+		m_compliances.clear();
+		m_outline.clear();
+		m_positions.reserve(Columns * Rows);
+		m_links.reserve(2 * linkCount);
+		m_compliances.reserve(linkCount);
+		m_outline.reserve(2 * (Columns + Rows) - 4);
+
+		const b2Vec2 spacing(Size.x / (Columns - 1), Size.y / (Rows - 1));
+		const b2Vec2 corner = -0.5f * Size;
+		for (int row = 0; row < Rows; row++)
+		{
+			for (int column = 0; column < Columns; column++)
+				m_positions.push_back(corner + b2Vec2(spacing.x * column, spacing.y * row));
+		}
+
+		// structural, along rows then up columns
+		for (int row = 0; row < Rows; row++)
+		{
+			for (int column = 0; column + 1 < Columns; column++)
+				AddLink(GetIndex(column, row), GetIndex(column + 1, row), StructuralCompliance);
+		}
+		for (int row = 0; row + 1 < Rows; row++)
+		{
+			for (int column = 0; column < Columns; column++)
+				AddLink(GetIndex(column, row), GetIndex(column, row + 1), StructuralCompliance);
+		}
+
+		// shear, both diagonals of each cell
+		for (int row = 0; row + 1 < Rows; row++)
+		{
+			for (int column = 0; column + 1 < Columns; column++)
+			{
+				AddLink(GetIndex(column, row), GetIndex(column + 1, row + 1), ShearCompliance);
+				AddLink(GetIndex(column + 1, row), GetIndex(column, row + 1), ShearCompliance);
+			}
+		}
+
+		// bend, skipping a particle along rows then up columns
+		for (int row = 0; row < Rows; row++)
+		{
+			for (int column = 0; column + 2 < Columns; column++)
+				AddLink(GetIndex(column, row), GetIndex(column + 2, row), BendCompliance);
+		}
+		for (int row = 0; row + 2 < Rows; row++)
+		{
+			for (int column = 0; column < Columns; column++)
+				AddLink(GetIndex(column, row), GetIndex(column, row + 2), BendCompliance);
+		}
+
+		// the bottom, right, top, and left edges, each without its last corner
+		for (int column = 0; column + 1 < Columns; column++)
+			m_outline.push_back(GetIndex(column, 0));
+		for (int row = 0; row + 1 < Rows; row++)
+			m_outline.push_back(GetIndex(Columns - 1, row));
+		for (int column = Columns - 1; column > 0; column--)
+			m_outline.push_back(GetIndex(column, Rows - 1));
+		for (int row = Rows - 1; row > 0; row--)
+			m_outline.push_back(GetIndex(0, row));
+	}
+
+	/*!
+	 *  A soft body definition of the lattice. Only the position differs between the
+	 *  soft bodies made from one lattice, the arrays are shared.
+	 *
+	 *      \param [in] position	where the center of the lattice goes
+	 *
+	 *      \return The definition, valid until the lattice is built again or destroyed.
+	 */
+	b2SoftBodyDef SoftLattice::GetDef(const b2Vec2& position) const
+	{
+		b2SoftBodyDef def;
+		def.position = position;
+		def.positions = m_positions.data();
+		def.count = GetParticleCount();
+		def.mass = Mass / GetParticleCount();
+		def.radius = Radius;
+		def.links = m_links.data();
+		def.linkCount = GetLinkCount();
+		def.compliances = m_compliances.data();
+		def.outline = m_outline.data();
+		def.outlineCount = GetOutlineCount();
+		return def;
+	}
+
+	/*!
+	 *  Makes room in the world for soft bodies of the lattice, so making them in bulk
+	 *  doesn't grow the world's arrays one soft body at a time
+	 *
+	 *      \param [in] world
+	 *      \param [in] count	soft bodies about to be made from the lattice
+	 */
+	void SoftLattice::Reserve(b2World& world, int count) const
+	{
+		world.ReserveSoftBodies(count * GetParticleCount(), count * GetLinkCount(),
+			count * GetOutlineCount());
+	}
+
+	int SoftLattice::GetIndex(int column, int row) const
+	{
+		return row * Columns + column;
+	}
+
+	int SoftLattice::GetParticleCount() const
+	{
+		return (int)m_positions.size();
+	}
+
+	int SoftLattice::GetLinkCount() const
+	{
+		return (int)m_compliances.size();
+	}
+
+	int SoftLattice::GetOutlineCount() const
+	{
+		return (int)m_outline.size();
+	}
+
+	void SoftLattice::AddLink(int a, int b, float compliance)
+	{
+		m_links.push_back(a);
+		m_links.push_back(b);
+		m_compliances.push_back(compliance);
+	}
+}
\ No newline at end of file
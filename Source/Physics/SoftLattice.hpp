@@ -0,0 +1,72 @@
+/****************************************************************************
+ * Copyright (C) 2021 by Joe Goldman	                                    *
+ *                                                                          *
+ * This file is part of GenevaEngine.                                       *
+ *                                                                          *
+ *   GenevaEngine is a custom C++ engine built for the purposes of 			*
+ *	 learning and fun. You can reach me at joecgo@gmail.com. 				*
+ *                                                                          *
+ ****************************************************************************/
+
+
+ /**
+  * \file SoftLattice.hpp
+  * \author Joe Goldman
+  * \brief SoftLattice class declaration
+  *
+  */
+
+#pragma once
+
+#include <Physics/Box2d.hpp>
+
+#include <vector> // vector
+
+namespace GenevaEngine
+{
+	/*!
+	 *  \brief	The particles and links of a soft body laid out as a grid of Columns by
+	 *			Rows particles. Structural links join each particle to the next along its
+	 *			row and column, shear links cross each cell, and bend links skip a
+	 *			particle along rows and columns. A lattice is built once and its
+	 *			definition shared by every soft body made from it.
+	 */
+	class SoftLattice
+	{
+	public:
+		// Creation Attributes, Define these before Build
+		int Columns = 4;
+		int Rows = 4;
+		b2Vec2 Size = b2Vec2(10.0f, 10.0f);
+		float Mass = 1.0f;					// of the whole lattice, spread evenly
+		float Radius = 0.5f;				// of every particle
+		float StructuralCompliance = 0.0f;	// resists stretching along rows and columns
+		float ShearCompliance = 0.0f;		// resists cells skewing
+		float BendCompliance = 0.0f;		// resists rows and columns folding
+
+		// builds the particles, links, and outline, with storage reserved up front
+		void Build();
+
+		// a soft body definition centered on position. It points into the lattice.
+		b2SoftBodyDef GetDef(const b2Vec2& position) const;
+
+		// reserves the world's soft body arrays for count more soft bodies of the lattice
+		void Reserve(b2World& world, int count) const;
+
+		int GetIndex(int column, int row) const;
+		int GetParticleCount() const;
+		int GetLinkCount() const;
+		int GetOutlineCount() const;
+
+	private:
+		// particle positions relative to the center, row by row from the bottom
+		std::vector<b2Vec2> m_positions;
+		// two particle indices per link, and each link's compliance
+		std::vector<int32> m_links;
+		std::vector<float> m_compliances;
+		// the edge particles, counter-clockwise from the bottom left
+		std::vector<int32> m_outline;
+
+		void AddLink(int a, int b, float compliance);
+	};
+}
\ No newline at end of file